@@ -89,6 +89,13 @@
 #error "Can not get functuon name"
 #endif
 
+// SIMD instruction sets (enabled by the compiler flags)
+#if defined __SSE2__ || defined _M_X64 || ( defined _M_IX86_FP && _M_IX86_FP >= 2 )
+#       define E_SIMD_SSE2 1
+#else
+#       define E_SIMD_SSE2 0
+#endif
+
 
 // Enable math defines
 #ifndef _USE_MATH_DEFINES
@@ -0,0 +1,169 @@
+/*!
+ * \file rBoundingVolume.cpp
+ * \brief \b Classes: \a _3D_Bounds
+ */
+/*
+ * Copyright (C) 2015 EEnginE project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rBoundingVolume.hpp"
+#include "rVertexSIMD.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace e_engine {
+
+namespace internal {
+
+namespace {
+
+template <class T>
+void calculateBoundsScalar( T const *_vert, size_t _begin, size_t _end, _3D_Bounds<T> &_out ) {
+   for ( size_t i = _begin; i < _end; ++i ) {
+      for ( size_t j = 0; j < 3; ++j ) {
+         _out.vMin[j] = std::min( _out.vMin[j], _vert[i * 3 + j] );
+         _out.vMax[j] = std::max( _out.vMax[j], _vert[i * 3 + j] );
+      }
+   }
+}
+
+template <class T>
+T calculateRadius2Scalar( T const *_vert, size_t _begin, size_t _end, T const *_center ) {
+   T lRadius2 = 0;
+   for ( size_t i = _begin; i < _end; ++i ) {
+      T lX = _vert[i * 3 + 0] - _center[0];
+      T lY = _vert[i * 3 + 1] - _center[1];
+      T lZ = _vert[i * 3 + 2] - _center[2];
+      lRadius2 = std::max( lRadius2, lX * lX + lY * lY + lZ * lZ );
+   }
+
+   return lRadius2;
+}
+}
+
+/*!
+ * \brief Calculates the bounding box and sphere of packed xyz vertices
+ *
+ * The sphere is centered in the bounding box. Its radius is the exact distance to the farthest
+ * vertex, which needs a second pass over the data. Both passes process 4 vertices at once when
+ * SSE2 is available.
+ *
+ * \param[in]  _vertices    Pointer to _numVertices * 3 floats
+ * \param[in]  _numVertices Number of vertices
+ * \param[out] _out         The bounds (vIsValid is false when there are no vertices)
+ */
+void calculateBounds( float const *_vertices, size_t _numVertices, _3D_Bounds<float> &_out ) {
+   _out.clear();
+
+   if ( _numVertices == 0 || !_vertices )
+      return;
+
+   for ( size_t j = 0; j < 3; ++j )
+      _out.vMin[j] = _out.vMax[j] = _vertices[j];
+
+   size_t lSIMDEnd = 0;
+
+#if E_SIMD_SSE2
+   lSIMDEnd = _numVertices & ~static_cast<size_t>( 3 );
+
+   if ( lSIMDEnd > 0 ) {
+      __m128 lMinX = _mm_set1_ps( _vertices[0] ), lMaxX = lMinX;
+      __m128 lMinY = _mm_set1_ps( _vertices[1] ), lMaxY = lMinY;
+      __m128 lMinZ = _mm_set1_ps( _vertices[2] ), lMaxZ = lMinZ;
+      __m128 lX, lY, lZ;
+
+      for ( size_t i = 0; i < lSIMDEnd; i += 4 ) {
+         loadXYZ( _vertices + i * 3, lX, lY, lZ );
+         lMinX = _mm_min_ps( lMinX, lX );
+         lMaxX = _mm_max_ps( lMaxX, lX );
+         lMinY = _mm_min_ps( lMinY, lY );
+         lMaxY = _mm_max_ps( lMaxY, lY );
+         lMinZ = _mm_min_ps( lMinZ, lZ );
+         lMaxZ = _mm_max_ps( lMaxZ, lZ );
+      }
+
+      _out.vMin[0] = horizontalMin( lMinX );
+      _out.vMin[1] = horizontalMin( lMinY );
+      _out.vMin[2] = horizontalMin( lMinZ );
+      _out.vMax[0] = horizontalMax( lMaxX );
+      _out.vMax[1] = horizontalMax( lMaxY );
+      _out.vMax[2] = horizontalMax( lMaxZ );
+   }
+#endif
+
+   calculateBoundsScalar( _vertices, lSIMDEnd, _numVertices, _out );
+
+   for ( size_t j = 0; j < 3; ++j )
+      _out.vCenter[j] = ( _out.vMin[j] + _out.vMax[j] ) / 2;
+
+   float lRadius2 = 0;
+
+#if E_SIMD_SSE2
+   if ( lSIMDEnd > 0 ) {
+      __m128 lCX = _mm_set1_ps( _out.vCenter[0] );
+      __m128 lCY = _mm_set1_ps( _out.vCenter[1] );
+      __m128 lCZ = _mm_set1_ps( _out.vCenter[2] );
+      __m128 lMax = _mm_setzero_ps();
+      __m128 lX, lY, lZ;
+
+      for ( size_t i = 0; i < lSIMDEnd; i += 4 ) {
+         loadXYZ( _vertices + i * 3, lX, lY, lZ );
+         lX = _mm_sub_ps( lX, lCX );
+         lY = _mm_sub_ps( lY, lCY );
+         lZ = _mm_sub_ps( lZ, lCZ );
+
+         __m128 lDist = _mm_add_ps( _mm_add_ps( _mm_mul_ps( lX, lX ), _mm_mul_ps( lY, lY ) ),
+                                    _mm_mul_ps( lZ, lZ ) );
+
+         lMax = _mm_max_ps( lMax, lDist );
+      }
+
+      lRadius2 = horizontalMax( lMax );
+   }
+#endif
+
+   lRadius2 = std::max(
+         lRadius2, calculateRadius2Scalar( _vertices, lSIMDEnd, _numVertices, _out.vCenter ) );
+
+   _out.vRadius = std::sqrt( lRadius2 );
+   _out.vIsValid = true;
+}
+
+/*!
+ * \brief Calculates the bounding box and sphere of packed xyz vertices (scalar)
+ * \sa calculateBounds( float const *, size_t, _3D_Bounds<float> & )
+ */
+void calculateBounds( double const *_vertices, size_t _numVertices, _3D_Bounds<double> &_out ) {
+   _out.clear();
+
+   if ( _numVertices == 0 || !_vertices )
+      return;
+
+   for ( size_t j = 0; j < 3; ++j )
+      _out.vMin[j] = _out.vMax[j] = _vertices[j];
+
+   calculateBoundsScalar( _vertices, 0, _numVertices, _out );
+
+   for ( size_t j = 0; j < 3; ++j )
+      _out.vCenter[j] = ( _out.vMin[j] + _out.vMax[j] ) / 2;
+
+   _out.vRadius = std::sqrt( calculateRadius2Scalar( _vertices, 0, _numVertices, _out.vCenter ) );
+   _out.vIsValid = true;
+}
+}
+}
+
+// kate: indent-mode cstyle; indent-width 3; replace-tabs on; line-numbers on;
@@ -0,0 +1,56 @@
+/*!
+ * \file rBoundingVolume.hpp
+ * \brief \b Classes: \a _3D_Bounds
+ */
+/*
+ * Copyright (C) 2015 EEnginE project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef R_BOUNDING_VOLUME_HPP
+#define R_BOUNDING_VOLUME_HPP
+
+#include "defines.hpp"
+
+#include <stddef.h>
+
+namespace e_engine {
+
+namespace internal {
+
+/*!
+ * \brief Axis aligned bounding box and bounding sphere of a mesh (object space)
+ *
+ * The center of the sphere is the center of the box.
+ */
+template <class T>
+struct _3D_Bounds {
+   T vMin[3] = {0, 0, 0};
+   T vMax[3] = {0, 0, 0};
+   T vCenter[3] = {0, 0, 0};
+   T vRadius = 0;
+
+   bool vIsValid = false; //!< false if there were no vertices
+
+   void clear() { *this = _3D_Bounds<T>(); }
+};
+
+void calculateBounds( float const *_vertices, size_t _numVertices, _3D_Bounds<float> &_out );
+void calculateBounds( double const *_vertices, size_t _numVertices, _3D_Bounds<double> &_out );
+}
+}
+
+#endif // R_BOUNDING_VOLUME_HPP
+
+// kate: indent-mode cstyle; indent-width 3; replace-tabs on; line-numbers on;
@@ -24,9 +24,14 @@
 
 #include <GL/glew.h>
 #include <vector>
-#include <list>
 #include <string>
+#include <limits>
+#include <algorithm>
 #include <type_traits>
+#include <cmath>
+#include <functional>
+#include <string.h>
+#include <stdint.h>
 #include "uLog.hpp"
 
 namespace e_engine {
@@ -79,6 +84,150 @@ struct _3D_Data {
    }
 };
 
+/*!
+ * \brief Interleaved vertex data (position [normal] [UV] per vertex)
+ *
+ * Can be uploaded into a single vertex buffer. The position is always 3 GLfloat. Normals are
+ * 3 GLfloat or one GL_INT_2_10_10_10_REV (4 components, normalized), UV coordinates are 2
+ * GLfloat or 2 GL_HALF_FLOAT. Offsets and the stride are counted in bytes.
+ */
+template <class T, class I>
+struct _3D_Data_INTERLEAVED {
+   std::vector<unsigned char> vData;
+   std::vector<I> vIndex;
+
+   uint32_t vStride = 0;       //!< Bytes per vertex (0: no data)
+   uint32_t vNormalOffset = 0; //!< Offset of the normal (0: no normals)
+   uint32_t vUVOffset = 0;     //!< Offset of the UV coordinates (0: no UV coordinates)
+
+   GLenum vNormalType = GL_FLOAT; //!< GL_FLOAT or GL_INT_2_10_10_10_REV
+   GLenum vUVType = GL_FLOAT;     //!< GL_FLOAT or GL_HALF_FLOAT
+
+   void clear() {
+      vData.clear();
+      vData.shrink_to_fit();
+      vIndex.clear();
+      vIndex.shrink_to_fit();
+      vStride = 0;
+      vNormalOffset = 0;
+      vUVOffset = 0;
+      vNormalType = GL_FLOAT;
+      vUVType = GL_FLOAT;
+   }
+};
+
+/*!
+ * \brief Converts a float into a IEEE 754 half float (round to nearest even)
+ */
+inline uint16_t toHalfFloat( float _val ) {
+   uint32_t lBits;
+   memcpy( &lBits, &_val, sizeof( lBits ) );
+
+   uint16_t lSign = static_cast<uint16_t>( ( lBits >> 16 ) & 0x8000 );
+   uint32_t lAbs = lBits & 0x7FFFFFFF;
+
+   // Inf and NaN
+   if ( lAbs >= 0x7F800000 )
+      return lSign | 0x7C00 | ( lAbs > 0x7F800000 ? 0x200 : 0 );
+
+   // Too big (rounds to >= 65536)
+   if ( lAbs >= 0x477FF000 )
+      return lSign | 0x7C00;
+
+   uint32_t lResult, lRemainder, lHalf;
+
+   if ( lAbs < 0x38800000 ) {
+      // Subnormal half float (or 0)
+      uint32_t lExp = lAbs >> 23;
+      if ( lExp < 102 )
+         return lSign;
+
+      uint32_t lMantissa = ( lAbs & 0x7FFFFF ) | 0x800000;
+      uint32_t lShift = 126 - lExp;
+
+      lResult = lMantissa >> lShift;
+      lRemainder = lMantissa & ( ( 1u << lShift ) - 1 );
+      lHalf = 1u << ( lShift - 1 );
+   } else {
+      // Rebias the exponent (127 -> 15) and cut the mantissa (23 -> 10 bits)
+      lResult = ( lAbs - 0x38000000 ) >> 13;
+      lRemainder = lAbs & 0x1FFF;
+      lHalf = 0x1000;
+   }
+
+   // A carry into the exponent is correct here
+   if ( lRemainder > lHalf || ( lRemainder == lHalf && ( lResult & 1 ) ) )
+      ++lResult;
+
+   return lSign | static_cast<uint16_t>( lResult );
+}
+
+/*!
+ * \brief Normalizes a normal and packs it into GL_INT_2_10_10_10_REV (w = 0)
+ */
+inline uint32_t packNormal2101010( float _x, float _y, float _z ) {
+   float lLength = std::sqrt( _x * _x + _y * _y + _z * _z );
+
+   if ( lLength > 0.0f ) {
+      _x /= lLength;
+      _y /= lLength;
+      _z /= lLength;
+   }
+
+   auto lPack = []( float _v ) -> uint32_t {
+      _v = std::min( std::max( _v, -1.0f ), 1.0f );
+      return static_cast<uint32_t>( static_cast<int32_t>( std::lround( _v * 511.0f ) ) ) & 0x3FF;
+   };
+
+   return lPack( _x ) | ( lPack( _y ) << 10 ) | ( lPack( _z ) << 20 );
+}
+
+/*!
+ * \brief Returns true if the native byte order is little endian
+ *
+ * Binary mesh formats (PLY, STL) store little endian data, which can then be copied in bulk.
+ */
+inline bool isLittleEndianHost() {
+   uint32_t lTest = 1;
+   unsigned char lFirst;
+   memcpy( &lFirst, &lTest, 1 );
+   return lFirst == 1;
+}
+
+/*!
+ * \brief Reads a little endian value (integer or IEEE 754 float) from unaligned memory
+ */
+template <class T>
+inline T readLittleEndian( void const *_data ) {
+   static_assert( sizeof( T ) == 1 || sizeof( T ) == 2 || sizeof( T ) == 4 || sizeof( T ) == 8,
+                  "Unsupported type size" );
+
+   typedef typename std::conditional<
+         sizeof( T ) == 1,
+         uint8_t,
+         typename std::conditional<
+               sizeof( T ) == 2,
+               uint16_t,
+               typename std::conditional<sizeof( T ) == 4, uint32_t, uint64_t>::type>::type>::type
+         UINT;
+
+   T lResult;
+
+   if ( isLittleEndianHost() ) {
+      memcpy( &lResult, _data, sizeof( T ) );
+      return lResult;
+   }
+
+   unsigned char const *lBytes = static_cast<unsigned char const *>( _data );
+   UINT lBits = 0;
+
+   for ( size_t i = 0; i < sizeof( T ); ++i )
+      lBits = static_cast<UINT>( lBits | ( static_cast<UINT>( lBytes[i] ) << ( 8 * i ) ) );
+
+   memcpy( &lResult, &lBits, sizeof( T ) );
+   return lResult;
+}
+
 typedef _3D_Data_RAW<GLfloat, GLuint> _3D_Data_RAWF;
 typedef _3D_Data_RAW<GLdouble, GLuint> _3D_Data_RAWD;
 
@@ -88,13 +237,84 @@ class rLoaderBase {
    static_assert( std::is_unsigned<I>::value, "I must be an unsigned type" );
 
  private:
-   struct __indexFinder__ {
-      I i1;
-      I i2;
+   /*!
+    * \brief Open addressing hash table (linear probing) for finding already reindexed vertices
+    *
+    * Maps an index tuple (vertex, 2nd, 3rd) to its new index. The table only stores the new
+    * index; the tuples themselves are stored in vKeys in the order they were inserted (the new
+    * index is the position in vKeys). All memory is reserved in the constructor.
+    */
+   class __indexHashTable__ {
+    private:
+      struct __key__ {
+         I iv;
+         I i2;
+         I i3;
+      };
+
+      std::vector<I> vTable;
+      std::vector<__key__> vKeys;
+      size_t vMask;
+      size_t vStride;
+
+      /*
+       * Vertices referenced by neighbouring corners usually have neighbouring indexes. Spreading
+       * the vertex index linearly over the table (instead of scattering it) keeps those lookups
+       * in the same cache lines. Tuples sharing a vertex end up next to each other and are
+       * resolved by the linear probing.
+       */
+      size_t hash( I _iv, I _i2, I _i3 ) const {
+         uint64_t lMix = static_cast<uint64_t>( _i2 ) * 0x9E3779B97F4A7C15ULL +
+                         static_cast<uint64_t>( _i3 ) * 0xC2B2AE3D27D4EB4FULL;
+         return ( static_cast<size_t>( _iv ) * vStride + static_cast<size_t>( lMix >> 61 ) ) &
+                vMask;
+      }
 
-      I index;
+    public:
+      /*!
+       * \param[in] _maxKeys      The maximum number of different keys (the number of corners)
+       * \param[in] _numVertices  The number of different vertex indexes
+       * \param[in] _expectedKeys The expected number of different keys
+       */
+      __indexHashTable__( size_t _maxKeys, size_t _numVertices, size_t _expectedKeys ) {
+         size_t lSize = 16;
 
-      __indexFinder__( I _i1, I _i2, I _index ) : i1( _i1 ), i2( _i2 ), index( _index ) {}
+         // Keep the load factor at or below 0.75 even in the worst case
+         while ( lSize < _maxKeys + _maxKeys / 3 )
+            lSize <<= 1;
+
+         vMask = lSize - 1;
+         vStride = _numVertices > 0 ? lSize / _numVertices : 1;
+
+         if ( vStride == 0 )
+            vStride = 1;
+
+         vTable.resize( lSize, std::numeric_limits<I>::max() );
+         vKeys.reserve( _expectedKeys < _maxKeys ? _expectedKeys : _maxKeys );
+      }
+
+      /*!
+       * \brief Finds the index of the tuple, or inserts it with the next free index
+       * \returns true if the tuple was already in the table
+       */
+      bool findOrInsert( I _iv, I _i2, I _i3, I &_index ) {
+         for ( size_t lSlot = hash( _iv, _i2, _i3 );; lSlot = ( lSlot + 1 ) & vMask ) {
+            I lIndex = vTable[lSlot];
+
+            if ( lIndex == std::numeric_limits<I>::max() ) {
+               _index = static_cast<I>( vKeys.size() );
+               vTable[lSlot] = _index;
+               vKeys.push_back( {_iv, _i2, _i3} );
+               return false;
+            }
+
+            __key__ const &lKey = vKeys[lIndex];
+            if ( lKey.iv == _iv && lKey.i2 == _i2 && lKey.i3 == _i3 ) {
+               _index = lIndex;
+               return true;
+            }
+         }
+      }
    };
 
    template <I VERT, I S2>
@@ -121,14 +341,36 @@ class rLoaderBase {
  protected:
    _3D_Data_RAW<T, I> vDataRaw;
    _3D_Data<T, I> vData;
+   _3D_Data_INTERLEAVED<T, I> vDataInterleaved;
+
+   //! Simplified index buffers (LOD 1..n) for the vertices of the base mesh
+   std::vector<std::vector<I>> vLODs;
 
    bool vIsDataLoaded_B;
    std::string vFilePath_str;
 
+   /*!
+    * \brief Receives the triangles that became complete since the last call (see emitBatch())
+    *
+    * The data is a triangle soup with 6 values (position, normal) per vertex. The callback is
+    * called from the loading thread.
+    */
+   typedef std::function<void( std::vector<T> const & )> BATCH_CALLBACK;
+
+   BATCH_CALLBACK vBatchCallback;
+   size_t vBatchStart = 0; //!< First index in vDataRaw.vIndexVertexData not passed on yet
+
+   void emitBatch();
+
  public:
    virtual ~rLoaderBase() {}
 
+   void setBatchCallback( BATCH_CALLBACK _callback ) { vBatchCallback = _callback; }
+   bool getIsStreaming() const { return static_cast<bool>( vBatchCallback ); }
+
    _3D_Data<T, I> *getData();
+   _3D_Data_INTERLEAVED<T, I> *getInterleavedData();
+   std::vector<std::vector<I>> *getLODs() { return &vLODs; }
 
    void setFile( std::string _file );
 
@@ -136,6 +378,9 @@ class rLoaderBase {
    std::string getFilePath() const;
 
    void reindex();
+   void interleave( bool _quantize = false );
+
+   bool getIsInterleaved() const { return vDataInterleaved.vStride != 0; }
 
    virtual int load() = 0;
    void unLoad();
@@ -150,6 +395,79 @@ void rLoaderBase<T, I>::unLoad() {
    vIsDataLoaded_B = false;
    vDataRaw.clear();
    vData.clear();
+   vDataInterleaved.clear();
+   vLODs.clear();
+   vBatchStart = 0;
+}
+
+/*!
+ * \brief Passes all complete triangles parsed since the last call to the batch callback
+ *
+ * Loaders supporting streaming call this from load() whenever a part of the file is parsed. The
+ * triangles are expanded from vDataRaw into a triangle soup (position and normal per vertex), so
+ * the receiver can append them to a vertex buffer without an index. Triangles with indices
+ * pointing to vertices that are not parsed yet end the batch; they are passed on with the next
+ * call. Files without normals get flat face normals.
+ *
+ * Does nothing if no batch callback is set.
+ */
+template <class T, class I>
+void rLoaderBase<T, I>::emitBatch() {
+   if ( !vBatchCallback )
+      return;
+
+   std::vector<I> const &lIndex = vDataRaw.vIndexVertexData;
+   std::vector<I> const &lNormalIndex = vDataRaw.vIndexNormalData;
+   std::vector<T> const &lVert = vDataRaw.vVertexData;
+   std::vector<T> const &lNorm = vDataRaw.vNormalesData;
+
+   size_t lNumVert = lVert.size() / 3;
+   size_t lNumNorm = lNorm.size() / 3;
+   bool lHasNormals = lNumNorm > 0 && lNormalIndex.size() == lIndex.size();
+
+   std::vector<T> lBatch;
+   lBatch.reserve( ( ( lIndex.size() - std::min( vBatchStart, lIndex.size() ) ) / 3 ) * 18 );
+
+   size_t i = vBatchStart;
+   for ( ; i + 3 <= lIndex.size(); i += 3 ) {
+      if ( lIndex[i] >= lNumVert || lIndex[i + 1] >= lNumVert || lIndex[i + 2] >= lNumVert )
+         break;
+
+      if ( lHasNormals && ( lNormalIndex[i] >= lNumNorm || lNormalIndex[i + 1] >= lNumNorm ||
+                            lNormalIndex[i + 2] >= lNumNorm ) )
+         break;
+
+      T const *lP[3] = {
+            &lVert[lIndex[i] * 3], &lVert[lIndex[i + 1] * 3], &lVert[lIndex[i + 2] * 3]};
+      T lFace[3] = {0, 0, 0};
+
+      if ( !lHasNormals ) {
+         T lE1[3] = {lP[1][0] - lP[0][0], lP[1][1] - lP[0][1], lP[1][2] - lP[0][2]};
+         T lE2[3] = {lP[2][0] - lP[0][0], lP[2][1] - lP[0][1], lP[2][2] - lP[0][2]};
+
+         lFace[0] = lE1[1] * lE2[2] - lE1[2] * lE2[1];
+         lFace[1] = lE1[2] * lE2[0] - lE1[0] * lE2[2];
+         lFace[2] = lE1[0] * lE2[1] - lE1[1] * lE2[0];
+
+         T lLength = std::sqrt( lFace[0] * lFace[0] + lFace[1] * lFace[1] + lFace[2] * lFace[2] );
+         if ( lLength > 0 ) {
+            lFace[0] /= lLength;
+            lFace[1] /= lLength;
+            lFace[2] /= lLength;
+         }
+      }
+
+      for ( size_t j = 0; j < 3; ++j ) {
+         T const *lN = lHasNormals ? &lNorm[lNormalIndex[i + j] * 3] : lFace;
+         lBatch.insert( lBatch.end(), lP[j], lP[j] + 3 );
+         lBatch.insert( lBatch.end(), lN, lN + 3 );
+      }
+   }
+
+   vBatchStart = i;
+
+   if ( !lBatch.empty() )
+      vBatchCallback( lBatch );
 }
 
 /*!
@@ -192,8 +510,96 @@ _3D_Data<T, I> *rLoaderBase<T, I>::getData() {
 }
 
 
+/*!
+ * \brief Gets the interleaved data pointer
+ * \returns The interleaved data pointer (only valid after interleave())
+ */
+template <class T, class I>
+_3D_Data_INTERLEAVED<T, I> *rLoaderBase<T, I>::getInterleavedData() {
+   return &vDataInterleaved;
+}
+
+/*!
+ * \brief Converts the (reindexed) data into the interleaved layout
+ *
+ * The index is moved and the separate attribute arrays are freed, so getData() will be empty
+ * afterwards. Do all other processing (optimizing, etc.) before calling this function.
+ *
+ * \param[in] _quantize Store normals as GL_INT_2_10_10_10_REV and UVs as GL_HALF_FLOAT
+ */
+template <class T, class I>
+void rLoaderBase<T, I>::interleave( bool _quantize ) {
+   size_t lNumVertices = vData.vVertexData.size() / 3;
+   bool lHasNormals = vData.vNormalesData.size() == lNumVertices * 3 && lNumVertices > 0;
+   bool lHasUV = vData.vUVData.size() == lNumVertices * 2 && lNumVertices > 0;
+
+   if ( lNumVertices == 0 )
+      return;
+
+   _3D_Data_INTERLEAVED<T, I> &lOut = vDataInterleaved;
+
+   lOut.vStride = 3 * sizeof( GLfloat );
+   lOut.vNormalOffset = 0;
+   lOut.vUVOffset = 0;
+   lOut.vNormalType = _quantize ? GL_INT_2_10_10_10_REV : GL_FLOAT;
+   lOut.vUVType = _quantize ? GL_HALF_FLOAT : GL_FLOAT;
+
+   if ( lHasNormals ) {
+      lOut.vNormalOffset = lOut.vStride;
+      lOut.vStride += _quantize ? sizeof( uint32_t ) : 3 * sizeof( GLfloat );
+   }
+
+   if ( lHasUV ) {
+      lOut.vUVOffset = lOut.vStride;
+      lOut.vStride += _quantize ? 2 * sizeof( uint16_t ) : 2 * sizeof( GLfloat );
+   }
+
+   lOut.vData.resize( lNumVertices * lOut.vStride );
+
+   unsigned char *lVertex = lOut.vData.data();
+   for ( size_t i = 0; i < lNumVertices; ++i, lVertex += lOut.vStride ) {
+      GLfloat lPos[3] = {static_cast<GLfloat>( vData.vVertexData[i * 3 + 0] ),
+                         static_cast<GLfloat>( vData.vVertexData[i * 3 + 1] ),
+                         static_cast<GLfloat>( vData.vVertexData[i * 3 + 2] )};
+      memcpy( lVertex, lPos, sizeof( lPos ) );
+
+      if ( lHasNormals ) {
+         GLfloat lNorm[3] = {static_cast<GLfloat>( vData.vNormalesData[i * 3 + 0] ),
+                             static_cast<GLfloat>( vData.vNormalesData[i * 3 + 1] ),
+                             static_cast<GLfloat>( vData.vNormalesData[i * 3 + 2] )};
+
+         if ( _quantize ) {
+            uint32_t lPacked = packNormal2101010( lNorm[0], lNorm[1], lNorm[2] );
+            memcpy( lVertex + lOut.vNormalOffset, &lPacked, sizeof( lPacked ) );
+         } else {
+            memcpy( lVertex + lOut.vNormalOffset, lNorm, sizeof( lNorm ) );
+         }
+      }
+
+      if ( lHasUV ) {
+         GLfloat lUV[2] = {static_cast<GLfloat>( vData.vUVData[i * 2 + 0] ),
+                           static_cast<GLfloat>( vData.vUVData[i * 2 + 1] )};
+
+         if ( _quantize ) {
+            uint16_t lHalf[2] = {toHalfFloat( lUV[0] ), toHalfFloat( lUV[1] )};
+            memcpy( lVertex + lOut.vUVOffset, lHalf, sizeof( lHalf ) );
+         } else {
+            memcpy( lVertex + lOut.vUVOffset, lUV, sizeof( lUV ) );
+         }
+      }
+   }
+
+   lOut.vIndex = std::move( vData.vIndex );
+   vData = _3D_Data<T, I>(); // Free the memory
+}
+
+
 template <class T, class I>
 void rLoaderBase<T, I>::reindex() {
+   // The loader filled vData directly (the format is already indexed per vertex)
+   if ( vDataRaw.vVertexData.empty() && !vData.vVertexData.empty() )
+      return;
+
    // Nothing to reindex
    if ( vDataRaw.vUVData.empty() && vDataRaw.vNormalesData.empty() ) {
       vData.vVertexData = std::move( vDataRaw.vVertexData );
@@ -251,19 +657,21 @@ void rLoaderBase<T, I>::reindex2( std::vector<T> *_vertIn,
                                   std::vector<I> *_index2nd,
                                   std::vector<I> *_indexOut ) {
 
-   std::vector<std::list<__indexFinder__>> lHelper;
-   lHelper.resize( _vertIn->size() );
-
-   I lCurrentIndex = 0, lIV, lI2;
-   bool lFoundIndex;
+   I lIV, lI2;
 
    if ( _index2nd->size() != _indexVert->size() ) {
       eLOG( "Invalid object -- not the same number of indexes '", vFilePath_str, "'" );
       return;
    }
 
+   size_t lExpected = std::max( _vertIn->size() / VERT, _2ndIn->size() / S2 );
+   __indexHashTable__ lHelper( _indexVert->size(), _vertIn->size() / VERT, lExpected );
+
+   _indexOut->reserve( _indexVert->size() );
+   _vertOut->reserve( lExpected * VERT );
+   _2ndOut->reserve( lExpected * S2 );
+
    for ( size_t i = 0; i < _indexVert->size(); ++i ) {
-      lFoundIndex = false;
       lIV = ( *_indexVert )[i];
       lI2 = ( *_index2nd )[i];
 
@@ -273,15 +681,9 @@ void rLoaderBase<T, I>::reindex2( std::vector<T> *_vertIn,
          continue;
       }
 
-      for ( auto const &j : lHelper[lIV] ) {
-         if ( j.i1 == lI2 ) {
-            _indexOut->emplace_back( j.index );
-            lFoundIndex = true;
-            break;
-         }
-      }
+      _indexOut->emplace_back( 0 );
 
-      if ( lFoundIndex )
+      if ( lHelper.findOrInsert( lIV, lI2, 0, _indexOut->back() ) )
          continue;
 
       for ( size_t j = 0; j < VERT; ++j )
@@ -289,10 +691,6 @@ void rLoaderBase<T, I>::reindex2( std::vector<T> *_vertIn,
 
       for ( size_t j = 0; j < S2; ++j )
          _2ndOut->emplace_back( ( *_2ndIn )[lI2 * S2 + j] );
-
-      _indexOut->emplace_back( lCurrentIndex );
-      lHelper[lIV].emplace_back( lI2, 0, lCurrentIndex );
-      ++lCurrentIndex;
    }
 }
 
@@ -310,19 +708,23 @@ void rLoaderBase<T, I>::reindex3( std::vector<T> *_vertIn,
                                   std::vector<I> *_index3rd,
                                   std::vector<I> *_indexOut ) {
 
-   std::vector<std::list<__indexFinder__>> lHelper;
-   lHelper.resize( _vertIn->size() );
-
-   I lCurrentIndex = 0, lIV, lI2, lI3;
-   bool lFoundIndex;
+   I lIV, lI2, lI3;
 
    if ( _index2nd->size() != _indexVert->size() || _index3rd->size() != _indexVert->size() ) {
       eLOG( "Invalid object -- not the same number of indexes '", vFilePath_str, "'" );
       return;
    }
 
+   size_t lExpected =
+         std::max( std::max( _vertIn->size() / VERT, _2ndIn->size() / S2 ), _3rdIn->size() / S3 );
+   __indexHashTable__ lHelper( _indexVert->size(), _vertIn->size() / VERT, lExpected );
+
+   _indexOut->reserve( _indexVert->size() );
+   _vertOut->reserve( lExpected * VERT );
+   _2ndOut->reserve( lExpected * S2 );
+   _3rdOut->reserve( lExpected * S3 );
+
    for ( size_t i = 0; i < _indexVert->size(); ++i ) {
-      lFoundIndex = false;
       lIV = ( *_indexVert )[i];
       lI2 = ( *_index2nd )[i];
       lI3 = ( *_index3rd )[i];
@@ -334,15 +736,9 @@ void rLoaderBase<T, I>::reindex3( std::vector<T> *_vertIn,
          continue;
       }
 
-      for ( auto const &j : lHelper[lIV] ) {
-         if ( j.i1 == lI2 && j.i2 == lI3 ) {
-            _indexOut->emplace_back( j.index );
-            lFoundIndex = true;
-            break;
-         }
-      }
+      _indexOut->emplace_back( 0 );
 
-      if ( lFoundIndex )
+      if ( lHelper.findOrInsert( lIV, lI2, lI3, _indexOut->back() ) )
          continue;
 
       for ( size_t j = 0; j < VERT; ++j )
@@ -353,10 +749,6 @@ void rLoaderBase<T, I>::reindex3( std::vector<T> *_vertIn,
 
       for ( size_t j = 0; j < S3; ++j )
          _3rdOut->emplace_back( ( *_3rdIn )[lI3 * S3 + j] );
-
-      _indexOut->emplace_back( lCurrentIndex );
-      lHelper[lIV].emplace_back( lI2, lI3, lCurrentIndex );
-      ++lCurrentIndex;
    }
 }
 }
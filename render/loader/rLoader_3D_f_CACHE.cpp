@@ -0,0 +1,384 @@
+/*!
+ * \file rLoader_3D_f_CACHE.cpp
+ * \brief \b Classes: \a rLoader_3D_f_CACHE
+ */
+/*
+ * Copyright (C) 2015 EEnginE project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rLoader_3D_f_CACHE.hpp"
+
+#include "uLog.hpp"
+#include "uSystem.hpp"
+#include "uSHA_2.hpp"
+#include "uMemoryMappedFile.hpp"
+
+#include <fstream>
+#include <algorithm>
+#include <string.h>
+#include <stdio.h>
+#include <boost/filesystem.hpp>
+
+namespace e_engine {
+
+rLoader_3D_f_CACHE::rLoader_3D_f_CACHE() { vIsDataLoaded_B = false; }
+
+rLoader_3D_f_CACHE::rLoader_3D_f_CACHE( std::string _file ) {
+   vIsDataLoaded_B = false;
+   vFilePath_str = _file;
+}
+
+namespace {
+
+void removeTempFile( std::string const &_file ) {
+   try {
+      boost::filesystem::remove( _file );
+   } catch ( const boost::filesystem::filesystem_error &ex ) { wLOG( ex.what() ); }
+}
+}
+
+void rLoader_3D_f_CACHE::fillHeader( __header__ &_header ) {
+   memset( &_header, 0, sizeof( _header ) );
+   memcpy( _header.magic, "EEMESH\0\0", 8 );
+   _header.version = CACHE_VERSION;
+   _header.byteOrder = 0x01020304;
+}
+
+/*!
+ * \brief Sets the source file the cache entry must belong to
+ *
+ * If set, load() will reject cache files with a different source hash or size.
+ */
+void rLoader_3D_f_CACHE::setExpectedSource( std::vector<unsigned char> const &_hash,
+                                            uint64_t _size ) {
+   vSourceHash = _hash;
+   vSourceSize = _size;
+}
+
+/*!
+ * \brief Sets the LOD settings the cache entry must be generated with
+ *
+ * load() rejects cache files with other settings. Only checked if the cache file has LODs (LODS
+ * flag, see setExpectedFlags()).
+ */
+void rLoader_3D_f_CACHE::setExpectedLODs( uint32_t _request, float _reduction ) {
+   vLODRequest = _request;
+   vLODReduction = _reduction;
+}
+
+/*!
+ * \brief loads the mesh from the cache file
+ * \returns 1 on success
+ * \returns 2 if the cache file is invalid (corrupt, stale, other version, etc.)
+ * \returns 3 if the cache file doesn't exists
+ * \returns 4 if the cache file is not a regular file
+ * \returns 5 if the cache file is not readable
+ * \returns 6 if already loaded
+ */
+int rLoader_3D_f_CACHE::load() {
+   if ( vIsDataLoaded_B )
+      return 6;
+
+   uMemoryMappedFile lFile( vFilePath_str );
+   int lRet = lFile();
+   if ( lRet != 1 )
+      return lRet;
+
+   __header__ lHeader;
+   __header__ lExpected;
+   fillHeader( lExpected );
+
+   if ( lFile.size() < sizeof( __header__ ) ) {
+      wLOG( "Mesh cache file '", vFilePath_str, "' is too small" );
+      return 2;
+   }
+
+   memcpy( &lHeader, lFile.begin(), sizeof( __header__ ) );
+
+   if ( memcmp( lHeader.magic, lExpected.magic, sizeof( lHeader.magic ) ) != 0 ||
+        lHeader.byteOrder != lExpected.byteOrder ) {
+      wLOG( "'", vFilePath_str, "' is not a mesh cache file (or from a different platform)" );
+      return 2;
+   }
+
+   if ( lHeader.version != CACHE_VERSION ) {
+      iLOG( "Mesh cache file '", vFilePath_str, "' has an old version (", lHeader.version, ")" );
+      return 2;
+   }
+
+   if ( !vSourceHash.empty() &&
+        ( vSourceHash.size() != sizeof( lHeader.sourceHash ) ||
+          memcmp( lHeader.sourceHash, vSourceHash.data(), vSourceHash.size() ) != 0 ||
+          lHeader.sourceSize != vSourceSize ) ) {
+      wLOG( "Mesh cache file '", vFilePath_str, "' belongs to a different source file" );
+      return 2;
+   }
+
+   if ( lHeader.flags != vFlags ) {
+      iLOG( "Mesh cache file '", vFilePath_str, "' was written with other post processing" );
+      return 2;
+   }
+
+   if ( ( lHeader.flags & LODS ) &&
+        ( lHeader.lodRequest != vLODRequest || lHeader.lodReduction != vLODReduction ) ) {
+      iLOG( "Mesh cache file '", vFilePath_str, "' was written with other LOD settings" );
+      return 2;
+   }
+
+   // Check the sizes before multiplying them (overflow)
+   uint64_t lMaxElements = lFile.size() / 4;
+   if ( lHeader.numVertexData > lMaxElements || lHeader.numUVData > lMaxElements ||
+        lHeader.numNormalesData > lMaxElements || lHeader.numIndex > lMaxElements ||
+        lHeader.numLODs > lMaxElements || ( lHeader.numLODs > 0 && !( lHeader.flags & LODS ) ) ||
+        sizeof( __header__ ) +
+                     ( lHeader.numVertexData + lHeader.numUVData + lHeader.numNormalesData ) *
+                           sizeof( GLfloat ) +
+                     lHeader.numIndex * sizeof( GLuint ) + lHeader.numLODs * sizeof( uint64_t ) >
+              lFile.size() ) {
+      wLOG( "Mesh cache file '", vFilePath_str, "' is corrupt (size mismatch)" );
+      return 2;
+   }
+
+   uint64_t lSize = sizeof( __header__ ) +
+                    ( lHeader.numVertexData + lHeader.numUVData + lHeader.numNormalesData ) *
+                          sizeof( GLfloat ) +
+                    lHeader.numIndex * sizeof( GLuint );
+
+   std::vector<uint64_t> lLODSizes( static_cast<size_t>( lHeader.numLODs ) );
+   if ( !lLODSizes.empty() )
+      memcpy( lLODSizes.data(), lFile.begin() + lSize, lLODSizes.size() * sizeof( uint64_t ) );
+
+   lSize += lHeader.numLODs * sizeof( uint64_t );
+
+   for ( auto i : lLODSizes ) {
+      if ( i > ( lFile.size() - lSize ) / sizeof( GLuint ) ) {
+         lSize = 0;
+         break;
+      }
+
+      lSize += i * sizeof( GLuint );
+   }
+
+   if ( lSize != lFile.size() ) {
+      wLOG( "Mesh cache file '", vFilePath_str, "' is corrupt (size mismatch)" );
+      return 2;
+   }
+
+   char const *lIter = lFile.begin() + sizeof( __header__ );
+
+   vData.vVertexData.resize( static_cast<size_t>( lHeader.numVertexData ) );
+   vData.vUVData.resize( static_cast<size_t>( lHeader.numUVData ) );
+   vData.vNormalesData.resize( static_cast<size_t>( lHeader.numNormalesData ) );
+   vData.vIndex.resize( static_cast<size_t>( lHeader.numIndex ) );
+
+   if ( !vData.vVertexData.empty() )
+      memcpy( vData.vVertexData.data(), lIter, vData.vVertexData.size() * sizeof( GLfloat ) );
+   lIter += vData.vVertexData.size() * sizeof( GLfloat );
+
+   if ( !vData.vUVData.empty() )
+      memcpy( vData.vUVData.data(), lIter, vData.vUVData.size() * sizeof( GLfloat ) );
+   lIter += vData.vUVData.size() * sizeof( GLfloat );
+
+   if ( !vData.vNormalesData.empty() )
+      memcpy( vData.vNormalesData.data(), lIter, vData.vNormalesData.size() * sizeof( GLfloat ) );
+   lIter += vData.vNormalesData.size() * sizeof( GLfloat );
+
+   if ( !vData.vIndex.empty() )
+      memcpy( vData.vIndex.data(), lIter, vData.vIndex.size() * sizeof( GLuint ) );
+   lIter += vData.vIndex.size() * sizeof( GLuint ) + lLODSizes.size() * sizeof( uint64_t );
+
+   vLODs.resize( lLODSizes.size() );
+
+   for ( size_t i = 0; i < lLODSizes.size(); ++i ) {
+      vLODs[i].resize( static_cast<size_t>( lLODSizes[i] ) );
+
+      if ( !vLODs[i].empty() )
+         memcpy( vLODs[i].data(), lIter, vLODs[i].size() * sizeof( GLuint ) );
+      lIter += vLODs[i].size() * sizeof( GLuint );
+   }
+
+   // A broken index would let the GPU read out of bounds
+   GLuint lNumVertices = static_cast<GLuint>( vData.vVertexData.size() / 3 );
+   bool lIsValid = std::all_of( vData.vIndex.begin(),
+                                vData.vIndex.end(),
+                                [lNumVertices]( GLuint i ) { return i < lNumVertices; } );
+
+   for ( auto const &i : vLODs )
+      lIsValid = lIsValid && std::all_of( i.begin(), i.end(), [lNumVertices]( GLuint j ) {
+                    return j < lNumVertices;
+                 } );
+
+   if ( !lIsValid ) {
+      wLOG( "Mesh cache file '", vFilePath_str, "' is corrupt (index out of range)" );
+      vData.clear();
+      vLODs.clear();
+      return 2;
+   }
+
+   vIsDataLoaded_B = true;
+   return 1;
+}
+
+
+/*!
+ * \brief Calculates the SHA-256 hash of a (source) file
+ * \param[in]  _file The file to hash
+ * \param[out] _hash The hash
+ * \param[out] _size The size of the file
+ * \returns true on success
+ */
+bool rLoader_3D_f_CACHE::hashFile( std::string _file,
+                                   std::vector<unsigned char> &_hash,
+                                   uint64_t &_size ) {
+   uMemoryMappedFile lFile( _file );
+   if ( lFile() != 1 )
+      return false;
+
+   uSHA_2 lHash( SHA2_256 );
+   lHash.add( reinterpret_cast<unsigned char const *>( lFile.begin() ), lFile.size() );
+
+   _hash = lHash.end();
+   _size = lFile.size();
+   return true;
+}
+
+/*!
+ * \brief Returns the path of the cache file for a source file hash
+ * \returns the path or an empty string if there is no usable cache dir
+ * \sa uSystem::getMeshCachePath
+ */
+std::string rLoader_3D_f_CACHE::getCacheFilePath( std::vector<unsigned char> const &_hash ) {
+   std::string lDir = SYSTEM.getMeshCachePath();
+   std::string lName;
+
+   if ( lDir.empty() )
+      return "";
+
+   char lBuffer[3];
+
+   for ( auto i : _hash ) {
+      snprintf( lBuffer, 3, "%02x", static_cast<unsigned int>( i ) );
+      lName += lBuffer;
+   }
+
+#if UNIX
+   return lDir + "/" + lName + ".mesh";
+#elif WINDOWS
+   return lDir + "\\" + lName + ".mesh";
+#endif
+}
+
+/*!
+ * \brief Writes a (reindexed) mesh to a cache file
+ *
+ * The data is written to a temporary file first, which is then renamed. So other processes
+ * will never see a half written cache file.
+ *
+ * \param[in] _file       The cache file to write
+ * \param[in] _sourceHash SHA-256 hash of the source file
+ * \param[in] _sourceSize Size of the source file
+ * \param[in] _data       The reindexed data
+ * \param[in] _flags      The post processing steps applied to _data (FLAGS)
+ * \param[in] _lods        The LOD index buffers (only written with the LODS flag)
+ * \param[in] _lodRequest   GlobConf.loader.numLODs the LODs were generated with
+ * \param[in] _lodReduction GlobConf.loader.lodReduction the LODs were generated with
+ *
+ * \returns 1 on success
+ * \returns 2 if the hash has the wrong size
+ * \returns 3 if the file could not be written
+ */
+int rLoader_3D_f_CACHE::write( std::string _file,
+                               std::vector<unsigned char> const &_sourceHash,
+                               uint64_t _sourceSize,
+                               internal::_3D_Data<GLfloat, GLuint> const *_data,
+                               uint64_t _flags,
+                               std::vector<std::vector<GLuint>> const *_lods,
+                               uint32_t _lodRequest,
+                               float _lodReduction ) {
+   __header__ lHeader;
+   fillHeader( lHeader );
+
+   if ( _sourceHash.size() != sizeof( lHeader.sourceHash ) ) {
+      eLOG( "Invalid source hash for mesh cache file '", _file, "'" );
+      return 2;
+   }
+
+   memcpy( lHeader.sourceHash, _sourceHash.data(), _sourceHash.size() );
+   lHeader.sourceSize = _sourceSize;
+   lHeader.numVertexData = _data->vVertexData.size();
+   lHeader.numUVData = _data->vUVData.size();
+   lHeader.numNormalesData = _data->vNormalesData.size();
+   lHeader.numIndex = _data->vIndex.size();
+   lHeader.flags = _flags;
+
+   std::vector<uint64_t> lLODSizes;
+
+   if ( ( _flags & LODS ) && _lods ) {
+      lHeader.lodRequest = _lodRequest;
+      lHeader.lodReduction = _lodReduction;
+      lHeader.numLODs = _lods->size();
+
+      for ( auto const &i : *_lods )
+         lLODSizes.push_back( i.size() );
+   }
+
+   std::string lTempFile = _file + ".tmp";
+
+   {
+      std::ofstream lStream( lTempFile, std::ios::out | std::ios::binary | std::ios::trunc );
+
+      if ( !lStream.is_open() ) {
+         wLOG( "Unable to open mesh cache file '", lTempFile, "' for writing" );
+         return 3;
+      }
+
+      lStream.write( reinterpret_cast<char const *>( &lHeader ), sizeof( lHeader ) );
+      lStream.write(
+            reinterpret_cast<char const *>( _data->vVertexData.data() ),
+            static_cast<std::streamsize>( _data->vVertexData.size() * sizeof( GLfloat ) ) );
+      lStream.write( reinterpret_cast<char const *>( _data->vUVData.data() ),
+                     static_cast<std::streamsize>( _data->vUVData.size() * sizeof( GLfloat ) ) );
+      lStream.write(
+            reinterpret_cast<char const *>( _data->vNormalesData.data() ),
+            static_cast<std::streamsize>( _data->vNormalesData.size() * sizeof( GLfloat ) ) );
+      lStream.write( reinterpret_cast<char const *>( _data->vIndex.data() ),
+                     static_cast<std::streamsize>( _data->vIndex.size() * sizeof( GLuint ) ) );
+      lStream.write( reinterpret_cast<char const *>( lLODSizes.data() ),
+                     static_cast<std::streamsize>( lLODSizes.size() * sizeof( uint64_t ) ) );
+
+      for ( size_t i = 0; i < lLODSizes.size(); ++i )
+         lStream.write( reinterpret_cast<char const *>( ( *_lods )[i].data() ),
+                        static_cast<std::streamsize>( lLODSizes[i] * sizeof( GLuint ) ) );
+
+      if ( !lStream.good() ) {
+         wLOG( "Failed to write mesh cache file '", lTempFile, "'" );
+         lStream.close();
+         removeTempFile( lTempFile );
+         return 3;
+      }
+   }
+
+   try {
+      boost::filesystem::rename( lTempFile, _file );
+   } catch ( const boost::filesystem::filesystem_error &ex ) {
+      wLOG( "Failed to rename mesh cache file '", lTempFile, "': ", ex.what() );
+      removeTempFile( lTempFile );
+      return 3;
+   }
+
+   return 1;
+}
+}
+// kate: indent-mode cstyle; indent-width 3; replace-tabs on; line-numbers on;
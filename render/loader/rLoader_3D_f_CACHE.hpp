@@ -0,0 +1,129 @@
+/*!
+ * \file rLoader_3D_f_CACHE.hpp
+ * \brief \b Classes: \a rLoader_3D_f_CACHE
+ */
+/*
+ * Copyright (C) 2015 EEnginE project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef R_LOADER_3D_F_CACHE_HPP
+#define R_LOADER_3D_F_CACHE_HPP
+
+#include "defines.hpp"
+
+#include "rLoaderBase.hpp"
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include <GL/glew.h>
+
+namespace e_engine {
+
+/*!
+ * \brief Loads (and writes) the binary mesh cache
+ *
+ * A cache file contains the already reindexed data (_3D_Data) of a source file (e.g. an OBJ
+ * file). The name of the cache file is the SHA-256 hash of the source file, so a changed source
+ * file will never hit an old cache entry.
+ *
+ * File layout (native byte order):
+ * | Offset | Content                                     |
+ * |--------|---------------------------------------------|
+ * | 0      | __header__ (112 bytes)                      |
+ * | 112    | vertex data  (numVertexData   * GLfloat)    |
+ * | ...    | UV data      (numUVData       * GLfloat)    |
+ * | ...    | normal data  (numNormalesData * GLfloat)    |
+ * | ...    | index data   (numIndex        * GLuint)     |
+ * | ...    | LOD sizes    (numLODs         * uint64_t)   |
+ * | ...    | LOD indexes  (sum of LOD sizes * GLuint)    |
+ *
+ * All arrays are tightly packed, so they can be passed to glBufferData straight from the mapped
+ * file. The LOD section is only present with the LODS flag (see rLoaderBase::getLODs()).
+ *
+ * \note The data is already reindexed: do NOT call reindex() after load()
+ */
+class rLoader_3D_f_CACHE : public internal::rLoaderBase<GLfloat, GLuint> {
+ public:
+   //! Increase this every time the layout or the loader output changes
+   static const uint32_t CACHE_VERSION = 3;
+
+   //! Post processing steps applied to the cached data
+   enum FLAGS {
+      OPTIMIZED = ( 1 << 0 ),
+      GENERATED_NORMALS = ( 1 << 1 ), //!< Normals were generated for meshes without normals
+      ANGLE_WEIGHTED_NORMALS = ( 1 << 2 ),
+      LODS = ( 1 << 3 ) //!< The simplified LOD index buffers follow the index data
+   };
+
+ private:
+   struct __header__ {
+      char magic[8];      //!< "EEMESH\0\0"
+      uint32_t version;   //!< CACHE_VERSION
+      uint32_t byteOrder; //!< 0x01020304 in the byte order of the writer
+
+      unsigned char sourceHash[32]; //!< SHA-256 of the source file
+      uint64_t sourceSize;          //!< Size of the source file
+
+      uint64_t numVertexData;
+      uint64_t numUVData;
+      uint64_t numNormalesData;
+      uint64_t numIndex;
+
+      uint64_t flags; //!< FLAGS
+
+      uint32_t lodRequest; //!< GlobConf.loader.numLODs the LODs were generated with
+      float lodReduction;  //!< GlobConf.loader.lodReduction the LODs were generated with
+      uint64_t numLODs;    //!< LODs actually generated (the chain can end early)
+   };
+
+   static_assert( sizeof( __header__ ) == 112, "Unexpected header size / padding" );
+
+   std::vector<unsigned char> vSourceHash;
+   uint64_t vSourceSize = 0;
+   uint64_t vFlags = 0;
+   uint32_t vLODRequest = 0;
+   float vLODReduction = 0;
+
+   static void fillHeader( __header__ &_header );
+
+ public:
+   rLoader_3D_f_CACHE();
+   rLoader_3D_f_CACHE( std::string _file );
+   virtual ~rLoader_3D_f_CACHE() {}
+
+   void setExpectedSource( std::vector<unsigned char> const &_hash, uint64_t _size );
+   void setExpectedFlags( uint64_t _flags ) { vFlags = _flags; }
+   void setExpectedLODs( uint32_t _request, float _reduction );
+
+   int load();
+
+   static bool hashFile( std::string _file, std::vector<unsigned char> &_hash, uint64_t &_size );
+   static std::string getCacheFilePath( std::vector<unsigned char> const &_hash );
+
+   static int write( std::string _file,
+                     std::vector<unsigned char> const &_sourceHash,
+                     uint64_t _sourceSize,
+                     internal::_3D_Data<GLfloat, GLuint> const *_data,
+                     uint64_t _flags = 0,
+                     std::vector<std::vector<GLuint>> const *_lods = nullptr,
+                     uint32_t _lodRequest = 0,
+                     float _lodReduction = 0 );
+};
+}
+
+#endif // R_LOADER_3D_F_CACHE_HPP
+
+// kate: indent-mode cstyle; indent-width 3; replace-tabs on; line-numbers on;
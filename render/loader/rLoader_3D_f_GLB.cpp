@@ -0,0 +1,515 @@
+/*!
+ * \file rLoader_3D_f_GLB.cpp
+ * \brief \b Classes: \a rLoader_3D_f_GLB
+ */
+/*
+ * Copyright (C) 2015 EEnginE project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rLoader_3D_f_GLB.hpp"
+
+#include "uLog.hpp"
+#include "uMemoryMappedFile.hpp"
+#include "uParserJSON.hpp"
+#include "uConfig.hpp"
+#include "rNormalGenerator.hpp"
+
+#include <limits>
+#include <algorithm>
+#include <cmath>
+#include <string.h>
+
+namespace e_engine {
+
+rLoader_3D_f_GLB::rLoader_3D_f_GLB() : vBin( nullptr ), vBinSize( 0 ) { vIsDataLoaded_B = false; }
+
+rLoader_3D_f_GLB::rLoader_3D_f_GLB( std::string _file ) : vBin( nullptr ), vBinSize( 0 ) {
+   vIsDataLoaded_B = false;
+   vFilePath_str = _file;
+}
+
+namespace {
+
+uJSON_data const *getMember( uJSON_data const *_obj, std::string const &_id ) {
+   if ( !_obj || _obj->type != JSON_OBJECT )
+      return nullptr;
+
+   for ( auto const &i : _obj->value_obj )
+      if ( i.id == _id )
+         return &i;
+
+   return nullptr;
+}
+
+uJSON_data const *getElement( uJSON_data const *_array, size_t _index ) {
+   if ( !_array || _array->type != JSON_ARRAY || _index >= _array->value_obj.size() )
+      return nullptr;
+
+   return &_array->value_obj[_index];
+}
+
+/*!
+ * \brief Reads a non negative integer
+ * \returns false if _num is not a number or not a valid index / size
+ */
+bool getSize( uJSON_data const *_num, size_t &_out ) {
+   if ( !_num || _num->type != JSON_NUMBER || _num->value_num < 0 ||
+        _num->value_num > static_cast<double>( std::numeric_limits<uint32_t>::max() ) ||
+        std::floor( _num->value_num ) != _num->value_num )
+      return false;
+
+   _out = static_cast<size_t>( _num->value_num );
+   return true;
+}
+
+//! Same as getSize, but _out is _default when the (optional) member is missing
+bool getSize( uJSON_data const *_obj, std::string const &_id, size_t &_out, size_t _default ) {
+   uJSON_data const *lNum = getMember( _obj, _id );
+
+   if ( !lNum ) {
+      _out = _default;
+      return true;
+   }
+
+   return getSize( lNum, _out );
+}
+
+size_t getComponentSize( unsigned _type ) {
+   switch ( _type ) {
+      case rLoader_3D_f_GLB::UNSIGNED_BYTE:
+         return 1;
+      case rLoader_3D_f_GLB::UNSIGNED_SHORT:
+         return 2;
+      case rLoader_3D_f_GLB::UNSIGNED_INT:
+      case rLoader_3D_f_GLB::FLOAT:
+         return 4;
+      default:
+         return 0;
+   }
+}
+}
+
+
+/*!
+ * \brief Gets the view of an accessor in the BIN chunk
+ * \param[in]  _root  The root object of the JSON chunk
+ * \param[in]  _index The index of the accessor (JSON number)
+ * \param[out] _out   The accessor data
+ * \returns 1 on success
+ * \returns 2 if the accessor is invalid or not supported
+ */
+int rLoader_3D_f_GLB::getAccessor( uJSON_data const &_root,
+                                   uJSON_data const *_index,
+                                   __accessor__ &_out ) {
+   size_t lIndex, lViewIndex, lAccOffset, lViewOffset, lViewLength, lStride, lBuffer, lType;
+
+   if ( !getSize( _index, lIndex ) ) {
+      eLOG( "Failed parsing file '", vFilePath_str, "': invalid accessor index" );
+      return 2;
+   }
+
+   uJSON_data const *lAcc = getElement( getMember( &_root, "accessors" ), lIndex );
+
+   if ( !lAcc || !getSize( getMember( lAcc, "bufferView" ), lViewIndex ) ||
+        !getSize( getMember( lAcc, "count" ), _out.count ) ||
+        !getSize( getMember( lAcc, "componentType" ), lType ) ||
+        !getSize( lAcc, "byteOffset", lAccOffset, 0 ) ) {
+      eLOG( "Failed parsing file '", vFilePath_str, "': invalid accessor ", lIndex );
+      return 2;
+   }
+
+   if ( getMember( lAcc, "sparse" ) ) {
+      eLOG( "Failed parsing file '", vFilePath_str, "': sparse accessors are not supported" );
+      return 2;
+   }
+
+   uJSON_data const *lTypeName = getMember( lAcc, "type" );
+   uJSON_data const *lNormalized = getMember( lAcc, "normalized" );
+
+   _out.type = static_cast<unsigned>( lType );
+   _out.normalized = lNormalized && lNormalized->type == JSON_BOOL && lNormalized->value_bool;
+   _out.components = 0;
+
+   if ( lTypeName && lTypeName->type == JSON_STRING ) {
+      if ( lTypeName->value_str == "SCALAR" )
+         _out.components = 1;
+      else if ( lTypeName->value_str == "VEC2" )
+         _out.components = 2;
+      else if ( lTypeName->value_str == "VEC3" )
+         _out.components = 3;
+   }
+
+   size_t lElementSize = getComponentSize( _out.type ) * _out.components;
+
+   if ( lElementSize == 0 ) {
+      eLOG( "Failed parsing file '", vFilePath_str, "': unsupported accessor type ", lIndex );
+      return 2;
+   }
+
+   uJSON_data const *lView = getElement( getMember( &_root, "bufferViews" ), lViewIndex );
+
+   if ( !lView || !getSize( getMember( lView, "byteLength" ), lViewLength ) ||
+        !getSize( lView, "byteOffset", lViewOffset, 0 ) ||
+        !getSize( lView, "byteStride", lStride, lElementSize ) ||
+        !getSize( lView, "buffer", lBuffer, 0 ) ) {
+      eLOG( "Failed parsing file '", vFilePath_str, "': invalid buffer view ", lViewIndex );
+      return 2;
+   }
+
+   if ( lBuffer != 0 || !vBin ) {
+      eLOG( "Failed parsing file '", vFilePath_str, "': only the BIN chunk buffer is supported" );
+      return 2;
+   }
+
+   // Everything must be inside the view and the view inside the BIN chunk
+   if ( _out.count == 0 || lStride < lElementSize || lViewOffset > vBinSize ||
+        lViewLength > vBinSize - lViewOffset || lAccOffset > lViewLength ||
+        lViewLength - lAccOffset < lElementSize ||
+        ( lViewLength - lAccOffset - lElementSize ) / lStride < _out.count - 1 ) {
+      eLOG( "Failed parsing file '", vFilePath_str, "': accessor ", lIndex, " out of range" );
+      return 2;
+   }
+
+   _out.data = vBin + lViewOffset + lAccOffset;
+   _out.stride = lStride;
+   return 1;
+}
+
+
+/*!
+ * \brief Appends the data of a float (or normalized unsigned) accessor to _out
+ * \returns false if the component type is not supported
+ */
+bool rLoader_3D_f_GLB::readFloats( __accessor__ const &_acc, std::vector<GLfloat> &_out ) {
+   size_t lStart = _out.size();
+   size_t lElementSize = getComponentSize( _acc.type ) * _acc.components;
+
+   if ( _acc.type != FLOAT && !_acc.normalized )
+      return false;
+
+   _out.resize( lStart + _acc.count * _acc.components );
+   GLfloat *lOut = _out.data() + lStart;
+
+   // Already in the engine layout
+   if ( _acc.type == FLOAT && _acc.stride == lElementSize && internal::isLittleEndianHost() ) {
+      memcpy( lOut, _acc.data, _acc.count * lElementSize );
+      return true;
+   }
+
+   char const *lIter = _acc.data;
+
+   for ( size_t i = 0; i < _acc.count; ++i, lIter += _acc.stride ) {
+      for ( size_t j = 0; j < _acc.components; ++j ) {
+         switch ( _acc.type ) {
+            case FLOAT:
+               *lOut++ = internal::readLittleEndian<GLfloat>( lIter + j * 4 );
+               break;
+            case UNSIGNED_BYTE:
+               *lOut++ = static_cast<GLfloat>( static_cast<unsigned char>( lIter[j] ) ) / 255.0f;
+               break;
+            case UNSIGNED_SHORT:
+               *lOut++ = internal::readLittleEndian<uint16_t>( lIter + j * 2 ) / 65535.0f;
+               break;
+            default:
+               return false;
+         }
+      }
+   }
+
+   return true;
+}
+
+/*!
+ * \brief Appends the indexes of an accessor (+ _offset) to _out
+ * \returns false if an index is out of range or the component type is not supported
+ */
+bool rLoader_3D_f_GLB::readIndices( __accessor__ const &_acc,
+                                    size_t _numVertices,
+                                    GLuint _offset,
+                                    std::vector<GLuint> &_out ) {
+   if ( _acc.components != 1 || _acc.type == FLOAT )
+      return false;
+
+   size_t lStart = _out.size();
+   _out.resize( lStart + _acc.count );
+   GLuint *lOut = _out.data() + lStart;
+   GLuint lMax = 0;
+
+   if ( _acc.type == UNSIGNED_INT && _acc.stride == 4 && internal::isLittleEndianHost() ) {
+      memcpy( lOut, _acc.data, _acc.count * 4 );
+
+      for ( size_t i = 0; i < _acc.count; ++i )
+         lMax = std::max( lMax, lOut[i] );
+   } else {
+      char const *lIter = _acc.data;
+
+      for ( size_t i = 0; i < _acc.count; ++i, lIter += _acc.stride ) {
+         switch ( _acc.type ) {
+            case UNSIGNED_BYTE:
+               lOut[i] = static_cast<unsigned char>( *lIter );
+               break;
+            case UNSIGNED_SHORT:
+               lOut[i] = internal::readLittleEndian<uint16_t>( lIter );
+               break;
+            default:
+               lOut[i] = internal::readLittleEndian<uint32_t>( lIter );
+               break;
+         }
+
+         lMax = std::max( lMax, lOut[i] );
+      }
+   }
+
+   if ( lMax >= _numVertices )
+      return false;
+
+   if ( _offset != 0 )
+      for ( size_t i = 0; i < _acc.count; ++i )
+         lOut[i] += _offset;
+
+   return true;
+}
+
+
+/*!
+ * \brief Appends one triangle primitive to vData
+ * \param[in] _root      The root object of the JSON chunk
+ * \param[in] _primitive The primitive object
+ * \param[in] _normals   Read the normals (generated if the primitive has none)
+ * \param[in] _uv        Read the UV coordinates (filled with 0 if the primitive has none)
+ * \returns 1 on success
+ * \returns 2 if there was a parsing error
+ */
+int rLoader_3D_f_GLB::readPrimitive( uJSON_data const &_root,
+                                     uJSON_data const &_primitive,
+                                     bool _normals,
+                                     bool _uv ) {
+   uJSON_data const *lAttributes = getMember( &_primitive, "attributes" );
+   uJSON_data const *lIndices = getMember( &_primitive, "indices" );
+   uJSON_data const *lNormalIndex = getMember( lAttributes, "NORMAL" );
+   uJSON_data const *lUVIndex = getMember( lAttributes, "TEXCOORD_0" );
+
+   __accessor__ lPos, lNormals, lUV, lIndex;
+   size_t lOffset = vData.vVertexData.size() / 3;
+
+   if ( getAccessor( _root, getMember( lAttributes, "POSITION" ), lPos ) != 1 )
+      return 2;
+
+   if ( lPos.components != 3 || lPos.type != FLOAT || !readFloats( lPos, vData.vVertexData ) ) {
+      eLOG( "Failed parsing file '", vFilePath_str, "': POSITION must be a float VEC3" );
+      return 2;
+   }
+
+   if ( _normals && lNormalIndex ) {
+      if ( getAccessor( _root, lNormalIndex, lNormals ) != 1 )
+         return 2;
+
+      if ( lNormals.components != 3 || lNormals.type != FLOAT || lNormals.count != lPos.count ||
+           !readFloats( lNormals, vData.vNormalesData ) ) {
+         eLOG( "Failed parsing file '", vFilePath_str, "': invalid NORMAL attribute" );
+         return 2;
+      }
+   } else if ( _normals ) {
+      // Calculated from the triangles below
+      vData.vNormalesData.resize( vData.vVertexData.size(), 0.0f );
+   }
+
+   if ( _uv && lUVIndex ) {
+      if ( getAccessor( _root, lUVIndex, lUV ) != 1 )
+         return 2;
+
+      if ( lUV.components != 2 || lUV.count != lPos.count || !readFloats( lUV, vData.vUVData ) ) {
+         eLOG( "Failed parsing file '", vFilePath_str, "': invalid TEXCOORD_0 attribute" );
+         return 2;
+      }
+   } else if ( _uv ) {
+      vData.vUVData.resize( vData.vVertexData.size() / 3 * 2, 0.0f );
+   }
+
+   size_t lStart = vData.vIndex.size();
+
+   if ( !lIndices ) {
+      // Not indexed: every 3 vertices are one triangle
+      vData.vIndex.resize( lStart + lPos.count - lPos.count % 3 );
+
+      for ( size_t i = lStart; i < vData.vIndex.size(); ++i )
+         vData.vIndex[i] = static_cast<GLuint>( lOffset + i - lStart );
+   } else {
+      if ( getAccessor( _root, lIndices, lIndex ) != 1 )
+         return 2;
+
+      if ( lIndex.count % 3 != 0 ||
+           !readIndices( lIndex, lPos.count, static_cast<GLuint>( lOffset ), vData.vIndex ) ) {
+         eLOG( "Failed parsing file '", vFilePath_str, "': invalid indices" );
+         return 2;
+      }
+   }
+
+   if ( _normals && !lNormalIndex )
+      generateNormals( lOffset, lStart );
+
+   return 1;
+}
+
+/*!
+ * \brief Calculates the normals of the vertices and triangles of the last primitive
+ *
+ * rObjectBase only generates normals for meshes without any, so the normals of primitives
+ * without NORMAL attribute (in a file where others have one) are calculated here.
+ *
+ * \param[in] _firstVertex The first vertex of the primitive
+ * \param[in] _firstIndex  The first index of the primitive
+ */
+void rLoader_3D_f_GLB::generateNormals( size_t _firstVertex, size_t _firstIndex ) {
+   std::vector<GLuint> lIndex( vData.vIndex.begin() + _firstIndex, vData.vIndex.end() );
+
+   for ( auto &i : lIndex )
+      i -= static_cast<GLuint>( _firstVertex );
+
+   internal::calculateNormals( vData.vVertexData.data() + _firstVertex * 3,
+                               vData.vVertexData.size() / 3 - _firstVertex,
+                               lIndex.data(),
+                               lIndex.size(),
+                               vData.vNormalesData.data() + _firstVertex * 3,
+                               GlobConf.loader.angleWeightedNormals ? internal::ANGLE_WEIGHTED
+                                                                    : internal::AREA_WEIGHTED );
+}
+
+
+/*!
+ * \brief loads the 3D content frome the binary glTF file
+ *
+ * \returns 1 on success
+ * \returns 2 if there was a parsing error
+ * \returns 3 if the GLB file doesn't exists
+ * \returns 4 if the GLB file is not a regular file
+ * \returns 5 if the GLB file is not readable
+ * \returns 6 if already loaded
+ */
+int rLoader_3D_f_GLB::load() {
+   if ( vIsDataLoaded_B )
+      return 6;
+
+   uMemoryMappedFile lFile( vFilePath_str );
+   int lRet = lFile();
+   if ( lRet != 1 )
+      return lRet;
+
+   char const *lData = lFile.begin();
+   size_t lSize = lFile.size();
+
+   if ( lSize < 20 || internal::readLittleEndian<uint32_t>( lData ) != MAGIC ) {
+      eLOG( "Failed parsing file '", vFilePath_str, "': not a binary glTF file" );
+      return 2;
+   }
+
+   if ( internal::readLittleEndian<uint32_t>( lData + 4 ) != 2 ) {
+      eLOG( "Failed parsing file '", vFilePath_str, "': only glTF version 2 is supported" );
+      return 2;
+   }
+
+   // Trailing data after the GLB is ignored
+   size_t lLength = internal::readLittleEndian<uint32_t>( lData + 8 );
+
+   if ( lLength < 20 || lLength > lSize ) {
+      eLOG( "Failed parsing file '", vFilePath_str, "': invalid file length ", lLength );
+      return 2;
+   }
+
+   lSize = lLength;
+   size_t lJSONSize = internal::readLittleEndian<uint32_t>( lData + 12 );
+
+   if ( internal::readLittleEndian<uint32_t>( lData + 16 ) != CHUNK_JSON ||
+        lJSONSize > lSize - 20 ) {
+      eLOG( "Failed parsing file '", vFilePath_str, "': invalid JSON chunk" );
+      return 2;
+   }
+
+   vBin = nullptr;
+   vBinSize = 0;
+
+   // The BIN chunk is optional
+   size_t lBinStart = 20 + lJSONSize;
+
+   if ( lBinStart + 8 <= lSize &&
+        internal::readLittleEndian<uint32_t>( lData + lBinStart + 4 ) == CHUNK_BIN ) {
+      vBinSize = internal::readLittleEndian<uint32_t>( lData + lBinStart );
+      vBin = lData + lBinStart + 8;
+
+      if ( vBinSize > lSize - lBinStart - 8 ) {
+         eLOG( "Failed parsing file '", vFilePath_str, "': invalid BIN chunk" );
+         return 2;
+      }
+   }
+
+   uParserJSON lParser( vFilePath_str );
+   if ( lParser.parseString( std::string( lData + 20, lJSONSize ) ) != 1 )
+      return 2;
+
+   uJSON_data const &lRoot = *lParser.getDataP();
+
+   // Collect the triangle primitives of all meshes
+   std::vector<uJSON_data const *> lPrimitives;
+   bool lNormals = false;
+   bool lUV = false;
+
+   uJSON_data const *lMeshes = getMember( &lRoot, "meshes" );
+   for ( size_t i = 0; getElement( lMeshes, i ); ++i ) {
+      uJSON_data const *lMeshPrimitives = getMember( getElement( lMeshes, i ), "primitives" );
+
+      for ( size_t j = 0; getElement( lMeshPrimitives, j ); ++j ) {
+         uJSON_data const *lPrimitive = getElement( lMeshPrimitives, j );
+         uJSON_data const *lAttributes = getMember( lPrimitive, "attributes" );
+         size_t lMode;
+
+         if ( !getSize( lPrimitive, "mode", lMode, 4 ) || lMode != 4 ) {
+            wLOG( "Skipping primitive ", j, " of mesh ", i, " in '", vFilePath_str, "' (mode)" );
+            continue;
+         }
+
+         // Primitives without UV coordinates get zeros, normals are calculated
+         lNormals = lNormals || getMember( lAttributes, "NORMAL" );
+         lUV = lUV || getMember( lAttributes, "TEXCOORD_0" );
+         lPrimitives.emplace_back( lPrimitive );
+      }
+   }
+
+   if ( lPrimitives.empty() ) {
+      eLOG( "Failed parsing file '", vFilePath_str, "': no triangle meshes" );
+      return 2;
+   }
+
+   for ( auto i : lPrimitives ) {
+      if ( readPrimitive( lRoot, *i, lNormals, lUV ) != 1 ) {
+         vData.clear();
+         return 2;
+      }
+   }
+
+   if ( vData.vIndex.empty() ) {
+      eLOG( "Failed parsing file '", vFilePath_str, "': no triangles" );
+      vData.clear();
+      return 2;
+   }
+
+   vBin = nullptr; // The file is unmapped now
+   vBinSize = 0;
+
+   vIsDataLoaded_B = true;
+   return 1;
+}
+}
+
+// kate: indent-mode cstyle; indent-width 3; replace-tabs on; line-numbers on;
@@ -0,0 +1,110 @@
+/*!
+ * \file rLoader_3D_f_GLB.hpp
+ * \brief \b Classes: \a rLoader_3D_f_GLB
+ */
+/*
+ * Copyright (C) 2015 EEnginE project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef R_LOADER_3D_F_GLB_HPP
+#define R_LOADER_3D_F_GLB_HPP
+
+#include "defines.hpp"
+
+#include "rLoaderBase.hpp"
+#include <string>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <GL/glew.h>
+
+namespace e_engine {
+
+struct uJSON_data;
+
+/*!
+ * \brief Loads binary glTF 2.0 files (.glb)
+ *
+ * File layout (little endian):
+ * | Offset | Content                                                 |
+ * |--------|---------------------------------------------------------|
+ * | 0      | magic "glTF", version (2), file length (uint32 each)    |
+ * | 12     | JSON chunk (length, type "JSON", data)                  |
+ * | 20 + n | BIN chunk (length, type "BIN\0", data; optional)        |
+ *
+ * The JSON chunk is parsed with uParserJSON. The triangle primitives of all meshes are merged into
+ * one mesh. The attributes POSITION, NORMAL (both float VEC3) and TEXCOORD_0 (float or normalized
+ * unsigned VEC2) and the indices are read straight from the memory mapped BIN chunk; tightly
+ * packed float data and 32 bit indices are copied in bulk. glTF is already indexed per vertex, so
+ * the data is written to the final (reindexed) buffers directly. If only some primitives have
+ * normals, the normals of the others are calculated with internal::calculateNormals.
+ *
+ * \note Node transformations, external buffers (uri), sparse accessors and materials are ignored
+ *       or NOT supported
+ * \note reindex() does nothing after load(); it is safe to call it anyway
+ */
+class rLoader_3D_f_GLB : public internal::rLoaderBase<GLfloat, GLuint> {
+ public:
+   static const uint32_t MAGIC = 0x46546C67;      //!< "glTF"
+   static const uint32_t CHUNK_JSON = 0x4E4F534A; //!< "JSON"
+   static const uint32_t CHUNK_BIN = 0x004E4942;  //!< "BIN\0"
+
+   enum COMPONENT_TYPE {
+      UNSIGNED_BYTE = 5121,
+      UNSIGNED_SHORT = 5123,
+      UNSIGNED_INT = 5125,
+      FLOAT = 5126
+   };
+
+ private:
+   //! View of the data of an accessor in the BIN chunk
+   struct __accessor__ {
+      char const *data = nullptr;
+      size_t count = 0;
+      size_t stride = 0;        //!< Distance between two elements in bytes
+      unsigned type = 0;        //!< The component type (COMPONENT_TYPE)
+      unsigned components = 0;  //!< Number of components (SCALAR: 1, VEC2: 2, VEC3: 3)
+      bool normalized = false;
+   };
+
+   char const *vBin;
+   size_t vBinSize;
+
+   int getAccessor( uJSON_data const &_root, uJSON_data const *_index, __accessor__ &_out );
+   int readPrimitive( uJSON_data const &_root,
+                      uJSON_data const &_primitive,
+                      bool _normals,
+                      bool _uv );
+   void generateNormals( size_t _firstVertex, size_t _firstIndex );
+
+   static bool readFloats( __accessor__ const &_acc, std::vector<GLfloat> &_out );
+   static bool readIndices( __accessor__ const &_acc,
+                            size_t _numVertices,
+                            GLuint _offset,
+                            std::vector<GLuint> &_out );
+
+ public:
+   rLoader_3D_f_GLB();
+   rLoader_3D_f_GLB( std::string _file );
+   virtual ~rLoader_3D_f_GLB() {}
+
+   int load();
+};
+}
+
+#endif // R_LOADER_3D_F_GLB_HPP
+
+// kate: indent-mode cstyle; indent-width 3; replace-tabs on; line-numbers on;
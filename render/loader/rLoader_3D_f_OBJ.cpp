@@ -22,6 +22,17 @@
 
 #include "uLog.hpp"
 #include "uFileIO.hpp"
+#include "uMemoryMappedFile.hpp"
+
+#include <algorithm>
+#include <thread>
+#include <cmath>
+#include <limits>
+#include <clocale>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
 
 namespace e_engine {
 
@@ -32,8 +43,154 @@ rLoader_3D_f_OBJ::rLoader_3D_f_OBJ( std::string _file ) {
    vFilePath_str = _file;
 }
 
+namespace {
+
+// Exact powers of 10 (every value up to 1e22 is exactly representable as a double)
+const double gPow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                         1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+// Every integer up to 2^53 is exactly representable as a double
+const uint64_t gMaxExactMantissa = 9007199254740992ULL;
+
+// Stop collecting mantissa digits here (19 digits always fit into an uint64_t)
+const uint64_t gMaxMantissa = 1000000000000000000ULL;
+
+/*!
+ * \brief Slow but exact path for the few numbers the fast path can not handle
+ *
+ * Replaces the '.' with the decimal point of the current locale, so the result is the same
+ * for every locale.
+ */
+bool parseFloatSlow( char const *_begin, char const *_end, float &_num ) {
+   char lBuffer[128];
+   size_t lSize = static_cast<size_t>( _end - _begin );
+
+   if ( lSize >= sizeof( lBuffer ) )
+      lSize = sizeof( lBuffer ) - 1; // No float needs that many chars
+
+   char lDecimalPoint = *localeconv()->decimal_point;
+
+   for ( size_t i = 0; i < lSize; ++i )
+      lBuffer[i] = _begin[i] == '.' ? lDecimalPoint : _begin[i];
+
+   lBuffer[lSize] = '\0';
+
+   char *lEnd;
+   errno = 0;
+   float lResult = strtof( lBuffer, &lEnd );
+
+   if ( lEnd == lBuffer || errno == ERANGE )
+      return false;
+
+   _num = lResult;
+   return true;
+}
+
+/*!
+ * \brief Locale free and allocation free float parser
+ *
+ * Parses the longest valid number prefix of [_begin, _end) (like std::stof) in the format
+ * [-]digits[.digits][e[-|+]digits]
+ *
+ * If the mantissa and the power of 10 are exact doubles, the double result of the division /
+ * multiplication is correctly rounded. Rounding that to float is correct too unless the double
+ * lies exactly between two floats. Everything else goes through parseFloatSlow().
+ *
+ * \returns false if there is no number or if it is out of the float range
+ */
+bool parseFloat( char const *_begin, char const *_end, float &_num ) {
+   char const *lIter = _begin;
+   bool lNegative = false;
+   bool lHasDigits = false;
+   bool lTruncated = false;
+   uint64_t lMantissa = 0;
+   int lExponent = 0;
+
+   if ( lIter != _end && *lIter == '-' ) {
+      lNegative = true;
+      ++lIter;
+   }
+
+   for ( ; lIter != _end && *lIter >= '0' && *lIter <= '9'; ++lIter ) {
+      lHasDigits = true;
+      if ( lMantissa < gMaxMantissa ) {
+         lMantissa = lMantissa * 10 + static_cast<uint64_t>( *lIter - '0' );
+      } else {
+         ++lExponent;
+         lTruncated = true;
+      }
+   }
+
+   if ( lIter != _end && *lIter == '.' ) {
+      for ( ++lIter; lIter != _end && *lIter >= '0' && *lIter <= '9'; ++lIter ) {
+         lHasDigits = true;
+         if ( lMantissa < gMaxMantissa ) {
+            lMantissa = lMantissa * 10 + static_cast<uint64_t>( *lIter - '0' );
+            --lExponent;
+         } else {
+            lTruncated = true;
+         }
+      }
+   }
+
+   if ( !lHasDigits )
+      return false;
+
+   // An incomplete exponent ("1e", "1e-") is ignored, just like std::stof does
+   if ( lIter != _end && ( *lIter == 'e' || *lIter == 'E' ) ) {
+      char const *lExpIter = lIter + 1;
+      bool lExpNegative = false;
+      int lExpValue = 0;
+
+      if ( lExpIter != _end && ( *lExpIter == '-' || *lExpIter == '+' ) ) {
+         lExpNegative = *lExpIter == '-';
+         ++lExpIter;
+      }
+
+      if ( lExpIter != _end && *lExpIter >= '0' && *lExpIter <= '9' ) {
+         for ( ; lExpIter != _end && *lExpIter >= '0' && *lExpIter <= '9'; ++lExpIter )
+            if ( lExpValue < 10000 )
+               lExpValue = lExpValue * 10 + ( *lExpIter - '0' );
+
+         lExponent += lExpNegative ? -lExpValue : lExpValue;
+         lIter = lExpIter;
+      }
+   }
+
+   if ( lMantissa == 0 && !lTruncated ) {
+      _num = lNegative ? -0.0f : 0.0f;
+      return true;
+   }
+
+   if ( lTruncated || lMantissa > gMaxExactMantissa || lExponent < -22 || lExponent > 22 )
+      return parseFloatSlow( _begin, lIter, _num );
+
+   double lValue = static_cast<double>( lMantissa );
+
+   if ( lExponent < 0 )
+      lValue /= gPow10[-lExponent];
+   else
+      lValue *= gPow10[lExponent];
+
+   // Denormal floats have less precision; a double exactly between two floats is ambiguous
+   uint64_t lBits;
+   memcpy( &lBits, &lValue, sizeof( lBits ) );
+   if ( lValue < static_cast<double>( std::numeric_limits<float>::min() ) ||
+        ( lBits & 0x1FFFFFFFULL ) == 0x10000000ULL )
+      return parseFloatSlow( _begin, lIter, _num );
+
+   float lResult = static_cast<float>( lNegative ? -lValue : lValue );
+
+   if ( std::isinf( lResult ) )
+      return false;
+
+   _num = lResult;
+   return true;
+}
+}
+
 bool rLoader_3D_f_OBJ::getNum( float &_num ) {
-   std::string lNum;
+   char const *lStart = vIter;
 
    while ( vIter != vEnd ) {
       switch ( *vIter ) {
@@ -50,24 +207,11 @@ bool rLoader_3D_f_OBJ::getNum( float &_num ) {
          case '7':
          case '8':
          case '9':
-            lNum += *vIter;
             ++vIter;
             break;
 
          default:
-            if ( lNum.empty() ) {
-               eLOG( "Failed parsing file '",
-                     vFilePath_str,
-                     "' at char '",
-                     *vIter,
-                     "' Line ",
-                     vCurrentLine,
-                     ": not a number" );
-               return false;
-            }
-            try {
-               _num = std::stof( lNum );
-            } catch ( ... ) {
+            if ( lStart == vIter || !parseFloat( lStart, vIter, _num ) ) {
                eLOG( "Failed parsing file '",
                      vFilePath_str,
                      "' at char '",
@@ -87,47 +231,53 @@ bool rLoader_3D_f_OBJ::getNum( float &_num ) {
 }
 
 bool rLoader_3D_f_OBJ::getInt( unsigned int &_num ) {
-   std::string lNum;
+   uint64_t lNum = 0;
+   char const *lStart = vIter;
+
+   while ( vIter != vEnd && *vIter >= '0' && *vIter <= '9' ) {
+      lNum = lNum * 10 + static_cast<uint64_t>( *vIter - '0' );
+
+      if ( lNum > std::numeric_limits<unsigned int>::max() ) {
+         eLOG( "Failed parsing file '",
+               vFilePath_str,
+               "' at char '",
+               *vIter,
+               "' Line ",
+               vCurrentLine,
+               ": index out of range" );
+         return false;
+      }
 
-   while ( vIter != vEnd ) {
-      switch ( *vIter ) {
-         case '0':
-         case '1':
-         case '2':
-         case '3':
-         case '4':
-         case '5':
-         case '6':
-         case '7':
-         case '8':
-         case '9':
-            lNum += *vIter;
-            ++vIter;
-            break;
+      ++vIter;
+   }
 
-         default:
-            if ( lNum.empty() ) {
-               eLOG( "Failed parsing file '",
-                     vFilePath_str,
-                     "' at char '",
-                     *vIter,
-                     "' Line ",
-                     vCurrentLine,
-                     ": not a number" );
-               return false;
-            }
-            _num = static_cast<unsigned>( std::stoi( lNum ) );
-            return true;
-      }
+   if ( vIter == vEnd ) {
+      eLOG( "Failed parsing file '", vFilePath_str, "': unexpected end of file" );
+      return false;
    }
 
-   eLOG( "Failed parsing file '", vFilePath_str, "': unexpected end of file" );
-   return false;
+   if ( lStart == vIter ) {
+      eLOG( "Failed parsing file '",
+            vFilePath_str,
+            "' at char '",
+            *vIter,
+            "' Line ",
+            vCurrentLine,
+            ": not a number" );
+      return false;
+   }
+
+   _num = static_cast<unsigned int>( lNum );
+   return true;
 }
 
 
 /*!
  * \brief loads the 3D content frome the OBJ file
+ *
+ * Depending on the load mode (see setLoadMode()) the file is either memory mapped and parsed
+ * in place (default) or copied into RAM first.
+ *
  * \returns 1 on success
  * \returns 2 if there was a parsing error
  * \returns 3 if the OBJ file doesn't exists
@@ -139,14 +289,235 @@ int rLoader_3D_f_OBJ::load() {
    if ( vIsDataLoaded_B )
       return 6;
 
-   uFileIO lFile( vFilePath_str );
-   int lRet = lFile();
+   int lRet;
+
+   if ( vLoadMode == MEMORY_MAPPED ) {
+      uMemoryMappedFile lFile( vFilePath_str );
+      lRet = lFile();
+      if ( lRet != 1 )
+         return lRet;
+
+      vIter = lFile.begin();
+      vEnd = lFile.end();
+
+      lRet = getIsStreaming() ? parseStreaming() : parse();
+   } else {
+      uFileIO lFile( vFilePath_str );
+      lRet = lFile();
+      if ( lRet != 1 )
+         return lRet;
+
+      size_t lSize = static_cast<size_t>( lFile.end() - lFile.begin() );
+      vIter = lSize == 0 ? nullptr : &*lFile.begin();
+      vEnd = vIter + lSize;
+
+      lRet = getIsStreaming() ? parseStreaming() : parse();
+   }
+
    if ( lRet != 1 )
       return lRet;
 
-   vIter = lFile.begin();
-   vEnd = lFile.end();
+   vIsDataLoaded_B = true;
+   return 1;
+}
+
+/*!
+ * \brief Parses the range vIter - vEnd (multithreaded if it is big enough)
+ * \returns the same as load()
+ */
+int rLoader_3D_f_OBJ::parse() {
+   unsigned int lNumThreads = vNumThreads;
+
+   if ( lNumThreads == 0 )
+      lNumThreads = std::thread::hardware_concurrency();
+
+   size_t lMaxThreads = static_cast<size_t>( vEnd - vIter ) / MIN_CHUNK_SIZE;
+
+   if ( lNumThreads > lMaxThreads )
+      lNumThreads = static_cast<unsigned int>( lMaxThreads );
+
+   if ( lNumThreads <= 1 )
+      return parseChunk();
+
+   return parseParallel( lNumThreads );
+}
+
+/*!
+ * \brief Parses the range vIter - vEnd in growing parts and emits the finished triangles
+ *
+ * Used when a batch callback is set. Every part ends at a line boundary and is parsed with
+ * parse() (so big parts are still parsed in parallel); emitBatch() is called after each of them.
+ * The parts start small, so the first triangles are available early, and double in size up to
+ * MAX_STREAM_SLICE_SIZE to keep the overhead low.
+ *
+ * \returns the same as load()
+ */
+int rLoader_3D_f_OBJ::parseStreaming() {
+   char const *lEnd = vEnd;
+   size_t lSliceSize = STREAM_SLICE_SIZE;
+   int lRet = 1;
+
+   while ( vIter != lEnd ) {
+      vEnd = lEnd;
+
+      if ( static_cast<size_t>( lEnd - vIter ) > lSliceSize ) {
+         vEnd = vIter + lSliceSize;
+
+         while ( vEnd != lEnd && *vEnd != '\n' )
+            ++vEnd;
+
+         if ( vEnd != lEnd )
+            ++vEnd;
+      }
+
+      lRet = parse();
+      if ( lRet != 1 )
+         break;
+
+      emitBatch();
+
+      if ( lSliceSize < MAX_STREAM_SLICE_SIZE )
+         lSliceSize *= 2;
+   }
+
+   vEnd = lEnd;
+   return lRet;
+}
+
+/*!
+ * \brief Splits vIter - vEnd at line boundaries and parses every chunk in its own thread
+ *
+ * Every worker fills its own raw data. The results are then appended in file order, so the
+ * result is exactly the same as the one of parseChunk(). OBJ indices are absolute (the same
+ * for every line of the file), so they do not need to be rebased.
+ *
+ * On an error the chunks up to (and including) the first failed chunk are kept, just like
+ * the single threaded parser would do.
+ *
+ * \returns the same as load()
+ */
+int rLoader_3D_f_OBJ::parseParallel( unsigned int _numThreads ) {
+   std::vector<rLoader_3D_f_OBJ> lWorkers( _numThreads );
+   std::vector<std::thread> lThreads;
+   std::vector<int> lResults( _numThreads, 1 );
+
+   size_t lSize = static_cast<size_t>( vEnd - vIter );
+   char const *lChunkBegin = vIter;
+
+   for ( unsigned int i = 0; i < _numThreads; ++i ) {
+      char const *lChunkEnd = vEnd;
+
+      if ( i + 1 < _numThreads ) {
+         lChunkEnd = vIter + ( lSize / _numThreads ) * ( i + 1 );
+
+         if ( lChunkEnd < lChunkBegin )
+            lChunkEnd = lChunkBegin;
+
+         while ( lChunkEnd != vEnd && *lChunkEnd != '\n' )
+            ++lChunkEnd;
+
+         if ( lChunkEnd != vEnd )
+            ++lChunkEnd; // The chunk ends after the newline
+      }
+
+      lWorkers[i].vFilePath_str = vFilePath_str;
+      lWorkers[i].vIter = lChunkBegin;
+      lWorkers[i].vEnd = lChunkEnd;
+      lWorkers[i].vCurrentLine = 0; // Temporary: the number of lines in the chunk
+
+      lChunkBegin = lChunkEnd;
+   }
+
+   // Count the lines first, so that error messages have the correct line number
+   for ( unsigned int i = 0; i < _numThreads; ++i ) {
+      lThreads.emplace_back( [&lWorkers, i]() {
+         lWorkers[i].vCurrentLine = static_cast<unsigned int>(
+               std::count( lWorkers[i].vIter, lWorkers[i].vEnd, '\n' ) );
+      } );
+   }
+
+   for ( auto &i : lThreads )
+      i.join();
+
+   lThreads.clear();
+
+   unsigned int lLine = vCurrentLine;
+   for ( auto &i : lWorkers ) {
+      unsigned int lLinesInChunk = i.vCurrentLine;
+      i.vCurrentLine = lLine;
+      lLine += lLinesInChunk;
+   }
+
+   for ( unsigned int i = 0; i < _numThreads; ++i )
+      lThreads.emplace_back(
+            [&lWorkers, &lResults, i]() { lResults[i] = lWorkers[i].parseChunk(); } );
+
+   for ( auto &i : lThreads )
+      i.join();
+
+   unsigned int lNumChunks = _numThreads;
+   int lRet = 1;
+
+   for ( unsigned int i = 0; i < _numThreads; ++i ) {
+      if ( lResults[i] != 1 ) {
+         lNumChunks = i + 1;
+         lRet = lResults[i];
+         break;
+      }
+   }
+
+   // Merge
+   size_t lVertexSize = 0, lUVSize = 0, lNormalSize = 0;
+   size_t lIndexVertexSize = 0, lIndexUVSize = 0, lIndexNormalSize = 0;
+
+   for ( unsigned int i = 0; i < lNumChunks; ++i ) {
+      lVertexSize += lWorkers[i].vDataRaw.vVertexData.size();
+      lUVSize += lWorkers[i].vDataRaw.vUVData.size();
+      lNormalSize += lWorkers[i].vDataRaw.vNormalesData.size();
+      lIndexVertexSize += lWorkers[i].vDataRaw.vIndexVertexData.size();
+      lIndexUVSize += lWorkers[i].vDataRaw.vIndexUVData.size();
+      lIndexNormalSize += lWorkers[i].vDataRaw.vIndexNormalData.size();
+   }
+
+   vDataRaw.vVertexData.reserve( vDataRaw.vVertexData.size() + lVertexSize );
+   vDataRaw.vUVData.reserve( vDataRaw.vUVData.size() + lUVSize );
+   vDataRaw.vNormalesData.reserve( vDataRaw.vNormalesData.size() + lNormalSize );
+   vDataRaw.vIndexVertexData.reserve( vDataRaw.vIndexVertexData.size() + lIndexVertexSize );
+   vDataRaw.vIndexUVData.reserve( vDataRaw.vIndexUVData.size() + lIndexUVSize );
+   vDataRaw.vIndexNormalData.reserve( vDataRaw.vIndexNormalData.size() + lIndexNormalSize );
+
+   for ( unsigned int i = 0; i < lNumChunks; ++i ) {
+      auto &lRaw = lWorkers[i].vDataRaw;
+
+      vDataRaw.vVertexData.insert(
+            vDataRaw.vVertexData.end(), lRaw.vVertexData.begin(), lRaw.vVertexData.end() );
+      vDataRaw.vUVData.insert( vDataRaw.vUVData.end(), lRaw.vUVData.begin(), lRaw.vUVData.end() );
+      vDataRaw.vNormalesData.insert(
+            vDataRaw.vNormalesData.end(), lRaw.vNormalesData.begin(), lRaw.vNormalesData.end() );
+      vDataRaw.vIndexVertexData.insert( vDataRaw.vIndexVertexData.end(),
+                                        lRaw.vIndexVertexData.begin(),
+                                        lRaw.vIndexVertexData.end() );
+      vDataRaw.vIndexUVData.insert(
+            vDataRaw.vIndexUVData.end(), lRaw.vIndexUVData.begin(), lRaw.vIndexUVData.end() );
+      vDataRaw.vIndexNormalData.insert( vDataRaw.vIndexNormalData.end(),
+                                        lRaw.vIndexNormalData.begin(),
+                                        lRaw.vIndexNormalData.end() );
+
+      lRaw.clear();
+   }
+
+   vIter = lWorkers[lNumChunks - 1].vIter;
+   vCurrentLine = lWorkers[lNumChunks - 1].vCurrentLine;
 
+   return lRet;
+}
+
+/*!
+ * \brief Parses the range vIter - vEnd in the current thread
+ * \returns the same as load()
+ * \note vEnd is never dereferenced; the range does not need to be null terminated
+ */
+int rLoader_3D_f_OBJ::parseChunk() {
    float lWorker;
    unsigned int lIWorker;
 
@@ -160,17 +531,25 @@ int rLoader_3D_f_OBJ::load() {
          case 'o':
          case 's':
          case '#':
-            while ( *vIter != '\n' && vIter != vEnd )
+            while ( vIter != vEnd && *vIter != '\n' )
                ++vIter;
 
             ++vCurrentLine;
-            ++vIter;
+
+            if ( vIter != vEnd )
+               ++vIter;
+
             break;
 
          // Vertex and normals
          case 'v':
             ++vIter;
 
+            if ( vIter == vEnd ) {
+               eLOG( "Failed parsing file '", vFilePath_str, "': unexpected end of file" );
+               return 2;
+            }
+
             // Normals
             if ( *vIter == 'n' ) {
                lPointer = &vDataRaw.vNormalesData;
@@ -194,7 +573,7 @@ int rLoader_3D_f_OBJ::load() {
                return 2;
             }
 
-            while ( *vIter == ' ' && vIter != vEnd )
+            while ( vIter != vEnd && *vIter == ' ' )
                ++vIter;
 
             for ( short unsigned int i = 0; i < lMax; ++i ) {
@@ -203,15 +582,15 @@ int rLoader_3D_f_OBJ::load() {
 
                lPointer->emplace_back( lWorker );
 
-               while ( *vIter == ' ' && vIter != vEnd )
+               while ( vIter != vEnd && *vIter == ' ' )
                   ++vIter;
             }
 
-            if ( *vIter != '\n' ) {
+            if ( vIter == vEnd || *vIter != '\n' ) {
                eLOG( "Failed parsing file '",
                      vFilePath_str,
                      "' at char '",
-                     *vIter,
+                     vIter == vEnd ? '\0' : *vIter,
                      "' Line ",
                      vCurrentLine,
                      ": expected a newline" );
@@ -227,20 +606,21 @@ int rLoader_3D_f_OBJ::load() {
             ++vIter;
 
             // Normals
-            if ( *vIter != ' ' ) {
+            if ( vIter == vEnd || *vIter != ' ' ) {
                eLOG( "Failed parsing file '",
                      vFilePath_str,
                      "' at char '",
-                     *vIter,
+                     vIter == vEnd ? '\0' : *vIter,
                      "' Line ",
                      vCurrentLine,
                      ": expected ' ' or 'n'" );
                return 2;
             }
 
-            while ( *vIter == ' ' && vIter != vEnd )
+            while ( vIter != vEnd && *vIter == ' ' )
                ++vIter;
 
+            // getInt() never stops at vEnd without failing, so vIter is always dereferenceable
             for ( short unsigned int i = 0; i < 3; ++i ) {
                if ( !getInt( lIWorker ) )
                   return 2;
@@ -251,7 +631,7 @@ int rLoader_3D_f_OBJ::load() {
                   ++vIter;
 
                   // Normal Index
-                  if ( *vIter == '/' ) {
+                  if ( vIter != vEnd && *vIter == '/' ) {
                      ++vIter;
 
                      if ( !getInt( lIWorker ) )
@@ -260,7 +640,8 @@ int rLoader_3D_f_OBJ::load() {
                      vDataRaw.vIndexNormalData.emplace_back( lIWorker );
                   } else {
                      // UV index
-                     ++vIter;
+                     if ( vIter != vEnd )
+                        ++vIter;
 
                      if ( !getInt( lIWorker ) )
                         return 2;
@@ -279,15 +660,15 @@ int rLoader_3D_f_OBJ::load() {
                   }
                }
 
-               while ( *vIter == ' ' && vIter != vEnd )
+               while ( vIter != vEnd && *vIter == ' ' )
                   ++vIter;
             }
 
-            if ( *vIter != '\n' ) {
+            if ( vIter == vEnd || *vIter != '\n' ) {
                eLOG( "Failed parsing file '",
                      vFilePath_str,
                      "' at char '",
-                     *vIter,
+                     vIter == vEnd ? '\0' : *vIter,
                      "' Line ",
                      vCurrentLine,
                      ": expected a newline" );
@@ -309,7 +690,6 @@ int rLoader_3D_f_OBJ::load() {
       }
    }
 
-   vIsDataLoaded_B = true;
    return 1;
 }
 }
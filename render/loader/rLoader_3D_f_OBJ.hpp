@@ -26,25 +26,54 @@
 #include "rLoaderBase.hpp"
 #include <string>
 #include <vector>
+#include <stddef.h>
 
 #include <GL/glew.h>
 
 namespace e_engine {
 
 class rLoader_3D_f_OBJ : public internal::rLoaderBase<GLfloat, GLuint> {
+ public:
+   //! Files (or the chunks of them) smaller than this are parsed by a single thread
+   static const size_t MIN_CHUNK_SIZE = 2 * 1024 * 1024;
+
+   //! Size of the first part parsed when streaming; every following part is twice as big
+   static const size_t STREAM_SLICE_SIZE = 1024 * 1024;
+   //! Upper limit for the part size when streaming
+   static const size_t MAX_STREAM_SLICE_SIZE = 64 * 1024 * 1024;
+
+   enum LOAD_MODE {
+      READ_FILE,    //!< Copy the file into RAM with uFileIO and parse the copy
+      MEMORY_MAPPED //!< Map the file with uMemoryMappedFile and parse it in place (default)
+   };
+
  private:
    bool getNum( float &_num );
    bool getInt( unsigned int &_num );
    unsigned int vCurrentLine = 1;
 
-   std::string::const_iterator vIter;
-   std::string::const_iterator vEnd;
+   char const *vIter;
+   char const *vEnd;
+
+   LOAD_MODE vLoadMode = MEMORY_MAPPED;
+   unsigned int vNumThreads = 0;
+
+   int parse();
+   int parseParallel( unsigned int _numThreads );
+   int parseChunk();
+   int parseStreaming();
 
  public:
    rLoader_3D_f_OBJ();
    rLoader_3D_f_OBJ( std::string _file );
    virtual ~rLoader_3D_f_OBJ() {}
 
+   void setLoadMode( LOAD_MODE _mode ) { vLoadMode = _mode; }
+   LOAD_MODE getLoadMode() const { return vLoadMode; }
+
+   void setNumThreads( unsigned int _threads ) { vNumThreads = _threads; }
+   unsigned int getNumThreads() const { return vNumThreads; }
+
    int load();
 };
 }
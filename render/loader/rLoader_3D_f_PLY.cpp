@@ -0,0 +1,552 @@
+/*!
+ * \file rLoader_3D_f_PLY.cpp
+ * \brief \b Classes: \a rLoader_3D_f_PLY
+ */
+/*
+ * Copyright (C) 2015 EEnginE project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rLoader_3D_f_PLY.hpp"
+
+#include "uLog.hpp"
+#include "uMemoryMappedFile.hpp"
+
+#include <sstream>
+#include <string.h>
+#include <stdint.h>
+
+namespace e_engine {
+
+rLoader_3D_f_PLY::rLoader_3D_f_PLY() { vIsDataLoaded_B = false; }
+
+rLoader_3D_f_PLY::rLoader_3D_f_PLY( std::string _file ) {
+   vIsDataLoaded_B = false;
+   vFilePath_str = _file;
+}
+
+namespace {
+
+//! Reads a PLY scalar of the type _type and converts it to T
+template <class T>
+T readValue( char const *_data, rLoader_3D_f_PLY::PLY_TYPE _type ) {
+   using internal::readLittleEndian;
+
+   switch ( _type ) {
+      case rLoader_3D_f_PLY::INT8:
+         return static_cast<T>( readLittleEndian<int8_t>( _data ) );
+      case rLoader_3D_f_PLY::UINT8:
+         return static_cast<T>( readLittleEndian<uint8_t>( _data ) );
+      case rLoader_3D_f_PLY::INT16:
+         return static_cast<T>( readLittleEndian<int16_t>( _data ) );
+      case rLoader_3D_f_PLY::UINT16:
+         return static_cast<T>( readLittleEndian<uint16_t>( _data ) );
+      case rLoader_3D_f_PLY::INT32:
+         return static_cast<T>( readLittleEndian<int32_t>( _data ) );
+      case rLoader_3D_f_PLY::UINT32:
+         return static_cast<T>( readLittleEndian<uint32_t>( _data ) );
+      case rLoader_3D_f_PLY::FLOAT32:
+         return static_cast<T>( readLittleEndian<float>( _data ) );
+      case rLoader_3D_f_PLY::FLOAT64:
+         return static_cast<T>( readLittleEndian<double>( _data ) );
+      case rLoader_3D_f_PLY::INVALID:
+         return 0;
+   }
+
+   return 0;
+}
+}
+
+rLoader_3D_f_PLY::PLY_TYPE rLoader_3D_f_PLY::getType( std::string const &_name ) {
+   if ( _name == "char" || _name == "int8" )
+      return INT8;
+   if ( _name == "uchar" || _name == "uint8" )
+      return UINT8;
+   if ( _name == "short" || _name == "int16" )
+      return INT16;
+   if ( _name == "ushort" || _name == "uint16" )
+      return UINT16;
+   if ( _name == "int" || _name == "int32" )
+      return INT32;
+   if ( _name == "uint" || _name == "uint32" )
+      return UINT32;
+   if ( _name == "float" || _name == "float32" )
+      return FLOAT32;
+   if ( _name == "double" || _name == "float64" )
+      return FLOAT64;
+
+   return INVALID;
+}
+
+size_t rLoader_3D_f_PLY::getTypeSize( PLY_TYPE _type ) {
+   switch ( _type ) {
+      case INT8:
+      case UINT8:
+         return 1;
+      case INT16:
+      case UINT16:
+         return 2;
+      case INT32:
+      case UINT32:
+      case FLOAT32:
+         return 4;
+      case FLOAT64:
+         return 8;
+      case INVALID:
+         return 0;
+   }
+
+   return 0;
+}
+
+
+/*!
+ * \brief loads the 3D content frome the PLY file
+ *
+ * \returns 1 on success
+ * \returns 2 if there was a parsing error (or the format is not supported)
+ * \returns 3 if the PLY file doesn't exists
+ * \returns 4 if the PLY file is not a regular file
+ * \returns 5 if the PLY file is not readable
+ * \returns 6 if already loaded
+ */
+int rLoader_3D_f_PLY::load() {
+   if ( vIsDataLoaded_B )
+      return 6;
+
+   uMemoryMappedFile lFile( vFilePath_str );
+   int lRet = lFile();
+   if ( lRet != 1 )
+      return lRet;
+
+   vIter = lFile.begin();
+   vEnd = lFile.end();
+
+   lRet = parseHeader();
+   if ( lRet != 1 )
+      return lRet;
+
+   bool lHasVertices = false;
+   bool lHasFaces = false;
+   size_t lNumVertices = 0;
+
+   for ( auto const &i : vElements ) {
+      if ( i.name == "vertex" && !lHasVertices ) {
+         lRet = readVertices( i );
+         lNumVertices = i.count;
+         lHasVertices = true;
+      } else if ( i.name == "face" && !lHasFaces ) {
+         if ( !lHasVertices ) {
+            eLOG( "Failed parsing file '", vFilePath_str, "': faces before the vertices" );
+            return 2;
+         }
+
+         lRet = readFaces( i, lNumVertices );
+         lHasFaces = true;
+      } else {
+         lRet = skipElement( i );
+      }
+
+      if ( lRet != 1 )
+         return lRet;
+   }
+
+   if ( vDataRaw.vIndexVertexData.empty() ) {
+      eLOG( "Failed parsing file '",
+            vFilePath_str,
+            "': no faces (point clouds are not supported)" );
+      return 2;
+   }
+
+   // Every vertex has its own normal / UV coordinates
+   if ( !vDataRaw.vNormalesData.empty() )
+      vDataRaw.vIndexNormalData = vDataRaw.vIndexVertexData;
+
+   if ( !vDataRaw.vUVData.empty() )
+      vDataRaw.vIndexUVData = vDataRaw.vIndexVertexData;
+
+   emitBatch(); // The whole mesh is one batch (binary data is read in one pass)
+
+   vIsDataLoaded_B = true;
+   return 1;
+}
+
+/*!
+ * \brief Parses the ASCII header and moves vIter to the start of the binary data
+ * \returns the same as load()
+ */
+int rLoader_3D_f_PLY::parseHeader() {
+   vElements.clear();
+
+   bool lIsFirstLine = true;
+   bool lHasFormat = false;
+
+   while ( true ) {
+      char const *lLineEnd = vIter;
+      while ( lLineEnd != vEnd && *lLineEnd != '\n' )
+         ++lLineEnd;
+
+      if ( lLineEnd == vEnd ) {
+         eLOG( "Failed parsing file '", vFilePath_str, "': no end_header" );
+         return 2;
+      }
+
+      std::string lLine( vIter, lLineEnd );
+      vIter = lLineEnd + 1;
+
+      if ( !lLine.empty() && lLine.back() == '\r' )
+         lLine.pop_back();
+
+      if ( lIsFirstLine ) {
+         if ( lLine != "ply" ) {
+            eLOG( "Failed parsing file '", vFilePath_str, "': not a PLY file" );
+            return 2;
+         }
+
+         lIsFirstLine = false;
+         continue;
+      }
+
+      std::istringstream lStream( lLine );
+      std::string lKeyword;
+      lStream >> lKeyword;
+
+      if ( lKeyword == "end_header" )
+         break;
+
+      if ( lKeyword == "comment" || lKeyword == "obj_info" || lKeyword.empty() )
+         continue;
+
+      if ( lKeyword == "format" ) {
+         std::string lFormat;
+         lStream >> lFormat;
+
+         if ( lFormat != "binary_little_endian" ) {
+            eLOG( "Failed parsing file '",
+                  vFilePath_str,
+                  "': unsupported PLY format '",
+                  lFormat,
+                  "' (only binary_little_endian)" );
+            return 2;
+         }
+
+         lHasFormat = true;
+         continue;
+      }
+
+      if ( lKeyword == "element" ) {
+         __element__ lElement;
+         lStream >> lElement.name >> lElement.count;
+
+         if ( lStream.fail() ) {
+            eLOG( "Failed parsing file '", vFilePath_str, "': invalid line '", lLine, "'" );
+            return 2;
+         }
+
+         vElements.emplace_back( lElement );
+         continue;
+      }
+
+      if ( lKeyword == "property" && !vElements.empty() ) {
+         __property__ lProperty;
+         std::string lType;
+         lStream >> lType;
+
+         if ( lType == "list" ) {
+            std::string lCountType;
+            lStream >> lCountType >> lType;
+            lProperty.countType = getType( lCountType );
+
+            if ( lProperty.countType == INVALID || lProperty.countType == FLOAT32 ||
+                 lProperty.countType == FLOAT64 ) {
+               eLOG( "Failed parsing file '", vFilePath_str, "': invalid line '", lLine, "'" );
+               return 2;
+            }
+         }
+
+         lStream >> lProperty.name;
+         lProperty.type = getType( lType );
+
+         if ( lStream.fail() || lProperty.type == INVALID ) {
+            eLOG( "Failed parsing file '", vFilePath_str, "': invalid line '", lLine, "'" );
+            return 2;
+         }
+
+         vElements.back().properties.emplace_back( lProperty );
+         continue;
+      }
+
+      eLOG( "Failed parsing file '", vFilePath_str, "': invalid line '", lLine, "'" );
+      return 2;
+   }
+
+   if ( !lHasFormat ) {
+      eLOG( "Failed parsing file '", vFilePath_str, "': no format" );
+      return 2;
+   }
+
+   // Records without lists have a fixed size
+   for ( auto &i : vElements ) {
+      size_t lOffset = 0;
+
+      for ( auto &j : i.properties ) {
+         if ( j.countType != INVALID ) {
+            lOffset = 0;
+            break;
+         }
+
+         j.offset = lOffset;
+         lOffset += getTypeSize( j.type );
+      }
+
+      i.stride = lOffset;
+   }
+
+   return 1;
+}
+
+/*!
+ * \brief Reads the positions, normals and UV coordinates of the vertex element
+ * \returns the same as load()
+ */
+int rLoader_3D_f_PLY::readVertices( __element__ const &_element ) {
+   if ( _element.stride == 0 ) {
+      eLOG( "Failed parsing file '", vFilePath_str, "': unsupported vertex properties (lists)" );
+      return 2;
+   }
+
+   if ( _element.count > static_cast<size_t>( vEnd - vIter ) / _element.stride ) {
+      eLOG( "Failed parsing file '", vFilePath_str, "': unexpected end of file" );
+      return 2;
+   }
+
+   auto lFind = [&]( std::initializer_list<char const *> _names ) -> __property__ const *{
+      for ( auto const &i : _element.properties )
+         for ( auto j : _names )
+            if ( i.name == j )
+               return &i;
+
+      return nullptr;
+   };
+
+   __property__ const *lPosition[] = {lFind( {"x"} ), lFind( {"y"} ), lFind( {"z"} )};
+   __property__ const *lNormal[] = {lFind( {"nx"} ), lFind( {"ny"} ), lFind( {"nz"} )};
+   __property__ const *lUV[] = {lFind( {"u", "s", "texture_u"} ),
+                                lFind( {"v", "t", "texture_v"} )};
+
+   if ( !lPosition[0] || !lPosition[1] || !lPosition[2] ) {
+      eLOG( "Failed parsing file '", vFilePath_str, "': no vertex positions (x, y, z)" );
+      return 2;
+   }
+
+   readAttribute( _element, lPosition, 3, vDataRaw.vVertexData );
+
+   if ( lNormal[0] && lNormal[1] && lNormal[2] )
+      readAttribute( _element, lNormal, 3, vDataRaw.vNormalesData );
+
+   if ( lUV[0] && lUV[1] )
+      readAttribute( _element, lUV, 2, vDataRaw.vUVData );
+
+   vIter += _element.count * _element.stride;
+   return 1;
+}
+
+/*!
+ * \brief Reads one attribute (_num properties) of all vertices starting at vIter
+ *
+ * Consecutive float properties are copied with memcpy (the whole block if the element contains
+ * nothing else); everything else is converted value by value.
+ */
+void rLoader_3D_f_PLY::readAttribute( __element__ const &_element,
+                                      __property__ const *const *_properties,
+                                      size_t _num,
+                                      std::vector<GLfloat> &_out ) {
+   size_t lCount = _element.count;
+   size_t lStride = _element.stride;
+   size_t lOffset = _properties[0]->offset;
+
+   _out.resize( lCount * _num );
+   GLfloat *lOut = _out.data();
+
+   if ( lCount == 0 )
+      return;
+
+   bool lPacked = internal::isLittleEndianHost();
+   for ( size_t i = 0; i < _num; ++i )
+      if ( _properties[i]->type != FLOAT32 || _properties[i]->offset != lOffset + i * 4 )
+         lPacked = false;
+
+   if ( lPacked && lStride == _num * sizeof( GLfloat ) ) {
+      memcpy( lOut, vIter, lCount * lStride );
+      return;
+   }
+
+   if ( lPacked ) {
+      for ( size_t i = 0; i < lCount; ++i )
+         memcpy( lOut + i * _num, vIter + i * lStride + lOffset, _num * sizeof( GLfloat ) );
+
+      return;
+   }
+
+   for ( size_t i = 0; i < lCount; ++i )
+      for ( size_t j = 0; j < _num; ++j )
+         lOut[i * _num + j] = readValue<GLfloat>( vIter + i * lStride + _properties[j]->offset,
+                                                  _properties[j]->type );
+}
+
+/*!
+ * \brief Moves vIter behind the property _property of the current record
+ * \param[out] _listSize Number of list entries (1 for scalar properties)
+ * \returns false if the file ends in the property (or the list size is invalid)
+ */
+bool rLoader_3D_f_PLY::skipProperty( __property__ const &_property, int64_t &_listSize ) {
+   size_t lSize = getTypeSize( _property.type );
+   _listSize = 1;
+
+   if ( _property.countType != INVALID ) {
+      size_t lCountSize = getTypeSize( _property.countType );
+
+      if ( static_cast<size_t>( vEnd - vIter ) < lCountSize )
+         return false;
+
+      _listSize = readValue<int64_t>( vIter, _property.countType );
+      vIter += lCountSize;
+
+      if ( _listSize < 0 )
+         return false;
+   }
+
+   if ( static_cast<uint64_t>( _listSize ) > static_cast<size_t>( vEnd - vIter ) / lSize )
+      return false;
+
+   vIter += static_cast<size_t>( _listSize ) * lSize;
+   return true;
+}
+
+/*!
+ * \brief Reads the faces and triangulates them (triangle fans)
+ * \returns the same as load()
+ */
+int rLoader_3D_f_PLY::readFaces( __element__ const &_element, size_t _numVertices ) {
+   __property__ const *lIndex = nullptr;
+
+   for ( auto const &i : _element.properties )
+      if ( i.countType != INVALID && ( i.name == "vertex_indices" || i.name == "vertex_index" ) )
+         lIndex = &i;
+
+   if ( !lIndex || lIndex->type == FLOAT32 || lIndex->type == FLOAT64 ) {
+      eLOG( "Failed parsing file '", vFilePath_str, "': no face indices (vertex_indices)" );
+      return 2;
+   }
+
+   // Every face has at least the list size (1 byte)
+   if ( _element.count > static_cast<size_t>( vEnd - vIter ) ) {
+      eLOG( "Failed parsing file '", vFilePath_str, "': unexpected end of file" );
+      return 2;
+   }
+
+   auto &lOut = vDataRaw.vIndexVertexData;
+   lOut.reserve( lOut.size() + _element.count * 3 );
+
+   size_t lIndexSize = getTypeSize( lIndex->type );
+   bool lPackedTriangles = internal::isLittleEndianHost() &&
+                           ( lIndex->type == INT32 || lIndex->type == UINT32 ) &&
+                           sizeof( GLuint ) == 4;
+
+   for ( size_t i = 0; i < _element.count; ++i ) {
+      for ( auto const &j : _element.properties ) {
+         int64_t lNum;
+
+         if ( !skipProperty( j, lNum ) ) {
+            eLOG( "Failed parsing file '",
+                  vFilePath_str,
+                  "': unexpected end of file (face ",
+                  i,
+                  ")" );
+            return 2;
+         }
+
+         if ( &j != lIndex || lNum < 3 )
+            continue;
+
+         char const *lData = vIter - static_cast<size_t>( lNum ) * lIndexSize;
+         size_t lBegin = lOut.size();
+
+         if ( lPackedTriangles && lNum == 3 ) {
+            lOut.resize( lBegin + 3 );
+            memcpy( &lOut[lBegin], lData, 3 * sizeof( GLuint ) );
+         } else {
+            GLuint lFirst = readValue<GLuint>( lData, lIndex->type );
+            GLuint lLast = readValue<GLuint>( lData + lIndexSize, lIndex->type );
+
+            for ( int64_t k = 2; k < lNum; ++k ) {
+               char const *lNextData = lData + static_cast<size_t>( k ) * lIndexSize;
+               GLuint lNext = readValue<GLuint>( lNextData, lIndex->type );
+               lOut.insert( lOut.end(), {lFirst, lLast, lNext} );
+               lLast = lNext;
+            }
+         }
+
+         // Negative (signed) indices are out of range as GLuint, too
+         for ( size_t k = lBegin; k < lOut.size(); ++k ) {
+            if ( lOut[k] >= _numVertices ) {
+               eLOG( "Failed parsing file '",
+                     vFilePath_str,
+                     "': index out of range (face ",
+                     i,
+                     ")" );
+               return 2;
+            }
+         }
+      }
+   }
+
+   return 1;
+}
+
+/*!
+ * \brief Moves vIter behind the element
+ * \returns the same as load()
+ */
+int rLoader_3D_f_PLY::skipElement( __element__ const &_element ) {
+   if ( _element.stride != 0 ) {
+      if ( _element.count > static_cast<size_t>( vEnd - vIter ) / _element.stride ) {
+         eLOG( "Failed parsing file '", vFilePath_str, "': unexpected end of file" );
+         return 2;
+      }
+
+      vIter += _element.count * _element.stride;
+      return 1;
+   }
+
+   // Records without properties are empty
+   if ( _element.properties.empty() )
+      return 1;
+
+   int64_t lNum;
+
+   for ( size_t i = 0; i < _element.count; ++i ) {
+      for ( auto const &j : _element.properties ) {
+         if ( !skipProperty( j, lNum ) ) {
+            eLOG( "Failed parsing file '", vFilePath_str, "': unexpected end of file" );
+            return 2;
+         }
+      }
+   }
+
+   return 1;
+}
+}
+
+// kate: indent-mode cstyle; indent-width 3; replace-tabs on; line-numbers on;
@@ -0,0 +1,98 @@
+/*!
+ * \file rLoader_3D_f_PLY.hpp
+ * \brief \b Classes: \a rLoader_3D_f_PLY
+ */
+/*
+ * Copyright (C) 2015 EEnginE project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef R_LOADER_3D_F_PLY_HPP
+#define R_LOADER_3D_F_PLY_HPP
+
+#include "defines.hpp"
+
+#include "rLoaderBase.hpp"
+#include <string>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <GL/glew.h>
+
+namespace e_engine {
+
+/*!
+ * \brief Loads binary little endian PLY files
+ *
+ * The vertex element must have the properties x, y and z. The normals (nx, ny, nz) and the UV
+ * coordinates (u, v / s, t / texture_u, texture_v) are optional. Properties can have any PLY
+ * scalar type. Faces (the vertex_indices or vertex_index list of the face element) are
+ * triangulated as triangle fans. All other elements and properties are skipped.
+ *
+ * Float properties in the native (little endian) byte order are copied in bulk. The file is
+ * memory mapped.
+ *
+ * \note ASCII and big endian PLY files are NOT supported
+ * \note Call reindex() after load()
+ */
+class rLoader_3D_f_PLY : public internal::rLoaderBase<GLfloat, GLuint> {
+ public:
+   enum PLY_TYPE { INT8, UINT8, INT16, UINT16, INT32, UINT32, FLOAT32, FLOAT64, INVALID };
+
+ private:
+   struct __property__ {
+      std::string name;
+      PLY_TYPE type = INVALID;
+      PLY_TYPE countType = INVALID; //!< Type of the list size (INVALID: no list)
+      size_t offset = 0;            //!< Offset in the record (only for elements without lists)
+   };
+
+   struct __element__ {
+      std::string name;
+      size_t count = 0;
+      size_t stride = 0; //!< Size of one record (0: the element has lists)
+      std::vector<__property__> properties;
+   };
+
+   std::vector<__element__> vElements;
+
+   char const *vIter;
+   char const *vEnd;
+
+   int parseHeader();
+   int readVertices( __element__ const &_element );
+   int readFaces( __element__ const &_element, size_t _numVertices );
+   void readAttribute( __element__ const &_element,
+                       __property__ const *const *_properties,
+                       size_t _num,
+                       std::vector<GLfloat> &_out );
+   bool skipProperty( __property__ const &_property, int64_t &_listSize );
+   int skipElement( __element__ const &_element );
+
+   static PLY_TYPE getType( std::string const &_name );
+   static size_t getTypeSize( PLY_TYPE _type );
+
+ public:
+   rLoader_3D_f_PLY();
+   rLoader_3D_f_PLY( std::string _file );
+   virtual ~rLoader_3D_f_PLY() {}
+
+   int load();
+};
+}
+
+#endif // R_LOADER_3D_F_PLY_HPP
+
+// kate: indent-mode cstyle; indent-width 3; replace-tabs on; line-numbers on;
@@ -0,0 +1,214 @@
+/*!
+ * \file rLoader_3D_f_STL.cpp
+ * \brief \b Classes: \a rLoader_3D_f_STL
+ */
+/*
+ * Copyright (C) 2015 EEnginE project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rLoader_3D_f_STL.hpp"
+
+#include "uLog.hpp"
+#include "uMemoryMappedFile.hpp"
+
+#include <vector>
+#include <limits>
+#include <cmath>
+#include <string.h>
+#include <stdint.h>
+
+namespace e_engine {
+
+rLoader_3D_f_STL::rLoader_3D_f_STL() { vIsDataLoaded_B = false; }
+
+rLoader_3D_f_STL::rLoader_3D_f_STL( std::string _file ) {
+   vIsDataLoaded_B = false;
+   vFilePath_str = _file;
+}
+
+namespace {
+
+/*!
+ * \brief Open addressing hash table (linear probing) mapping positions to vertex indexes
+ *
+ * The positions are compared bitwise (-0.0 is stored as 0.0). They are stored in the output
+ * vertex array; the table only stores their indexes.
+ */
+class __positionHashTable__ {
+ private:
+   std::vector<GLuint> vTable;
+   std::vector<GLfloat> *vVertices;
+   size_t vMask;
+
+   static uint32_t getBits( GLfloat _val ) {
+      uint32_t lBits;
+      _val += 0.0f; // -0.0 + 0.0 == 0.0
+      memcpy( &lBits, &_val, sizeof( lBits ) );
+      return lBits;
+   }
+
+ public:
+   __positionHashTable__( size_t _maxKeys, std::vector<GLfloat> *_vertices )
+       : vVertices( _vertices ) {
+      size_t lSize = 16;
+
+      while ( lSize < _maxKeys + _maxKeys / 3 )
+         lSize <<= 1;
+
+      vMask = lSize - 1;
+      vTable.resize( lSize, std::numeric_limits<GLuint>::max() );
+   }
+
+   GLuint findOrInsert( GLfloat const *_pos ) {
+      uint32_t lX = getBits( _pos[0] ), lY = getBits( _pos[1] ), lZ = getBits( _pos[2] );
+      uint64_t lHash = lX * 0x9E3779B97F4A7C15ULL ^ lY * 0xC2B2AE3D27D4EB4FULL ^
+                       lZ * 0x165667B19E3779F9ULL;
+
+      for ( size_t lSlot = static_cast<size_t>( lHash >> 32 ) & vMask;;
+            lSlot = ( lSlot + 1 ) & vMask ) {
+         GLuint lIndex = vTable[lSlot];
+
+         if ( lIndex == std::numeric_limits<GLuint>::max() ) {
+            lIndex = static_cast<GLuint>( vVertices->size() / 3 );
+            vTable[lSlot] = lIndex;
+            vVertices->insert( vVertices->end(), {_pos[0] + 0.0f, _pos[1] + 0.0f, _pos[2] + 0.0f} );
+            return lIndex;
+         }
+
+         GLfloat const *lPos = vVertices->data() + lIndex * 3;
+         if ( getBits( lPos[0] ) == lX && getBits( lPos[1] ) == lY && getBits( lPos[2] ) == lZ )
+            return lIndex;
+      }
+   }
+};
+}
+
+
+/*!
+ * \brief loads the 3D content frome the binary STL file
+ *
+ * \returns 1 on success
+ * \returns 2 if there was a parsing error (or it is an ASCII STL file)
+ * \returns 3 if the STL file doesn't exists
+ * \returns 4 if the STL file is not a regular file
+ * \returns 5 if the STL file is not readable
+ * \returns 6 if already loaded
+ */
+int rLoader_3D_f_STL::load() {
+   if ( vIsDataLoaded_B )
+      return 6;
+
+   uMemoryMappedFile lFile( vFilePath_str );
+   int lRet = lFile();
+   if ( lRet != 1 )
+      return lRet;
+
+   char const *lData = lFile.begin();
+   size_t lSize = lFile.size();
+
+   bool lIsASCII = lSize >= 5 && memcmp( lData, "solid", 5 ) == 0;
+
+   if ( lSize < HEADER_SIZE ) {
+      eLOG( "Failed parsing file '", vFilePath_str, "': ", lIsASCII ? "ASCII STL" : "too small" );
+      return 2;
+   }
+
+   size_t lNumTriangles = internal::readLittleEndian<uint32_t>( lData + 80 );
+
+   // ASCII files can also start with "solid"; the size is the better check
+   if ( lNumTriangles > ( lSize - HEADER_SIZE ) / TRIANGLE_SIZE ||
+        ( lIsASCII && lSize != HEADER_SIZE + lNumTriangles * TRIANGLE_SIZE ) ) {
+      eLOG( "Failed parsing file '",
+            vFilePath_str,
+            "': ",
+            lIsASCII ? "ASCII STL files are not supported" : "unexpected end of file" );
+      return 2;
+   }
+
+   if ( lNumTriangles == 0 ) {
+      eLOG( "Failed parsing file '", vFilePath_str, "': no triangles" );
+      return 2;
+   }
+
+   auto &lVertices = vDataRaw.vVertexData;
+   auto &lIndex = vDataRaw.vIndexVertexData;
+   auto &lNormals = vDataRaw.vNormalesData;
+
+   // Closed meshes have about half as many vertices as triangles
+   lVertices.reserve( lNumTriangles * 3 / 2 );
+   lIndex.resize( lNumTriangles * 3 );
+
+   if ( vUseFaceNormals )
+      lNormals.resize( lNumTriangles * 3 );
+
+   __positionHashTable__ lTable( lNumTriangles * 3, &lVertices );
+   bool lBulkCopy = internal::isLittleEndianHost();
+   GLfloat lTriangle[12]; // normal, 3 vertices
+
+   char const *lIter = lData + HEADER_SIZE;
+
+   for ( size_t i = 0; i < lNumTriangles; ++i, lIter += TRIANGLE_SIZE ) {
+      if ( lBulkCopy ) {
+         memcpy( lTriangle, lIter, sizeof( lTriangle ) );
+      } else {
+         for ( size_t j = 0; j < 12; ++j )
+            lTriangle[j] = internal::readLittleEndian<GLfloat>( lIter + j * sizeof( GLfloat ) );
+      }
+
+      for ( size_t j = 0; j < 3; ++j )
+         lIndex[i * 3 + j] = lTable.findOrInsert( lTriangle + 3 + j * 3 );
+
+      if ( !vUseFaceNormals )
+         continue;
+
+      GLfloat *lN = lTriangle;
+
+      if ( lN[0] == 0.0f && lN[1] == 0.0f && lN[2] == 0.0f ) {
+         GLfloat const *lA = lTriangle + 3;
+         GLfloat const *lB = lTriangle + 6;
+         GLfloat const *lC = lTriangle + 9;
+         GLfloat lE1[3] = {lB[0] - lA[0], lB[1] - lA[1], lB[2] - lA[2]};
+         GLfloat lE2[3] = {lC[0] - lA[0], lC[1] - lA[1], lC[2] - lA[2]};
+
+         lN[0] = lE1[1] * lE2[2] - lE1[2] * lE2[1];
+         lN[1] = lE1[2] * lE2[0] - lE1[0] * lE2[2];
+         lN[2] = lE1[0] * lE2[1] - lE1[1] * lE2[0];
+
+         GLfloat lLength = std::sqrt( lN[0] * lN[0] + lN[1] * lN[1] + lN[2] * lN[2] );
+         if ( lLength > 0.0f )
+            for ( size_t j = 0; j < 3; ++j )
+               lN[j] /= lLength;
+      }
+
+      memcpy( &lNormals[i * 3], lN, 3 * sizeof( GLfloat ) );
+   }
+
+   // One normal per triangle
+   if ( vUseFaceNormals ) {
+      auto &lNormalIndex = vDataRaw.vIndexNormalData;
+      lNormalIndex.resize( lNumTriangles * 3 );
+
+      for ( size_t i = 0; i < lNormalIndex.size(); ++i )
+         lNormalIndex[i] = static_cast<GLuint>( i / 3 );
+   }
+
+   emitBatch(); // The whole mesh is one batch (binary data is read in one pass)
+
+   vIsDataLoaded_B = true;
+   return 1;
+}
+}
+
+// kate: indent-mode cstyle; indent-width 3; replace-tabs on; line-numbers on;
@@ -0,0 +1,74 @@
+/*!
+ * \file rLoader_3D_f_STL.hpp
+ * \brief \b Classes: \a rLoader_3D_f_STL
+ */
+/*
+ * Copyright (C) 2015 EEnginE project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef R_LOADER_3D_F_STL_HPP
+#define R_LOADER_3D_F_STL_HPP
+
+#include "defines.hpp"
+
+#include "rLoaderBase.hpp"
+#include <string>
+#include <stddef.h>
+
+#include <GL/glew.h>
+
+namespace e_engine {
+
+/*!
+ * \brief Loads binary STL files
+ *
+ * File layout (little endian):
+ * | Offset | Content                                                 |
+ * |--------|---------------------------------------------------------|
+ * | 0      | header (80 bytes, ignored)                              |
+ * | 80     | number of triangles (uint32)                            |
+ * | 84     | triangles (50 bytes: normal and 3 vertices, 2 unused)   |
+ *
+ * STL stores every corner separately. Equal positions are merged while loading, so the mesh has
+ * shared vertices. The normal of a triangle is used for all of its corners (flat shading;
+ * the normal is calculated if the file contains a null vector). Without face normals
+ * (setUseFaceNormals( false )) the mesh is smooth but has no normals.
+ *
+ * \note ASCII STL files are NOT supported
+ * \note Call reindex() after load()
+ */
+class rLoader_3D_f_STL : public internal::rLoaderBase<GLfloat, GLuint> {
+ public:
+   static const size_t HEADER_SIZE = 84;
+   static const size_t TRIANGLE_SIZE = 50;
+
+ private:
+   bool vUseFaceNormals = true;
+
+ public:
+   rLoader_3D_f_STL();
+   rLoader_3D_f_STL( std::string _file );
+   virtual ~rLoader_3D_f_STL() {}
+
+   void setUseFaceNormals( bool _use ) { vUseFaceNormals = _use; }
+   bool getUseFaceNormals() const { return vUseFaceNormals; }
+
+   int load();
+};
+}
+
+#endif // R_LOADER_3D_F_STL_HPP
+
+// kate: indent-mode cstyle; indent-width 3; replace-tabs on; line-numbers on;
@@ -0,0 +1,559 @@
+/*!
+ * \file rMeshOptimizer.hpp
+ * \brief \b Classes: \a rMeshOptimizer
+ */
+/*
+ * Copyright (C) 2015 EEnginE project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef R_MESH_OPTIMIZER_HPP
+#define R_MESH_OPTIMIZER_HPP
+
+#include "defines.hpp"
+
+#include "rLoaderBase.hpp"
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+#include <cmath>
+#include <string.h>
+#include <stdint.h>
+
+namespace e_engine {
+
+namespace internal {
+
+/*!
+ * \brief Post processing of reindexed (_3D_Data) triangle meshes
+ *
+ * optimize() runs all steps in this order:
+ *  1. weldVertices():              merges vertices with identical attributes
+ *  2. removeDegenerateTriangles(): removes triangles with repeated vertices or zero area
+ *  3. optimizeVertexCache():       reorders the triangles for the post transform vertex cache
+ *                                  (Tom Forsyth's linear speed vertex cache optimization)
+ *  4. optimizeVertexFetch():       reorders the vertices in the order of their first use (and
+ *                                  removes unused vertices)
+ *
+ * The ACMR (average cache miss ratio: transformed vertices per triangle) for a FIFO cache with
+ * CACHE_SIZE entries is stored before and after the optimization.
+ */
+template <class T, class I>
+class rMeshOptimizer {
+   static_assert( std::is_floating_point<T>::value, "T must be a floating point type" );
+   static_assert( std::is_unsigned<I>::value, "I must be an unsigned type" );
+
+ public:
+   static const uint32_t CACHE_SIZE = 32;
+
+ private:
+   static const uint32_t MAX_VALENCE_TABLE = 32;
+
+   double vACMRBefore = 0;
+   double vACMRAfter = 0;
+
+   size_t vNumWelded = 0;
+   size_t vNumDegenerate = 0;
+
+   float vCacheScore[CACHE_SIZE];
+   float vValenceScore[MAX_VALENCE_TABLE];
+
+   static I empty() { return std::numeric_limits<I>::max(); }
+
+   static uint64_t bits( T _val );
+   static bool isValid( _3D_Data<T, I> const *_data );
+   static void permute( std::vector<T> &_data,
+                        size_t _components,
+                        std::vector<I> const &_newIndex,
+                        size_t _numNew );
+
+   float vertexScore( uint32_t _cachePos, uint32_t _numTriangles ) const;
+
+ public:
+   rMeshOptimizer();
+
+   bool optimize( _3D_Data<T, I> *_data );
+
+   size_t weldVertices( _3D_Data<T, I> *_data );
+   size_t removeDegenerateTriangles( _3D_Data<T, I> *_data );
+   void optimizeVertexCache( _3D_Data<T, I> *_data );
+   void optimizeVertexFetch( _3D_Data<T, I> *_data );
+
+   static double calculateACMR( std::vector<I> const &_index, uint32_t _cacheSize = CACHE_SIZE );
+
+   double getACMRBefore() const { return vACMRBefore; }
+   double getACMRAfter() const { return vACMRAfter; }
+   size_t getNumWeldedVertices() const { return vNumWelded; }
+   size_t getNumDegenerateTriangles() const { return vNumDegenerate; }
+};
+
+
+template <class T, class I>
+rMeshOptimizer<T, I>::rMeshOptimizer() {
+   // Scores from Tom Forsyth's "Linear-Speed Vertex Cache Optimisation"
+   for ( uint32_t i = 0; i < CACHE_SIZE; ++i ) {
+      if ( i < 3 ) {
+         // The last triangle: using it again is not worth that much (avoids strips)
+         vCacheScore[i] = 0.75f;
+      } else {
+         float lScore = 1.0f - static_cast<float>( i - 3 ) / static_cast<float>( CACHE_SIZE - 3 );
+         vCacheScore[i] = std::pow( lScore, 1.5f );
+      }
+   }
+
+   vValenceScore[0] = 0.0f;
+   for ( uint32_t i = 1; i < MAX_VALENCE_TABLE; ++i )
+      vValenceScore[i] = 2.0f / std::sqrt( static_cast<float>( i ) );
+}
+
+/*!
+ * \brief Score of a vertex
+ * \param[in] _cachePos     Position in the simulated cache (CACHE_SIZE: not in the cache)
+ * \param[in] _numTriangles Number of not yet added triangles using this vertex
+ */
+template <class T, class I>
+float rMeshOptimizer<T, I>::vertexScore( uint32_t _cachePos, uint32_t _numTriangles ) const {
+   if ( _numTriangles == 0 )
+      return -1.0f;
+
+   float lScore = _cachePos < CACHE_SIZE ? vCacheScore[_cachePos] : 0.0f;
+
+   // Boost vertices with only a few triangles left, so that they are finished soon
+   if ( _numTriangles < MAX_VALENCE_TABLE )
+      return lScore + vValenceScore[_numTriangles];
+
+   return lScore + 2.0f / std::sqrt( static_cast<float>( _numTriangles ) );
+}
+
+//! Bit pattern of _val (-0 and +0 have the same pattern)
+template <class T, class I>
+uint64_t rMeshOptimizer<T, I>::bits( T _val ) {
+   uint64_t lBits = 0;
+   _val += static_cast<T>( 0 );
+   memcpy( &lBits, &_val, sizeof( T ) );
+   return lBits;
+}
+
+//! Checks the sizes of the attribute arrays and the range of the indexes
+template <class T, class I>
+bool rMeshOptimizer<T, I>::isValid( _3D_Data<T, I> const *_data ) {
+   size_t lNumVertices = _data->vVertexData.size() / 3;
+
+   if ( _data->vVertexData.size() % 3 != 0 || _data->vIndex.size() % 3 != 0 )
+      return false;
+
+   if ( !_data->vNormalesData.empty() && _data->vNormalesData.size() != lNumVertices * 3 )
+      return false;
+
+   if ( !_data->vUVData.empty() && _data->vUVData.size() != lNumVertices * 2 )
+      return false;
+
+   for ( auto i : _data->vIndex )
+      if ( static_cast<size_t>( i ) >= lNumVertices )
+         return false;
+
+   return true;
+}
+
+//! Moves component block i of _data to _newIndex[i] (empty(): drop it)
+template <class T, class I>
+void rMeshOptimizer<T, I>::permute( std::vector<T> &_data,
+                                    size_t _components,
+                                    std::vector<I> const &_newIndex,
+                                    size_t _numNew ) {
+   if ( _data.empty() )
+      return;
+
+   std::vector<T> lTemp( _numNew * _components );
+
+   for ( size_t i = 0; i < _newIndex.size(); ++i ) {
+      if ( _newIndex[i] == empty() )
+         continue;
+
+      for ( size_t j = 0; j < _components; ++j )
+         lTemp[_newIndex[i] * _components + j] = _data[i * _components + j];
+   }
+
+   _data.swap( lTemp );
+}
+
+
+/*!
+ * \brief Runs all optimization steps
+ * \returns false if the data is not a valid indexed triangle mesh (nothing is changed then)
+ */
+template <class T, class I>
+bool rMeshOptimizer<T, I>::optimize( _3D_Data<T, I> *_data ) {
+   if ( !isValid( _data ) ) {
+      wLOG( "Mesh optimizer: invalid mesh data ==> not optimizing" );
+      return false;
+   }
+
+   vACMRBefore = calculateACMR( _data->vIndex );
+
+   vNumWelded = weldVertices( _data );
+   vNumDegenerate = removeDegenerateTriangles( _data );
+   optimizeVertexCache( _data );
+   optimizeVertexFetch( _data );
+
+   vACMRAfter = calculateACMR( _data->vIndex );
+   return true;
+}
+
+
+/*!
+ * \brief Merges vertices with exactly the same position, normal and UV
+ *
+ * Only bitwise identical vertices are merged (except -0 / +0), so the mesh does not change.
+ *
+ * \returns the number of removed vertices
+ */
+template <class T, class I>
+size_t rMeshOptimizer<T, I>::weldVertices( _3D_Data<T, I> *_data ) {
+   std::vector<T> &lVert = _data->vVertexData;
+   std::vector<T> &lNorm = _data->vNormalesData;
+   std::vector<T> &lUV = _data->vUVData;
+
+   size_t lNumVertices = lVert.size() / 3;
+   bool lHasNormals = !lNorm.empty();
+   bool lHasUV = !lUV.empty();
+
+   if ( lNumVertices == 0 )
+      return 0;
+
+   size_t lSize = 16;
+   while ( lSize < lNumVertices * 2 )
+      lSize <<= 1;
+
+   std::vector<I> lTable( lSize, empty() );
+   std::vector<I> lNewIndex( lNumVertices );
+   size_t lMask = lSize - 1;
+   size_t lNumNew = 0;
+
+   // Vertex _a (already moved to its new position) == vertex _b (old position)?
+   auto lEqual = [&]( size_t _a, size_t _b ) -> bool {
+      for ( size_t j = 0; j < 3; ++j )
+         if ( lVert[_a * 3 + j] != lVert[_b * 3 + j] )
+            return false;
+
+      if ( lHasNormals )
+         for ( size_t j = 0; j < 3; ++j )
+            if ( lNorm[_a * 3 + j] != lNorm[_b * 3 + j] )
+               return false;
+
+      if ( lHasUV )
+         for ( size_t j = 0; j < 2; ++j )
+            if ( lUV[_a * 2 + j] != lUV[_b * 2 + j] )
+               return false;
+
+      return true;
+   };
+
+   for ( size_t i = 0; i < lNumVertices; ++i ) {
+      uint64_t lHash = 0xCBF29CE484222325ULL;
+
+      for ( size_t j = 0; j < 3; ++j )
+         lHash = ( lHash ^ bits( lVert[i * 3 + j] ) ) * 0x100000001B3ULL;
+
+      if ( lHasNormals )
+         for ( size_t j = 0; j < 3; ++j )
+            lHash = ( lHash ^ bits( lNorm[i * 3 + j] ) ) * 0x100000001B3ULL;
+
+      if ( lHasUV )
+         for ( size_t j = 0; j < 2; ++j )
+            lHash = ( lHash ^ bits( lUV[i * 2 + j] ) ) * 0x100000001B3ULL;
+
+      lHash ^= lHash >> 29;
+
+      for ( size_t lSlot = static_cast<size_t>( lHash ) & lMask;; lSlot = ( lSlot + 1 ) & lMask ) {
+         I lIndex = lTable[lSlot];
+
+         if ( lIndex == empty() ) {
+            // New vertex: compact in place (lNumNew <= i)
+            if ( lNumNew != i ) {
+               for ( size_t j = 0; j < 3; ++j )
+                  lVert[lNumNew * 3 + j] = lVert[i * 3 + j];
+
+               if ( lHasNormals )
+                  for ( size_t j = 0; j < 3; ++j )
+                     lNorm[lNumNew * 3 + j] = lNorm[i * 3 + j];
+
+               if ( lHasUV )
+                  for ( size_t j = 0; j < 2; ++j )
+                     lUV[lNumNew * 2 + j] = lUV[i * 2 + j];
+            }
+
+            lTable[lSlot] = static_cast<I>( lNumNew );
+            lNewIndex[i] = static_cast<I>( lNumNew );
+            ++lNumNew;
+            break;
+         }
+
+         if ( lEqual( lIndex, i ) ) {
+            lNewIndex[i] = lIndex;
+            break;
+         }
+      }
+   }
+
+   if ( lNumNew == lNumVertices )
+      return 0;
+
+   lVert.resize( lNumNew * 3 );
+
+   if ( lHasNormals )
+      lNorm.resize( lNumNew * 3 );
+
+   if ( lHasUV )
+      lUV.resize( lNumNew * 2 );
+
+   for ( auto &i : _data->vIndex )
+      i = lNewIndex[i];
+
+   return lNumVertices - lNumNew;
+}
+
+
+/*!
+ * \brief Removes triangles using a vertex more than once or with a zero area
+ * \returns the number of removed triangles
+ */
+template <class T, class I>
+size_t rMeshOptimizer<T, I>::removeDegenerateTriangles( _3D_Data<T, I> *_data ) {
+   std::vector<I> &lIndex = _data->vIndex;
+   std::vector<T> const &lVert = _data->vVertexData;
+
+   size_t lOut = 0;
+
+   for ( size_t i = 0; i + 2 < lIndex.size(); i += 3 ) {
+      I a = lIndex[i + 0];
+      I b = lIndex[i + 1];
+      I c = lIndex[i + 2];
+
+      if ( a == b || b == c || a == c )
+         continue;
+
+      T lE1[3], lE2[3];
+      for ( size_t j = 0; j < 3; ++j ) {
+         lE1[j] = lVert[b * 3 + j] - lVert[a * 3 + j];
+         lE2[j] = lVert[c * 3 + j] - lVert[a * 3 + j];
+      }
+
+      T lX = lE1[1] * lE2[2] - lE1[2] * lE2[1];
+      T lY = lE1[2] * lE2[0] - lE1[0] * lE2[2];
+      T lZ = lE1[0] * lE2[1] - lE1[1] * lE2[0];
+
+      if ( lX == 0 && lY == 0 && lZ == 0 )
+         continue;
+
+      lIndex[lOut++] = a;
+      lIndex[lOut++] = b;
+      lIndex[lOut++] = c;
+   }
+
+   size_t lRemoved = ( lIndex.size() - lOut ) / 3;
+   lIndex.resize( lOut );
+   return lRemoved;
+}
+
+
+/*!
+ * \brief Reorders the triangles for the post transform vertex cache
+ *
+ * Greedy algorithm from Tom Forsyth: always add the triangle with the best score next. The
+ * score of a triangle is the sum of the scores of its vertices, which depend on the position in
+ * a simulated LRU cache and on the number of remaining triangles. Only the triangles of the
+ * vertices in the cache are rescored after every step.
+ */
+template <class T, class I>
+void rMeshOptimizer<T, I>::optimizeVertexCache( _3D_Data<T, I> *_data ) {
+   std::vector<I> &lIndex = _data->vIndex;
+   size_t lNumTriangles = lIndex.size() / 3;
+   size_t lNumVertices = _data->vVertexData.size() / 3;
+
+   if ( lNumTriangles == 0 )
+      return;
+
+   // Triangles per vertex (compressed adjacency lists)
+   std::vector<uint32_t> lRemaining( lNumVertices, 0 );
+   std::vector<size_t> lOffset( lNumVertices + 1, 0 );
+   std::vector<I> lAdjacency( lIndex.size() );
+
+   for ( auto i : lIndex )
+      ++lRemaining[i];
+
+   for ( size_t i = 0; i < lNumVertices; ++i )
+      lOffset[i + 1] = lOffset[i] + lRemaining[i];
+
+   {
+      std::vector<size_t> lFill( lOffset.begin(), lOffset.end() - 1 );
+      for ( size_t i = 0; i < lIndex.size(); ++i )
+         lAdjacency[lFill[lIndex[i]]++] = static_cast<I>( i / 3 );
+   }
+
+   std::vector<uint32_t> lCachePos( lNumVertices, static_cast<uint32_t>( CACHE_SIZE ) );
+   std::vector<float> lVertexScore( lNumVertices );
+   std::vector<bool> lAdded( lNumTriangles, false );
+
+   for ( size_t i = 0; i < lNumVertices; ++i )
+      lVertexScore[i] = vertexScore( CACHE_SIZE, lRemaining[i] );
+
+   size_t lBest = 0;
+   float lBestScore = -1.0f;
+
+   for ( size_t i = 0; i < lNumTriangles; ++i ) {
+      float lScore = lVertexScore[lIndex[i * 3 + 0]] + lVertexScore[lIndex[i * 3 + 1]] +
+                     lVertexScore[lIndex[i * 3 + 2]];
+
+      if ( lScore > lBestScore ) {
+         lBestScore = lScore;
+         lBest = i;
+      }
+   }
+
+   I lCache[CACHE_SIZE + 3];
+   I lNewCache[CACHE_SIZE + 3];
+   size_t lCacheSize = 0;
+   size_t lCursor = 0;
+
+   std::vector<I> lOut;
+   lOut.reserve( lIndex.size() );
+
+   for ( size_t lStep = 0; lStep < lNumTriangles; ++lStep ) {
+      if ( lBestScore < 0.0f ) {
+         // No triangle left in the cache ==> take the next one in the old order
+         while ( lAdded[lCursor] )
+            ++lCursor;
+
+         lBest = lCursor;
+      }
+
+      I const *lTri = &lIndex[lBest * 3];
+      lAdded[lBest] = true;
+      lOut.insert( lOut.end(), lTri, lTri + 3 );
+
+      // Remove the triangle from the (active part of the) adjacency lists
+      for ( size_t i = 0; i < 3; ++i ) {
+         I *lBegin = &lAdjacency[lOffset[lTri[i]]];
+         I *lEnd = lBegin + lRemaining[lTri[i]];
+
+         for ( I *j = lBegin; j != lEnd; ++j ) {
+            if ( static_cast<size_t>( *j ) == lBest ) {
+               *j = *( lEnd - 1 );
+               break;
+            }
+         }
+
+         --lRemaining[lTri[i]];
+      }
+
+      // The new cache: the triangle first, then the old cache content
+      size_t lNewSize = 0;
+      for ( size_t i = 0; i < 3; ++i )
+         lNewCache[lNewSize++] = lTri[i];
+
+      for ( size_t i = 0; i < lCacheSize; ++i )
+         if ( lCache[i] != lTri[0] && lCache[i] != lTri[1] && lCache[i] != lTri[2] )
+            lNewCache[lNewSize++] = lCache[i];
+
+      for ( size_t i = 0; i < lNewSize; ++i ) {
+         I v = lNewCache[i];
+         lCachePos[v] = i < CACHE_SIZE ? static_cast<uint32_t>( i ) : CACHE_SIZE;
+         lVertexScore[v] = vertexScore( lCachePos[v], lRemaining[v] );
+      }
+
+      // Rescore the triangles of the affected vertices and find the best one
+      lBestScore = -1.0f;
+
+      for ( size_t i = 0; i < lNewSize; ++i ) {
+         I v = lNewCache[i];
+         I const *lAdj = &lAdjacency[lOffset[v]];
+
+         for ( uint32_t j = 0; j < lRemaining[v]; ++j ) {
+            I const *lT = &lIndex[lAdj[j] * 3];
+            float lScore = lVertexScore[lT[0]] + lVertexScore[lT[1]] + lVertexScore[lT[2]];
+
+            if ( lScore > lBestScore ) {
+               lBestScore = lScore;
+               lBest = lAdj[j];
+            }
+         }
+      }
+
+      lCacheSize = lNewSize < CACHE_SIZE ? lNewSize : CACHE_SIZE;
+      for ( size_t i = 0; i < lCacheSize; ++i )
+         lCache[i] = lNewCache[i];
+   }
+
+   lIndex.swap( lOut );
+}
+
+
+/*!
+ * \brief Reorders the vertices in the order they are first used by the index buffer
+ *
+ * Vertices that are not used by any triangle are removed.
+ */
+template <class T, class I>
+void rMeshOptimizer<T, I>::optimizeVertexFetch( _3D_Data<T, I> *_data ) {
+   size_t lNumVertices = _data->vVertexData.size() / 3;
+   std::vector<I> lNewIndex( lNumVertices, empty() );
+   size_t lNumNew = 0;
+
+   for ( auto &i : _data->vIndex ) {
+      if ( lNewIndex[i] == empty() )
+         lNewIndex[i] = static_cast<I>( lNumNew++ );
+
+      i = lNewIndex[i];
+   }
+
+   permute( _data->vVertexData, 3, lNewIndex, lNumNew );
+   permute( _data->vNormalesData, 3, lNewIndex, lNumNew );
+   permute( _data->vUVData, 2, lNewIndex, lNumNew );
+}
+
+
+/*!
+ * \brief Calculates the average cache miss ratio for a FIFO vertex cache
+ * \param[in] _index     The triangle list
+ * \param[in] _cacheSize The size of the simulated cache
+ * \returns the number of cache misses per triangle (0.5 is optimal, 3 is the worst case)
+ */
+template <class T, class I>
+double rMeshOptimizer<T, I>::calculateACMR( std::vector<I> const &_index, uint32_t _cacheSize ) {
+   if ( _index.size() < 3 )
+      return 0.0;
+
+   I lMax = *std::max_element( _index.begin(), _index.end() );
+
+   // Vertex is in the cache if it was inserted less than _cacheSize misses ago
+   std::vector<size_t> lInserted( static_cast<size_t>( lMax ) + 1, 0 );
+   size_t lMisses = 0;
+
+   for ( auto i : _index ) {
+      if ( lInserted[i] == 0 || lMisses - lInserted[i] >= _cacheSize ) {
+         ++lMisses;
+         lInserted[i] = lMisses;
+      }
+   }
+
+   return static_cast<double>( lMisses ) / static_cast<double>( _index.size() / 3 );
+}
+}
+}
+
+#endif // R_MESH_OPTIMIZER_HPP
+
+// kate: indent-mode cstyle; indent-width 3; replace-tabs on; line-numbers on;
@@ -0,0 +1,690 @@
+/*!
+ * \file rMeshSimplifier.hpp
+ * \brief \b Classes: \a rMeshSimplifier
+ */
+/*
+ * Copyright (C) 2015 EEnginE project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef R_MESH_SIMPLIFIER_HPP
+#define R_MESH_SIMPLIFIER_HPP
+
+#include "defines.hpp"
+
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <cmath>
+#include <stdint.h>
+
+namespace e_engine {
+
+namespace internal {
+
+/*!
+ * \brief Quadric error metric (Garland / Heckbert) simplification of an index buffer
+ *
+ * The simplifier only collapses vertices onto existing vertices (half edge collapses), so the
+ * simplified index buffers can be rendered with the unchanged vertex data of the base mesh.
+ *
+ * Every call of simplify() continues with the result of the previous call, so a LOD chain is
+ * generated by calling simplify() with decreasing targets.
+ *
+ * Vertices on a border of the mesh can only be collapsed along the border. Vertices sharing
+ * their position with other vertices (normal / UV seams) form a seam group: the whole group is
+ * collapsed onto one neighbor group, every vertex onto the neighbor vertex on its side of the
+ * seam, so that no cracks are opened. Groups which can not be collapsed this way (more than two
+ * vertices, seams on a border) are never removed.
+ */
+template <class T, class I>
+class rMeshSimplifier {
+   static_assert( std::is_floating_point<T>::value, "T must be a floating point type" );
+   static_assert( std::is_unsigned<I>::value, "I must be an unsigned type" );
+
+ public:
+   enum VERTEX_KIND : uint8_t {
+      INTERIOR = 0, //!< Can be collapsed onto every neighbor
+      BORDER,       //!< Can only be collapsed along a border edge
+      SEAM,         //!< Two vertices with one position; collapsed together along the seam
+      LOCKED        //!< Can not be collapsed (seam corners, seams on a border)
+   };
+
+ private:
+   //! Weight of the planes keeping the border in place
+   static const uint32_t BORDER_WEIGHT = 10;
+
+   //! Symmetric 4x4 matrix (a2, b2, c2, ab, ac, bc, ad, bd, cd, d2)
+   struct rQuadric {
+      double v[10] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+      void add( rQuadric const &_q ) {
+         for ( uint32_t i = 0; i < 10; ++i )
+            v[i] += _q.v[i];
+      }
+   };
+
+   struct rCollapse {
+      double vCost;
+      I vFrom;
+      I vTo;
+
+      bool operator<( rCollapse const &_c ) const { return vCost < _c.vCost; }
+   };
+
+   std::vector<T> const &vVertices;
+   std::vector<I> vIndex;
+
+   std::vector<rQuadric> vQuadrics;
+   std::vector<double> vNormals; //!< Area weighted vertex normals of the base mesh
+   std::vector<uint8_t> vKind;         //!< VERTEX_KIND of the seam groups (first vertex only)
+   std::vector<I> vGroup;              //!< First vertex with the same position (seam group)
+   std::vector<I> vNextWedge;          //!< Next vertex of the seam group (circular list)
+   std::vector<uint64_t> vBorderEdges; //!< Sorted edgeKey() of the border edges
+
+   size_t vNumVertices;
+   double vError = 0;
+
+   //! Key of the (undirected) edge _a, _b
+   static uint64_t edgeKey( I _a, I _b ) {
+      if ( _a > _b )
+         std::swap( _a, _b );
+
+      return ( static_cast<uint64_t>( _a ) << 32 ) | static_cast<uint64_t>( _b );
+   }
+
+   static void addPlane( rQuadric &_q, double _a, double _b, double _c, double _d, double _w );
+   double evaluate( rQuadric const &_q, I _vertex ) const;
+   void normal( I _a, I _b, I _c, double *_n ) const;
+
+   void classifyVertices();
+   void findBorderEdges( bool _groups );
+   void computeQuadrics();
+
+   rQuadric groupQuadric( I _group ) const;
+   bool isBorderEdge( I _a, I _b ) const;
+   bool canCollapse( I _from, I _to ) const;
+   bool findPartners( I _from,
+                      I _to,
+                      std::vector<size_t> const &_offset,
+                      std::vector<I> const &_adjacency,
+                      std::vector<std::pair<I, I>> &_pairs ) const;
+   bool isFlipped( I _from,
+                   I _to,
+                   std::vector<size_t> const &_offset,
+                   std::vector<I> const &_adjacency ) const;
+
+   size_t collapsePass( size_t _targetIndexCount );
+
+ public:
+   rMeshSimplifier( std::vector<T> const &_vertices, std::vector<I> const &_index );
+
+   std::vector<I> const &simplify( size_t _targetIndexCount );
+
+   //! The square root of the biggest quadric error of all collapses so far (in model units)
+   double getError() const { return std::sqrt( vError ); }
+   std::vector<I> const &getIndex() const { return vIndex; }
+
+   size_t getNumCollapsible() const;
+};
+
+
+/*!
+ * \brief Prepares the simplification
+ * \param[in] _vertices The positions (3 components per vertex); must outlive the simplifier
+ * \param[in] _index    The triangles
+ */
+template <class T, class I>
+rMeshSimplifier<T, I>::rMeshSimplifier( std::vector<T> const &_vertices,
+                                        std::vector<I> const &_index )
+    : vVertices( _vertices ), vIndex( _index ), vNumVertices( _vertices.size() / 3 ) {
+   vIndex.resize( vIndex.size() - vIndex.size() % 3 );
+
+   for ( auto i : vIndex ) {
+      if ( static_cast<size_t>( i ) >= vNumVertices ) {
+         // Invalid data ==> do not simplify anything
+         vIndex.clear();
+         return;
+      }
+   }
+
+   classifyVertices();
+   computeQuadrics();
+}
+
+template <class T, class I>
+void rMeshSimplifier<T, I>::addPlane(
+      rQuadric &_q, double _a, double _b, double _c, double _d, double _w ) {
+   _q.v[0] += _w * _a * _a;
+   _q.v[1] += _w * _b * _b;
+   _q.v[2] += _w * _c * _c;
+   _q.v[3] += _w * _a * _b;
+   _q.v[4] += _w * _a * _c;
+   _q.v[5] += _w * _b * _c;
+   _q.v[6] += _w * _a * _d;
+   _q.v[7] += _w * _b * _d;
+   _q.v[8] += _w * _c * _d;
+   _q.v[9] += _w * _d * _d;
+}
+
+//! Error of the quadric at the position of _vertex
+template <class T, class I>
+double rMeshSimplifier<T, I>::evaluate( rQuadric const &_q, I _vertex ) const {
+   double x = vVertices[_vertex * 3 + 0];
+   double y = vVertices[_vertex * 3 + 1];
+   double z = vVertices[_vertex * 3 + 2];
+
+   double lError = _q.v[0] * x * x + _q.v[1] * y * y + _q.v[2] * z * z +
+                   2 * ( _q.v[3] * x * y + _q.v[4] * x * z + _q.v[5] * y * z ) +
+                   2 * ( _q.v[6] * x + _q.v[7] * y + _q.v[8] * z ) + _q.v[9];
+
+   // Rounding errors
+   return lError < 0 ? 0 : lError;
+}
+
+//! The (not normalized) normal of the triangle _a, _b, _c
+template <class T, class I>
+void rMeshSimplifier<T, I>::normal( I _a, I _b, I _c, double *_n ) const {
+   double lE1[3], lE2[3];
+
+   for ( size_t j = 0; j < 3; ++j ) {
+      lE1[j] = static_cast<double>( vVertices[_b * 3 + j] ) - vVertices[_a * 3 + j];
+      lE2[j] = static_cast<double>( vVertices[_c * 3 + j] ) - vVertices[_a * 3 + j];
+   }
+
+   _n[0] = lE1[1] * lE2[2] - lE1[2] * lE2[1];
+   _n[1] = lE1[2] * lE2[0] - lE1[0] * lE2[2];
+   _n[2] = lE1[0] * lE2[1] - lE1[1] * lE2[0];
+}
+
+/*!
+ * \brief Groups vertices with the same position and classifies the groups
+ *
+ * Single vertices are INTERIOR or (on a border edge) BORDER, pairs are SEAM. Bigger groups and
+ * pairs on a border are LOCKED.
+ */
+template <class T, class I>
+void rMeshSimplifier<T, I>::classifyVertices() {
+   vKind.assign( vNumVertices, INTERIOR );
+   vGroup.resize( vNumVertices );
+   vNextWedge.resize( vNumVertices );
+
+   // Vertices with the same position (but other normals / UVs)
+   std::vector<I> lSorted( vNumVertices );
+   for ( size_t i = 0; i < vNumVertices; ++i )
+      lSorted[i] = static_cast<I>( i );
+
+   T const *lPos = vVertices.data();
+   auto lLess = [lPos]( I _a, I _b ) {
+      return std::lexicographical_compare(
+            lPos + _a * 3, lPos + _a * 3 + 3, lPos + _b * 3, lPos + _b * 3 + 3 );
+   };
+
+   std::sort( lSorted.begin(), lSorted.end(), lLess );
+
+   for ( size_t i = 0; i < vNumVertices; ) {
+      size_t lEnd = i + 1;
+      while ( lEnd < vNumVertices && !lLess( lSorted[i], lSorted[lEnd] ) )
+         ++lEnd;
+
+      for ( size_t j = i; j < lEnd; ++j ) {
+         vGroup[lSorted[j]] = lSorted[i];
+         vNextWedge[lSorted[j]] = lSorted[j + 1 < lEnd ? j + 1 : i];
+      }
+
+      if ( lEnd - i == 2 )
+         vKind[lSorted[i]] = SEAM;
+      else if ( lEnd - i > 2 )
+         vKind[lSorted[i]] = LOCKED;
+
+      i = lEnd;
+   }
+
+   findBorderEdges( true );
+
+   for ( auto i : vBorderEdges ) {
+      for ( I j : {static_cast<I>( i >> 32 ), static_cast<I>( i & 0xFFFFFFFF )} ) {
+         if ( vKind[j] == INTERIOR )
+            vKind[j] = BORDER;
+         else if ( vKind[j] == SEAM )
+            vKind[j] = LOCKED;
+      }
+   }
+}
+
+/*!
+ * \brief Finds all edges of the current index which are only used by one triangle
+ * \param[in] _groups Find the edges between seam groups (else between vertices, so the seams are
+ *                    also border edges)
+ */
+template <class T, class I>
+void rMeshSimplifier<T, I>::findBorderEdges( bool _groups ) {
+   std::vector<uint64_t> lEdges;
+   lEdges.reserve( vIndex.size() );
+
+   for ( size_t i = 0; i < vIndex.size(); i += 3 ) {
+      for ( size_t j = 0; j < 3; ++j ) {
+         I a = vIndex[i + j];
+         I b = vIndex[i + ( j + 1 ) % 3];
+
+         if ( _groups ) {
+            a = vGroup[a];
+            b = vGroup[b];
+         }
+
+         if ( a != b )
+            lEdges.push_back( edgeKey( a, b ) );
+      }
+   }
+
+   std::sort( lEdges.begin(), lEdges.end() );
+
+   vBorderEdges.clear();
+
+   for ( size_t i = 0; i < lEdges.size(); ) {
+      size_t lEnd = i + 1;
+      while ( lEnd < lEdges.size() && lEdges[lEnd] == lEdges[i] )
+         ++lEnd;
+
+      if ( lEnd - i == 1 )
+         vBorderEdges.push_back( lEdges[i] );
+
+      i = lEnd;
+   }
+}
+
+/*!
+ * \brief Sums up the planes of all triangles (and the border planes) for every vertex
+ */
+template <class T, class I>
+void rMeshSimplifier<T, I>::computeQuadrics() {
+   vQuadrics.assign( vNumVertices, rQuadric() );
+   vNormals.assign( vNumVertices * 3, 0 );
+
+   // The planes along the seams keep them in place like the borders
+   findBorderEdges( false );
+
+   for ( size_t i = 0; i < vIndex.size(); i += 3 ) {
+      I lTri[3] = {vIndex[i + 0], vIndex[i + 1], vIndex[i + 2]};
+      double n[3];
+
+      normal( lTri[0], lTri[1], lTri[2], n );
+
+      for ( size_t j = 0; j < 3; ++j )
+         for ( size_t k = 0; k < 3; ++k )
+            vNormals[lTri[j] * 3 + k] += n[k];
+      double lLength = std::sqrt( n[0] * n[0] + n[1] * n[1] + n[2] * n[2] );
+
+      if ( lLength <= 0 )
+         continue;
+
+      n[0] /= lLength;
+      n[1] /= lLength;
+      n[2] /= lLength;
+
+      double d = -( n[0] * vVertices[lTri[0] * 3 + 0] + n[1] * vVertices[lTri[0] * 3 + 1] +
+                    n[2] * vVertices[lTri[0] * 3 + 2] );
+
+      rQuadric lQ;
+      addPlane( lQ, n[0], n[1], n[2], d, 1 );
+
+      for ( size_t j = 0; j < 3; ++j ) {
+         vQuadrics[lTri[j]].add( lQ );
+
+         I a = lTri[j];
+         I b = lTri[( j + 1 ) % 3];
+
+         if ( !std::binary_search( vBorderEdges.begin(), vBorderEdges.end(), edgeKey( a, b ) ) )
+            continue;
+
+         // Plane through the border edge, perpendicular to the triangle
+         double e[3];
+         for ( size_t k = 0; k < 3; ++k )
+            e[k] = static_cast<double>( vVertices[b * 3 + k] ) - vVertices[a * 3 + k];
+
+         double p[3] = {e[1] * n[2] - e[2] * n[1], e[2] * n[0] - e[0] * n[2],
+                        e[0] * n[1] - e[1] * n[0]};
+         double lPLength = std::sqrt( p[0] * p[0] + p[1] * p[1] + p[2] * p[2] );
+
+         if ( lPLength <= 0 )
+            continue;
+
+         p[0] /= lPLength;
+         p[1] /= lPLength;
+         p[2] /= lPLength;
+
+         double pd = -( p[0] * vVertices[a * 3 + 0] + p[1] * vVertices[a * 3 + 1] +
+                        p[2] * vVertices[a * 3 + 2] );
+
+         rQuadric lBorder;
+         addPlane( lBorder, p[0], p[1], p[2], pd, BORDER_WEIGHT );
+         vQuadrics[a].add( lBorder );
+         vQuadrics[b].add( lBorder );
+      }
+   }
+}
+
+//! The sum of the quadrics of all vertices of a seam group
+template <class T, class I>
+typename rMeshSimplifier<T, I>::rQuadric rMeshSimplifier<T, I>::groupQuadric( I _group ) const {
+   rQuadric lQ = vQuadrics[_group];
+
+   for ( I i = vNextWedge[_group]; i != _group; i = vNextWedge[i] )
+      lQ.add( vQuadrics[i] );
+
+   return lQ;
+}
+
+template <class T, class I>
+bool rMeshSimplifier<T, I>::isBorderEdge( I _a, I _b ) const {
+   return std::binary_search( vBorderEdges.begin(), vBorderEdges.end(), edgeKey( _a, _b ) );
+}
+
+//! Checks the kinds of the seam groups _from and _to (see findPartners() for the seams)
+template <class T, class I>
+bool rMeshSimplifier<T, I>::canCollapse( I _from, I _to ) const {
+   switch ( vKind[_from] ) {
+      case INTERIOR:
+      case SEAM:
+         return true;
+      case BORDER:
+         return vKind[_to] != INTERIOR && isBorderEdge( _from, _to );
+      default:
+         return false;
+   }
+}
+
+/*!
+ * \brief Finds the target vertex in the seam group _to for every vertex of the seam group _from
+ *
+ * The target is the (only) vertex of _to connected to the vertex, so every vertex stays on its
+ * side of the seam. Unused vertices are skipped.
+ *
+ * \returns false if a vertex has no or more than one target
+ */
+template <class T, class I>
+bool rMeshSimplifier<T, I>::findPartners( I _from,
+                                          I _to,
+                                          std::vector<size_t> const &_offset,
+                                          std::vector<I> const &_adjacency,
+                                          std::vector<std::pair<I, I>> &_pairs ) const {
+   _pairs.clear();
+   I lWedge = _from;
+
+   do {
+      I lPartner = lWedge; // Never in _to
+
+      for ( size_t i = _offset[lWedge]; i < _offset[lWedge + 1]; ++i ) {
+         size_t lTri = static_cast<size_t>( _adjacency[i] ) * 3;
+
+         for ( size_t j = 0; j < 3; ++j ) {
+            I lVert = vIndex[lTri + j];
+
+            if ( vGroup[lVert] != _to )
+               continue;
+
+            if ( lPartner != lWedge && lPartner != lVert )
+               return false;
+
+            lPartner = lVert;
+         }
+      }
+
+      if ( _offset[lWedge] != _offset[lWedge + 1] ) {
+         if ( lPartner == lWedge )
+            return false;
+
+         _pairs.emplace_back( lWedge, lPartner );
+      }
+
+      lWedge = vNextWedge[lWedge];
+   } while ( lWedge != _from );
+
+   return !_pairs.empty();
+}
+
+/*!
+ * \brief Checks if moving _from to _to flips (or nearly flips) one of the triangles of _from
+ */
+template <class T, class I>
+bool rMeshSimplifier<T, I>::isFlipped( I _from,
+                                       I _to,
+                                       std::vector<size_t> const &_offset,
+                                       std::vector<I> const &_adjacency ) const {
+   for ( size_t i = _offset[_from]; i < _offset[_from + 1]; ++i ) {
+      size_t lTri = static_cast<size_t>( _adjacency[i] ) * 3;
+      I lOld[3] = {vIndex[lTri + 0], vIndex[lTri + 1], vIndex[lTri + 2]};
+      I lNew[3];
+
+      bool lRemoved = false;
+      for ( size_t j = 0; j < 3; ++j ) {
+         lNew[j] = lOld[j] == _from ? _to : lOld[j];
+         lRemoved = lRemoved || lOld[j] == _to;
+      }
+
+      // This triangle will be removed
+      if ( lRemoved )
+         continue;
+
+      double lN1[3], lN2[3];
+      normal( lOld[0], lOld[1], lOld[2], lN1 );
+      normal( lNew[0], lNew[1], lNew[2], lN2 );
+
+      double lDot = lN1[0] * lN2[0] + lN1[1] * lN2[1] + lN1[2] * lN2[2];
+      double lLen1 = std::sqrt( lN1[0] * lN1[0] + lN1[1] * lN1[1] + lN1[2] * lN1[2] );
+      double lLen2 = std::sqrt( lN2[0] * lN2[0] + lN2[1] * lN2[1] + lN2[2] * lN2[2] );
+
+      // Also rejects rotations of more than ~75 degrees and degenerated triangles
+      if ( lDot <= 0.25 * lLen1 * lLen2 )
+         return true;
+
+      // Many small rotations can still flip the triangle relative to the base mesh
+      double lRef[3] = {0, 0, 0};
+      for ( size_t j = 0; j < 3; ++j )
+         for ( size_t k = 0; k < 3; ++k )
+            lRef[k] += vNormals[lNew[j] * 3 + k];
+
+      if ( lN2[0] * lRef[0] + lN2[1] * lRef[1] + lN2[2] * lRef[2] <= 0 )
+         return true;
+   }
+
+   return false;
+}
+
+/*!
+ * \brief Collapses the cheapest independent edges of the current index
+ *
+ * All vertices of the triangles around a collapsed vertex are locked until the next pass, so
+ * that the quadrics and the flip tests of a pass stay valid.
+ *
+ * \returns the number of collapses
+ */
+template <class T, class I>
+size_t rMeshSimplifier<T, I>::collapsePass( size_t _targetIndexCount ) {
+   size_t lNumTriangles = vIndex.size() / 3;
+   size_t lTargetTriangles = _targetIndexCount / 3;
+
+   findBorderEdges( true );
+
+   // Candidates (the cheaper direction of every edge between two seam groups)
+   std::vector<uint64_t> lEdges;
+   lEdges.reserve( vIndex.size() );
+
+   for ( size_t i = 0; i < vIndex.size(); i += 3 ) {
+      for ( size_t j = 0; j < 3; ++j ) {
+         I a = vGroup[vIndex[i + j]];
+         I b = vGroup[vIndex[i + ( j + 1 ) % 3]];
+
+         if ( a != b )
+            lEdges.push_back( edgeKey( a, b ) );
+      }
+   }
+
+   std::sort( lEdges.begin(), lEdges.end() );
+   lEdges.erase( std::unique( lEdges.begin(), lEdges.end() ), lEdges.end() );
+
+   std::vector<rCollapse> lCandidates;
+   lCandidates.reserve( lEdges.size() );
+
+   for ( auto i : lEdges ) {
+      I a = static_cast<I>( i >> 32 );
+      I b = static_cast<I>( i & 0xFFFFFFFF );
+
+      bool lAB = canCollapse( a, b );
+      bool lBA = canCollapse( b, a );
+
+      if ( !lAB && !lBA )
+         continue;
+
+      rQuadric lQ = groupQuadric( a );
+      lQ.add( groupQuadric( b ) );
+
+      double lCostAB = lAB ? evaluate( lQ, b ) : 0;
+      double lCostBA = lBA ? evaluate( lQ, a ) : 0;
+
+      if ( lAB && ( !lBA || lCostAB <= lCostBA ) )
+         lCandidates.push_back( {lCostAB, a, b} );
+      else
+         lCandidates.push_back( {lCostBA, b, a} );
+   }
+
+   std::sort( lCandidates.begin(), lCandidates.end() );
+
+   // Triangles per vertex (compressed adjacency lists)
+   std::vector<size_t> lOffset( vNumVertices + 1, 0 );
+   std::vector<I> lAdjacency( vIndex.size() );
+
+   for ( auto i : vIndex )
+      ++lOffset[i + 1];
+
+   for ( size_t i = 0; i < vNumVertices; ++i )
+      lOffset[i + 1] += lOffset[i];
+
+   {
+      std::vector<size_t> lFill( lOffset.begin(), lOffset.end() - 1 );
+      for ( size_t i = 0; i < vIndex.size(); ++i )
+         lAdjacency[lFill[vIndex[i]]++] = static_cast<I>( i / 3 );
+   }
+
+   std::vector<I> lRemap( vNumVertices );
+   for ( size_t i = 0; i < vNumVertices; ++i )
+      lRemap[i] = static_cast<I>( i );
+
+   std::vector<uint8_t> lLocked( vNumVertices, 0 ); // Per seam group
+   std::vector<std::pair<I, I>> lPairs;
+   size_t lNumCollapses = 0;
+
+   for ( auto const &c : lCandidates ) {
+      if ( lNumTriangles <= lTargetTriangles )
+         break;
+
+      if ( lLocked[c.vFrom] || lLocked[c.vTo] )
+         continue;
+
+      if ( !findPartners( c.vFrom, c.vTo, lOffset, lAdjacency, lPairs ) )
+         continue;
+
+      bool lFlipped = false;
+      for ( auto const &p : lPairs )
+         lFlipped = lFlipped || isFlipped( p.first, p.second, lOffset, lAdjacency );
+
+      if ( lFlipped )
+         continue;
+
+      vError = std::max( vError, c.vCost );
+      ++lNumCollapses;
+
+      for ( auto const &p : lPairs ) {
+         lRemap[p.first] = p.second;
+         vQuadrics[p.second].add( vQuadrics[p.first] );
+
+         for ( size_t i = lOffset[p.first]; i < lOffset[p.first + 1]; ++i ) {
+            size_t lTri = static_cast<size_t>( lAdjacency[i] ) * 3;
+            bool lRemoved = false;
+
+            for ( size_t j = 0; j < 3; ++j ) {
+               lLocked[vGroup[vIndex[lTri + j]]] = 1;
+               lRemoved = lRemoved || vIndex[lTri + j] == p.second;
+            }
+
+            if ( lRemoved )
+               --lNumTriangles;
+         }
+      }
+   }
+
+   if ( lNumCollapses == 0 )
+      return 0;
+
+   // Apply the collapses and remove the degenerated triangles
+   size_t lOut = 0;
+   for ( size_t i = 0; i < vIndex.size(); i += 3 ) {
+      I a = lRemap[vIndex[i + 0]];
+      I b = lRemap[vIndex[i + 1]];
+      I c = lRemap[vIndex[i + 2]];
+
+      if ( a == b || b == c || a == c )
+         continue;
+
+      vIndex[lOut++] = a;
+      vIndex[lOut++] = b;
+      vIndex[lOut++] = c;
+   }
+
+   vIndex.resize( lOut );
+   return lNumCollapses;
+}
+
+/*!
+ * \brief Returns the number of seam groups which can be collapsed
+ *
+ * Every collapse removes at most two triangles, so this limits how far the mesh can be simplified.
+ * Meshes made of seams (e.g. flat shaded meshes) have almost no collapsible groups.
+ */
+template <class T, class I>
+size_t rMeshSimplifier<T, I>::getNumCollapsible() const {
+   size_t lCount = 0;
+
+   for ( size_t i = 0; i < vGroup.size(); ++i )
+      if ( vGroup[i] == static_cast<I>( i ) && vKind[i] != LOCKED )
+         ++lCount;
+
+   return lCount;
+}
+
+/*!
+ * \brief Simplifies the current index until it has at most _targetIndexCount indexes
+ *
+ * The result can have more indexes if no more edges can be collapsed (borders, seams or
+ * flipped triangles).
+ *
+ * \returns the simplified index
+ */
+template <class T, class I>
+std::vector<I> const &rMeshSimplifier<T, I>::simplify( size_t _targetIndexCount ) {
+   while ( vIndex.size() > _targetIndexCount ) {
+      if ( collapsePass( _targetIndexCount ) == 0 )
+         break;
+   }
+
+   return vIndex;
+}
+
+}
+}
+
+#endif // R_MESH_SIMPLIFIER_HPP
+
+// kate: indent-mode cstyle; indent-width 3; replace-tabs on; line-numbers on;
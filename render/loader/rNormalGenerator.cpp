@@ -0,0 +1,414 @@
+/*!
+ * \file rNormalGenerator.cpp
+ * \brief \b Classes: \a none (smooth vertex normal generation)
+ */
+/*
+ * Copyright (C) 2015 EEnginE project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rNormalGenerator.hpp"
+#include "rVertexSIMD.hpp"
+
+#include <vector>
+#include <thread>
+#include <functional>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+#include <string.h>
+#include <stdint.h>
+
+namespace e_engine {
+
+namespace internal {
+
+namespace {
+
+//! Less triangles are not worth starting a thread
+const size_t MIN_TRIANGLES_PER_THREAD = 32768;
+
+/*!
+ * \brief Maps every vertex to the first vertex with the same position
+ *
+ * Vertices which only differ in other attributes (UV seams) get the same normal this way. The
+ * positions are compared bitwise (-0.0 == 0.0).
+ */
+void findEqualPositions( GLfloat const *_vert, size_t _num, std::vector<GLuint> &_out ) {
+   size_t lSize = 16;
+   while ( lSize < _num + _num / 3 )
+      lSize <<= 1;
+
+   std::vector<GLuint> lTable( lSize, std::numeric_limits<GLuint>::max() );
+   size_t lMask = lSize - 1;
+
+   auto lBits = []( GLfloat _val ) {
+      uint32_t lRet;
+      _val += 0.0f; // -0.0 + 0.0 == 0.0
+      memcpy( &lRet, &_val, sizeof( lRet ) );
+      return lRet;
+   };
+
+   _out.resize( _num );
+
+   for ( size_t i = 0; i < _num; ++i ) {
+      uint32_t lX = lBits( _vert[i * 3 + 0] ), lY = lBits( _vert[i * 3 + 1] ),
+               lZ = lBits( _vert[i * 3 + 2] );
+      uint64_t lHash = lX * 0x9E3779B97F4A7C15ULL ^ lY * 0xC2B2AE3D27D4EB4FULL ^
+                       lZ * 0x165667B19E3779F9ULL;
+
+      for ( size_t lSlot = static_cast<size_t>( lHash >> 32 ) & lMask;;
+            lSlot = ( lSlot + 1 ) & lMask ) {
+         GLuint lIndex = lTable[lSlot];
+
+         if ( lIndex == std::numeric_limits<GLuint>::max() ) {
+            lTable[lSlot] = _out[i] = static_cast<GLuint>( i );
+            break;
+         }
+
+         GLfloat const *lPos = _vert + lIndex * 3;
+         if ( lBits( lPos[0] ) == lX && lBits( lPos[1] ) == lY && lBits( lPos[2] ) == lZ ) {
+            _out[i] = lIndex;
+            break;
+         }
+      }
+   }
+}
+
+/*!
+ * \brief Adds the weighted face normals of the triangles [_begin, _end) to _acc (scalar)
+ */
+void accumulateScalar( GLfloat const *_vert,
+                       GLuint const *_index,
+                       GLuint const *_pos,
+                       size_t _begin,
+                       size_t _end,
+                       NORMAL_WEIGHTING _weighting,
+                       GLfloat *_acc ) {
+   for ( size_t t = _begin; t < _end; ++t ) {
+      GLfloat const *lP0 = _vert + _index[t * 3 + 0] * 3;
+      GLfloat const *lP1 = _vert + _index[t * 3 + 1] * 3;
+      GLfloat const *lP2 = _vert + _index[t * 3 + 2] * 3;
+
+      GLfloat lE1[3] = {lP1[0] - lP0[0], lP1[1] - lP0[1], lP1[2] - lP0[2]};
+      GLfloat lE2[3] = {lP2[0] - lP0[0], lP2[1] - lP0[1], lP2[2] - lP0[2]};
+      GLfloat lN[3] = {lE1[1] * lE2[2] - lE1[2] * lE2[1],
+                       lE1[2] * lE2[0] - lE1[0] * lE2[2],
+                       lE1[0] * lE2[1] - lE1[1] * lE2[0]};
+
+      // The length of the cross product is twice the area
+      GLfloat lW[3] = {1.0f, 1.0f, 1.0f};
+
+      if ( _weighting == ANGLE_WEIGHTED ) {
+         GLfloat lLength = std::sqrt( lN[0] * lN[0] + lN[1] * lN[1] + lN[2] * lN[2] );
+         if ( lLength == 0.0f )
+            continue;
+
+         GLfloat lE3[3] = {lP2[0] - lP1[0], lP2[1] - lP1[1], lP2[2] - lP1[2]};
+         GLfloat lL1 = std::sqrt( lE1[0] * lE1[0] + lE1[1] * lE1[1] + lE1[2] * lE1[2] );
+         GLfloat lL2 = std::sqrt( lE2[0] * lE2[0] + lE2[1] * lE2[1] + lE2[2] * lE2[2] );
+         GLfloat lL3 = std::sqrt( lE3[0] * lE3[0] + lE3[1] * lE3[1] + lE3[2] * lE3[2] );
+
+         GLfloat lDot12 = lE1[0] * lE2[0] + lE1[1] * lE2[1] + lE1[2] * lE2[2];
+         GLfloat lDot13 = lE1[0] * lE3[0] + lE1[1] * lE3[1] + lE1[2] * lE3[2];
+         GLfloat lDot23 = lE2[0] * lE3[0] + lE2[1] * lE3[1] + lE2[2] * lE3[2];
+         GLfloat lCos[3] = {
+               lDot12 / ( lL1 * lL2 ), -lDot13 / ( lL1 * lL3 ), lDot23 / ( lL2 * lL3 )};
+
+         for ( size_t j = 0; j < 3; ++j ) {
+            // NaN (degenerated edge) ==> angle 0
+            GLfloat lC = std::isnan( lCos[j] ) ? 1.0f : lCos[j];
+            lW[j] = std::acos( std::max( std::min( lC, 1.0f ), -1.0f ) ) / lLength;
+         }
+      }
+
+      for ( size_t j = 0; j < 3; ++j ) {
+         GLfloat *lOut = _acc + _pos[_index[t * 3 + j]] * 3;
+         lOut[0] += lN[0] * lW[j];
+         lOut[1] += lN[1] * lW[j];
+         lOut[2] += lN[2] * lW[j];
+      }
+   }
+}
+
+#if E_SIMD_SSE2
+
+/*!
+ * \brief acos for 4 values in [-1, 1] (Abramowitz & Stegun 4.4.45, error < 7e-5)
+ */
+inline __m128 acosPS( __m128 _x ) {
+   __m128 lAbs = _mm_andnot_ps( _mm_set1_ps( -0.0f ), _x );
+   __m128 lPoly = _mm_set1_ps( -0.0187293f );
+
+   lPoly = _mm_add_ps( _mm_mul_ps( lPoly, lAbs ), _mm_set1_ps( 0.0742610f ) );
+   lPoly = _mm_add_ps( _mm_mul_ps( lPoly, lAbs ), _mm_set1_ps( -0.2121144f ) );
+   lPoly = _mm_add_ps( _mm_mul_ps( lPoly, lAbs ), _mm_set1_ps( 1.5707288f ) );
+
+   __m128 lRes = _mm_mul_ps( _mm_sqrt_ps( _mm_sub_ps( _mm_set1_ps( 1.0f ), lAbs ) ), lPoly );
+   __m128 lNeg = _mm_cmplt_ps( _x, _mm_setzero_ps() );
+
+   // acos( -x ) == pi - acos( x )
+   return _mm_or_ps( _mm_and_ps( lNeg, _mm_sub_ps( _mm_set1_ps( 3.14159265f ), lRes ) ),
+                     _mm_andnot_ps( lNeg, lRes ) );
+}
+
+//! The angle between 2 edges from their dot product and lengths (0 for degenerated edges)
+inline __m128 cornerAngle( __m128 _dot, __m128 _l1, __m128 _l2 ) {
+   __m128 lCos = _mm_div_ps( _dot, _mm_mul_ps( _l1, _l2 ) );
+
+   // _mm_min_ps returns the second operand for NaN ==> acos( 1 ) == 0
+   lCos = _mm_max_ps( _mm_min_ps( lCos, _mm_set1_ps( 1.0f ) ), _mm_set1_ps( -1.0f ) );
+   return acosPS( lCos );
+}
+
+inline __m128 dot( __m128 _x1, __m128 _y1, __m128 _z1, __m128 _x2, __m128 _y2, __m128 _z2 ) {
+   return _mm_add_ps( _mm_add_ps( _mm_mul_ps( _x1, _x2 ), _mm_mul_ps( _y1, _y2 ) ),
+                      _mm_mul_ps( _z1, _z2 ) );
+}
+
+/*!
+ * \brief Adds the weighted face normals of 4 triangles at once to _acc
+ *
+ * The positions are gathered into x, y and z registers; the normals and weights are computed in
+ * parallel and added to the vertices with scalar code.
+ *
+ * \returns the first triangle which was not processed
+ */
+size_t accumulateSSE2( GLfloat const *_vert,
+                       GLuint const *_index,
+                       GLuint const *_pos,
+                       size_t _begin,
+                       size_t _end,
+                       NORMAL_WEIGHTING _weighting,
+                       GLfloat *_acc ) {
+   alignas( 16 ) GLfloat lN[3][4];
+   alignas( 16 ) GLfloat lW[3][4];
+
+   for ( size_t j = 0; j < 3; ++j )
+      _mm_store_ps( lW[j], _mm_set1_ps( 1.0f ) );
+
+   size_t t = _begin;
+
+   for ( ; t + 4 <= _end; t += 4 ) {
+      GLuint const *lI = _index + t * 3;
+
+      auto lGather = [&]( size_t _corner, size_t _comp ) {
+         return _mm_setr_ps( _vert[lI[_corner + 0] * 3 + _comp],
+                             _vert[lI[_corner + 3] * 3 + _comp],
+                             _vert[lI[_corner + 6] * 3 + _comp],
+                             _vert[lI[_corner + 9] * 3 + _comp] );
+      };
+
+      __m128 lP0X = lGather( 0, 0 ), lP0Y = lGather( 0, 1 ), lP0Z = lGather( 0, 2 );
+      __m128 lP1X = lGather( 1, 0 ), lP1Y = lGather( 1, 1 ), lP1Z = lGather( 1, 2 );
+      __m128 lP2X = lGather( 2, 0 ), lP2Y = lGather( 2, 1 ), lP2Z = lGather( 2, 2 );
+
+      __m128 lE1X = _mm_sub_ps( lP1X, lP0X ), lE1Y = _mm_sub_ps( lP1Y, lP0Y );
+      __m128 lE1Z = _mm_sub_ps( lP1Z, lP0Z );
+      __m128 lE2X = _mm_sub_ps( lP2X, lP0X ), lE2Y = _mm_sub_ps( lP2Y, lP0Y );
+      __m128 lE2Z = _mm_sub_ps( lP2Z, lP0Z );
+
+      __m128 lNX = _mm_sub_ps( _mm_mul_ps( lE1Y, lE2Z ), _mm_mul_ps( lE1Z, lE2Y ) );
+      __m128 lNY = _mm_sub_ps( _mm_mul_ps( lE1Z, lE2X ), _mm_mul_ps( lE1X, lE2Z ) );
+      __m128 lNZ = _mm_sub_ps( _mm_mul_ps( lE1X, lE2Y ), _mm_mul_ps( lE1Y, lE2X ) );
+
+      _mm_store_ps( lN[0], lNX );
+      _mm_store_ps( lN[1], lNY );
+      _mm_store_ps( lN[2], lNZ );
+
+      if ( _weighting == ANGLE_WEIGHTED ) {
+         __m128 lE3X = _mm_sub_ps( lP2X, lP1X ), lE3Y = _mm_sub_ps( lP2Y, lP1Y );
+         __m128 lE3Z = _mm_sub_ps( lP2Z, lP1Z );
+
+         __m128 lL1 = _mm_sqrt_ps( dot( lE1X, lE1Y, lE1Z, lE1X, lE1Y, lE1Z ) );
+         __m128 lL2 = _mm_sqrt_ps( dot( lE2X, lE2Y, lE2Z, lE2X, lE2Y, lE2Z ) );
+         __m128 lL3 = _mm_sqrt_ps( dot( lE3X, lE3Y, lE3Z, lE3X, lE3Y, lE3Z ) );
+         __m128 lLength = _mm_sqrt_ps( dot( lNX, lNY, lNZ, lNX, lNY, lNZ ) );
+
+         // 1 / length of the normal (0 for degenerated triangles)
+         __m128 lInv = _mm_and_ps( _mm_cmpgt_ps( lLength, _mm_setzero_ps() ),
+                                   _mm_div_ps( _mm_set1_ps( 1.0f ), lLength ) );
+
+         __m128 lDot12 = dot( lE1X, lE1Y, lE1Z, lE2X, lE2Y, lE2Z );
+         __m128 lDot13 = dot( lE1X, lE1Y, lE1Z, lE3X, lE3Y, lE3Z );
+         __m128 lDot23 = dot( lE2X, lE2Y, lE2Z, lE3X, lE3Y, lE3Z );
+
+         lDot13 = _mm_xor_ps( lDot13, _mm_set1_ps( -0.0f ) );
+
+         _mm_store_ps( lW[0], _mm_mul_ps( cornerAngle( lDot12, lL1, lL2 ), lInv ) );
+         _mm_store_ps( lW[1], _mm_mul_ps( cornerAngle( lDot13, lL1, lL3 ), lInv ) );
+         _mm_store_ps( lW[2], _mm_mul_ps( cornerAngle( lDot23, lL2, lL3 ), lInv ) );
+      }
+
+      for ( size_t k = 0; k < 4; ++k ) {
+         for ( size_t j = 0; j < 3; ++j ) {
+            GLfloat *lOut = _acc + _pos[lI[k * 3 + j]] * 3;
+            lOut[0] += lN[0][k] * lW[j][k];
+            lOut[1] += lN[1][k] * lW[j][k];
+            lOut[2] += lN[2][k] * lW[j][k];
+         }
+      }
+   }
+
+   return t;
+}
+
+#endif
+
+void accumulate( GLfloat const *_vert,
+                 GLuint const *_index,
+                 GLuint const *_pos,
+                 size_t _begin,
+                 size_t _end,
+                 NORMAL_WEIGHTING _weighting,
+                 GLfloat *_acc ) {
+#if E_SIMD_SSE2
+   _begin = accumulateSSE2( _vert, _index, _pos, _begin, _end, _weighting, _acc );
+#endif
+
+   accumulateScalar( _vert, _index, _pos, _begin, _end, _weighting, _acc );
+}
+
+/*!
+ * \brief Normalizes the vectors [_begin, _end) (4 at once with SSE2; null vectors stay null)
+ */
+void normalize( GLfloat *_vec, size_t _begin, size_t _end ) {
+   size_t i = _begin;
+
+#if E_SIMD_SSE2
+   __m128 lX, lY, lZ;
+
+   for ( ; i + 4 <= _end; i += 4 ) {
+      loadXYZ( _vec + i * 3, lX, lY, lZ );
+
+      __m128 lLength = _mm_sqrt_ps( dot( lX, lY, lZ, lX, lY, lZ ) );
+      __m128 lInv = _mm_and_ps( _mm_cmpgt_ps( lLength, _mm_setzero_ps() ),
+                                _mm_div_ps( _mm_set1_ps( 1.0f ), lLength ) );
+
+      lX = _mm_mul_ps( lX, lInv );
+      lY = _mm_mul_ps( lY, lInv );
+      lZ = _mm_mul_ps( lZ, lInv );
+      storeXYZ( _vec + i * 3, lX, lY, lZ );
+   }
+#endif
+
+   for ( ; i < _end; ++i ) {
+      GLfloat *lV = _vec + i * 3;
+      GLfloat lLength = std::sqrt( lV[0] * lV[0] + lV[1] * lV[1] + lV[2] * lV[2] );
+
+      if ( lLength > 0.0f )
+         for ( size_t j = 0; j < 3; ++j )
+            lV[j] /= lLength;
+   }
+}
+}
+
+/*!
+ * \brief Calculates smooth vertex normals
+ *
+ * Every vertex gets the weighted sum of the face normals of all triangles using its position
+ * (vertices with equal positions are treated as one vertex, so UV seams are not visible).
+ *
+ * The triangles are split between _numThreads threads, each accumulating into its own buffer.
+ * The buffers are then summed and normalized in parallel over the vertices. Plain threads are
+ * used (not the loader uWorkerPool), because this function itself runs in a loader job.
+ *
+ * \param[in]  _vertices    Pointer to _numVertices * 3 floats
+ * \param[in]  _numVertices Number of vertices
+ * \param[in]  _index       Triangle indexes
+ * \param[in]  _numIndex    Number of indexes
+ * \param[out] _normals     Pointer to _numVertices * 3 floats for the normals
+ * \param[in]  _weighting   How the face normals are weighted
+ * \param[in]  _numThreads  Max number of threads (0: hardware concurrency)
+ *
+ * \note Vertices not used by any (non degenerated) triangle get a null normal
+ */
+void calculateNormals( GLfloat const *_vertices,
+                       size_t _numVertices,
+                       GLuint const *_index,
+                       size_t _numIndex,
+                       GLfloat *_normals,
+                       NORMAL_WEIGHTING _weighting,
+                       unsigned int _numThreads ) {
+   if ( !_vertices || !_normals || _numVertices == 0 )
+      return;
+
+   std::fill( _normals, _normals + _numVertices * 3, 0.0f );
+
+   size_t lNumTriangles = _index ? _numIndex / 3 : 0;
+
+   std::vector<GLuint> lPos;
+   findEqualPositions( _vertices, _numVertices, lPos );
+
+   if ( _numThreads == 0 )
+      _numThreads = std::thread::hardware_concurrency();
+
+   size_t lNumThreads = std::min<size_t>( _numThreads, lNumTriangles / MIN_TRIANGLES_PER_THREAD );
+   lNumThreads = std::max<size_t>( lNumThreads, 1 );
+
+   // Thread 0 accumulates directly into _normals
+   std::vector<std::vector<GLfloat>> lBuffers( lNumThreads - 1 );
+
+   auto lAccumulate = [&]( size_t _thread ) {
+      GLfloat *lAcc = _normals;
+
+      if ( _thread > 0 ) {
+         lBuffers[_thread - 1].resize( _numVertices * 3, 0.0f );
+         lAcc = lBuffers[_thread - 1].data();
+      }
+
+      accumulate( _vertices,
+                  _index,
+                  lPos.data(),
+                  lNumTriangles * _thread / lNumThreads,
+                  lNumTriangles * ( _thread + 1 ) / lNumThreads,
+                  _weighting,
+                  lAcc );
+   };
+
+   auto lReduce = [&]( size_t _thread ) {
+      size_t lBegin = _numVertices * _thread / lNumThreads;
+      size_t lEnd = _numVertices * ( _thread + 1 ) / lNumThreads;
+
+      for ( auto const &i : lBuffers )
+         for ( size_t j = lBegin * 3; j < lEnd * 3; ++j )
+            _normals[j] += i[j];
+
+      normalize( _normals, lBegin, lEnd );
+   };
+
+   auto lRunParallel = [&]( std::function<void( size_t )> _step ) {
+      std::vector<std::thread> lThreads;
+
+      for ( size_t i = 1; i < lNumThreads; ++i )
+         lThreads.emplace_back( _step, i );
+
+      _step( 0 );
+
+      for ( auto &i : lThreads )
+         i.join();
+   };
+
+   lRunParallel( lAccumulate );
+   lRunParallel( lReduce );
+
+   // Copy the normals of the first vertex with the same position
+   for ( size_t i = 0; i < _numVertices; ++i )
+      if ( lPos[i] != i )
+         memcpy( _normals + i * 3, _normals + lPos[i] * 3, 3 * sizeof( GLfloat ) );
+}
+}
+}
+
+// kate: indent-mode cstyle; indent-width 3; replace-tabs on; line-numbers on;
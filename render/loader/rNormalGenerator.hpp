@@ -0,0 +1,51 @@
+/*!
+ * \file rNormalGenerator.hpp
+ * \brief \b Classes: \a none (smooth vertex normal generation)
+ */
+/*
+ * Copyright (C) 2015 EEnginE project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef R_NORMAL_GENERATOR_HPP
+#define R_NORMAL_GENERATOR_HPP
+
+#include "defines.hpp"
+
+#include <stddef.h>
+
+#include <GL/glew.h>
+
+namespace e_engine {
+
+namespace internal {
+
+enum NORMAL_WEIGHTING {
+   AREA_WEIGHTED, //!< Face normals weighted by the triangle area
+   ANGLE_WEIGHTED //!< Face normals weighted by the corner angle (independent of tessellation)
+};
+
+void calculateNormals( GLfloat const *_vertices,
+                       size_t _numVertices,
+                       GLuint const *_index,
+                       size_t _numIndex,
+                       GLfloat *_normals,
+                       NORMAL_WEIGHTING _weighting = ANGLE_WEIGHTED,
+                       unsigned int _numThreads = 0 );
+}
+}
+
+#endif // R_NORMAL_GENERATOR_HPP
+
+// kate: indent-mode cstyle; indent-width 3; replace-tabs on; line-numbers on;
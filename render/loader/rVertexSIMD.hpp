@@ -0,0 +1,83 @@
+/*!
+ * \file rVertexSIMD.hpp
+ * \brief \b Classes: \a none (SSE2 helpers for packed xyz vertices)
+ */
+/*
+ * Copyright (C) 2015 EEnginE project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef R_VERTEX_SIMD_HPP
+#define R_VERTEX_SIMD_HPP
+
+#include "defines.hpp"
+
+#if E_SIMD_SSE2
+#include <emmintrin.h>
+
+namespace e_engine {
+
+namespace internal {
+
+/*!
+ * \brief Loads 4 packed xyz vertices (12 floats) as 3 registers with 4 x, y and z values
+ */
+inline void loadXYZ( float const *_vert, __m128 &_x, __m128 &_y, __m128 &_z ) {
+   __m128 lA = _mm_loadu_ps( _vert + 0 ); // x0 y0 z0 x1
+   __m128 lB = _mm_loadu_ps( _vert + 4 ); // y1 z1 x2 y2
+   __m128 lC = _mm_loadu_ps( _vert + 8 ); // z2 x3 y3 z3
+
+   __m128 lT0 = _mm_shuffle_ps( lB, lC, _MM_SHUFFLE( 2, 1, 3, 2 ) ); // x2 y2 x3 y3
+   __m128 lT1 = _mm_shuffle_ps( lA, lB, _MM_SHUFFLE( 1, 0, 2, 1 ) ); // y0 z0 y1 z1
+
+   _x = _mm_shuffle_ps( lA, lT0, _MM_SHUFFLE( 2, 0, 3, 0 ) );
+   _y = _mm_shuffle_ps( lT1, lT0, _MM_SHUFFLE( 3, 1, 2, 0 ) );
+   _z = _mm_shuffle_ps( lT1, lC, _MM_SHUFFLE( 3, 0, 3, 1 ) );
+}
+
+/*!
+ * \brief Stores 4 x, y and z values as 4 packed xyz vertices (inverse of loadXYZ)
+ */
+inline void storeXYZ( float *_vert, __m128 _x, __m128 _y, __m128 _z ) {
+   __m128 lXY0 = _mm_shuffle_ps( _x, _y, _MM_SHUFFLE( 1, 0, 1, 0 ) ); // x0 x1 y0 y1
+   __m128 lZX0 = _mm_shuffle_ps( _z, _x, _MM_SHUFFLE( 1, 0, 1, 0 ) ); // z0 z1 x0 x1
+   __m128 lYZ1 = _mm_shuffle_ps( _y, _z, _MM_SHUFFLE( 2, 1, 2, 1 ) ); // y1 y2 z1 z2
+   __m128 lXY2 = _mm_shuffle_ps( _x, _y, _MM_SHUFFLE( 3, 2, 3, 2 ) ); // x2 x3 y2 y3
+   __m128 lZX2 = _mm_shuffle_ps( _z, _x, _MM_SHUFFLE( 3, 2, 3, 2 ) ); // z2 z3 x2 x3
+   __m128 lYZ3 = _mm_shuffle_ps( _y, _z, _MM_SHUFFLE( 3, 3, 3, 3 ) ); // y3 y3 z3 z3
+
+   _mm_storeu_ps( _vert + 0, _mm_shuffle_ps( lXY0, lZX0, _MM_SHUFFLE( 3, 0, 2, 0 ) ) );
+   _mm_storeu_ps( _vert + 4, _mm_shuffle_ps( lYZ1, lXY2, _MM_SHUFFLE( 2, 0, 2, 0 ) ) );
+   _mm_storeu_ps( _vert + 8, _mm_shuffle_ps( lZX2, lYZ3, _MM_SHUFFLE( 2, 0, 3, 0 ) ) );
+}
+
+inline float horizontalMin( __m128 _v ) {
+   _v = _mm_min_ps( _v, _mm_shuffle_ps( _v, _v, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+   _v = _mm_min_ps( _v, _mm_shuffle_ps( _v, _v, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+   return _mm_cvtss_f32( _v );
+}
+
+inline float horizontalMax( __m128 _v ) {
+   _v = _mm_max_ps( _v, _mm_shuffle_ps( _v, _v, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+   _v = _mm_max_ps( _v, _mm_shuffle_ps( _v, _v, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+   return _mm_cvtss_f32( _v );
+}
+}
+}
+
+#endif // E_SIMD_SSE2
+
+#endif // R_VERTEX_SIMD_HPP
+
+// kate: indent-mode cstyle; indent-width 3; replace-tabs on; line-numbers on;
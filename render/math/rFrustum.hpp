@@ -0,0 +1,350 @@
+/*!
+ * \file rFrustum.hpp
+ * \brief \b Classes: \a rFrustum
+ */
+/*
+ * Copyright (C) 2015 EEnginE project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef R_FRUSTUM_HPP
+#define R_FRUSTUM_HPP
+
+#include "defines.hpp"
+
+#include "rMatrixMath.hpp"
+#include "rMatrixSIMD.hpp"
+
+#include <cmath>
+
+namespace e_engine {
+
+namespace internal {
+
+//! One bounding volume per pack (the scalar version and the tail of the SIMD loop)
+template <class T>
+struct rFrustumScalarPack {
+   typedef T TYPE;
+   typedef bool MASK;
+   static const size_t SIZE = 1;
+
+   static void load( rVec4<T> const *_v, T &_x, T &_y, T &_z, T &_w ) {
+      _x = _v->vDataMat[0];
+      _y = _v->vDataMat[1];
+      _z = _v->vDataMat[2];
+      _w = _v->vDataMat[3];
+   }
+
+   static T splat( T _v ) { return _v; }
+
+   static MASK allInside() { return true; }
+
+   //! Clears _inside if _distance < 0 or NaN (a NaN distance is outside)
+   static MASK inside( MASK _inside, T _distance ) { return _inside && _distance >= 0; }
+
+   static size_t storeInside( MASK _inside, uint8_t *_out ) {
+      *_out = _inside ? 1 : 0;
+      return *_out;
+   }
+};
+
+#if E_SIMD_SSE2
+
+//! 4 float bounding volumes per pack
+struct rFrustumSSEPack {
+   typedef rPack4f TYPE;
+   typedef __m128 MASK;
+   static const size_t SIZE = 4;
+
+   //! Loads 4 rVec4f and transposes them (lane i is _v[i])
+   static void load( rVec4<float> const *_v, rPack4f &_x, rPack4f &_y, rPack4f &_z, rPack4f &_w ) {
+      __m128 l0 = _mm_loadu_ps( _v[0].vDataMat );
+      __m128 l1 = _mm_loadu_ps( _v[1].vDataMat );
+      __m128 l2 = _mm_loadu_ps( _v[2].vDataMat );
+      __m128 l3 = _mm_loadu_ps( _v[3].vDataMat );
+
+      _MM_TRANSPOSE4_PS( l0, l1, l2, l3 );
+
+      _x = l0;
+      _y = l1;
+      _z = l2;
+      _w = l3;
+   }
+
+   static rPack4f splat( float _v ) { return _mm_set1_ps( _v ); }
+
+   static MASK allInside() { return _mm_castsi128_ps( _mm_set1_epi32( -1 ) ); }
+
+   //! Same as the scalar version (_mm_cmpge_ps is false for NaN)
+   static MASK inside( MASK _inside, rPack4f _distance ) {
+      return _mm_and_ps( _inside, _mm_cmpge_ps( _distance.v, _mm_setzero_ps() ) );
+   }
+
+   static size_t storeInside( MASK _inside, uint8_t *_out ) {
+      int lMask = _mm_movemask_ps( _inside );
+
+      for ( int i = 0; i < 4; ++i )
+         _out[i] = static_cast<uint8_t>( ( lMask >> i ) & 1 );
+
+      return static_cast<size_t>( ( lMask & 1 ) + ( ( lMask >> 1 ) & 1 ) + ( ( lMask >> 2 ) & 1 ) +
+                                  ( ( lMask >> 3 ) & 1 ) );
+   }
+};
+
+#endif // E_SIMD_SSE2
+
+template <class T>
+struct rFrustumPack {
+   typedef rFrustumScalarPack<T> PACK;
+};
+
+#if E_SIMD_SSE2
+template <>
+struct rFrustumPack<float> {
+   typedef rFrustumSSEPack PACK;
+};
+#endif
+}
+
+/*!
+ * \brief The 6 planes of a view frustum and bounding volume tests against them
+ *
+ * The planes are extracted from a view projection matrix (Gribb / Hartmann), so the bounding
+ * volumes are tested in world space. A plane is stored as n . p + d with |n| = 1 and n pointing
+ * into the frustum; a bounding volume is culled when it is completely behind one of the planes.
+ * The tests are conservative: a volume near a corner of the frustum may be visible although it is
+ * outside. A volume with a NaN distance to one of the planes is outside.
+ *
+ * testSpheres() and testBoxes() test 4 volumes at once for float (SSE). Everything works without
+ * an OpenGL context.
+ *
+ * \sa rSceneBase::cullObjects
+ */
+template <class T>
+class rFrustum {
+ public:
+   enum PLANES { PLANE_LEFT = 0, PLANE_RIGHT, PLANE_BOTTOM, PLANE_TOP, PLANE_NEAR, PLANE_FAR };
+
+   static const uint32_t NUM_PLANES = 6;
+
+   static_assert( sizeof( rVec4<T> ) == 4 * sizeof( T ), "The bounding volumes must be packed" );
+
+ private:
+   T vNormalX[NUM_PLANES];
+   T vNormalY[NUM_PLANES];
+   T vNormalZ[NUM_PLANES];
+   T vDistance[NUM_PLANES];
+
+   template <class PACK>
+   size_t testSphereBlocks( rVec4<T> const *_spheres, size_t &_num, uint8_t *_visible ) const;
+
+   template <class PACK>
+   size_t testBoxBlocks( rVec4<T> const *_centers,
+                         rVec4<T> const *_extents,
+                         size_t &_num,
+                         uint8_t *_visible ) const;
+
+ public:
+   rFrustum();
+
+   void setViewProjection( rMat4<T> const &_viewProjection );
+   inline rVec4<T> getPlane( uint32_t _plane ) const;
+
+   size_t testSpheres( rVec4<T> const *_spheres, size_t _num, uint8_t *_visible ) const;
+   size_t testBoxes( rVec4<T> const *_centers,
+                     rVec4<T> const *_extents,
+                     size_t _num,
+                     uint8_t *_visible ) const;
+};
+
+template <class T>
+const uint32_t rFrustum<T>::NUM_PLANES;
+
+//! Everything is visible until setViewProjection() is called
+template <class T>
+rFrustum<T>::rFrustum() {
+   for ( uint32_t i = 0; i < NUM_PLANES; ++i ) {
+      vNormalX[i] = 0;
+      vNormalY[i] = 0;
+      vNormalZ[i] = 0;
+      vDistance[i] = 1;
+   }
+}
+
+/*!
+ * \brief Extracts the planes from a view projection matrix (OpenGL clip space: -w <= x, y, z <= w)
+ *
+ * The planes are the sums and differences of the 4th row with the other rows.
+ */
+template <class T>
+void rFrustum<T>::setViewProjection( rMat4<T> const &_viewProjection ) {
+   for ( uint32_t i = 0; i < NUM_PLANES; ++i ) {
+      uint32_t lRow = i / 2;
+      T lSign = i % 2 == 0 ? 1 : -1;
+
+      // get( column, row )
+      T lPlane[4];
+      for ( uint32_t c = 0; c < 4; ++c )
+         lPlane[c] = _viewProjection.get( c, 3 ) + lSign * _viewProjection.get( c, lRow );
+
+      T lLength =
+            std::sqrt( lPlane[0] * lPlane[0] + lPlane[1] * lPlane[1] + lPlane[2] * lPlane[2] );
+
+      vNormalX[i] = lPlane[0] / lLength;
+      vNormalY[i] = lPlane[1] / lLength;
+      vNormalZ[i] = lPlane[2] / lLength;
+      vDistance[i] = lPlane[3] / lLength;
+   }
+}
+
+//! The plane _plane (PLANES) as normal (xyz) and distance (w)
+template <class T>
+rVec4<T> rFrustum<T>::getPlane( uint32_t _plane ) const {
+   return rVec4<T>( static_cast<T>( vNormalX[_plane] ),
+                    static_cast<T>( vNormalY[_plane] ),
+                    static_cast<T>( vNormalZ[_plane] ),
+                    static_cast<T>( vDistance[_plane] ) );
+}
+
+/*!
+ * \brief Tests bounding spheres against the frustum
+ * \param[in]  _spheres World space centers (xyz) and radii (w)
+ * \param[in]  _num     Number of spheres
+ * \param[out] _visible 1 for every sphere that is (partially) inside, 0 otherwise
+ * \returns the number of visible spheres
+ */
+template <class T>
+size_t rFrustum<T>::testSpheres( rVec4<T> const *_spheres, size_t _num, uint8_t *_visible ) const {
+   size_t lDone = _num;
+   size_t lVisible = testSphereBlocks<typename internal::rFrustumPack<T>::PACK>(
+         _spheres, lDone, _visible );
+
+   size_t lTail = _num - lDone;
+   lVisible += testSphereBlocks<internal::rFrustumScalarPack<T>>(
+         _spheres + lDone, lTail, _visible + lDone );
+
+   return lVisible;
+}
+
+/*!
+ * \brief Tests axis aligned bounding boxes against the frustum
+ *
+ * The box is inside a plane if its center is in front of the plane or closer to it than the
+ * extent projected onto the normal (|n.x| e.x + |n.y| e.y + |n.z| e.z).
+ *
+ * \param[in]  _centers World space centers of the boxes (w is ignored)
+ * \param[in]  _extents Half of the size of the boxes (w is ignored)
+ * \param[in]  _num     Number of boxes
+ * \param[out] _visible 1 for every box that is (partially) inside, 0 otherwise
+ * \returns the number of visible boxes
+ */
+template <class T>
+size_t rFrustum<T>::testBoxes( rVec4<T> const *_centers,
+                               rVec4<T> const *_extents,
+                               size_t _num,
+                               uint8_t *_visible ) const {
+   size_t lDone = _num;
+   size_t lVisible = testBoxBlocks<typename internal::rFrustumPack<T>::PACK>(
+         _centers, _extents, lDone, _visible );
+
+   size_t lTail = _num - lDone;
+   lVisible += testBoxBlocks<internal::rFrustumScalarPack<T>>(
+         _centers + lDone, _extents + lDone, lTail, _visible + lDone );
+
+   return lVisible;
+}
+
+/*!
+ * \brief Tests PACK::SIZE spheres at once, as long as there are enough spheres left
+ * \param[in,out] _num The number of spheres; set to the number of tested spheres
+ * \returns the number of visible spheres
+ */
+template <class T>
+template <class PACK>
+size_t rFrustum<T>::testSphereBlocks( rVec4<T> const *_spheres,
+                                      size_t &_num,
+                                      uint8_t *_visible ) const {
+   typedef typename PACK::TYPE V;
+
+   size_t lVisible = 0;
+   size_t i = 0;
+
+   for ( ; i + PACK::SIZE <= _num; i += PACK::SIZE ) {
+      V x, y, z, r;
+      PACK::load( _spheres + i, x, y, z, r );
+
+      typename PACK::MASK lInside = PACK::allInside();
+
+      // Signed distance of the sphere surface (negative: completely behind the plane)
+      for ( uint32_t p = 0; p < NUM_PLANES; ++p ) {
+         V lDist = PACK::splat( vDistance[p] ) + r;
+         lDist = lDist + PACK::splat( vNormalX[p] ) * x;
+         lDist = lDist + PACK::splat( vNormalY[p] ) * y;
+         lDist = lDist + PACK::splat( vNormalZ[p] ) * z;
+         lInside = PACK::inside( lInside, lDist );
+      }
+
+      lVisible += PACK::storeInside( lInside, _visible + i );
+   }
+
+   _num = i;
+   return lVisible;
+}
+
+/*!
+ * \brief Tests PACK::SIZE boxes at once, as long as there are enough boxes left
+ * \param[in,out] _num The number of boxes; set to the number of tested boxes
+ * \returns the number of visible boxes
+ */
+template <class T>
+template <class PACK>
+size_t rFrustum<T>::testBoxBlocks( rVec4<T> const *_centers,
+                                   rVec4<T> const *_extents,
+                                   size_t &_num,
+                                   uint8_t *_visible ) const {
+   typedef typename PACK::TYPE V;
+
+   size_t lVisible = 0;
+   size_t i = 0;
+
+   for ( ; i + PACK::SIZE <= _num; i += PACK::SIZE ) {
+      V x, y, z, w;
+      V ex, ey, ez, ew;
+      PACK::load( _centers + i, x, y, z, w );
+      PACK::load( _extents + i, ex, ey, ez, ew );
+
+      typename PACK::MASK lInside = PACK::allInside();
+
+      for ( uint32_t p = 0; p < NUM_PLANES; ++p ) {
+         V lDist = PACK::splat( vDistance[p] );
+         lDist = lDist + PACK::splat( vNormalX[p] ) * x;
+         lDist = lDist + PACK::splat( vNormalY[p] ) * y;
+         lDist = lDist + PACK::splat( vNormalZ[p] ) * z;
+         lDist = lDist + PACK::splat( std::abs( vNormalX[p] ) ) * ex;
+         lDist = lDist + PACK::splat( std::abs( vNormalY[p] ) ) * ey;
+         lDist = lDist + PACK::splat( std::abs( vNormalZ[p] ) ) * ez;
+         lInside = PACK::inside( lInside, lDist );
+      }
+
+      lVisible += PACK::storeInside( lInside, _visible + i );
+   }
+
+   _num = i;
+   return lVisible;
+}
+}
+
+#endif // R_FRUSTUM_HPP
+
+// kate: indent-mode cstyle; indent-width 3; replace-tabs on; line-numbers on;
@@ -23,6 +23,8 @@
 #include "defines.hpp"
 
 #include "uLog.hpp"
+#include "rMatrixSIMD.hpp"
+#include "rMatrixExpr.hpp"
 #include <type_traits>
 
 #define TOLERANCE 0.001
@@ -31,9 +33,24 @@ namespace e_engine {
 
 namespace internal {
 
+//! Tag for the constexpr constructor of rMatrixData (every element is initialized with 0)
+enum MATRIX_INIT { MATRIX_ZERO };
+
 template <class T, uint32_t R, uint32_t S>
 struct rMatrixData {
    T vDataMat[R * S];
+
+   rMatrixData() = default;
+   constexpr rMatrixData( MATRIX_INIT ) : vDataMat{} {}
+};
+
+//! Aligned for the SSE kernels in rMatrixSIMD.hpp
+template <>
+struct rMatrixData<float, 4, 4> {
+   alignas( 16 ) float vDataMat[16];
+
+   rMatrixData() = default;
+   constexpr rMatrixData( MATRIX_INIT ) : vDataMat{} {}
 };
 
 template <class T>
@@ -46,6 +63,9 @@ struct rMatrixData<T, 2, 1> {
       T vDataMat[2];
    };
 
+   rMatrixData() = default;
+   constexpr rMatrixData( MATRIX_INIT ) : vDataMat{} {}
+
    void normalize() {
       T lLength2 = x * x + y * y;
 
@@ -72,6 +92,9 @@ struct rMatrixData<T, 3, 1> {
       T vDataMat[3];
    };
 
+   rMatrixData() = default;
+   constexpr rMatrixData( MATRIX_INIT ) : vDataMat{} {}
+
    void normalize() {
       T lLength2 = x * x + y * y + z * z;
 
@@ -99,6 +122,9 @@ struct rMatrixData<T, 4, 1> {
       T vDataMat[4];
    };
 
+   rMatrixData() = default;
+   constexpr rMatrixData( MATRIX_INIT ) : vDataMat{} {}
+
    void normalize() {
       T lLength2 = x * x + y * y + z * z + w * w;
 
@@ -119,19 +145,22 @@ struct rMatrixData<T, 4, 1> {
 }
 
 template <class TYPE, uint32_t ROWS, uint32_t COLLUMNS>
-class rMatrix : public internal::rMatrixData<TYPE, ROWS, COLLUMNS> {
+class rMatrix : public internal::rMatrixData<TYPE, ROWS, COLLUMNS>,
+                public rMatrixExpr<rMatrix<TYPE, ROWS, COLLUMNS>> {
    static_assert( ( ROWS * COLLUMNS ) >= 2, "Matrix size (ROWS*COLLUMNS) must be at least 2" );
 
  private:
+   typedef internal::rMatrixData<TYPE, ROWS, COLLUMNS> DATA;
+
    template <uint32_t POS, class... ARGS>
-   inline void setHelper( TYPE &&_arg, ARGS &&... _args );
+   constexpr void setHelper( TYPE &&_arg, ARGS &&... _args );
    template <uint32_t POS>
-   inline void setHelper( TYPE &&_arg );
+   constexpr void setHelper( TYPE &&_arg );
 
    template <uint32_t POS, class... ARGS>
-   inline void setHelper( const TYPE &_arg, ARGS &&... _args );
+   constexpr void setHelper( const TYPE &_arg, ARGS &&... _args );
    template <uint32_t POS>
-   inline void setHelper( const TYPE &_arg );
+   constexpr void setHelper( const TYPE &_arg );
 
 
    inline void TYPE2String( uint32_t &&_pos, std::string &_str );
@@ -140,116 +169,137 @@ class rMatrix : public internal::rMatrixData<TYPE, ROWS, COLLUMNS> {
    // Tell the compiler that we are using templates and can access this:
    using internal::rMatrixData<TYPE, ROWS, COLLUMNS>::vDataMat;
 
+   typedef TYPE VALUE_TYPE;
+   typedef rMatrix<TYPE, ROWS, COLLUMNS> MATRIX_TYPE;
+   static const uint32_t NUM_ROWS = ROWS;
+   static const uint32_t NUM_COLLUMNS = COLLUMNS;
+
+   /*!
+    * The default constructor leaves the matrix uninitialized (and is therefore not constexpr). All
+    * other constructors can be used in constant expressions.
+    */
    rMatrix() {}
-   rMatrix( TYPE &_f ) { fill( std::forward<TYPE>( _f ) ); }
-   rMatrix( TYPE &&_f ) { fill( _f ); }
-   rMatrix( TYPE *_f );
-   rMatrix( const rMatrix<TYPE, ROWS, COLLUMNS> &_newMatrix );
+   constexpr rMatrix( TYPE &_f ) : DATA( internal::MATRIX_ZERO ) { fill( _f ); }
+   constexpr rMatrix( TYPE &&_f ) : DATA( internal::MATRIX_ZERO ) { fill( _f ); }
+   constexpr rMatrix( TYPE *_f );
+   constexpr rMatrix( const rMatrix<TYPE, ROWS, COLLUMNS> &_newMatrix ) = default;
+
+   template <class E,
+             class = typename std::enable_if<std::is_same<typename E::MATRIX_TYPE,
+                                                          MATRIX_TYPE>::value>::type>
+   constexpr rMatrix( const rMatrixExpr<E> &_expr )
+       : DATA( internal::MATRIX_ZERO ) {
+      _expr.self().evalTo( *this );
+   }
 
    template <class... ARGS>
-   rMatrix( TYPE &&_a1, ARGS &&... _args );
-
-   ~rMatrix() {}
+   constexpr rMatrix( TYPE &&_a1, ARGS &&... _args );
 
-   TYPE &get( uint32_t _position ) { return vDataMat[_position]; }
-   TYPE const &get( uint32_t _position ) const { return vDataMat[_position]; }
-   TYPE &get( uint32_t _x, uint32_t _y ) { return vDataMat[( _x * ROWS ) + _y]; }
-   TYPE const &get( uint32_t _x, uint32_t _y ) const { return vDataMat[( _x * ROWS ) + _y]; }
+   constexpr TYPE &get( uint32_t _position ) { return vDataMat[_position]; }
+   constexpr TYPE const &get( uint32_t _position ) const { return vDataMat[_position]; }
+   constexpr TYPE &get( uint32_t _x, uint32_t _y ) { return vDataMat[( _x * ROWS ) + _y]; }
+   constexpr TYPE const &get( uint32_t _x, uint32_t _y ) const {
+      return vDataMat[( _x * ROWS ) + _y];
+   }
 
    template <uint32_t I>
-   TYPE &get() {
+   constexpr TYPE &get() {
       static_assert( I < ROWS * COLLUMNS, "Out of range" );
       return vDataMat[I];
    }
    template <uint32_t I>
-   TYPE const &get() const {
+   constexpr TYPE const &get() const {
       static_assert( I < ROWS * COLLUMNS, "Out of range" );
       return vDataMat[I];
    }
    template <uint32_t X, uint32_t Y>
-   TYPE &get() {
+   constexpr TYPE &get() {
       static_assert( X < COLLUMNS && Y < ROWS, "Out of range" );
       return vDataMat[( X * ROWS ) + Y];
    }
    template <uint32_t X, uint32_t Y>
-   TYPE const &get() const {
+   constexpr TYPE const &get() const {
       static_assert( X < COLLUMNS && Y < ROWS, "Out of range" );
       return vDataMat[( X * ROWS ) + Y];
    }
 
    TYPE *getMatrix() { return vDataMat; }
-   void set( uint32_t _position, TYPE _newVal ) { vDataMat[_position] = _newVal; }
+   constexpr void set( uint32_t _position, TYPE _newVal ) { vDataMat[_position] = _newVal; }
 
-   void set( uint32_t _x, uint32_t _y, TYPE _newVal ) { vDataMat[( _x * ROWS ) + _y] = _newVal; }
-   void set( TYPE *_matrix );
+   constexpr void set( uint32_t _x, uint32_t _y, TYPE _newVal ) {
+      vDataMat[( _x * ROWS ) + _y] = _newVal;
+   }
+   constexpr void set( TYPE *_matrix );
 
    template <class... ARGS>
-   void setMat( ARGS &&... _args );
+   constexpr void setMat( ARGS &&... _args );
 
-   uint32_t getRowSize() { return ROWS; }
-   uint32_t getCollumnSize() { return COLLUMNS; }
-   uint32_t getSize() { return ROWS * COLLUMNS; }
+   constexpr uint32_t getRowSize() const { return ROWS; }
+   constexpr uint32_t getCollumnSize() const { return COLLUMNS; }
+   constexpr uint32_t getSize() const { return ROWS * COLLUMNS; }
 
    // DTTSEIW = DUMMY_TEMPLATE_THAT_STD_ENABLE_IF_WORKS
    template <class DTTSEIW = void>
-   typename std::enable_if<ROWS == COLLUMNS, DTTSEIW>::type toIdentityMatrix();
+   constexpr typename std::enable_if<ROWS == COLLUMNS, DTTSEIW>::type toIdentityMatrix();
 
-   void fill( TYPE &_f ) { fill( std::forward<TYPE>( _f ) ); }
-   void fill( TYPE &&_f );
+   constexpr void fill( TYPE &_f ) { fill( std::forward<TYPE>( _f ) ); }
+   constexpr void fill( TYPE &&_f );
 
    template <uint32_t R, uint32_t C>
-   void downscale( rMatrix<TYPE, R, C> *_new ) const;
+   constexpr void downscale( rMatrix<TYPE, R, C> *_new ) const;
 
    template <uint32_t R, uint32_t C>
-   void upscale( rMatrix<TYPE, R, C> *_new ) const;
-
-   template <uint32_t COLLUMNS_NEW>
-   void multiply( const rMatrix<TYPE, COLLUMNS, COLLUMNS_NEW> &_matrix,
-                  rMatrix<TYPE, ROWS, COLLUMNS_NEW> *_targetMatrix );
-
-   // Hardcoded multiply methods
-   void multiply( const rMatrix<TYPE, 2, 2> &_matrix, rMatrix<TYPE, 2, 2> *_targetMatrix );
-   void multiply( const rMatrix<TYPE, 3, 3> &_matrix, rMatrix<TYPE, 3, 3> *_targetMatrix );
-   void multiply( const rMatrix<TYPE, 4, 4> &_matrix, rMatrix<TYPE, 4, 4> *_targetMatrix );
-
-   void add( const rMatrix<TYPE, ROWS, COLLUMNS> &_matrix,
-             rMatrix<TYPE, ROWS, COLLUMNS> *_targetMatrix );
-   void subtract( const rMatrix<TYPE, ROWS, COLLUMNS> &_matrix,
-                  rMatrix<TYPE, ROWS, COLLUMNS> *_targetMatrix );
-
-   // Operators
+   constexpr void upscale( rMatrix<TYPE, R, C> *_new ) const;
 
    /*!
-    * The template parameters are changed due to a conflict with the already existing templates.
+    * \note The float 4x4 specializations use the SIMD kernels and are not constexpr
     */
-   template <class T, uint32_t R, uint32_t C, uint32_t C_N>
-   friend rMatrix<T, R, C_N> operator*( rMatrix<T, R, C> _lMatrix, rMatrix<T, C, C_N> &_rMatrix );
-
-   template <class T, uint32_t R, uint32_t C>
-   friend rMatrix<T, R, C> operator*( T _lScalar, const rMatrix<T, R, C> &_rMatrix );
-
-   template <class T, uint32_t R, uint32_t C>
-   friend rMatrix<T, R, C> operator*( rMatrix<T, R, C> _lMatrix, const T &_rScalar );
-
-   template <class T, uint32_t R, uint32_t C>
-   friend rMatrix<T, R, C> operator+( rMatrix<T, R, C> _lMatrix, const rMatrix<T, R, C> &_rMatrix );
-
-   template <class T, uint32_t R, uint32_t C>
-   friend rMatrix<T, R, C> operator-( rMatrix<T, R, C> _lMatrix, const rMatrix<T, R, C> &_rMatrix );
+   template <uint32_t COLLUMNS_NEW>
+   constexpr void multiply( const rMatrix<TYPE, COLLUMNS, COLLUMNS_NEW> &_matrix,
+                            rMatrix<TYPE, ROWS, COLLUMNS_NEW> *_targetMatrix ) const;
 
-   rMatrix<TYPE, ROWS, COLLUMNS> &operator=( rMatrix<TYPE, ROWS, COLLUMNS> _newMatrix );
+   // Hardcoded multiply methods
+   constexpr void multiply( const rMatrix<TYPE, 2, 2> &_matrix,
+                            rMatrix<TYPE, 2, 2> *_targetMatrix ) const;
+   constexpr void multiply( const rMatrix<TYPE, 3, 3> &_matrix,
+                            rMatrix<TYPE, 3, 3> *_targetMatrix ) const;
+   constexpr void multiply( const rMatrix<TYPE, 4, 4> &_matrix,
+                            rMatrix<TYPE, 4, 4> *_targetMatrix ) const;
+
+   constexpr void transpose( rMatrix<TYPE, COLLUMNS, ROWS> *_targetMatrix ) const;
+
+   constexpr void add( const rMatrix<TYPE, ROWS, COLLUMNS> &_matrix,
+                       rMatrix<TYPE, ROWS, COLLUMNS> *_targetMatrix ) const;
+   constexpr void subtract( const rMatrix<TYPE, ROWS, COLLUMNS> &_matrix,
+                            rMatrix<TYPE, ROWS, COLLUMNS> *_targetMatrix ) const;
+
+   // Operators (+, - and * are lazy, see rMatrixExpr.hpp)
+
+   constexpr rMatrix<TYPE, ROWS, COLLUMNS> &
+   operator=( const rMatrix<TYPE, ROWS, COLLUMNS> &_newMatrix ) = default;
+
+   template <class E>
+   constexpr typename std::enable_if<std::is_same<typename E::MATRIX_TYPE, MATRIX_TYPE>::value,
+                                     rMatrix<TYPE, ROWS, COLLUMNS> &>::type
+   operator=( const rMatrixExpr<E> &_expr ) {
+      _expr.self().evalTo( *this );
+      return *this;
+   }
 
-   rMatrix<TYPE, ROWS, COLLUMNS> &operator+=( const rMatrix<TYPE, ROWS, COLLUMNS> &_rMatrix );
-   rMatrix<TYPE, ROWS, COLLUMNS> &operator-=( const rMatrix<TYPE, ROWS, COLLUMNS> &_rMatrix );
-   rMatrix<TYPE, ROWS, COLLUMNS> &operator*=( const rMatrix<TYPE, ROWS, COLLUMNS> &_rMatrix );
-   rMatrix<TYPE, ROWS, COLLUMNS> &operator*=( const TYPE &_rScalar );
-   rMatrix<TYPE, ROWS, COLLUMNS> &operator/=( const TYPE &_rScalar );
+   constexpr rMatrix<TYPE, ROWS, COLLUMNS> &
+   operator+=( const rMatrix<TYPE, ROWS, COLLUMNS> &_rMatrix );
+   constexpr rMatrix<TYPE, ROWS, COLLUMNS> &
+   operator-=( const rMatrix<TYPE, ROWS, COLLUMNS> &_rMatrix );
+   constexpr rMatrix<TYPE, ROWS, COLLUMNS> &
+   operator*=( const rMatrix<TYPE, ROWS, COLLUMNS> &_rMatrix );
+   constexpr rMatrix<TYPE, ROWS, COLLUMNS> &operator*=( const TYPE &_rScalar );
+   constexpr rMatrix<TYPE, ROWS, COLLUMNS> &operator/=( const TYPE &_rScalar );
 
-   TYPE &operator[]( uint32_t _x ) { return get( _x ); }
-   TYPE &operator()( uint32_t _x, uint32_t _y ) { return get( _x, _y ); }
+   constexpr TYPE &operator[]( uint32_t _x ) { return get( _x ); }
+   constexpr TYPE &operator()( uint32_t _x, uint32_t _y ) { return get( _x, _y ); }
 
-   TYPE const &operator[]( uint32_t _x ) const { return get( _x ); }
-   TYPE const &operator()( uint32_t _x, uint32_t _y ) const { return get( _x, _y ); }
+   constexpr TYPE const &operator[]( uint32_t _x ) const { return get( _x ); }
+   constexpr TYPE const &operator()( uint32_t _x, uint32_t _y ) const { return get( _x, _y ); }
 
    void print( std::string _name = "Matrix", char _type = 'D' );
 };
@@ -264,7 +314,8 @@ class rMatrix : public internal::rMatrixData<TYPE, ROWS, COLLUMNS> {
 //
 
 template <class TYPE, uint32_t ROWS, uint32_t COLLUMNS>
-rMatrix<TYPE, ROWS, COLLUMNS>::rMatrix( TYPE *_f ) {
+constexpr rMatrix<TYPE, ROWS, COLLUMNS>::rMatrix( TYPE *_f )
+    : DATA( internal::MATRIX_ZERO ) {
    if ( _f == nullptr )
       return;
 
@@ -272,15 +323,10 @@ rMatrix<TYPE, ROWS, COLLUMNS>::rMatrix( TYPE *_f ) {
       vDataMat[i] = _f[i];
 }
 
-template <class TYPE, uint32_t ROWS, uint32_t COLLUMNS>
-rMatrix<TYPE, ROWS, COLLUMNS>::rMatrix( const rMatrix<TYPE, ROWS, COLLUMNS> &_newMatrix ) {
-   for ( uint32_t i = 0; i < ( ROWS * COLLUMNS ); ++i )
-      vDataMat[i] = _newMatrix.vDataMat[i];
-}
-
 template <class TYPE, uint32_t ROWS, uint32_t COLLUMNS>
 template <class... ARGS>
-rMatrix<TYPE, ROWS, COLLUMNS>::rMatrix( TYPE &&_a1, ARGS &&... _args ) {
+constexpr rMatrix<TYPE, ROWS, COLLUMNS>::rMatrix( TYPE &&_a1, ARGS &&... _args )
+    : DATA( internal::MATRIX_ZERO ) {
    static_assert( sizeof...( _args ) == ( ROWS * COLLUMNS - 1 ),
                   "Wrong Number of arguments for this size of matrix / vector" );
    setHelper<0>( std::forward<TYPE>( _a1 ), std::forward<ARGS>( _args )... );
@@ -297,18 +343,10 @@ rMatrix<TYPE, ROWS, COLLUMNS>::rMatrix( TYPE &&_a1, ARGS &&... _args ) {
 //        |_|
 
 
-template <class TYPE, uint32_t ROWS, uint32_t COLLUMNS>
-rMatrix<TYPE, ROWS, COLLUMNS> &rMatrix<TYPE, ROWS, COLLUMNS>::
-operator=( rMatrix<TYPE, ROWS, COLLUMNS> _newMatrix ) {
-   for ( uint32_t i = 0; i < ( ROWS * COLLUMNS ); ++i )
-      vDataMat[i] = _newMatrix.get( i );
-   return *this;
-}
-
 
 
 template <class TYPE, uint32_t ROWS, uint32_t COLLUMNS>
-rMatrix<TYPE, ROWS, COLLUMNS> &rMatrix<TYPE, ROWS, COLLUMNS>::
+constexpr rMatrix<TYPE, ROWS, COLLUMNS> &rMatrix<TYPE, ROWS, COLLUMNS>::
 operator+=( const rMatrix<TYPE, ROWS, COLLUMNS> &_rMatrix ) {
    add( _rMatrix, this );
    return *this;
@@ -316,21 +354,21 @@ operator+=( const rMatrix<TYPE, ROWS, COLLUMNS> &_rMatrix ) {
 
 
 template <class TYPE, uint32_t ROWS, uint32_t COLLUMNS>
-rMatrix<TYPE, ROWS, COLLUMNS> &rMatrix<TYPE, ROWS, COLLUMNS>::
+constexpr rMatrix<TYPE, ROWS, COLLUMNS> &rMatrix<TYPE, ROWS, COLLUMNS>::
 operator-=( const rMatrix<TYPE, ROWS, COLLUMNS> &_rMatrix ) {
    subtract( _rMatrix, this );
    return *this;
 }
 
 template <class TYPE, uint32_t ROWS, uint32_t COLLUMNS>
-rMatrix<TYPE, ROWS, COLLUMNS> &rMatrix<TYPE, ROWS, COLLUMNS>::
+constexpr rMatrix<TYPE, ROWS, COLLUMNS> &rMatrix<TYPE, ROWS, COLLUMNS>::
 operator*=( const rMatrix<TYPE, ROWS, COLLUMNS> &_rMatrix ) {
-   multiply( _rMatrix, this );
-   return *this;
+   return *this = *this * _rMatrix;
 }
 
 template <class TYPE, uint32_t ROWS, uint32_t COLLUMNS>
-rMatrix<TYPE, ROWS, COLLUMNS> &rMatrix<TYPE, ROWS, COLLUMNS>::operator*=( const TYPE &_rScalar ) {
+constexpr rMatrix<TYPE, ROWS, COLLUMNS> &rMatrix<TYPE, ROWS, COLLUMNS>::
+operator*=( const TYPE &_rScalar ) {
    for ( uint32_t i = 0; i < ( ROWS * COLLUMNS ); ++i )
       vDataMat[i] *= _rScalar;
 
@@ -338,7 +376,8 @@ rMatrix<TYPE, ROWS, COLLUMNS> &rMatrix<TYPE, ROWS, COLLUMNS>::operator*=( const
 }
 
 template <class TYPE, uint32_t ROWS, uint32_t COLLUMNS>
-rMatrix<TYPE, ROWS, COLLUMNS> &rMatrix<TYPE, ROWS, COLLUMNS>::operator/=( const TYPE &_rScalar ) {
+constexpr rMatrix<TYPE, ROWS, COLLUMNS> &rMatrix<TYPE, ROWS, COLLUMNS>::
+operator/=( const TYPE &_rScalar ) {
    for ( uint32_t i = 0; i < ( ROWS * COLLUMNS ); ++i )
       vDataMat[i] /= _rScalar;
 
@@ -348,42 +387,6 @@ rMatrix<TYPE, ROWS, COLLUMNS> &rMatrix<TYPE, ROWS, COLLUMNS>::operator/=( const
 
 
 
-template <class TYPE, uint32_t ROWS, uint32_t COLLUMNS, uint32_t COLLUMNS_NEW>
-rMatrix<TYPE, ROWS, COLLUMNS_NEW> operator*( rMatrix<TYPE, ROWS, COLLUMNS> _lMatrix,
-                                             rMatrix<TYPE, COLLUMNS, COLLUMNS_NEW> &_rMatrix ) {
-   rMatrix<TYPE, ROWS, COLLUMNS_NEW> _target;
-   _lMatrix.multiply( _rMatrix, &_target );
-   return _target;
-}
-
-
-template <class TYPE, uint32_t ROWS, uint32_t COLLUMNS>
-rMatrix<TYPE, ROWS, COLLUMNS> operator*( TYPE _lScalar,
-                                         const rMatrix<TYPE, ROWS, COLLUMNS> &_rMatrix ) {
-   rMatrix<TYPE, ROWS, COLLUMNS> lTarget = _rMatrix;
-   lTarget *= _lScalar;
-   return lTarget;
-}
-
-template <class TYPE, uint32_t ROWS, uint32_t COLLUMNS>
-rMatrix<TYPE, ROWS, COLLUMNS> operator*( rMatrix<TYPE, ROWS, COLLUMNS> _lMatrix,
-                                         const TYPE &_rScalar ) {
-   return _lMatrix *= _rScalar;
-}
-
-template <class TYPE, uint32_t ROWS, uint32_t COLLUMNS>
-rMatrix<TYPE, ROWS, COLLUMNS> operator+( rMatrix<TYPE, ROWS, COLLUMNS> _lMatrix,
-                                         const rMatrix<TYPE, ROWS, COLLUMNS> &_rMatrix ) {
-   return _lMatrix += _rMatrix;
-}
-
-template <class TYPE, uint32_t ROWS, uint32_t COLLUMNS>
-rMatrix<TYPE, ROWS, COLLUMNS> operator-( rMatrix<TYPE, ROWS, COLLUMNS> _lMatrix,
-                                         const rMatrix<TYPE, ROWS, COLLUMNS> &_rMatrix ) {
-   return _lMatrix -= _rMatrix;
-}
-
-
 //  ______             _       __ _                _                   _        _
 //  | ___ \           | |     / _(_)              | |                 | |      (_)
 //  | |_/ / __ ___  __| | ___| |_ _ _ __   ___  __| |  _ __ ___   __ _| |_ _ __ ___  __
@@ -400,7 +403,7 @@ rMatrix<TYPE, ROWS, COLLUMNS> operator-( rMatrix<TYPE, ROWS, COLLUMNS> _lMatrix,
 // DTTSEIW = DUMMY_TEMPLATE_THAT_STD_ENABLE_IF_WORKS
 template <class TYPE, uint32_t ROWS, uint32_t COLLUMNS>
 template <class DTTSEIW>
-typename std::enable_if<ROWS == COLLUMNS, DTTSEIW>::type
+constexpr typename std::enable_if<ROWS == COLLUMNS, DTTSEIW>::type
 rMatrix<TYPE, ROWS, COLLUMNS>::toIdentityMatrix() {
    vDataMat[0] = 1;
    for ( uint32_t i = 1; i < ROWS * ROWS; ++i )
@@ -411,14 +414,14 @@ rMatrix<TYPE, ROWS, COLLUMNS>::toIdentityMatrix() {
 }
 
 template <class TYPE, uint32_t ROWS, uint32_t COLLUMNS>
-void rMatrix<TYPE, ROWS, COLLUMNS>::fill( TYPE &&_f ) {
-   for ( uint32_t i = 1; i < ROWS * COLLUMNS; ++i )
+constexpr void rMatrix<TYPE, ROWS, COLLUMNS>::fill( TYPE &&_f ) {
+   for ( uint32_t i = 0; i < ROWS * COLLUMNS; ++i )
       vDataMat[i] = _f;
 }
 
 template <class TYPE, uint32_t ROWS, uint32_t COLLUMNS>
 template <uint32_t R, uint32_t C>
-void rMatrix<TYPE, ROWS, COLLUMNS>::downscale( rMatrix<TYPE, R, C> *_new ) const {
+constexpr void rMatrix<TYPE, ROWS, COLLUMNS>::downscale( rMatrix<TYPE, R, C> *_new ) const {
    static_assert( ( ROWS * COLLUMNS ) >= 2, "Matrix size (R*C) must be at least 2" );
    static_assert( R <= ROWS && C <= COLLUMNS, "The matrix to downscale must be smaller" );
 
@@ -429,7 +432,7 @@ void rMatrix<TYPE, ROWS, COLLUMNS>::downscale( rMatrix<TYPE, R, C> *_new ) const
 
 template <class TYPE, uint32_t ROWS, uint32_t COLLUMNS>
 template <uint32_t R, uint32_t C>
-void rMatrix<TYPE, ROWS, COLLUMNS>::upscale( rMatrix<TYPE, R, C> *_new ) const {
+constexpr void rMatrix<TYPE, ROWS, COLLUMNS>::upscale( rMatrix<TYPE, R, C> *_new ) const {
    static_assert( ( ROWS * COLLUMNS ) >= 2, "Matrix size (R*C) must be at least 2" );
    static_assert( R >= ROWS && C >= COLLUMNS, "The matrix to upscale must be larger" );
 
@@ -457,8 +460,9 @@ void rMatrix<TYPE, ROWS, COLLUMNS>::upscale( rMatrix<TYPE, R, C> *_new ) const {
 
 template <class TYPE, uint32_t ROWS, uint32_t COLLUMNS>
 template <uint32_t COLLUMNS_NEW>
-void rMatrix<TYPE, ROWS, COLLUMNS>::multiply( const rMatrix<TYPE, COLLUMNS, COLLUMNS_NEW> &_matrix,
-                                              rMatrix<TYPE, ROWS, COLLUMNS_NEW> *_targetMatrix ) {
+constexpr void rMatrix<TYPE, ROWS, COLLUMNS>::multiply(
+      const rMatrix<TYPE, COLLUMNS, COLLUMNS_NEW> &_matrix,
+      rMatrix<TYPE, ROWS, COLLUMNS_NEW> *_targetMatrix ) const {
    uint32_t currentIndex = 0;
    TYPE currentSum = 0;
    for ( uint32_t i = 0; i < COLLUMNS_NEW; ++i ) { // Second Matrix
@@ -475,8 +479,8 @@ void rMatrix<TYPE, ROWS, COLLUMNS>::multiply( const rMatrix<TYPE, COLLUMNS, COLL
 
 // HARDCODED 2x2
 template <class TYPE, uint32_t ROWS, uint32_t COLLUMNS>
-void rMatrix<TYPE, ROWS, COLLUMNS>::multiply( const rMatrix<TYPE, 2, 2> &_matrix,
-                                              rMatrix<TYPE, 2, 2> *_targetMatrix ) {
+constexpr void rMatrix<TYPE, ROWS, COLLUMNS>::multiply( const rMatrix<TYPE, 2, 2> &_matrix,
+                                                        rMatrix<TYPE, 2, 2> *_targetMatrix ) const {
    _targetMatrix->vDataMat[0] =
          ( ( vDataMat[0] * _matrix.vDataMat[0] ) + ( vDataMat[2] * _matrix.vDataMat[1] ) );
    _targetMatrix->vDataMat[1] =
@@ -490,8 +494,8 @@ void rMatrix<TYPE, ROWS, COLLUMNS>::multiply( const rMatrix<TYPE, 2, 2> &_matrix
 
 // HARDCODED 3x3
 template <class TYPE, uint32_t ROWS, uint32_t COLLUMNS>
-void rMatrix<TYPE, ROWS, COLLUMNS>::multiply( const rMatrix<TYPE, 3, 3> &_matrix,
-                                              rMatrix<TYPE, 3, 3> *_targetMatrix ) {
+constexpr void rMatrix<TYPE, ROWS, COLLUMNS>::multiply( const rMatrix<TYPE, 3, 3> &_matrix,
+                                                        rMatrix<TYPE, 3, 3> *_targetMatrix ) const {
    _targetMatrix->vDataMat[0] =
          ( ( vDataMat[0] * _matrix.vDataMat[0] ) + ( vDataMat[3] * _matrix.vDataMat[1] ) +
            ( vDataMat[6] * _matrix.vDataMat[2] ) );
@@ -524,8 +528,8 @@ void rMatrix<TYPE, ROWS, COLLUMNS>::multiply( const rMatrix<TYPE, 3, 3> &_matrix
 
 // HARDCODED 4x4
 template <class TYPE, uint32_t ROWS, uint32_t COLLUMNS>
-void rMatrix<TYPE, ROWS, COLLUMNS>::multiply( const rMatrix<TYPE, 4, 4> &_matrix,
-                                              rMatrix<TYPE, 4, 4> *_targetMatrix ) {
+constexpr void rMatrix<TYPE, ROWS, COLLUMNS>::multiply( const rMatrix<TYPE, 4, 4> &_matrix,
+                                                        rMatrix<TYPE, 4, 4> *_targetMatrix ) const {
    _targetMatrix->vDataMat[0] =
          ( ( vDataMat[0] * _matrix.vDataMat[0] ) + ( vDataMat[4] * _matrix.vDataMat[1] ) +
            ( vDataMat[8] * _matrix.vDataMat[2] ) + ( vDataMat[12] * _matrix.vDataMat[3] ) );
@@ -576,16 +580,52 @@ void rMatrix<TYPE, ROWS, COLLUMNS>::multiply( const rMatrix<TYPE, 4, 4> &_matrix
            ( vDataMat[11] * _matrix.vDataMat[14] ) + ( vDataMat[15] * _matrix.vDataMat[15] ) );
 }
 
+// SIMD 4x4 float (rMatrixSIMD.hpp)
+template <>
+inline void rMatrix<float, 4, 4>::multiply( const rMatrix<float, 4, 4> &_matrix,
+                                            rMatrix<float, 4, 4> *_targetMatrix ) const {
+   internal::mat4Multiply( vDataMat, _matrix.vDataMat, _targetMatrix->vDataMat );
+}
+
+template <>
+template <>
+inline void rMatrix<float, 4, 4>::multiply<1>( const rMatrix<float, 4, 1> &_matrix,
+                                               rMatrix<float, 4, 1> *_targetMatrix ) const {
+   internal::mat4MultiplyVec4( vDataMat, _matrix.vDataMat, _targetMatrix->vDataMat );
+}
+
+/*!
+ * \brief Writes the transposed matrix to _targetMatrix (may be this)
+ */
+template <class TYPE, uint32_t ROWS, uint32_t COLLUMNS>
+constexpr void rMatrix<TYPE, ROWS, COLLUMNS>::transpose(
+      rMatrix<TYPE, COLLUMNS, ROWS> *_targetMatrix ) const {
+   rMatrix<TYPE, COLLUMNS, ROWS> lTemp( static_cast<TYPE>( 0 ) );
+
+   for ( uint32_t x = 0; x < COLLUMNS; ++x )
+      for ( uint32_t y = 0; y < ROWS; ++y )
+         lTemp.set( y, x, get( x, y ) );
+
+   *_targetMatrix = lTemp;
+}
+
+template <>
+inline void rMatrix<float, 4, 4>::transpose( rMatrix<float, 4, 4> *_targetMatrix ) const {
+   internal::mat4Transpose( vDataMat, _targetMatrix->vDataMat );
+}
+
 template <class TYPE, uint32_t ROWS, uint32_t COLLUMNS>
-void rMatrix<TYPE, ROWS, COLLUMNS>::add( const rMatrix<TYPE, ROWS, COLLUMNS> &_matrix,
-                                         rMatrix<TYPE, ROWS, COLLUMNS> *_targetMatrix ) {
+constexpr void rMatrix<TYPE, ROWS, COLLUMNS>::add(
+      const rMatrix<TYPE, ROWS, COLLUMNS> &_matrix,
+      rMatrix<TYPE, ROWS, COLLUMNS> *_targetMatrix ) const {
    for ( uint32_t i = 0; i < ( ROWS * COLLUMNS ); ++i )
       _targetMatrix->set( i, ( vDataMat[i] + _matrix.get( i ) ) );
 }
 
 template <class TYPE, uint32_t ROWS, uint32_t COLLUMNS>
-void rMatrix<TYPE, ROWS, COLLUMNS>::subtract( const rMatrix<TYPE, ROWS, COLLUMNS> &_matrix,
-                                              rMatrix<TYPE, ROWS, COLLUMNS> *_targetMatrix ) {
+constexpr void rMatrix<TYPE, ROWS, COLLUMNS>::subtract(
+      const rMatrix<TYPE, ROWS, COLLUMNS> &_matrix,
+      rMatrix<TYPE, ROWS, COLLUMNS> *_targetMatrix ) const {
    for ( uint32_t i = 0; i < ( ROWS * COLLUMNS ); ++i )
       _targetMatrix->set( i, ( vDataMat[i] - _matrix.get( i ) ) );
 }
@@ -601,14 +641,14 @@ void rMatrix<TYPE, ROWS, COLLUMNS>::subtract( const rMatrix<TYPE, ROWS, COLLUMNS
 
 
 template <class TYPE, uint32_t ROWS, uint32_t COLLUMNS>
-void rMatrix<TYPE, ROWS, COLLUMNS>::set( TYPE *_matrix ) {
+constexpr void rMatrix<TYPE, ROWS, COLLUMNS>::set( TYPE *_matrix ) {
    for ( uint32_t i = 0; i < ( ROWS * COLLUMNS ); ++i )
       vDataMat[i] = _matrix[i];
 }
 
 template <class TYPE, uint32_t ROWS, uint32_t COLLUMNS>
 template <class... ARGS>
-void rMatrix<TYPE, ROWS, COLLUMNS>::setMat( ARGS &&... _args ) {
+constexpr void rMatrix<TYPE, ROWS, COLLUMNS>::setMat( ARGS &&... _args ) {
    static_assert(
          sizeof...( _args ) == ( ROWS * COLLUMNS ),
          "Wrong Number of arguments to set the size of this size of matrix / vector [set2]" );
@@ -619,28 +659,28 @@ void rMatrix<TYPE, ROWS, COLLUMNS>::setMat( ARGS &&... _args ) {
 
 template <class TYPE, uint32_t ROWS, uint32_t COLLUMNS>
 template <uint32_t POS, class... ARGS>
-inline void rMatrix<TYPE, ROWS, COLLUMNS>::setHelper( TYPE &&_arg, ARGS &&... _args ) {
+constexpr void rMatrix<TYPE, ROWS, COLLUMNS>::setHelper( TYPE &&_arg, ARGS &&... _args ) {
    vDataMat[( ( POS % ROWS ) * COLLUMNS ) + ( POS / ROWS )] = _arg;
    setHelper<POS + 1>( static_cast<TYPE>( std::forward<ARGS>( _args ) )... );
 }
 
 template <class TYPE, uint32_t ROWS, uint32_t COLLUMNS>
 template <uint32_t POS>
-inline void rMatrix<TYPE, ROWS, COLLUMNS>::setHelper( TYPE &&_arg ) {
+constexpr void rMatrix<TYPE, ROWS, COLLUMNS>::setHelper( TYPE &&_arg ) {
    vDataMat[( ( POS % ROWS ) * COLLUMNS ) + ( POS / ROWS )] = _arg;
 }
 
 
 template <class TYPE, uint32_t ROWS, uint32_t COLLUMNS>
 template <uint32_t POS, class... ARGS>
-inline void rMatrix<TYPE, ROWS, COLLUMNS>::setHelper( const TYPE &_arg, ARGS &&... _args ) {
+constexpr void rMatrix<TYPE, ROWS, COLLUMNS>::setHelper( const TYPE &_arg, ARGS &&... _args ) {
    vDataMat[( ( POS % ROWS ) * COLLUMNS ) + ( POS / ROWS )] = _arg;
    setHelper<POS + 1>( std::forward<ARGS>( _args )... );
 }
 
 template <class TYPE, uint32_t ROWS, uint32_t COLLUMNS>
 template <uint32_t POS>
-inline void rMatrix<TYPE, ROWS, COLLUMNS>::setHelper( const TYPE &_arg ) {
+constexpr void rMatrix<TYPE, ROWS, COLLUMNS>::setHelper( const TYPE &_arg ) {
    vDataMat[( ( POS % ROWS ) * COLLUMNS ) + ( POS / ROWS )] = _arg;
 }
 
@@ -0,0 +1,236 @@
+/*!
+ * \file rMatrixExpr.hpp
+ * \brief \b Classes: \a rMatrixExpr, \a rMatrixSum, \a rMatrixDifference, \a rMatrixScaled,
+ *                    \a rMatrixProduct
+ */
+/*
+ * Copyright (C) 2015 EEnginE project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef R_MATRIX_EXPR_HPP
+#define R_MATRIX_EXPR_HPP
+
+#include "defines.hpp"
+
+#include <stdint.h>
+#include <type_traits>
+
+namespace e_engine {
+
+template <class TYPE, uint32_t ROWS, uint32_t COLLUMNS>
+class rMatrix;
+
+template <class L, class R>
+class rMatrixProduct;
+
+/*!
+ * \brief Base class of rMatrix and of all lazy matrix expressions (CRTP)
+ *
+ * The rMatrix operators +, - and * do not calculate anything. They return a small expression
+ * object, which is evaluated when it is assigned to (or used to construct) a rMatrix:
+ *
+ *  - sums, differences and scalar products of a whole chain are evaluated element by element in
+ *    one loop, without any temporary matrix
+ *  - products are calculated with rMatrix::multiply (and thus the SIMD kernels) directly into the
+ *    target matrix. Only a product used as operand of another operation needs a temporary.
+ *
+ * Expressions reference the matrices they are built from. Assign them to a rMatrix (or call
+ * eval()) instead of keeping them in an \c auto variable.
+ */
+template <class E>
+class rMatrixExpr {
+ public:
+   constexpr E const &self() const { return *static_cast<E const *>( this ); }
+
+   //! Evaluates the expression (needed when passing it to a function template like dotProduct)
+   constexpr auto eval() const { return typename E::MATRIX_TYPE( self() ); }
+};
+
+namespace internal {
+
+//! Matrices are referenced, the (small) expression nodes are copied
+template <class E>
+struct rExprOperand {
+   typedef E const type;
+};
+
+template <class T, uint32_t R, uint32_t C>
+struct rExprOperand<rMatrix<T, R, C>> {
+   typedef rMatrix<T, R, C> const &type;
+};
+
+//! Products have no element access and are evaluated
+template <class L, class R>
+struct rExprOperand<rMatrixProduct<L, R>> {
+   typedef typename rMatrixProduct<L, R>::MATRIX_TYPE const type;
+};
+
+//! A product needs random access to its operands, so everything except a rMatrix is evaluated
+template <class E>
+struct rExprProductOperand {
+   typedef typename E::MATRIX_TYPE const type;
+};
+
+template <class T, uint32_t R, uint32_t C>
+struct rExprProductOperand<rMatrix<T, R, C>> {
+   typedef rMatrix<T, R, C> const &type;
+};
+
+/*!
+ * \brief Base of the element wise expressions
+ *
+ * get( i ) only depends on element i of the operands, so the target may be an operand.
+ */
+template <class E>
+class rMatrixElementExpr : public rMatrixExpr<E> {
+ public:
+   template <class M>
+   constexpr void evalTo( M &_target ) const {
+      for ( uint32_t i = 0; i < ( M::NUM_ROWS * M::NUM_COLLUMNS ); ++i )
+         _target.vDataMat[i] = this->self().get( i );
+   }
+};
+}
+
+template <class L, class R>
+class rMatrixSum : public internal::rMatrixElementExpr<rMatrixSum<L, R>> {
+   static_assert( std::is_same<typename L::MATRIX_TYPE, typename R::MATRIX_TYPE>::value,
+                  "Matrices must have the same type and size" );
+
+ private:
+   typename internal::rExprOperand<L>::type vLeft;
+   typename internal::rExprOperand<R>::type vRight;
+
+ public:
+   typedef typename L::MATRIX_TYPE MATRIX_TYPE;
+   typedef typename L::VALUE_TYPE VALUE_TYPE;
+
+   constexpr rMatrixSum( L const &_left, R const &_right ) : vLeft( _left ), vRight( _right ) {}
+
+   constexpr VALUE_TYPE get( uint32_t _i ) const { return vLeft.get( _i ) + vRight.get( _i ); }
+};
+
+template <class L, class R>
+class rMatrixDifference : public internal::rMatrixElementExpr<rMatrixDifference<L, R>> {
+   static_assert( std::is_same<typename L::MATRIX_TYPE, typename R::MATRIX_TYPE>::value,
+                  "Matrices must have the same type and size" );
+
+ private:
+   typename internal::rExprOperand<L>::type vLeft;
+   typename internal::rExprOperand<R>::type vRight;
+
+ public:
+   typedef typename L::MATRIX_TYPE MATRIX_TYPE;
+   typedef typename L::VALUE_TYPE VALUE_TYPE;
+
+   constexpr rMatrixDifference( L const &_left, R const &_right )
+       : vLeft( _left ), vRight( _right ) {}
+
+   constexpr VALUE_TYPE get( uint32_t _i ) const { return vLeft.get( _i ) - vRight.get( _i ); }
+};
+
+template <class E>
+class rMatrixScaled : public internal::rMatrixElementExpr<rMatrixScaled<E>> {
+ public:
+   typedef typename E::MATRIX_TYPE MATRIX_TYPE;
+   typedef typename E::VALUE_TYPE VALUE_TYPE;
+
+ private:
+   typename internal::rExprOperand<E>::type vMatrix;
+   VALUE_TYPE vScalar;
+
+ public:
+   constexpr rMatrixScaled( E const &_matrix, VALUE_TYPE _scalar )
+       : vMatrix( _matrix ), vScalar( _scalar ) {}
+
+   constexpr VALUE_TYPE get( uint32_t _i ) const { return vMatrix.get( _i ) * vScalar; }
+};
+
+/*!
+ * \brief Matrix product, evaluated with rMatrix::multiply
+ *
+ * Nested expressions are evaluated once when the product is built (multiply needs every element
+ * several times). The result is written directly into the target, unless the target is one of the
+ * operands.
+ */
+template <class L, class R>
+class rMatrixProduct : public rMatrixExpr<rMatrixProduct<L, R>> {
+ public:
+   typedef typename L::MATRIX_TYPE LEFT_TYPE;
+   typedef typename R::MATRIX_TYPE RIGHT_TYPE;
+   typedef typename L::VALUE_TYPE VALUE_TYPE;
+   typedef rMatrix<VALUE_TYPE, LEFT_TYPE::NUM_ROWS, RIGHT_TYPE::NUM_COLLUMNS> MATRIX_TYPE;
+
+   static_assert( std::is_same<VALUE_TYPE, typename R::VALUE_TYPE>::value,
+                  "Matrices must have the same type" );
+   static_assert( LEFT_TYPE::NUM_COLLUMNS == RIGHT_TYPE::NUM_ROWS,
+                  "The collumn-count of the first matrix must equal the row-count of the second" );
+
+ private:
+   typename internal::rExprProductOperand<L>::type vLeft;
+   typename internal::rExprProductOperand<R>::type vRight;
+
+ public:
+   constexpr rMatrixProduct( L const &_left, R const &_right ) : vLeft( _left ), vRight( _right ) {}
+
+   constexpr void evalTo( MATRIX_TYPE &_target ) const {
+      void const *lTarget = &_target;
+
+      if ( lTarget == &vLeft || lTarget == &vRight ) {
+         MATRIX_TYPE lTemp( _target );
+         vLeft.multiply( vRight, &lTemp );
+         _target = lTemp;
+         return;
+      }
+
+      vLeft.multiply( vRight, &_target );
+   }
+};
+
+
+template <class L, class R>
+constexpr rMatrixSum<L, R> operator+( rMatrixExpr<L> const &_lMatrix,
+                                      rMatrixExpr<R> const &_rMatrix ) {
+   return rMatrixSum<L, R>( _lMatrix.self(), _rMatrix.self() );
+}
+
+template <class L, class R>
+constexpr rMatrixDifference<L, R> operator-( rMatrixExpr<L> const &_lMatrix,
+                                             rMatrixExpr<R> const &_rMatrix ) {
+   return rMatrixDifference<L, R>( _lMatrix.self(), _rMatrix.self() );
+}
+
+template <class L, class R>
+constexpr rMatrixProduct<L, R> operator*( rMatrixExpr<L> const &_lMatrix,
+                                          rMatrixExpr<R> const &_rMatrix ) {
+   return rMatrixProduct<L, R>( _lMatrix.self(), _rMatrix.self() );
+}
+
+template <class E>
+constexpr rMatrixScaled<E> operator*( typename E::VALUE_TYPE _lScalar,
+                                      rMatrixExpr<E> const &_rMatrix ) {
+   return rMatrixScaled<E>( _rMatrix.self(), _lScalar );
+}
+
+template <class E>
+constexpr rMatrixScaled<E> operator*( rMatrixExpr<E> const &_lMatrix,
+                                      typename E::VALUE_TYPE _rScalar ) {
+   return rMatrixScaled<E>( _lMatrix.self(), _rScalar );
+}
+}
+
+#endif // R_MATRIX_EXPR_HPP
+
+// kate: indent-mode cstyle; indent-width 3; replace-tabs on; line-numbers on;
@@ -55,24 +55,64 @@ using rMat = rMatrix<T, N, N>;
 
 class rMatrixMath {
  public:
+   /*!
+    * \brief What an affine transformation can contain (selects the fast paths)
+    *
+    * The view matrix of rMatrixSceneBase is rigid, so a model view matrix has the class of the
+    * model matrix.
+    */
+   enum TRANSFORM_CLASS {
+      TRANSFORM_RIGID,         //!< Rotation and translation
+      TRANSFORM_UNIFORM_SCALE, //!< Rotation, translation and the same scale on all axes
+      TRANSFORM_GENERAL        //!< Any invertible affine transformation
+   };
+
    template <class T>
-   static void scale( T _n, rMat4<T> &_out );
+   static constexpr void scale( T _n, rMat4<T> &_out );
    template <class T>
-   static void scale( const rVec3<T> &_n, rMat4<T> &_out );
+   static constexpr void scale( const rVec3<T> &_n, rMat4<T> &_out );
 
    template <class T>
-   static void translate( const rVec3<T> &_n, rMat4<T> &_out );
+   static constexpr void translate( const rVec3<T> &_n, rMat4<T> &_out );
 
    template <class T>
    static void rotate( const rVec3<T> &_axis, T _angle, rMat4<T> &_out );
+   template <class T>
+   static constexpr void rotate( const rVec4<T> &_quaternion, rMat4<T> &_out );
+
+   template <class T>
+   static void rotationQuaternion( const rVec3<T> &_axis, T _angle, rVec4<T> &_out );
+
+   template <class T>
+   static constexpr void transformation( const rVec3<T> &_position,
+                                         const rVec4<T> &_rotation,
+                                         const rVec3<T> &_scale,
+                                         rMat4<T> &_out );
 
    template <class T>
    static void perspective( T _aspectRatio, T _nearZ, T _farZ, T _fofy, rMat4<T> &_out );
+   template <class T>
+   static constexpr void
+   perspectiveFocal( T _aspectRatio, T _nearZ, T _farZ, T _focal, rMat4<T> &_out );
+
+   template <class T>
+   static constexpr TRANSFORM_CLASS getTransformClass( const rVec3<T> &_scale );
 
    template <class T>
-   static void getNormalMatrix( rMat4<T> const &_in, rMat3<T> &_out );
+   static constexpr void getNormalMatrix( rMat4<T> const &_in, rMat3<T> &_out );
    template <class T>
-   static void getNormalMatrix( rMat3<T> const &_in, rMat3<T> &_out );
+   static constexpr void getNormalMatrix( rMat3<T> const &_in, rMat3<T> &_out );
+   template <class T>
+   static constexpr void
+   getNormalMatrix( rMat4<T> const &_in, rMat3<T> &_out, TRANSFORM_CLASS _class );
+
+   template <class T>
+   static void affineInverse( rMat4<T> const &_in, rMat4<T> &_out );
+   template <class T>
+   static void affineInverse( rMat4<T> const &_in, rMat4<T> &_out, TRANSFORM_CLASS _class );
+
+   template <class T>
+   static constexpr T inverseScale2( rMat4<T> const &_in, TRANSFORM_CLASS _class );
 
    template <class T>
    static void camera( const rVec3<T> &_position,
@@ -81,46 +121,74 @@ class rMatrixMath {
                        rMat4<T> &_out );
 };
 
+/*
+ * The constexpr functions only access the elements with [] / get (and not with x, y, z, w):
+ * reading a member of the union in rMatrixData that was not written is not allowed in a constant
+ * expression.
+ */
+
 template <class T>
-void rMatrixMath::scale( T _n, rMat4<T> &_out ) {
+constexpr void rMatrixMath::scale( T _n, rMat4<T> &_out ) {
    _out.setMat( _n, 0, 0, 0, 0, _n, 0, 0, 0, 0, _n, 0, 0, 0, 0, 1 );
 }
 
 template <class T>
-void rMatrixMath::scale( const rVec3<T> &_n, rMat4<T> &_out ) {
-   _out.setMat( _n.x, 0, 0, 0, 0, _n.y, 0, 0, 0, 0, _n.z, 0, 0, 0, 0, 1 );
+constexpr void rMatrixMath::scale( const rVec3<T> &_n, rMat4<T> &_out ) {
+   _out.setMat( _n[0], 0, 0, 0, 0, _n[1], 0, 0, 0, 0, _n[2], 0, 0, 0, 0, 1 );
 }
 
 template <class T>
-void rMatrixMath::translate( const rVec3<T> &_n, rMat4<T> &_out ) {
-   _out.setMat( 1, 0, 0, _n.x, 0, 1, 0, _n.y, 0, 0, 1, _n.z, 0, 0, 0, 1 );
+constexpr void rMatrixMath::translate( const rVec3<T> &_n, rMat4<T> &_out ) {
+   _out.setMat( 1, 0, 0, _n[0], 0, 1, 0, _n[1], 0, 0, 1, _n[2], 0, 0, 0, 1 );
 }
 
 template <class T>
 void rMatrixMath::rotate( const rVec3<T> &_axis, T _angle, rMat4<T> &_out ) {
+   rVec4<T> lTemp;
+   rotationQuaternion( _axis, _angle, lTemp );
+   rotate( lTemp, _out );
+}
+
+/*!
+ * \brief Calculates the (normalized) quaternion used by rotate()
+ * \param[in]  _axis  The rotation axis
+ * \param[in]  _angle The angle in degrees
+ * \param[out] _out   The quaternion (x, y, z, w)
+ */
+template <class T>
+void rMatrixMath::rotationQuaternion( const rVec3<T> &_axis, T _angle, rVec4<T> &_out ) {
    rVec3<T> lAxis = _axis;
    lAxis.normalize();
    T lAngleToUse = static_cast<T>( DEG_TO_RAD( _angle ) / 2 );
    T lSin = static_cast<T>( sin( lAngleToUse ) );
 
+   _out.x = _axis.x * lSin;
+   _out.y = _axis.y * lSin;
+   _out.z = _axis.z * lSin;
+   _out.w = static_cast<T>( cos( lAngleToUse ) );
 
-   rVec4<T> lTemp;
-   lTemp.x = _axis.x * lSin;
-   lTemp.y = _axis.y * lSin;
-   lTemp.z = _axis.z * lSin;
-   lTemp.w = static_cast<T>( cos( lAngleToUse ) );
-
-   lTemp.normalize();
-
-   T x2 = lTemp.x * lTemp.x;
-   T y2 = lTemp.y * lTemp.y;
-   T z2 = lTemp.z * lTemp.z;
-   T xy = lTemp.x * lTemp.y;
-   T xz = lTemp.x * lTemp.z;
-   T yz = lTemp.y * lTemp.z;
-   T wx = lTemp.w * lTemp.x;
-   T wy = lTemp.w * lTemp.y;
-   T wz = lTemp.w * lTemp.z;
+   _out.normalize();
+}
+
+/*!
+ * \brief Calculates the rotation matrix of a normalized quaternion (see rotationQuaternion)
+ */
+template <class T>
+constexpr void rMatrixMath::rotate( const rVec4<T> &_quaternion, rMat4<T> &_out ) {
+   T x = _quaternion[0];
+   T y = _quaternion[1];
+   T z = _quaternion[2];
+   T w = _quaternion[3];
+
+   T x2 = x * x;
+   T y2 = y * y;
+   T z2 = z * z;
+   T xy = x * y;
+   T xz = x * z;
+   T yz = y * z;
+   T wx = w * x;
+   T wy = w * y;
+   T wz = w * z;
 
    _out.template get<0, 0>() = 1 - 2 * y2 - 2 * z2;
    _out.template get<1, 0>() = 2 * xy - 2 * wz;
@@ -129,11 +197,11 @@ void rMatrixMath::rotate( const rVec3<T> &_axis, T _angle, rMat4<T> &_out ) {
 
    _out.template get<0, 1>() = 2 * xy + 2 * wz;
    _out.template get<1, 1>() = 1 - 2 * x2 - 2 * z2;
-   _out.template get<2, 1>() = 2 * yz + 2 * wx;
+   _out.template get<2, 1>() = 2 * yz - 2 * wx;
    _out.template get<3, 1>() = 0;
 
    _out.template get<0, 2>() = 2 * xz - 2 * wy;
-   _out.template get<1, 2>() = 2 * yz - 2 * wx;
+   _out.template get<1, 2>() = 2 * yz + 2 * wx;
    _out.template get<2, 2>() = 1 - 2 * x2 - 2 * y2;
    _out.template get<3, 2>() = 0;
 
@@ -143,13 +211,50 @@ void rMatrixMath::rotate( const rVec3<T> &_axis, T _angle, rMat4<T> &_out ) {
    _out.template get<3, 3>() = 1;
 }
 
+/*!
+ * \brief Calculates translation * rotation * scale without multiplying the 3 matrices
+ *
+ * The columns of the rotation matrix are scaled and the position is the last column.
+ *
+ * \param[in]  _position The translation
+ * \param[in]  _rotation The normalized rotation quaternion
+ * \param[in]  _scale    The scale of the x, y and z axis
+ * \param[out] _out      The model matrix
+ */
+template <class T>
+constexpr void rMatrixMath::transformation( const rVec3<T> &_position,
+                                            const rVec4<T> &_rotation,
+                                            const rVec3<T> &_scale,
+                                            rMat4<T> &_out ) {
+   rotate( _rotation, _out );
+
+   // get( column, row )
+   for ( uint32_t c = 0; c < 3; ++c ) {
+      for ( uint32_t r = 0; r < 3; ++r )
+         _out.get( c, r ) *= _scale[c];
+
+      _out.get( 3, c ) = _position[c];
+   }
+}
+
 template <class T>
 void rMatrixMath::perspective( T _aspectRatio, T _nearZ, T _farZ, T _fofy, rMat4<T> &_out ) {
    T f = static_cast<T>( 1.0 / tan( static_cast<double>( DEG_TO_RAD( _fofy / 2 ) ) ) );
+   perspectiveFocal( _aspectRatio, _nearZ, _farZ, f, _out );
+}
 
+/*!
+ * \brief perspective() with the focal length 1 / tan( fofy / 2 ) instead of the field of view
+ *
+ * tan() can not be used in a constant expression, so this version can build constant projection
+ * matrices at compile time.
+ */
+template <class T>
+constexpr void
+rMatrixMath::perspectiveFocal( T _aspectRatio, T _nearZ, T _farZ, T _focal, rMat4<T> &_out ) {
    _out.fill( 0 );
-   _out.template get<0, 0>() = f / _aspectRatio;
-   _out.template get<1, 1>() = f;
+   _out.template get<0, 0>() = _focal / _aspectRatio;
+   _out.template get<1, 1>() = _focal;
    _out.template get<2, 2>() = ( _farZ + _nearZ ) / ( _nearZ - _farZ );
    _out.template get<3, 2>() = ( 2 * _farZ * _nearZ ) / ( _nearZ - _farZ );
    _out.template get<2, 3>() = -1;
@@ -186,15 +291,106 @@ void rMatrixMath::camera( const rVec3<T> &_position,
 }
 
 
+/*!
+ * \brief Inverts an affine matrix (the last row must be 0 0 0 1; _out may be _in)
+ *
+ * Much cheaper than a general 4x4 inverse. Scaling and shearing are supported, but the upper 3x3
+ * matrix must be invertible.
+ */
+template <class T>
+void rMatrixMath::affineInverse( rMat4<T> const &_in, rMat4<T> &_out ) {
+   internal::mat4AffineInverseScalar( _in.vDataMat, _out.vDataMat );
+}
+
+template <>
+inline void rMatrixMath::affineInverse( rMat4<float> const &_in, rMat4<float> &_out ) {
+   internal::mat4AffineInverse( _in.vDataMat, _out.vDataMat );
+}
+
+/*!
+ * \brief Inverts an affine matrix with the fast path of its transformation class
+ *
+ * Rigid and uniformly scaled matrices are inverted by transposing the upper 3x3 matrix (see
+ * internal::mat4RigidInverseScalar), general ones with affineInverse( _in, _out ).
+ */
+template <class T>
+void rMatrixMath::affineInverse( rMat4<T> const &_in, rMat4<T> &_out, TRANSFORM_CLASS _class ) {
+   if ( _class == TRANSFORM_GENERAL ) {
+      affineInverse( _in, _out );
+      return;
+   }
+
+   internal::mat4RigidInverseScalar( _in.vDataMat, inverseScale2( _in, _class ), _out.vDataMat );
+}
+
+template <>
+inline void
+rMatrixMath::affineInverse( rMat4<float> const &_in, rMat4<float> &_out, TRANSFORM_CLASS _class ) {
+   if ( _class == TRANSFORM_GENERAL ) {
+      affineInverse( _in, _out );
+      return;
+   }
+
+   internal::mat4RigidInverse( _in.vDataMat, inverseScale2( _in, _class ), _out.vDataMat );
+}
+
+/*!
+ * \brief The transformation class of a model matrix with the scale _scale
+ */
 template <class T>
-void rMatrixMath::getNormalMatrix( rMat4<T> const &_in, rMat3<T> &_out ) {
-   rMat3<T> lTemp;
+constexpr rMatrixMath::TRANSFORM_CLASS rMatrixMath::getTransformClass( const rVec3<T> &_scale ) {
+   if ( _scale[0] != _scale[1] || _scale[0] != _scale[2] )
+      return TRANSFORM_GENERAL;
+
+   return _scale[0] == 1 ? TRANSFORM_RIGID : TRANSFORM_UNIFORM_SCALE;
+}
+
+/*!
+ * \brief 1 / s^2 of a matrix with the uniform scale s (the squared length of the first column)
+ *
+ * Returns exactly 1 for rigid transformations. Not defined for TRANSFORM_GENERAL.
+ */
+template <class T>
+constexpr T rMatrixMath::inverseScale2( rMat4<T> const &_in, TRANSFORM_CLASS _class ) {
+   if ( _class == TRANSFORM_RIGID )
+      return 1;
+
+   return 1 / ( _in.template get<0, 0>() * _in.template get<0, 0>() +
+                _in.template get<0, 1>() * _in.template get<0, 1>() +
+                _in.template get<0, 2>() * _in.template get<0, 2>() );
+}
+
+
+template <class T>
+constexpr void rMatrixMath::getNormalMatrix( rMat4<T> const &_in, rMat3<T> &_out ) {
+   rMat3<T> lTemp( static_cast<T>( 0 ) );
    _in.downscale( &lTemp );
    getNormalMatrix( lTemp, _out );
 }
 
+/*!
+ * \brief getNormalMatrix with the fast path of the transformation class of _in
+ *
+ *  - rigid:         the inverse transpose of a rotation is the rotation itself
+ *  - uniform scale: ( s * R )^-T = R / s, so the upper 3x3 matrix is multiplied with 1 / s^2
+ *  - general:       the inverse transpose (getNormalMatrix( _in, _out ))
+ */
+template <class T>
+constexpr void
+rMatrixMath::getNormalMatrix( rMat4<T> const &_in, rMat3<T> &_out, TRANSFORM_CLASS _class ) {
+   if ( _class == TRANSFORM_GENERAL ) {
+      getNormalMatrix( _in, _out );
+      return;
+   }
+
+   _in.downscale( &_out );
+
+   if ( _class == TRANSFORM_UNIFORM_SCALE )
+      _out *= inverseScale2( _in, _class );
+}
+
 template <class T>
-void rMatrixMath::getNormalMatrix( rMat3<T> const &_in, rMat3<T> &_out ) {
+constexpr void rMatrixMath::getNormalMatrix( rMat3<T> const &_in, rMat3<T> &_out ) {
    T lDeterminante =
          +_in.template get<0, 0>() * ( _in.template get<1, 1>() * _in.template get<2, 2>() -
                                        _in.template get<1, 2>() * _in.template get<2, 1>() ) -
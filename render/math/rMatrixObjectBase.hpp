@@ -25,24 +25,39 @@
 
 #include "rMatrixMath.hpp"
 #include "rMatrixSceneBase.hpp"
+#include "rQuat.hpp"
+#include "rSceneGraph.hpp"
+#include "rTransformSystem.hpp"
+
+#include <cmath>
+#include <algorithm>
 
 namespace e_engine {
 
 /*!
  * \brief Class for managing Camera space matrix
  *
+ * Only the position, the rotation (quaternion) and the scale are stored. The model matrix is
+ * built directly from them (rMatrixMath::transformation).
+ *
+ * The matrices are calculated lazily (see updateFinalMatrix): the setters only mark the model
+ * matrix as dirty and a camera change is detected with the version of the scene. So a static
+ * object only recalculates its view dependent matrices after a camera change, and a moving one
+ * everything at most once per frame.
  *
+ * Objects can be attached to each other (setParent). Their position, rotation and scale are then
+ * relative to the parent and the model matrix is the world matrix of their node in a rSceneGraph.
  */
 template <class T>
 class rMatrixObjectBase {
- private:
-   rMat4<T> vScaleMatrix_MAT;
-   rMat4<T> vRotationMatrix_MAT;
-   rMat4<T> vTranslationMatrix_MAT;
+ public:
+   enum DIRTY_FLAGS {
+      MODEL_DIRTY = ( 1 << 0 ),          //!< Position, rotation or scale changed
+      BOUNDING_VOLUME_DIRTY = ( 1 << 1 ) //!< The world space bounding volume is out of date
+   };
 
-   rMat4<T> *vViewProjectionMatrix_MAT;
-   rMat4<T> *vViewMatrix_MAT;
-   rMat4<T> *vProjectionMatrix_MAT;
+ private:
+   rMatrixSceneBase<T> *vScene;
 
    rMat4<T> vModelMatrix_MAT;
    rMat4<T> vModelViewMatrix_MAT;
@@ -53,135 +68,438 @@ class rMatrixObjectBase {
    rVec3<T> vPosition;
    rVec3<T> vPositionModelView;
    rVec3<T> vScale;
+   rQuat<T> vRotation; //!< Normalized quaternion
+
+   rMatrixMath::TRANSFORM_CLASS vTransformClass; //!< Of the model matrix
+
+   rTransformSystem<T> *vTransforms; //!< Calculates the final matrices if set
+   size_t vTransformID;
+
+   rSceneGraph<T> *vGraph; //!< Calculates the model matrix (with the parents) if set
+   size_t vNodeID;
+   uint64_t vNodeVersion; //!< rSceneGraph::getWorldVersion() of the model matrix
+
+   rVec3<T> vBoxMin; //!< Bounding box (object space)
+   rVec3<T> vBoxMax;
+   rVec4<T> vSphere; //!< Bounding sphere (object space; w is the radius)
+
+   rVec3<T> vWorldBoxMin; //!< Bounding box (world space)
+   rVec3<T> vWorldBoxMax;
+   rVec4<T> vWorldSphere; //!< Bounding sphere (world space; w is the radius)
+
+   bool vHasBoundingVolume;
+
+   uint32_t vDirty;        //!< DIRTY_FLAGS
+   uint64_t vSceneVersion; //!< rMatrixSceneBase::getVersion() of the view dependent matrices
 
    rMatrixObjectBase();
 
+   inline void transformationChanged();
+   inline void updateBoundingVolume();
+
  public:
    rMatrixObjectBase( rMatrixSceneBase<T> *_scene );
+   ~rMatrixObjectBase();
+
+   // Forbid copying (the ID in the transform system can only have one owner)
+   rMatrixObjectBase( const rMatrixObjectBase & ) = delete;
+   rMatrixObjectBase &operator=( const rMatrixObjectBase & ) = delete;
+
+   bool setTransformSystem( rTransformSystem<T> *_system );
+   rTransformSystem<T> *getTransformSystem() { return vTransforms; }
+
+   bool setSceneGraph( rSceneGraph<T> *_graph, size_t _parentNode = rSceneGraph<T>::INVALID_ID );
+   bool setParent( rMatrixObjectBase *_parent );
+   rSceneGraph<T> *getSceneGraph() { return vGraph; }
+   size_t getSceneNode() const { return vNodeID; }
 
    inline void setPosition( const rVec3<T> &_pos );
    inline void getPosition( rVec3<T> &_pos );
    inline rVec3<T> *getPosition() { return &vPosition; }
-   inline rVec3<T> *getPositionModelView() { return &vPositionModelView; }
+   inline rVec3<T> *getPositionModelView() {
+      updateFinalMatrix();
+      return vTransforms ? vTransforms->getPositionModelView( vTransformID ) : &vPositionModelView;
+   }
    inline void addPositionDelta( const rVec3<T> &_pos );
 
    inline void setRotation( const rVec3<T> &_axis, T _angle );
+   inline void setRotation( const rQuat<T> &_rotation );
+   inline rQuat<T> *getRotation() { return &vRotation; }
+   inline void addRotationDelta( const rQuat<T> &_rotation );
 
    inline void setScale( T _scale );
    inline void setScale( const rVec3<T> &_scale );
    inline rVec3<T> *getScale() { return &vScale; }
+   inline rMatrixMath::TRANSFORM_CLASS getTransformClass() const { return vTransformClass; }
    inline void addScaleDelta( const rVec3<T> &_scale );
 
 
-   inline rMat4<T> *getScaleMatrix() { return &vScaleMatrix_MAT; }
-   inline rMat4<T> *getRotationMatrix() { return &vRotationMatrix_MAT; }
-   inline rMat4<T> *getTranslationMatrix() { return &vTranslationMatrix_MAT; }
+   inline void getScaleMatrix( rMat4<T> &_out ) const { rMatrixMath::scale( vScale, _out ); }
+   inline void getRotationMatrix( rMat4<T> &_out ) const { vRotation.toMatrix( _out ); }
+   inline void getTranslationMatrix( rMat4<T> &_out ) const {
+      rMatrixMath::translate( vPosition, _out );
+   }
 
-   inline rMat4<T> *getModelMatrix() { return &vModelMatrix_MAT; }
-   inline rMat4<T> *getModelViewMatrix() { return &vModelViewMatrix_MAT; }
-   inline rMat4<T> *getViewMatrix() { return vViewMatrix_MAT; }
+   // The getters update the matrices first. Renderers keep the pointers, so the scene calls
+   // updateFinalMatrix() every frame (rObjectBase::updateMatrices)
+   inline rMat4<T> *getModelMatrix() {
+      updateFinalMatrix();
+      return vTransforms ? vTransforms->getModelMatrix( vTransformID ) : &vModelMatrix_MAT;
+   }
+   inline rMat4<T> *getModelViewMatrix() {
+      updateFinalMatrix();
+      return vTransforms ? vTransforms->getModelViewMatrix( vTransformID ) : &vModelViewMatrix_MAT;
+   }
+   inline rMat4<T> *getViewMatrix() { return vScene->getViewMatrix(); }
+
+   inline rMat4<T> *getProjectionMatrix() { return vScene->getProjectionMatrix(); }
+   inline rMat4<T> *getViewProjectionMatrix() { return vScene->getViewProjectionMatrix(); }
+   inline rMat4<T> *getModelViewProjectionMatrix() {
+      updateFinalMatrix();
+      return vTransforms ? vTransforms->getModelViewProjectionMatrix( vTransformID )
+                         : &vModelViewProjectionMatrix_MAT;
+   }
+
+   inline rMat3<T> *getNormalMatrix() {
+      updateFinalMatrix();
+      return vTransforms ? vTransforms->getNormalMatrix( vTransformID ) : &vNormalMatrix;
+   }
 
-   inline rMat4<T> *getProjectionMatrix() { return vProjectionMatrix_MAT; }
-   inline rMat4<T> *getViewProjectionMatrix() { return vViewProjectionMatrix_MAT; }
-   inline rMat4<T> *getModelViewProjectionMatrix() { return &vModelViewProjectionMatrix_MAT; }
+   inline void setBoundingVolume( const rVec3<T> &_min,
+                                  const rVec3<T> &_max,
+                                  const rVec4<T> &_sphere );
+   inline void clearBoundingVolume() { vHasBoundingVolume = false; }
+   inline bool getHasBoundingVolume() const { return vHasBoundingVolume; }
 
-   inline rMat3<T> *getNormalMatrix() { return &vNormalMatrix; }
+   inline rVec3<T> *getWorldBoxMin() {
+      updateFinalMatrix();
+      return &vWorldBoxMin;
+   }
+   inline rVec3<T> *getWorldBoxMax() {
+      updateFinalMatrix();
+      return &vWorldBoxMax;
+   }
+   inline rVec4<T> *getWorldSphere() {
+      updateFinalMatrix();
+      return &vWorldSphere;
+   }
+
+   inline uint32_t getDirtyFlags() const { return vDirty; }
 
    inline void updateFinalMatrix();
 };
 
 template <class T>
-rMatrixObjectBase<T>::rMatrixObjectBase( rMatrixSceneBase<T> *_scene ) {
-   vScaleMatrix_MAT.toIdentityMatrix();
-   vRotationMatrix_MAT.toIdentityMatrix();
-   vTranslationMatrix_MAT.toIdentityMatrix();
-   vModelViewMatrix_MAT.toIdentityMatrix();
+rMatrixObjectBase<T>::rMatrixObjectBase( rMatrixSceneBase<T> *_scene )
+    : vScene( _scene ),
+      vPosition( 0, 0, 0 ),
+      vScale( 1, 1, 1 ),
+      vTransformClass( rMatrixMath::TRANSFORM_RIGID ),
+      vTransforms( nullptr ),
+      vTransformID( rTransformSystem<T>::INVALID_ID ),
+      vGraph( nullptr ),
+      vNodeID( rSceneGraph<T>::INVALID_ID ),
+      vNodeVersion( 0 ),
+      vBoxMin( 0, 0, 0 ),
+      vBoxMax( 0, 0, 0 ),
+      vSphere( 0, 0, 0, 0 ),
+      vWorldBoxMin( 0, 0, 0 ),
+      vWorldBoxMax( 0, 0, 0 ),
+      vWorldSphere( 0, 0, 0, 0 ),
+      vHasBoundingVolume( false ),
+      vDirty( MODEL_DIRTY | BOUNDING_VOLUME_DIRTY ),
+      vSceneVersion( _scene->getVersion() ) {}
 
-   vViewProjectionMatrix_MAT = _scene->getViewProjectionMatrix();
-   vViewMatrix_MAT = _scene->getViewMatrix();
-   vProjectionMatrix_MAT = _scene->getProjectionMatrix();
+template <class T>
+rMatrixObjectBase<T>::~rMatrixObjectBase() {
+   if ( vTransforms )
+      vTransforms->remove( vTransformID );
 
-   vModelMatrix_MAT = vTranslationMatrix_MAT * vRotationMatrix_MAT * vScaleMatrix_MAT;
+   if ( vGraph )
+      vGraph->remove( vNodeID );
+}
 
-   if ( vViewProjectionMatrix_MAT )
-      vModelViewProjectionMatrix_MAT = *vViewProjectionMatrix_MAT * vModelMatrix_MAT;
-   else
-      vModelViewProjectionMatrix_MAT.toIdentityMatrix();
+/*!
+ * \brief Moves the transformation of this object into a (batched) transform system
+ *
+ * The final matrices are then stored in and calculated by _system. updateFinalMatrix() only
+ * updates this object, unless the camera changed: then the first call updates all objects of the
+ * system at once (rTransformSystem::refresh). Call rTransformSystem::update( pool ) after a camera
+ * change to split that work on a worker pool.
+ *
+ * \param[in] _system The transform system (nullptr to calculate the matrices here again)
+ * \returns false if _system is full or the object is in a scene graph (the object is not moved
+ *          then)
+ *
+ * \warning Renderers keep pointers to the matrices, so call this before setting the renderer
+ */
+template <class T>
+bool rMatrixObjectBase<T>::setTransformSystem( rTransformSystem<T> *_system ) {
+   if ( _system == vTransforms )
+      return true;
+
+   if ( _system && vGraph )
+      return false;
+
+   size_t lID = rTransformSystem<T>::INVALID_ID;
+
+   if ( _system ) {
+      lID = _system->add();
+      if ( lID == rTransformSystem<T>::INVALID_ID )
+         return false;
+   }
+
+   if ( vTransforms )
+      vTransforms->remove( vTransformID );
+
+   vTransforms = _system;
+   vTransformID = lID;
+
+   transformationChanged();
+   return true;
 }
 
+/*!
+ * \brief Moves this object into a scene graph (as a new node)
+ *
+ * The position, rotation and scale are then relative to the parent node and the model matrix is
+ * the world matrix of the node. The graph must outlive the object.
+ *
+ * \param[in] _graph      The scene graph (nullptr to leave the current one)
+ * \param[in] _parentNode The parent node in _graph (INVALID_ID for a root node)
+ * \returns false if the object uses a transform system (the hierarchy is not batched)
+ */
 template <class T>
-void rMatrixObjectBase<T>::setScale( T _scale ) {
-   vScale.fill( _scale );
+bool rMatrixObjectBase<T>::setSceneGraph( rSceneGraph<T> *_graph, size_t _parentNode ) {
+   if ( _graph && vTransforms )
+      return false;
 
-   vScaleMatrix_MAT.setMat( _scale, 0, 0, 0, 0, _scale, 0, 0, 0, 0, _scale, 0, 0, 0, 0, 1 );
+   if ( vGraph )
+      vGraph->remove( vNodeID );
 
-   updateFinalMatrix();
+   vGraph = _graph;
+   vNodeID = _graph ? _graph->add( _parentNode ) : rSceneGraph<T>::INVALID_ID;
+   vNodeVersion = 0;
+
+   transformationChanged();
+   return true;
 }
 
+/*!
+ * \brief Attaches this object to _parent (e.g. a light to a moving object)
+ *
+ * The object joins the scene graph of _parent if necessary. Its position, rotation and scale are
+ * kept, but are relative to _parent from now on.
+ *
+ * \param[in] _parent The new parent (nullptr to make this object a root of its scene graph)
+ * \returns false if _parent is not in a scene graph, is a child of this object or if this object
+ *          uses a transform system
+ */
 template <class T>
-void rMatrixObjectBase<T>::setScale( const rVec3<T> &_scale ) {
-   vScale = _scale;
+bool rMatrixObjectBase<T>::setParent( rMatrixObjectBase *_parent ) {
+   if ( !_parent )
+      return !vGraph || vGraph->setParent( vNodeID, rSceneGraph<T>::INVALID_ID );
 
-   vScaleMatrix_MAT.setMat( _scale.x, 0, 0, 0, 0, _scale.y, 0, 0, 0, 0, _scale.z, 0, 0, 0, 0, 1 );
+   if ( !_parent->vGraph )
+      return false;
 
-   updateFinalMatrix();
+   if ( vGraph != _parent->vGraph )
+      return setSceneGraph( _parent->vGraph, _parent->vNodeID );
+
+   return vGraph->setParent( vNodeID, _parent->vNodeID );
+}
+
+template <class T>
+void rMatrixObjectBase<T>::setScale( T _scale ) {
+   vScale.fill( _scale );
+   transformationChanged();
+}
+
+template <class T>
+void rMatrixObjectBase<T>::setScale( const rVec3<T> &_scale ) {
+   vScale = _scale;
+   transformationChanged();
 }
 
 
 template <class T>
 void rMatrixObjectBase<T>::addScaleDelta( const rVec3<T> &_scale ) {
    vScale += _scale;
+   transformationChanged();
+}
 
-   vScaleMatrix_MAT.setMat( vScale.x, 0, 0, 0, 0, vScale.y, 0, 0, 0, 0, vScale.z, 0, 0, 0, 0, 1 );
+template <class T>
+void rMatrixObjectBase<T>::setRotation( const rVec3<T> &_axis, T _angle ) {
+   vRotation = rQuat<T>::fromAxisAngle( _axis, _angle );
+   transformationChanged();
+}
 
-   updateFinalMatrix();
+template <class T>
+void rMatrixObjectBase<T>::setRotation( const rQuat<T> &_rotation ) {
+   vRotation = _rotation;
+   transformationChanged();
 }
 
+/*!
+ * \brief Rotates the object further (_rotation is applied after the current rotation)
+ *
+ * Cheaper than setRotation( axis, angle ) for a continuous rotation: one quaternion product
+ * instead of sin / cos. The result is normalized, so the rounding errors do not add up.
+ */
 template <class T>
-void rMatrixObjectBase<T>::setRotation( const rVec3<T> &_axis, T _angle ) {
-   rMatrixMath::rotate( _axis, _angle, vRotationMatrix_MAT );
+void rMatrixObjectBase<T>::addRotationDelta( const rQuat<T> &_rotation ) {
+   vRotation = _rotation * vRotation;
+   vRotation.normalize();
+   transformationChanged();
+}
 
-   updateFinalMatrix();
+/*!
+ * \brief Marks the model matrix as dirty (and passes the transformation to the transform system
+ *        or the scene graph)
+ */
+template <class T>
+void rMatrixObjectBase<T>::transformationChanged() {
+   if ( vTransforms ) {
+      vTransforms->setPosition( vTransformID, vPosition );
+      vTransforms->setRotation( vTransformID, vRotation );
+      vTransforms->setScale( vTransformID, vScale );
+   }
+
+   if ( vGraph )
+      vGraph->setTransform( vNodeID, vPosition, vRotation, vScale );
+
+   vTransformClass = rMatrixMath::getTransformClass( vScale );
+   vDirty |= MODEL_DIRTY | BOUNDING_VOLUME_DIRTY;
 }
 
 
 template <class T>
 void rMatrixObjectBase<T>::setPosition( const rVec3<T> &_pos ) {
    vPosition = _pos;
-
-   vTranslationMatrix_MAT.setMat( 1, 0, 0, _pos.x, 0, 1, 0, _pos.y, 0, 0, 1, _pos.z, 0, 0, 0, 1 );
-
-   updateFinalMatrix();
+   transformationChanged();
 }
 
 
 template <class T>
 void rMatrixObjectBase<T>::addPositionDelta( const rVec3<T> &_pos ) {
    vPosition += _pos;
-
-   vTranslationMatrix_MAT.setMat(
-         1, 0, 0, vPosition.x, 0, 1, 0, vPosition.y, 0, 0, 1, vPosition.z, 0, 0, 0, 1 );
-
-   updateFinalMatrix();
+   transformationChanged();
 }
 
 
+/*!
+ * \brief Recalculates the matrices that are out of date
+ *
+ *  - the model matrix (and the world space bounding volume) after a change of the position,
+ *    rotation or scale (or of a parent in the scene graph)
+ *  - the model view (projection) and normal matrix after that or after a camera change (the
+ *    version of the scene changed)
+ *
+ * Without a change this only costs the checks. With a transform system the system does the work
+ * (rTransformSystem::refresh). In a scene graph the first object updated after a change updates
+ * the whole graph (rSceneGraph::update).
+ */
 template <class T>
 void rMatrixObjectBase<T>::updateFinalMatrix() {
-   vModelMatrix_MAT = vTranslationMatrix_MAT * vRotationMatrix_MAT * vScaleMatrix_MAT;
+   if ( vTransforms ) {
+      vTransforms->refresh( vTransformID );
+   } else {
+      uint64_t lVersion = vScene->getVersion();
+
+      if ( vGraph ) {
+         vGraph->update();
+
+         if ( vGraph->getWorldVersion( vNodeID ) != vNodeVersion )
+            vDirty |= MODEL_DIRTY | BOUNDING_VOLUME_DIRTY;
+      }
+
+      if ( !vDirty && lVersion == vSceneVersion )
+         return;
+
+      if ( ( vDirty & MODEL_DIRTY ) && vGraph ) {
+         vModelMatrix_MAT = *vGraph->getWorldMatrix( vNodeID );
+         vNodeVersion = vGraph->getWorldVersion( vNodeID );
+         vTransformClass = vGraph->getTransformClass( vNodeID );
+      } else if ( vDirty & MODEL_DIRTY ) {
+         rMatrixMath::transformation( vPosition, vRotation, vScale, vModelMatrix_MAT );
+      }
+
+      if ( ( vDirty & MODEL_DIRTY ) || lVersion != vSceneVersion ) {
+         vModelViewProjectionMatrix_MAT = *vScene->getViewProjectionMatrix() * vModelMatrix_MAT;
+         vModelViewMatrix_MAT = *vScene->getViewMatrix() * vModelMatrix_MAT;
+
+         rVec4<T> lTemp( 0, 0, 0, 1 );
+         lTemp = vModelViewMatrix_MAT * lTemp;
+         lTemp.downscale( &vPositionModelView );
+
+         // The view matrix is rigid, so the model view has the class of the model matrix
+         rMatrixMath::getNormalMatrix( vModelViewMatrix_MAT, vNormalMatrix, vTransformClass );
+         vSceneVersion = lVersion;
+      }
+   }
+
+   if ( vDirty & BOUNDING_VOLUME_DIRTY )
+      updateBoundingVolume();
 
-   if ( vViewProjectionMatrix_MAT )
-      vModelViewProjectionMatrix_MAT = *vViewProjectionMatrix_MAT * vModelMatrix_MAT;
+   vDirty = 0;
+}
 
-   if ( vViewMatrix_MAT ) {
-      vModelViewMatrix_MAT = *vViewMatrix_MAT * vModelMatrix_MAT;
+/*!
+ * \brief Sets the object space bounding volume and calculates the world space version
+ * \param[in] _min    Minimum of the bounding box
+ * \param[in] _max    Maximum of the bounding box
+ * \param[in] _sphere Center (xyz) and radius (w) of the bounding sphere
+ */
+template <class T>
+void rMatrixObjectBase<T>::setBoundingVolume( const rVec3<T> &_min,
+                                              const rVec3<T> &_max,
+                                              const rVec4<T> &_sphere ) {
+   vBoxMin = _min;
+   vBoxMax = _max;
+   vSphere = _sphere;
+   vHasBoundingVolume = true;
+
+   vDirty |= BOUNDING_VOLUME_DIRTY;
+}
 
-      rVec4<T> lTemp( 0, 0, 0, 1 );
-      lTemp = vModelViewMatrix_MAT * lTemp;
-      lTemp.downscale( &vPositionModelView );
+/*!
+ * \brief Transforms the bounding volume into world space (model matrix)
+ *
+ * The box is the axis aligned box around the transformed box: the transformed center plus the
+ * extent multiplied with the absolute values of the matrix (Arvo). The sphere radius is scaled by
+ * the largest axis scale.
+ */
+template <class T>
+void rMatrixObjectBase<T>::updateBoundingVolume() {
+   if ( !vHasBoundingVolume )
+      return;
+
+   rMat4<T> const &lM =
+         vTransforms ? *vTransforms->getModelMatrix( vTransformID ) : vModelMatrix_MAT;
+   T lScale2 = 0;
+
+   // get( column, row )
+   for ( uint32_t r = 0; r < 3; ++r ) {
+      T lCenter = lM.get( 3, r );
+      T lExtent = 0;
+      T lSphere = lM.get( 3, r );
+
+      for ( uint32_t c = 0; c < 3; ++c ) {
+         lCenter += lM.get( c, r ) * ( vBoxMin[c] + vBoxMax[c] ) / 2;
+         lExtent += std::abs( lM.get( c, r ) ) * ( vBoxMax[c] - vBoxMin[c] ) / 2;
+         lSphere += lM.get( c, r ) * vSphere[c];
+      }
+
+      vWorldBoxMin[r] = lCenter - lExtent;
+      vWorldBoxMax[r] = lCenter + lExtent;
+      vWorldSphere[r] = lSphere;
+
+      T lColumn = lM.get( r, 0 ) * lM.get( r, 0 ) + lM.get( r, 1 ) * lM.get( r, 1 ) +
+                  lM.get( r, 2 ) * lM.get( r, 2 );
+      lScale2 = std::max( lScale2, lColumn );
    }
 
-   rMatrixMath::getNormalMatrix( vModelViewMatrix_MAT, vNormalMatrix );
+   vWorldSphere[3] = vSphere[3] * std::sqrt( lScale2 );
 }
 }
 
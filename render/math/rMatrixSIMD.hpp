@@ -0,0 +1,397 @@
+/*!
+ * \file rMatrixSIMD.hpp
+ * \brief \b Classes: \a none (SSE kernels for 4x4 float matrices)
+ */
+/*
+ * Copyright (C) 2015 EEnginE project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef R_MATRIX_SIMD_HPP
+#define R_MATRIX_SIMD_HPP
+
+#include "defines.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdint.h>
+
+#if E_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+/*
+ * All kernels work on column major 4x4 matrices (the layout of rMatrix) and are selected at
+ * compile time (E_SIMD_SSE2 or the scalar versions). The output may be the same memory as one
+ * of the inputs.
+ *
+ * There is no AVX version of mat4Multiply: an 8 wide kernel (two columns per register) was slower
+ * than the SSE2 one in the matrix benchmark (BenchClass::doMatrix).
+ *
+ * The SIMD versions do exactly the same operations in the same order as the scalar ones:
+ *  - mat4Multiply:      bit identical to the hardcoded 4x4 rMatrix::multiply
+ *  - mat4MultiplyVec4:  equal to the generic rMatrix::multiply (which starts the sum with +0, so
+ *                       only the sign of a zero result can be different)
+ *  - mat4Transpose:     bit identical
+ *  - mat4AffineInverse: bit identical to mat4AffineInverseScalar
+ *  - mat4RigidInverse:  bit identical to mat4RigidInverseScalar
+ *  - quatMultiply:      bit identical to quatMultiplyScalar
+ *  - quatNormalize:     bit identical to quatNormalizeScalar
+ *
+ * When the compiler is allowed to contract a * b + c into FMA instructions (-mfma without
+ * -ffp-contract=off), both versions can differ in the last bit (relative error < 1e-6).
+ */
+
+namespace e_engine {
+
+namespace internal {
+
+template <class T>
+inline void mat4MultiplyScalar( T const *_a, T const *_b, T *_out ) {
+   T lResult[16];
+
+   for ( uint32_t i = 0; i < 4; ++i )
+      for ( uint32_t j = 0; j < 4; ++j )
+         lResult[i * 4 + j] = ( ( _a[j] * _b[i * 4] ) + ( _a[j + 4] * _b[i * 4 + 1] ) +
+                                ( _a[j + 8] * _b[i * 4 + 2] ) + ( _a[j + 12] * _b[i * 4 + 3] ) );
+
+   std::copy( lResult, lResult + 16, _out );
+}
+
+template <class T>
+inline void mat4MultiplyVec4Scalar( T const *_m, T const *_v, T *_out ) {
+   T lResult[4];
+
+   for ( uint32_t j = 0; j < 4; ++j )
+      lResult[j] = ( ( _m[j] * _v[0] ) + ( _m[j + 4] * _v[1] ) + ( _m[j + 8] * _v[2] ) +
+                     ( _m[j + 12] * _v[3] ) );
+
+   std::copy( lResult, lResult + 4, _out );
+}
+
+template <class T>
+inline void mat4TransposeScalar( T const *_m, T *_out ) {
+   T lResult[16];
+
+   for ( uint32_t i = 0; i < 4; ++i )
+      for ( uint32_t j = 0; j < 4; ++j )
+         lResult[j * 4 + i] = _m[i * 4 + j];
+
+   std::copy( lResult, lResult + 16, _out );
+}
+
+/*!
+ * \brief Inverts an affine matrix (last row 0 0 0 1)
+ *
+ * The inverse of the upper 3x3 matrix are the cross products of its columns divided by the
+ * determinant. This also works with shearing and non uniform scaling, but the 3x3 matrix must be
+ * invertible.
+ */
+template <class T>
+inline void mat4AffineInverseScalar( T const *_m, T *_out ) {
+   T const *c0 = _m;
+   T const *c1 = _m + 4;
+   T const *c2 = _m + 8;
+   T lT[3] = {_m[12], _m[13], _m[14]};
+
+   // The rows of the inverse
+   T r[3][3] = {{c1[1] * c2[2] - c1[2] * c2[1],
+                 c1[2] * c2[0] - c1[0] * c2[2],
+                 c1[0] * c2[1] - c1[1] * c2[0]},
+                {c2[1] * c0[2] - c2[2] * c0[1],
+                 c2[2] * c0[0] - c2[0] * c0[2],
+                 c2[0] * c0[1] - c2[1] * c0[0]},
+                {c0[1] * c1[2] - c0[2] * c1[1],
+                 c0[2] * c1[0] - c0[0] * c1[2],
+                 c0[0] * c1[1] - c0[1] * c1[0]}};
+
+   T lDet = ( c0[0] * r[0][0] + c0[1] * r[0][1] ) + c0[2] * r[0][2];
+
+   for ( uint32_t j = 0; j < 3; ++j ) {
+      for ( uint32_t i = 0; i < 3; ++i )
+         _out[j * 4 + i] = r[i][j] / lDet;
+
+      _out[j * 4 + 3] = 0;
+   }
+
+   for ( uint32_t i = 0; i < 3; ++i )
+      _out[12 + i] = -( ( lT[0] * _out[i] + lT[1] * _out[4 + i] ) + lT[2] * _out[8 + i] );
+
+   _out[15] = 1;
+}
+
+/*!
+ * \brief Inverts a rotation (with uniform scale s) and translation
+ *
+ * The inverse of s * R is R^T / s^2, so the upper 3x3 matrix is only transposed and multiplied
+ * with _invScale2 = 1 / s^2 (1 for a rigid transformation).
+ */
+template <class T>
+inline void mat4RigidInverseScalar( T const *_m, T _invScale2, T *_out ) {
+   T lT[3] = {_m[12], _m[13], _m[14]};
+   T lR[12];
+
+   for ( uint32_t j = 0; j < 3; ++j ) {
+      for ( uint32_t i = 0; i < 3; ++i )
+         lR[j * 4 + i] = _m[i * 4 + j] * _invScale2;
+
+      lR[j * 4 + 3] = 0;
+   }
+
+   std::copy( lR, lR + 12, _out );
+
+   for ( uint32_t i = 0; i < 3; ++i )
+      _out[12 + i] = -( ( lT[0] * _out[i] + lT[1] * _out[4 + i] ) + lT[2] * _out[8 + i] );
+
+   _out[15] = 1;
+}
+
+//! Hamilton product _a * _b of two quaternions (x, y, z, w)
+template <class T>
+constexpr void quatMultiplyScalar( T const *_a, T const *_b, T *_out ) {
+   T x1 = _a[0], y1 = _a[1], z1 = _a[2], w1 = _a[3];
+   T x2 = _b[0], y2 = _b[1], z2 = _b[2], w2 = _b[3];
+
+   _out[0] = ( w1 * x2 ) + ( x1 * w2 ) + ( y1 * z2 ) - ( z1 * y2 );
+   _out[1] = ( w1 * y2 ) - ( x1 * z2 ) + ( y1 * w2 ) + ( z1 * x2 );
+   _out[2] = ( w1 * z2 ) + ( x1 * y2 ) - ( y1 * x2 ) + ( z1 * w2 );
+   _out[3] = ( w1 * w2 ) - ( x1 * x2 ) - ( y1 * y2 ) - ( z1 * z2 );
+}
+
+template <class T>
+inline void quatNormalizeScalar( T *_q ) {
+   T lLength = std::sqrt( ( _q[0] * _q[0] + _q[1] * _q[1] ) + ( _q[2] * _q[2] + _q[3] * _q[3] ) );
+
+   for ( uint32_t i = 0; i < 4; ++i )
+      _q[i] /= lLength;
+}
+
+
+#if E_SIMD_SSE2
+
+//! a.yzx * b.zxy - a.zxy * b.yzx (w is 0 for finite values)
+inline __m128 crossSSE( __m128 _a, __m128 _b ) {
+   __m128 lA1 = _mm_shuffle_ps( _a, _a, _MM_SHUFFLE( 3, 0, 2, 1 ) );
+   __m128 lB1 = _mm_shuffle_ps( _b, _b, _MM_SHUFFLE( 3, 1, 0, 2 ) );
+   __m128 lA2 = _mm_shuffle_ps( _a, _a, _MM_SHUFFLE( 3, 1, 0, 2 ) );
+   __m128 lB2 = _mm_shuffle_ps( _b, _b, _MM_SHUFFLE( 3, 0, 2, 1 ) );
+   return _mm_sub_ps( _mm_mul_ps( lA1, lB1 ), _mm_mul_ps( lA2, lB2 ) );
+}
+
+//! Broadcasts element I of _v
+template <int I>
+inline __m128 splatSSE( __m128 _v ) {
+   return _mm_shuffle_ps( _v, _v, _MM_SHUFFLE( I, I, I, I ) );
+}
+
+/*!
+ * \brief 4 floats with arithmetic operators (one lane per object in the batched kernels)
+ */
+struct rPack4f {
+   __m128 v;
+
+   rPack4f() {}
+   rPack4f( __m128 _v ) : v( _v ) {}
+};
+
+inline rPack4f operator+( rPack4f _a, rPack4f _b ) { return _mm_add_ps( _a.v, _b.v ); }
+inline rPack4f operator-( rPack4f _a, rPack4f _b ) { return _mm_sub_ps( _a.v, _b.v ); }
+inline rPack4f operator*( rPack4f _a, rPack4f _b ) { return _mm_mul_ps( _a.v, _b.v ); }
+inline rPack4f operator/( rPack4f _a, rPack4f _b ) { return _mm_div_ps( _a.v, _b.v ); }
+inline rPack4f operator-( rPack4f _a ) { return _mm_xor_ps( _a.v, _mm_set1_ps( -0.0f ) ); }
+
+#endif // E_SIMD_SSE2
+
+
+/*!
+ * \brief _out = _a * _b (column major 4x4 matrices)
+ */
+inline void mat4Multiply( float const *_a, float const *_b, float *_out ) {
+#if E_SIMD_SSE2
+   __m128 lA0 = _mm_loadu_ps( _a + 0 );
+   __m128 lA1 = _mm_loadu_ps( _a + 4 );
+   __m128 lA2 = _mm_loadu_ps( _a + 8 );
+   __m128 lA3 = _mm_loadu_ps( _a + 12 );
+
+   __m128 lB[4] = {_mm_loadu_ps( _b + 0 ),
+                   _mm_loadu_ps( _b + 4 ),
+                   _mm_loadu_ps( _b + 8 ),
+                   _mm_loadu_ps( _b + 12 )};
+
+   for ( uint32_t i = 0; i < 4; ++i ) {
+      __m128 lR = _mm_mul_ps( lA0, splatSSE<0>( lB[i] ) );
+      lR = _mm_add_ps( lR, _mm_mul_ps( lA1, splatSSE<1>( lB[i] ) ) );
+      lR = _mm_add_ps( lR, _mm_mul_ps( lA2, splatSSE<2>( lB[i] ) ) );
+      lR = _mm_add_ps( lR, _mm_mul_ps( lA3, splatSSE<3>( lB[i] ) ) );
+      _mm_storeu_ps( _out + i * 4, lR );
+   }
+#else
+   mat4MultiplyScalar( _a, _b, _out );
+#endif
+}
+
+/*!
+ * \brief _out = _m * _v (column major 4x4 matrix; 4D vector)
+ */
+inline void mat4MultiplyVec4( float const *_m, float const *_v, float *_out ) {
+#if E_SIMD_SSE2
+   __m128 lV = _mm_loadu_ps( _v );
+
+   __m128 lR = _mm_mul_ps( _mm_loadu_ps( _m + 0 ), splatSSE<0>( lV ) );
+   lR = _mm_add_ps( lR, _mm_mul_ps( _mm_loadu_ps( _m + 4 ), splatSSE<1>( lV ) ) );
+   lR = _mm_add_ps( lR, _mm_mul_ps( _mm_loadu_ps( _m + 8 ), splatSSE<2>( lV ) ) );
+   lR = _mm_add_ps( lR, _mm_mul_ps( _mm_loadu_ps( _m + 12 ), splatSSE<3>( lV ) ) );
+   _mm_storeu_ps( _out, lR );
+#else
+   mat4MultiplyVec4Scalar( _m, _v, _out );
+#endif
+}
+
+inline void mat4Transpose( float const *_m, float *_out ) {
+#if E_SIMD_SSE2
+   __m128 lC0 = _mm_loadu_ps( _m + 0 );
+   __m128 lC1 = _mm_loadu_ps( _m + 4 );
+   __m128 lC2 = _mm_loadu_ps( _m + 8 );
+   __m128 lC3 = _mm_loadu_ps( _m + 12 );
+
+   _MM_TRANSPOSE4_PS( lC0, lC1, lC2, lC3 );
+
+   _mm_storeu_ps( _out + 0, lC0 );
+   _mm_storeu_ps( _out + 4, lC1 );
+   _mm_storeu_ps( _out + 8, lC2 );
+   _mm_storeu_ps( _out + 12, lC3 );
+#else
+   mat4TransposeScalar( _m, _out );
+#endif
+}
+
+/*!
+ * \brief Inverts an affine matrix (see mat4AffineInverseScalar)
+ */
+inline void mat4AffineInverse( float const *_m, float *_out ) {
+#if E_SIMD_SSE2
+   __m128 lC0 = _mm_loadu_ps( _m + 0 );
+   __m128 lC1 = _mm_loadu_ps( _m + 4 );
+   __m128 lC2 = _mm_loadu_ps( _m + 8 );
+   __m128 lT = _mm_loadu_ps( _m + 12 );
+
+   // The rows of the inverse
+   __m128 lR0 = crossSSE( lC1, lC2 );
+   __m128 lR1 = crossSSE( lC2, lC0 );
+   __m128 lR2 = crossSSE( lC0, lC1 );
+   __m128 lR3 = _mm_setzero_ps();
+
+   // ( x + y ) + z in the first element
+   __m128 lDet = _mm_mul_ps( lC0, lR0 );
+   lDet = _mm_add_ss( _mm_add_ss( lDet, splatSSE<1>( lDet ) ), splatSSE<2>( lDet ) );
+   lDet = splatSSE<0>( lDet );
+
+   lR0 = _mm_div_ps( lR0, lDet );
+   lR1 = _mm_div_ps( lR1, lDet );
+   lR2 = _mm_div_ps( lR2, lDet );
+
+   // Rows -> columns; the 4th row (0) is the w component of the columns
+   _MM_TRANSPOSE4_PS( lR0, lR1, lR2, lR3 );
+
+   __m128 lTInv = _mm_mul_ps( splatSSE<0>( lT ), lR0 );
+   lTInv = _mm_add_ps( lTInv, _mm_mul_ps( splatSSE<1>( lT ), lR1 ) );
+   lTInv = _mm_add_ps( lTInv, _mm_mul_ps( splatSSE<2>( lT ), lR2 ) );
+   lTInv = _mm_xor_ps( lTInv, _mm_set1_ps( -0.0f ) );
+
+   _mm_storeu_ps( _out + 0, lR0 );
+   _mm_storeu_ps( _out + 4, lR1 );
+   _mm_storeu_ps( _out + 8, lR2 );
+   _mm_storeu_ps( _out + 12, lTInv );
+   _out[15] = 1;
+#else
+   mat4AffineInverseScalar( _m, _out );
+#endif
+}
+
+/*!
+ * \brief Inverts a rotation (with uniform scale) and translation (see mat4RigidInverseScalar)
+ */
+inline void mat4RigidInverse( float const *_m, float _invScale2, float *_out ) {
+#if E_SIMD_SSE2
+   __m128 lScale = _mm_set1_ps( _invScale2 );
+   __m128 lR0 = _mm_mul_ps( _mm_loadu_ps( _m + 0 ), lScale );
+   __m128 lR1 = _mm_mul_ps( _mm_loadu_ps( _m + 4 ), lScale );
+   __m128 lR2 = _mm_mul_ps( _mm_loadu_ps( _m + 8 ), lScale );
+   __m128 lR3 = _mm_setzero_ps();
+   __m128 lT = _mm_loadu_ps( _m + 12 );
+
+   // The columns become the rows; the 4th row (0) is the w component of the columns
+   _MM_TRANSPOSE4_PS( lR0, lR1, lR2, lR3 );
+
+   __m128 lTInv = _mm_mul_ps( splatSSE<0>( lT ), lR0 );
+   lTInv = _mm_add_ps( lTInv, _mm_mul_ps( splatSSE<1>( lT ), lR1 ) );
+   lTInv = _mm_add_ps( lTInv, _mm_mul_ps( splatSSE<2>( lT ), lR2 ) );
+   lTInv = _mm_xor_ps( lTInv, _mm_set1_ps( -0.0f ) );
+
+   _mm_storeu_ps( _out + 0, lR0 );
+   _mm_storeu_ps( _out + 4, lR1 );
+   _mm_storeu_ps( _out + 8, lR2 );
+   _mm_storeu_ps( _out + 12, lTInv );
+   _out[15] = 1;
+#else
+   mat4RigidInverseScalar( _m, _invScale2, _out );
+#endif
+}
+
+/*!
+ * \brief _out = _a * _b (quaternions)
+ *
+ * Every lane is w1 * b + x1 * b.wzyx + y1 * b.zwxy + z1 * b.yxwz with the signs of the Hamilton
+ * product applied to the shuffled b.
+ */
+inline void quatMultiply( float const *_a, float const *_b, float *_out ) {
+#if E_SIMD_SSE2
+   __m128 lA = _mm_loadu_ps( _a );
+   __m128 lB = _mm_loadu_ps( _b );
+
+   // _mm_set_ps takes the lanes in reverse order ( w, z, y, x )
+   __m128 lB1 = _mm_shuffle_ps( lB, lB, _MM_SHUFFLE( 0, 1, 2, 3 ) );
+   __m128 lB2 = _mm_shuffle_ps( lB, lB, _MM_SHUFFLE( 1, 0, 3, 2 ) );
+   __m128 lB3 = _mm_shuffle_ps( lB, lB, _MM_SHUFFLE( 2, 3, 0, 1 ) );
+   lB1 = _mm_xor_ps( lB1, _mm_set_ps( -0.0f, 0.0f, -0.0f, 0.0f ) );
+   lB2 = _mm_xor_ps( lB2, _mm_set_ps( -0.0f, -0.0f, 0.0f, 0.0f ) );
+   lB3 = _mm_xor_ps( lB3, _mm_set_ps( -0.0f, 0.0f, 0.0f, -0.0f ) );
+
+   __m128 lR = _mm_mul_ps( splatSSE<3>( lA ), lB );
+   lR = _mm_add_ps( lR, _mm_mul_ps( splatSSE<0>( lA ), lB1 ) );
+   lR = _mm_add_ps( lR, _mm_mul_ps( splatSSE<1>( lA ), lB2 ) );
+   lR = _mm_add_ps( lR, _mm_mul_ps( splatSSE<2>( lA ), lB3 ) );
+   _mm_storeu_ps( _out, lR );
+#else
+   quatMultiplyScalar( _a, _b, _out );
+#endif
+}
+
+inline void quatNormalize( float *_q ) {
+#if E_SIMD_SSE2
+   __m128 lQ = _mm_loadu_ps( _q );
+   __m128 lSum = _mm_mul_ps( lQ, lQ );
+   lSum = _mm_add_ps( lSum, _mm_shuffle_ps( lSum, lSum, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+   lSum = _mm_add_ps( lSum, _mm_shuffle_ps( lSum, lSum, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+   _mm_storeu_ps( _q, _mm_div_ps( lQ, _mm_sqrt_ps( lSum ) ) );
+#else
+   quatNormalizeScalar( _q );
+#endif
+}
+}
+}
+
+#endif // R_MATRIX_SIMD_HPP
+
+// kate: indent-mode cstyle; indent-width 3; replace-tabs on; line-numbers on;
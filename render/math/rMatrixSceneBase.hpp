@@ -39,6 +39,8 @@ class rMatrixSceneBase {
    rMat4<T> vViewMatrix_MAT;
    rMat4<T> vViewProjectionMatrix_MAT;
 
+   uint64_t vVersion = 0; //!< Incremented on every change of the matrices
+
  public:
    rMatrixSceneBase();
 
@@ -51,6 +53,14 @@ class rMatrixSceneBase {
    inline rMat4<T> *getProjectionMatrix() { return &vProjectionMatrix_MAT; }
    inline rMat4<T> *getViewMatrix() { return &vViewMatrix_MAT; }
    inline rMat4<T> *getViewProjectionMatrix() { return &vViewProjectionMatrix_MAT; }
+
+   /*!
+    * \brief Changes whenever the view or the projection matrix changes
+    *
+    * Objects compare it with the version their matrices were calculated with, so they only
+    * recalculate the view dependent matrices after a camera change (see rMatrixObjectBase).
+    */
+   inline uint64_t getVersion() const { return vVersion; }
 };
 
 
@@ -76,6 +86,7 @@ void
 rMatrixSceneBase<T>::calculateProjectionPerspective( T _aspectRatio, T _nearZ, T _farZ, T _fofy ) {
    rMatrixMath::perspective( _aspectRatio, _nearZ, _farZ, _fofy, vProjectionMatrix_MAT );
    vViewProjectionMatrix_MAT = vProjectionMatrix_MAT * vViewMatrix_MAT;
+   ++vVersion;
 }
 
 /*!
@@ -92,6 +103,7 @@ void rMatrixSceneBase<T>::calculateProjectionPerspective(
       T _width, T _height, T _nearZ, T _farZ, T _fofy ) {
    rMatrixMath::perspective( _width / _height, _nearZ, _farZ, _fofy, vProjectionMatrix_MAT );
    vViewProjectionMatrix_MAT = vProjectionMatrix_MAT * vViewMatrix_MAT;
+   ++vVersion;
 }
 
 /*!
@@ -107,6 +119,7 @@ void rMatrixSceneBase<T>::setCamera( const rVec3<T> &_position,
                                      const rVec3<T> &_upVector ) {
    rMatrixMath::camera( _position, _lookAt, _upVector, vViewMatrix_MAT );
    vViewProjectionMatrix_MAT = vProjectionMatrix_MAT * vViewMatrix_MAT;
+   ++vVersion;
 }
 }
 
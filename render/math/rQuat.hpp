@@ -0,0 +1,179 @@
+/*!
+ * \file rQuat.hpp
+ * \brief \b Classes: \a rQuat
+ */
+/*
+ * Copyright (C) 2015 EEnginE project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef R_QUAT_HPP
+#define R_QUAT_HPP
+
+#include "defines.hpp"
+
+#include "rMatrixMath.hpp"
+#include "rMatrixSIMD.hpp"
+
+#include <cmath>
+
+namespace e_engine {
+
+/*!
+ * \brief Rotation quaternion (x, y, z, w)
+ *
+ * A rQuat is a rVec4, so it can be passed to everything that expects a quaternion as rVec4
+ * (rMatrixMath::rotate, rTransformSystem::setRotation). It only needs 4 values instead of a
+ * 4x4 matrix and 2 rotations are combined with 16 multiplications instead of 64.
+ *
+ * q1 * q2 first rotates with q2 and then with q1 (like the product of the rotation matrices).
+ */
+template <class T>
+class rQuat : public rVec4<T> {
+ public:
+   //! The identity (no rotation)
+   constexpr rQuat() : rVec4<T>( 0, 0, 0, 1 ) {}
+   constexpr rQuat( T _x, T _y, T _z, T _w )
+       : rVec4<T>( static_cast<T>( _x ), static_cast<T>( _y ), static_cast<T>( _z ),
+                   static_cast<T>( _w ) ) {}
+   constexpr explicit rQuat( const rVec4<T> &_vec ) : rVec4<T>( _vec ) {}
+
+   static rQuat fromAxisAngle( const rVec3<T> &_axis, T _angle );
+   static rQuat slerp( const rQuat &_from, const rQuat &_to, T _t );
+
+   constexpr rQuat conjugate() const;
+   constexpr T dot( const rQuat &_quat ) const;
+
+   inline void normalize();
+
+   //! The rotation matrix (see rMatrixMath::rotate)
+   constexpr void toMatrix( rMat4<T> &_out ) const { rMatrixMath::rotate( *this, _out ); }
+
+   constexpr rVec3<T> rotate( const rVec3<T> &_vec ) const;
+
+   inline rQuat &operator*=( const rQuat &_quat );
+};
+
+typedef rQuat<float> rQuatf;
+typedef rQuat<double> rQuatd;
+
+//! Hamilton product: rotates with _b and then with _a
+template <class T>
+constexpr rQuat<T> operator*( const rQuat<T> &_a, const rQuat<T> &_b ) {
+   rQuat<T> lOut;
+   internal::quatMultiplyScalar( _a.vDataMat, _b.vDataMat, lOut.vDataMat );
+   return lOut;
+}
+
+template <>
+inline rQuat<float> operator*( const rQuat<float> &_a, const rQuat<float> &_b ) {
+   rQuat<float> lOut;
+   internal::quatMultiply( _a.vDataMat, _b.vDataMat, lOut.vDataMat );
+   return lOut;
+}
+
+template <class T>
+rQuat<T> &rQuat<T>::operator*=( const rQuat &_quat ) {
+   return *this = *this * _quat;
+}
+
+/*!
+ * \brief Creates the rotation quaternion of a rotation around _axis
+ * \param[in] _axis  The rotation axis
+ * \param[in] _angle The angle in degrees
+ */
+template <class T>
+rQuat<T> rQuat<T>::fromAxisAngle( const rVec3<T> &_axis, T _angle ) {
+   rQuat lOut;
+   rMatrixMath::rotationQuaternion( _axis, _angle, lOut );
+   return lOut;
+}
+
+//! The inverse rotation (for normalized quaternions)
+template <class T>
+constexpr rQuat<T> rQuat<T>::conjugate() const {
+   return rQuat( -( *this )[0], -( *this )[1], -( *this )[2], ( *this )[3] );
+}
+
+template <class T>
+constexpr T rQuat<T>::dot( const rQuat &_quat ) const {
+   return ( ( *this )[0] * _quat[0] + ( *this )[1] * _quat[1] ) +
+          ( ( *this )[2] * _quat[2] + ( *this )[3] * _quat[3] );
+}
+
+/*!
+ * \brief Scales the quaternion to the length 1
+ *
+ * Call this now and then when combining many rotations, or the rounding errors add up to a
+ * scaling.
+ */
+template <class T>
+void rQuat<T>::normalize() {
+   internal::quatNormalizeScalar( this->vDataMat );
+}
+
+template <>
+inline void rQuat<float>::normalize() {
+   internal::quatNormalize( this->vDataMat );
+}
+
+//! Rotates _vec: v + 2w (q x v) + 2 q x (q x v)
+template <class T>
+constexpr rVec3<T> rQuat<T>::rotate( const rVec3<T> &_vec ) const {
+   rVec3<T> lQ( static_cast<T>( ( *this )[0] ),
+                static_cast<T>( ( *this )[1] ),
+                static_cast<T>( ( *this )[2] ) );
+   rVec3<T> lT = rVectorMath::crossProduct( lQ, _vec ) * static_cast<T>( 2 );
+   return _vec + lT * ( *this )[3] + rVectorMath::crossProduct( lQ, lT );
+}
+
+/*!
+ * \brief Spherical linear interpolation with the shortest path
+ *
+ * Almost equal rotations are interpolated linearly (and normalized), because sin( angle ) gets
+ * too close to 0 for the division.
+ *
+ * \param[in] _from The rotation for _t = 0
+ * \param[in] _to   The rotation for _t = 1
+ * \param[in] _t    The interpolation factor [0, 1]
+ */
+template <class T>
+rQuat<T> rQuat<T>::slerp( const rQuat &_from, const rQuat &_to, T _t ) {
+   T lCos = _from.dot( _to );
+   rQuat lTo = _to;
+
+   // q and -q are the same rotation: take the one with the smaller angle
+   if ( lCos < 0 ) {
+      lCos = -lCos;
+      lTo = rQuat( -_to[0], -_to[1], -_to[2], -_to[3] );
+   }
+
+   if ( lCos > static_cast<T>( 0.9995 ) ) {
+      rQuat lOut( rVec4<T>( _from * ( 1 - _t ) + lTo * _t ) );
+      lOut.normalize();
+      return lOut;
+   }
+
+   T lAngle = std::acos( lCos );
+   T lSin = std::sin( lAngle );
+   T lWeightFrom = std::sin( ( 1 - _t ) * lAngle ) / lSin;
+   T lWeightTo = std::sin( _t * lAngle ) / lSin;
+
+   return rQuat( rVec4<T>( _from * lWeightFrom + lTo * lWeightTo ) );
+}
+}
+
+#endif // R_QUAT_HPP
+
+// kate: indent-mode cstyle; indent-width 3; replace-tabs on; line-numbers on;
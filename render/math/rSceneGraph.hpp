@@ -0,0 +1,432 @@
+/*!
+ * \file rSceneGraph.hpp
+ * \brief \b Classes: \a rSceneGraph
+ */
+/*
+ * Copyright (C) 2015 EEnginE project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef R_SCENE_GRAPH_HPP
+#define R_SCENE_GRAPH_HPP
+
+#include "defines.hpp"
+
+#include "rMatrixMath.hpp"
+#include "rQuat.hpp"
+
+#include <vector>
+#include <algorithm>
+
+namespace e_engine {
+
+/*!
+ * \brief Hierarchy of transformations (parent / child)
+ *
+ * Every node has a local transformation (position, rotation, scale) relative to its parent. The
+ * world matrix of a node is the world matrix of its parent times its local matrix.
+ *
+ * The nodes are stored in arrays sorted in depth first pre-order: a parent is always in front of
+ * its children and every subtree is one contiguous range. update() finds the changed nodes with
+ * one linear scan and recalculates only their subtrees, from front to back (the parent matrix is
+ * always up to date when a child needs it). The local matrices are cached, so an unchanged child
+ * of a moved node costs one matrix product.
+ *
+ * Nodes are addressed by IDs, which stay valid until the node is removed. The arrays are sorted
+ * again in update() after a structural change (add() with a parent that is not the last subtree,
+ * remove() or setParent()); pointers returned by getWorldMatrix() are only valid until then.
+ *
+ * \sa rMatrixObjectBase::setParent
+ */
+template <class T>
+class rSceneGraph {
+ public:
+   static const size_t INVALID_ID = static_cast<size_t>( -1 );
+
+ private:
+   // Indexed by the position in the sorted arrays
+   std::vector<size_t> vNodeID;     //!< INVALID_ID for removed nodes (until the next sort)
+   std::vector<size_t> vParent;     //!< Position of the parent (can be removed until the next sort)
+   std::vector<size_t> vSubtreeEnd; //!< Position after the last node of the subtree
+
+   std::vector<rVec3<T>> vPosition;
+   std::vector<rQuat<T>> vRotation;
+   std::vector<rVec3<T>> vScale;
+
+   std::vector<rMat4<T>> vLocal;
+   std::vector<rMat4<T>> vWorld;
+
+   std::vector<uint8_t> vLocalClass; //!< rMatrixMath::TRANSFORM_CLASS of the local matrix
+   std::vector<uint8_t> vWorldClass; //!< rMatrixMath::TRANSFORM_CLASS of the world matrix
+   std::vector<uint8_t> vDirty;      //!< 1 if the local transformation or the parent changed
+   std::vector<uint64_t> vVersion;   //!< Number of the update() that last changed the world matrix
+
+   // Indexed by the node ID
+   std::vector<size_t> vIndex; //!< Position in the sorted arrays
+   std::vector<size_t> vFreeIDs;
+
+   uint64_t vUpdateCount;
+   bool vHasDirty;
+   bool vNeedsSort;
+
+   void sort();
+   size_t propagate( size_t _first, size_t _last );
+
+   template <class V>
+   static void permute( std::vector<V> &_v, std::vector<size_t> const &_order );
+
+ public:
+   rSceneGraph() : vUpdateCount( 0 ), vHasDirty( false ), vNeedsSort( false ) {}
+
+   // Forbid copying (the nodes are owned by the objects using their IDs)
+   rSceneGraph( const rSceneGraph & ) = delete;
+   rSceneGraph &operator=( const rSceneGraph & ) = delete;
+
+   size_t add( size_t _parent = INVALID_ID );
+   void remove( size_t _id );
+
+   bool setParent( size_t _id, size_t _parent );
+   inline size_t getParent( size_t _id ) const;
+
+   inline void setTransform( size_t _id,
+                             const rVec3<T> &_position,
+                             const rQuat<T> &_rotation,
+                             const rVec3<T> &_scale );
+
+   size_t update();
+
+   inline rMat4<T> const *getWorldMatrix( size_t _id ) const { return &vWorld[vIndex[_id]]; }
+   inline uint64_t getWorldVersion( size_t _id ) const { return vVersion[vIndex[_id]]; }
+   inline rMatrixMath::TRANSFORM_CLASS getTransformClass( size_t _id ) const {
+      return static_cast<rMatrixMath::TRANSFORM_CLASS>( vWorldClass[vIndex[_id]] );
+   }
+
+   size_t getSize() const { return vIndex.size() - vFreeIDs.size(); }
+};
+
+template <class T>
+const size_t rSceneGraph<T>::INVALID_ID;
+
+/*!
+ * \brief Adds a node (no translation, no rotation, scale 1)
+ *
+ * The node is appended to the arrays. That keeps them sorted for a root and for a child of the
+ * last subtree (building a hierarchy from top to bottom), otherwise the next update() sorts again.
+ *
+ * \param[in] _parent The parent node (INVALID_ID for a root)
+ * \returns the ID of the new node
+ */
+template <class T>
+size_t rSceneGraph<T>::add( size_t _parent ) {
+   size_t lID;
+   size_t lPos = vNodeID.size();
+   size_t lParent = _parent == INVALID_ID ? INVALID_ID : vIndex[_parent];
+
+   if ( !vFreeIDs.empty() ) {
+      lID = vFreeIDs.back();
+      vFreeIDs.pop_back();
+      vIndex[lID] = lPos;
+   } else {
+      lID = vIndex.size();
+      vIndex.push_back( lPos );
+   }
+
+   vNodeID.push_back( lID );
+   vParent.push_back( lParent );
+   vSubtreeEnd.push_back( lPos + 1 );
+   vPosition.emplace_back( 0, 0, 0 );
+   vRotation.emplace_back();
+   vScale.emplace_back( 1, 1, 1 );
+   vLocal.emplace_back();
+   vWorld.emplace_back();
+   vLocalClass.push_back( rMatrixMath::TRANSFORM_RIGID );
+   vWorldClass.push_back( rMatrixMath::TRANSFORM_RIGID );
+   vDirty.push_back( 1 );
+   vVersion.push_back( 0 );
+   vHasDirty = true;
+
+   if ( lParent == INVALID_ID )
+      return lID;
+
+   if ( vSubtreeEnd[lParent] != lPos ) {
+      vNeedsSort = true;
+      return lID;
+   }
+
+   // The parent and all its ancestors end with the new node now
+   for ( size_t i = lParent; i != INVALID_ID; i = vParent[i] )
+      vSubtreeEnd[i] = lPos + 1;
+
+   return lID;
+}
+
+/*!
+ * \brief Removes a node (its children are attached to its parent)
+ *
+ * The node is only marked as removed; it keeps its parent, so that the next update() (sort())
+ * can attach the children to the next ancestor that is not removed. That keeps removing all n
+ * nodes of a scene O(n).
+ */
+template <class T>
+void rSceneGraph<T>::remove( size_t _id ) {
+   if ( _id >= vIndex.size() || vIndex[_id] == INVALID_ID )
+      return;
+
+   size_t lPos = vIndex[_id];
+
+   vNodeID[lPos] = INVALID_ID;
+   vDirty[lPos] = 0;
+   vIndex[_id] = INVALID_ID;
+   vFreeIDs.push_back( _id );
+   vNeedsSort = true;
+}
+
+/*!
+ * \brief Attaches _id to a new parent (its local transformation is kept)
+ * \param[in] _id     The node
+ * \param[in] _parent The new parent (INVALID_ID to make _id a root)
+ * \returns false if _parent is _id or one of its descendants
+ */
+template <class T>
+bool rSceneGraph<T>::setParent( size_t _id, size_t _parent ) {
+   size_t lPos = vIndex[_id];
+   size_t lParent = _parent == INVALID_ID ? INVALID_ID : vIndex[_parent];
+
+   for ( size_t i = lParent; i != INVALID_ID; i = vParent[i] )
+      if ( i == lPos )
+         return false;
+
+   if ( vParent[lPos] == lParent )
+      return true;
+
+   vParent[lPos] = lParent;
+   vDirty[lPos] = 1;
+   vHasDirty = true;
+   vNeedsSort = true;
+   return true;
+}
+
+template <class T>
+size_t rSceneGraph<T>::getParent( size_t _id ) const {
+   size_t lParent = vParent[vIndex[_id]];
+
+   // Skip the removed parents (until the next sort)
+   while ( lParent != INVALID_ID && vNodeID[lParent] == INVALID_ID )
+      lParent = vParent[lParent];
+
+   return lParent == INVALID_ID ? INVALID_ID : vNodeID[lParent];
+}
+
+//! Sets the transformation of _id relative to its parent
+template <class T>
+void rSceneGraph<T>::setTransform( size_t _id,
+                                   const rVec3<T> &_position,
+                                   const rQuat<T> &_rotation,
+                                   const rVec3<T> &_scale ) {
+   size_t lPos = vIndex[_id];
+
+   vPosition[lPos] = _position;
+   vRotation[lPos] = _rotation;
+   vScale[lPos] = _scale;
+   vLocalClass[lPos] = rMatrixMath::getTransformClass( _scale );
+   vDirty[lPos] = 1;
+   vHasDirty = true;
+}
+
+/*!
+ * \brief Recalculates the world matrices of all changed nodes and their descendants
+ *
+ * Without a change this only costs a check. Not thread safe.
+ *
+ * \returns the number of recalculated world matrices
+ */
+template <class T>
+size_t rSceneGraph<T>::update() {
+   if ( vNeedsSort )
+      sort();
+
+   if ( !vHasDirty )
+      return 0;
+
+   ++vUpdateCount;
+
+   size_t lNumUpdated = 0;
+   auto lBegin = vDirty.begin();
+   auto lEnd = vDirty.end();
+
+   for ( auto i = std::find( lBegin, lEnd, 1 ); i != lEnd; i = std::find( i, lEnd, 1 ) ) {
+      size_t lPos = static_cast<size_t>( i - lBegin );
+      lNumUpdated += propagate( lPos, vSubtreeEnd[lPos] );
+      i = lBegin + vSubtreeEnd[lPos];
+   }
+
+   vHasDirty = false;
+   return lNumUpdated;
+}
+
+/*!
+ * \brief Recalculates the world matrices of the nodes _first to _last - 1 (one subtree)
+ * \returns the number of nodes
+ */
+template <class T>
+size_t rSceneGraph<T>::propagate( size_t _first, size_t _last ) {
+   for ( size_t i = _first; i < _last; ++i ) {
+      if ( vDirty[i] ) {
+         rMatrixMath::transformation( vPosition[i], vRotation[i], vScale[i], vLocal[i] );
+         vDirty[i] = 0;
+      }
+
+      size_t lParent = vParent[i];
+
+      if ( lParent == INVALID_ID ) {
+         vWorld[i] = vLocal[i];
+         vWorldClass[i] = vLocalClass[i];
+      } else {
+         vWorld[i] = vWorld[lParent] * vLocal[i];
+         vWorldClass[i] = std::max( vWorldClass[lParent], vLocalClass[i] );
+      }
+
+      vVersion[i] = vUpdateCount;
+   }
+
+   return _last - _first;
+}
+
+/*!
+ * \brief Sorts the nodes in depth first pre-order (children keep their relative order)
+ *
+ * Also drops the removed nodes; their children are attached to the next ancestor that is not
+ * removed. The subtree ends are calculated back to front: all descendants of a node are behind it.
+ */
+template <class T>
+void rSceneGraph<T>::sort() {
+   size_t lSize = vNodeID.size();
+
+   for ( size_t i = 0; i < lSize; ++i ) {
+      size_t lParent = vParent[i];
+
+      if ( vNodeID[i] == INVALID_ID || lParent == INVALID_ID || vNodeID[lParent] != INVALID_ID )
+         continue;
+
+      size_t lAlive = lParent;
+      while ( lAlive != INVALID_ID && vNodeID[lAlive] == INVALID_ID )
+         lAlive = vParent[lAlive];
+
+      // Path compression: the other children of the removed nodes skip the walk
+      while ( lParent != lAlive ) {
+         size_t lNext = vParent[lParent];
+         vParent[lParent] = lAlive;
+         lParent = lNext;
+      }
+
+      vParent[i] = lAlive;
+      vDirty[i] = 1;
+      vHasDirty = true;
+   }
+
+   std::vector<size_t> lFirstChild( lSize, INVALID_ID );
+   std::vector<size_t> lLastChild( lSize, INVALID_ID );
+   std::vector<size_t> lNextSibling( lSize, INVALID_ID );
+
+   for ( size_t i = 0; i < lSize; ++i ) {
+      size_t lParent = vParent[i];
+
+      if ( vNodeID[i] == INVALID_ID || lParent == INVALID_ID )
+         continue;
+
+      if ( lLastChild[lParent] == INVALID_ID )
+         lFirstChild[lParent] = i;
+      else
+         lNextSibling[lLastChild[lParent]] = i;
+
+      lLastChild[lParent] = i;
+   }
+
+   std::vector<size_t> lOrder;
+   lOrder.reserve( lSize );
+
+   for ( size_t lRoot = 0; lRoot < lSize; ++lRoot ) {
+      if ( vNodeID[lRoot] == INVALID_ID || vParent[lRoot] != INVALID_ID )
+         continue;
+
+      size_t lNode = lRoot;
+
+      while ( true ) {
+         lOrder.push_back( lNode );
+
+         if ( lFirstChild[lNode] != INVALID_ID ) {
+            lNode = lFirstChild[lNode];
+            continue;
+         }
+
+         while ( lNode != lRoot && lNextSibling[lNode] == INVALID_ID )
+            lNode = vParent[lNode];
+
+         if ( lNode == lRoot )
+            break;
+
+         lNode = lNextSibling[lNode];
+      }
+   }
+
+   std::vector<size_t> lNewPos( lSize, INVALID_ID );
+   for ( size_t i = 0; i < lOrder.size(); ++i )
+      lNewPos[lOrder[i]] = i;
+
+   permute( vNodeID, lOrder );
+   permute( vParent, lOrder );
+   permute( vPosition, lOrder );
+   permute( vRotation, lOrder );
+   permute( vScale, lOrder );
+   permute( vLocal, lOrder );
+   permute( vWorld, lOrder );
+   permute( vLocalClass, lOrder );
+   permute( vWorldClass, lOrder );
+   permute( vDirty, lOrder );
+   permute( vVersion, lOrder );
+
+   vSubtreeEnd.resize( lOrder.size() );
+
+   for ( size_t i = 0; i < lOrder.size(); ++i ) {
+      if ( vParent[i] != INVALID_ID )
+         vParent[i] = lNewPos[vParent[i]];
+
+      vIndex[vNodeID[i]] = i;
+      vSubtreeEnd[i] = i + 1;
+   }
+
+   for ( size_t i = lOrder.size(); i-- > 0; )
+      if ( vParent[i] != INVALID_ID )
+         vSubtreeEnd[vParent[i]] = std::max( vSubtreeEnd[vParent[i]], vSubtreeEnd[i] );
+
+   vNeedsSort = false;
+}
+
+//! _v[i] = old _v[_order[i]] (shrinks _v to the size of _order)
+template <class T>
+template <class V>
+void rSceneGraph<T>::permute( std::vector<V> &_v, std::vector<size_t> const &_order ) {
+   std::vector<V> lOut;
+   lOut.reserve( _order.size() );
+
+   for ( size_t i : _order )
+      lOut.push_back( _v[i] );
+
+   _v.swap( lOut );
+}
+}
+
+#endif // R_SCENE_GRAPH_HPP
+
+// kate: indent-mode cstyle; indent-width 3; replace-tabs on; line-numbers on;
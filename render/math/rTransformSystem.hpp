@@ -0,0 +1,467 @@
+/*!
+ * \file rTransformSystem.hpp
+ * \brief \b Classes: \a rTransformSystem
+ */
+/*
+ * Copyright (C) 2015 EEnginE project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef R_TRANSFORM_SYSTEM_HPP
+#define R_TRANSFORM_SYSTEM_HPP
+
+#include "defines.hpp"
+
+#include "rMatrixMath.hpp"
+#include "rMatrixSIMD.hpp"
+#include "rMatrixSceneBase.hpp"
+#include "uWorkerPool.hpp"
+
+#include <vector>
+#include <future>
+#include <algorithm>
+
+namespace e_engine {
+
+namespace internal {
+
+//! One object per pack (the scalar version and the tail of the SIMD loop)
+template <class T>
+struct rScalarPack {
+   typedef T TYPE;
+   static const size_t SIZE = 1;
+
+   static T load( T const *_p ) { return *_p; }
+   static T splat( T _v ) { return _v; }
+   static void store( T const *_elements, size_t _num, T *_dst, size_t ) {
+      std::copy( _elements, _elements + _num, _dst );
+   }
+};
+
+#if E_SIMD_SSE2
+
+//! 4 float objects per pack
+struct rSSEPack {
+   typedef rPack4f TYPE;
+   static const size_t SIZE = 4;
+
+   static rPack4f load( float const *_p ) { return _mm_loadu_ps( _p ); }
+   static rPack4f splat( float _v ) { return _mm_set1_ps( _v ); }
+
+   //! Writes element i of object j to _dst[j * _stride + i] (4 elements per transpose)
+   static void store( rPack4f const *_elements, size_t _num, float *_dst, size_t _stride ) {
+      size_t lNumFull = _num - _num % 4;
+
+      for ( size_t i = 0; i < lNumFull; i += 4 ) {
+         __m128 l0 = _elements[i + 0].v;
+         __m128 l1 = _elements[i + 1].v;
+         __m128 l2 = _elements[i + 2].v;
+         __m128 l3 = _elements[i + 3].v;
+
+         _MM_TRANSPOSE4_PS( l0, l1, l2, l3 );
+
+         _mm_storeu_ps( _dst + i, l0 );
+         _mm_storeu_ps( _dst + _stride + i, l1 );
+         _mm_storeu_ps( _dst + 2 * _stride + i, l2 );
+         _mm_storeu_ps( _dst + 3 * _stride + i, l3 );
+      }
+
+      for ( size_t i = lNumFull; i < _num; ++i ) {
+         alignas( 16 ) float lTemp[4];
+         _mm_store_ps( lTemp, _elements[i].v );
+
+         for ( size_t j = 0; j < 4; ++j )
+            _dst[j * _stride + i] = lTemp[j];
+      }
+   }
+};
+
+#endif // E_SIMD_SSE2
+
+template <class T>
+struct rBatchPack {
+   typedef rScalarPack<T> PACK;
+};
+
+#if E_SIMD_SSE2
+template <>
+struct rBatchPack<float> {
+   typedef rSSEPack PACK;
+};
+#endif
+}
+
+/*!
+ * \brief Batched transformations of many objects
+ *
+ * Position, rotation (normalized quaternion, see rMatrixMath::rotationQuaternion) and scale of
+ * every object are stored as structure of arrays. update() calculates the model, model view,
+ * model view projection and normal matrix and the model view position of all objects in one pass
+ * (4 objects per SSE register for float) and can split the work on a uWorkerPool.
+ *
+ * The results are stored in contiguous arrays with one element per object. The capacity is fixed,
+ * so pointers to the results stay valid until the transform system is destroyed.
+ *
+ * The results are equal to the ones of rMatrixObjectBase (only the sign of zeros can differ,
+ * because the multiplications with the zeros of the affine matrices are skipped). The normal
+ * matrix is always the general inverse transpose here, so for rigid and uniformly scaled objects
+ * it can differ in the last bits from the fast paths of rMatrixObjectBase.
+ *
+ * refresh() only updates what is out of date: all objects after a camera change (see
+ * rMatrixSceneBase::getVersion), otherwise only the objects with a changed transformation.
+ *
+ * \sa rMatrixObjectBase::setTransformSystem
+ */
+template <class T>
+class rTransformSystem {
+ public:
+   static const size_t INVALID_ID = static_cast<size_t>( -1 );
+   static const size_t MIN_JOB_SIZE = 1024; //!< Minimum number of objects per worker job
+
+   static_assert( sizeof( rMat4<T> ) == 16 * sizeof( T ) && sizeof( rMat3<T> ) == 9 * sizeof( T ) &&
+                        sizeof( rVec3<T> ) == 3 * sizeof( T ),
+                  "The output arrays must be tightly packed" );
+
+ private:
+   rMatrixSceneBase<T> *vScene;
+
+   size_t vCapacity;
+   size_t vSize; //!< Number of used IDs (including the removed ones)
+
+   std::vector<size_t> vFreeIDs;
+
+   std::vector<T> vPosX;
+   std::vector<T> vPosY;
+   std::vector<T> vPosZ;
+
+   std::vector<T> vRotX;
+   std::vector<T> vRotY;
+   std::vector<T> vRotZ;
+   std::vector<T> vRotW;
+
+   std::vector<T> vScaleX;
+   std::vector<T> vScaleY;
+   std::vector<T> vScaleZ;
+
+   std::vector<rMat4<T>> vModel;
+   std::vector<rMat4<T>> vModelView;
+   std::vector<rMat4<T>> vModelViewProjection;
+   std::vector<rMat3<T>> vNormal;
+   std::vector<rVec3<T>> vPositionModelView;
+
+   std::vector<uint8_t> vDirty; //!< 1 if the transformation changed since the last update
+   uint64_t vSceneVersion;      //!< rMatrixSceneBase::getVersion() of the last update()
+
+   template <class PACK>
+   size_t updateBlocks( size_t _first, size_t _last );
+
+   template <class V>
+   static inline void multiplyAffine( V const *_a, V const *_m, V *_out );
+
+   rTransformSystem() {}
+
+ public:
+   rTransformSystem( rMatrixSceneBase<T> *_scene, size_t _capacity );
+
+   // Forbid copying (the results are referenced by pointers)
+   rTransformSystem( const rTransformSystem & ) = delete;
+   rTransformSystem &operator=( const rTransformSystem & ) = delete;
+
+   size_t add();
+   void remove( size_t _id );
+
+   inline void setPosition( size_t _id, const rVec3<T> &_pos );
+   inline void setRotation( size_t _id, const rVec4<T> &_quaternion );
+   inline void setScale( size_t _id, const rVec3<T> &_scale );
+
+   void update( uWorkerPool *_pool = nullptr );
+   void update( size_t _first, size_t _last );
+   inline void refresh( size_t _id );
+
+   size_t getSize() const { return vSize; }
+   size_t getCapacity() const { return vCapacity; }
+
+   rMat4<T> *getModelMatrix( size_t _id ) { return &vModel[_id]; }
+   rMat4<T> *getModelViewMatrix( size_t _id ) { return &vModelView[_id]; }
+   rMat4<T> *getModelViewProjectionMatrix( size_t _id ) { return &vModelViewProjection[_id]; }
+   rMat3<T> *getNormalMatrix( size_t _id ) { return &vNormal[_id]; }
+   rVec3<T> *getPositionModelView( size_t _id ) { return &vPositionModelView[_id]; }
+
+   // Arrays with getSize() elements
+   rMat4<T> *getModelMatrices() { return vModel.data(); }
+   rMat4<T> *getModelViewMatrices() { return vModelView.data(); }
+   rMat4<T> *getModelViewProjectionMatrices() { return vModelViewProjection.data(); }
+   rMat3<T> *getNormalMatrices() { return vNormal.data(); }
+   rVec3<T> *getPositionsModelView() { return vPositionModelView.data(); }
+};
+
+template <class T>
+const size_t rTransformSystem<T>::INVALID_ID;
+
+template <class T>
+const size_t rTransformSystem<T>::MIN_JOB_SIZE;
+
+/*!
+ * \param[in] _scene    The scene with the view and projection matrices
+ * \param[in] _capacity The maximum number of objects
+ */
+template <class T>
+rTransformSystem<T>::rTransformSystem( rMatrixSceneBase<T> *_scene, size_t _capacity )
+    : vScene( _scene ),
+      vCapacity( _capacity ),
+      vSize( 0 ),
+      vPosX( _capacity ),
+      vPosY( _capacity ),
+      vPosZ( _capacity ),
+      vRotX( _capacity ),
+      vRotY( _capacity ),
+      vRotZ( _capacity ),
+      vRotW( _capacity ),
+      vScaleX( _capacity ),
+      vScaleY( _capacity ),
+      vScaleZ( _capacity ),
+      vModel( _capacity ),
+      vModelView( _capacity ),
+      vModelViewProjection( _capacity ),
+      vNormal( _capacity ),
+      vPositionModelView( _capacity ),
+      vDirty( _capacity, 0 ),
+      vSceneVersion( _scene->getVersion() ) {}
+
+/*!
+ * \brief Adds an object (no translation, no rotation, scale 1) and calculates its matrices
+ * \returns the ID of the object or INVALID_ID if the capacity is reached
+ */
+template <class T>
+size_t rTransformSystem<T>::add() {
+   size_t lID;
+
+   if ( !vFreeIDs.empty() ) {
+      lID = vFreeIDs.back();
+      vFreeIDs.pop_back();
+   } else if ( vSize < vCapacity ) {
+      lID = vSize++;
+   } else {
+      return INVALID_ID;
+   }
+
+   setPosition( lID, rVec3<T>( 0, 0, 0 ) );
+   setRotation( lID, rVec4<T>( 0, 0, 0, 1 ) );
+   setScale( lID, rVec3<T>( 1, 1, 1 ) );
+   update( lID, lID + 1 );
+   return lID;
+}
+
+/*!
+ * \brief Releases the ID _id (it will be reused by add())
+ */
+template <class T>
+void rTransformSystem<T>::remove( size_t _id ) {
+   if ( _id >= vSize || std::find( vFreeIDs.begin(), vFreeIDs.end(), _id ) != vFreeIDs.end() )
+      return;
+
+   vFreeIDs.push_back( _id );
+}
+
+template <class T>
+void rTransformSystem<T>::setPosition( size_t _id, const rVec3<T> &_pos ) {
+   vPosX[_id] = _pos.x;
+   vPosY[_id] = _pos.y;
+   vPosZ[_id] = _pos.z;
+   vDirty[_id] = 1;
+}
+
+template <class T>
+void rTransformSystem<T>::setRotation( size_t _id, const rVec4<T> &_quaternion ) {
+   vRotX[_id] = _quaternion.x;
+   vRotY[_id] = _quaternion.y;
+   vRotZ[_id] = _quaternion.z;
+   vRotW[_id] = _quaternion.w;
+   vDirty[_id] = 1;
+}
+
+template <class T>
+void rTransformSystem<T>::setScale( size_t _id, const rVec3<T> &_scale ) {
+   vScaleX[_id] = _scale.x;
+   vScaleY[_id] = _scale.y;
+   vScaleZ[_id] = _scale.z;
+   vDirty[_id] = 1;
+}
+
+/*!
+ * \brief Updates the matrices of all objects (after a camera change)
+ * \param[in] _pool Splits the work into jobs of at least MIN_JOB_SIZE objects (optional)
+ */
+template <class T>
+void rTransformSystem<T>::update( uWorkerPool *_pool ) {
+   vSceneVersion = vScene->getVersion();
+
+   size_t lNumJobs = _pool ? std::min( _pool->getNumThreads(), vSize / MIN_JOB_SIZE ) : 1;
+
+   if ( lNumJobs < 2 ) {
+      update( 0, vSize );
+      return;
+   }
+
+   // Multiple of 4, so that only the last job has a scalar tail
+   size_t lJobSize = ( ( vSize + lNumJobs - 1 ) / lNumJobs + 3 ) & ~static_cast<size_t>( 3 );
+   std::vector<std::future<void>> lJobs;
+
+   for ( size_t i = 0; i < vSize; i += lJobSize ) {
+      size_t lLast = std::min( i + lJobSize, vSize );
+      lJobs.emplace_back( _pool->push( [this, i, lLast]() { update( i, lLast ); } ) );
+   }
+
+   for ( auto &i : lJobs )
+      i.get();
+}
+
+/*!
+ * \brief Updates the matrices of the objects _first to _last - 1
+ */
+template <class T>
+void rTransformSystem<T>::update( size_t _first, size_t _last ) {
+   size_t lNext = updateBlocks<typename internal::rBatchPack<T>::PACK>( _first, _last );
+   updateBlocks<internal::rScalarPack<T>>( lNext, _last );
+   std::fill( vDirty.begin() + _first, vDirty.begin() + _last, 0 );
+}
+
+/*!
+ * \brief Updates all objects after a camera change, otherwise only _id if it changed
+ *
+ * The first object refreshed after a camera change updates all objects, the others are then
+ * already up to date.
+ */
+template <class T>
+void rTransformSystem<T>::refresh( size_t _id ) {
+   if ( vSceneVersion != vScene->getVersion() )
+      update();
+   else if ( vDirty[_id] )
+      update( _id, _id + 1 );
+}
+
+/*!
+ * \brief _out = _a * _m where _m is affine (last row 0 0 0 1)
+ *
+ * Same order of operations as rMatrix::multiply, without the products with 0 and 1.
+ */
+template <class T>
+template <class V>
+void rTransformSystem<T>::multiplyAffine( V const *_a, V const *_m, V *_out ) {
+   for ( uint32_t r = 0; r < 4; ++r ) {
+      for ( uint32_t c = 0; c < 3; ++c )
+         _out[c * 4 + r] = ( _a[r] * _m[c * 4] + _a[4 + r] * _m[c * 4 + 1] ) +
+                           _a[8 + r] * _m[c * 4 + 2];
+
+      _out[12 + r] = ( ( _a[r] * _m[12] + _a[4 + r] * _m[13] ) + _a[8 + r] * _m[14] ) + _a[12 + r];
+   }
+}
+
+/*!
+ * \brief Updates PACK::SIZE objects at once, as long as there are enough objects left
+ * \returns the first object that was not updated
+ */
+template <class T>
+template <class PACK>
+size_t rTransformSystem<T>::updateBlocks( size_t _first, size_t _last ) {
+   typedef typename PACK::TYPE V;
+
+   V lView[16];
+   V lViewProj[16];
+
+   for ( uint32_t i = 0; i < 16; ++i ) {
+      lView[i] = PACK::splat( vScene->getViewMatrix()->get( i ) );
+      lViewProj[i] = PACK::splat( vScene->getViewProjectionMatrix()->get( i ) );
+   }
+
+   V lZero = PACK::splat( 0 );
+   V lOne = PACK::splat( 1 );
+   V lTwo = PACK::splat( 2 );
+
+   size_t i = _first;
+
+   for ( ; i + PACK::SIZE <= _last; i += PACK::SIZE ) {
+      V x = PACK::load( &vRotX[i] );
+      V y = PACK::load( &vRotY[i] );
+      V z = PACK::load( &vRotZ[i] );
+      V w = PACK::load( &vRotW[i] );
+
+      V lScaleX = PACK::load( &vScaleX[i] );
+      V lScaleY = PACK::load( &vScaleY[i] );
+      V lScaleZ = PACK::load( &vScaleZ[i] );
+
+      V x2 = x * x;
+      V y2 = y * y;
+      V z2 = z * z;
+      V xy = x * y;
+      V xz = x * z;
+      V yz = y * z;
+      V wx = w * x;
+      V wy = w * y;
+      V wz = w * z;
+
+      // Model matrix: translation * rotation (rMatrixMath::rotate) * scale
+      V lM[16];
+      lM[0] = ( lOne - lTwo * y2 - lTwo * z2 ) * lScaleX;
+      lM[1] = ( lTwo * xy + lTwo * wz ) * lScaleX;
+      lM[2] = ( lTwo * xz - lTwo * wy ) * lScaleX;
+      lM[3] = lZero;
+      lM[4] = ( lTwo * xy - lTwo * wz ) * lScaleY;
+      lM[5] = ( lOne - lTwo * x2 - lTwo * z2 ) * lScaleY;
+      lM[6] = ( lTwo * yz + lTwo * wx ) * lScaleY;
+      lM[7] = lZero;
+      lM[8] = ( lTwo * xz + lTwo * wy ) * lScaleZ;
+      lM[9] = ( lTwo * yz - lTwo * wx ) * lScaleZ;
+      lM[10] = ( lOne - lTwo * x2 - lTwo * y2 ) * lScaleZ;
+      lM[11] = lZero;
+      lM[12] = PACK::load( &vPosX[i] );
+      lM[13] = PACK::load( &vPosY[i] );
+      lM[14] = PACK::load( &vPosZ[i] );
+      lM[15] = lOne;
+
+      V lMV[16];
+      V lMVP[16];
+      multiplyAffine( lView, lM, lMV );
+      multiplyAffine( lViewProj, lM, lMVP );
+
+      // Normal matrix: same as rMatrixMath::getNormalMatrix
+      V lDet = lMV[0] * ( lMV[5] * lMV[10] - lMV[6] * lMV[9] ) -
+               lMV[1] * ( lMV[4] * lMV[10] - lMV[6] * lMV[8] ) +
+               lMV[2] * ( lMV[4] * lMV[9] - lMV[5] * lMV[8] );
+
+      V lN[9];
+      lN[0] = ( lMV[5] * lMV[10] - lMV[9] * lMV[6] ) / lDet;
+      lN[1] = -( lMV[4] * lMV[10] - lMV[8] * lMV[6] ) / lDet;
+      lN[2] = ( lMV[4] * lMV[9] - lMV[8] * lMV[5] ) / lDet;
+      lN[3] = -( lMV[1] * lMV[10] - lMV[9] * lMV[2] ) / lDet;
+      lN[4] = ( lMV[0] * lMV[10] - lMV[8] * lMV[2] ) / lDet;
+      lN[5] = -( lMV[0] * lMV[9] - lMV[8] * lMV[1] ) / lDet;
+      lN[6] = ( lMV[1] * lMV[6] - lMV[5] * lMV[2] ) / lDet;
+      lN[7] = -( lMV[0] * lMV[6] - lMV[4] * lMV[2] ) / lDet;
+      lN[8] = ( lMV[0] * lMV[5] - lMV[4] * lMV[1] ) / lDet;
+
+      PACK::store( lM, 16, vModel[i].getMatrix(), 16 );
+      PACK::store( lMV, 16, vModelView[i].getMatrix(), 16 );
+      PACK::store( lMVP, 16, vModelViewProjection[i].getMatrix(), 16 );
+      PACK::store( lN, 9, vNormal[i].getMatrix(), 9 );
+      PACK::store( lMV + 12, 3, vPositionModelView[i].getMatrix(), 3 );
+   }
+
+   return i;
+}
+}
+
+#endif // R_TRANSFORM_SYSTEM_HPP
+
+// kate: indent-mode cstyle; indent-width 3; replace-tabs on; line-numbers on;
@@ -64,19 +64,20 @@ using rVecNd = rMatrix<double, N, 1>;
 class rVectorMath {
  public:
    template <class T, int N>
-   static T dotProduct( const rVecN<T, N> &_vec1, const rVecN<T, N> &_vec2 );
+   static constexpr T dotProduct( const rVecN<T, N> &_vec1, const rVecN<T, N> &_vec2 );
    template <class T>
-   static T dotProduct( const rVec2<T> &_vec1, const rVec2<T> &_vec2 );
+   static constexpr T dotProduct( const rVec2<T> &_vec1, const rVec2<T> &_vec2 );
    template <class T>
-   static T dotProduct( const rVec3<T> &_vec1, const rVec3<T> &_vec2 );
+   static constexpr T dotProduct( const rVec3<T> &_vec1, const rVec3<T> &_vec2 );
    template <class T>
-   static T dotProduct( const rVec4<T> &_vec1, const rVec4<T> &_vec2 );
+   static constexpr T dotProduct( const rVec4<T> &_vec1, const rVec4<T> &_vec2 );
 
    template <class T>
-   static void quaternionMultiplication( const rVec4<T> &_q1, const rVec4<T> &_q2, rVec4<T> &_out );
+   static constexpr void
+   quaternionMultiplication( const rVec4<T> &_q1, const rVec4<T> &_q2, rVec4<T> &_out );
 
    template <class T>
-   static rVec3<T> crossProduct( const rVec3<T> &_vec1, const rVec3<T> &_vec2 );
+   static constexpr rVec3<T> crossProduct( const rVec3<T> &_vec1, const rVec3<T> &_vec2 );
 };
 
 
@@ -89,7 +90,7 @@ class rVectorMath {
 //
 
 template <class T, int N>
-T rVectorMath::dotProduct( const rVecN<T, N> &_vec1, const rVecN<T, N> &_vec2 ) {
+constexpr T rVectorMath::dotProduct( const rVecN<T, N> &_vec1, const rVecN<T, N> &_vec2 ) {
    T lProduct = 0;
 
    for ( int i = 0; i < N; ++i )
@@ -98,19 +99,21 @@ T rVectorMath::dotProduct( const rVecN<T, N> &_vec1, const rVecN<T, N> &_vec2 )
    return lProduct;
 }
 
+// [] instead of x, y, z, w: constant expressions may only read the written member of the union
+
 template <class T>
-T rVectorMath::dotProduct( const rVec2<T> &_vec1, const rVec2<T> &_vec2 ) {
-   return _vec1.x * _vec2.x + _vec1.y * _vec2.y;
+constexpr T rVectorMath::dotProduct( const rVec2<T> &_vec1, const rVec2<T> &_vec2 ) {
+   return _vec1[0] * _vec2[0] + _vec1[1] * _vec2[1];
 }
 
 template <class T>
-T rVectorMath::dotProduct( const rVec3<T> &_vec1, const rVec3<T> &_vec2 ) {
-   return _vec1.x * _vec2.x + _vec1.y * _vec2.y + _vec1.z * _vec2.z;
+constexpr T rVectorMath::dotProduct( const rVec3<T> &_vec1, const rVec3<T> &_vec2 ) {
+   return _vec1[0] * _vec2[0] + _vec1[1] * _vec2[1] + _vec1[2] * _vec2[2];
 }
 
 template <class T>
-T rVectorMath::dotProduct( const rVec4<T> &_vec1, const rVec4<T> &_vec2 ) {
-   return _vec1.x * _vec2.x + _vec1.y * _vec2.y + _vec1.z * _vec2.z + _vec1.w * _vec2.w;
+constexpr T rVectorMath::dotProduct( const rVec4<T> &_vec1, const rVec4<T> &_vec2 ) {
+   return _vec1[0] * _vec2[0] + _vec1[1] * _vec2[1] + _vec1[2] * _vec2[2] + _vec1[3] * _vec2[3];
 }
 
 
@@ -124,10 +127,10 @@ T rVectorMath::dotProduct( const rVec4<T> &_vec1, const rVec4<T> &_vec2 ) {
 
 
 template <class T>
-rVec3<T> rVectorMath::crossProduct( const rVec3<T> &_vec1, const rVec3<T> &_vec2 ) {
-   return rVec3<T>( ( _vec1.y * _vec2.z ) - ( _vec1.z * _vec2.y ),
-                    ( _vec1.z * _vec2.x ) - ( _vec1.x * _vec2.z ),
-                    ( _vec1.x * _vec2.y ) - ( _vec1.y * _vec2.x ) );
+constexpr rVec3<T> rVectorMath::crossProduct( const rVec3<T> &_vec1, const rVec3<T> &_vec2 ) {
+   return rVec3<T>( ( _vec1[1] * _vec2[2] ) - ( _vec1[2] * _vec2[1] ),
+                    ( _vec1[2] * _vec2[0] ) - ( _vec1[0] * _vec2[2] ),
+                    ( _vec1[0] * _vec2[1] ) - ( _vec1[1] * _vec2[0] ) );
 }
 
 /*
@@ -138,12 +141,15 @@ rVec3<T> rVectorMath::crossProduct( const rVec3<T> &_vec1, const rVec3<T> &_vec2
 */
 
 template <class T>
-void
+constexpr void
 rVectorMath::quaternionMultiplication( const rVec4<T> &_q1, const rVec4<T> &_q2, rVec4<T> &_out ) {
-   _out.x = ( _q1.w * _q2.x ) + ( _q1.x * _q2.w ) + ( _q1.y * _q2.z ) - ( _q1.z * _q2.y );
-   _out.y = ( _q1.w * _q2.y ) - ( _q1.x * _q2.z ) + ( _q1.y * _q2.w ) + ( _q1.z * _q2.x );
-   _out.z = ( _q1.w * _q2.z ) + ( _q1.x * _q2.y ) - ( _q1.y * _q2.x ) + ( _q1.z * _q2.w );
-   _out.w = ( _q1.w * _q2.w ) - ( _q1.x * _q2.x ) - ( _q1.y * _q2.y ) - ( _q1.z * _q2.z );
+   T x1 = _q1[0], y1 = _q1[1], z1 = _q1[2], w1 = _q1[3];
+   T x2 = _q2[0], y2 = _q2[1], z2 = _q2[2], w2 = _q2[3];
+
+   _out[0] = ( w1 * x2 ) + ( x1 * w2 ) + ( y1 * z2 ) - ( z1 * y2 );
+   _out[1] = ( w1 * y2 ) - ( x1 * z2 ) + ( y1 * w2 ) + ( z1 * x2 );
+   _out[2] = ( w1 * z2 ) + ( x1 * y2 ) - ( y1 * x2 ) + ( z1 * w2 );
+   _out[3] = ( w1 * w2 ) - ( x1 * x2 ) - ( y1 * y2 ) - ( z1 * z2 );
 }
 }
 
@@ -95,6 +95,9 @@ uint32_t rDirectionalLight<T>::getVector( rVec3<T> **_vec, VECTOR_TYPES _type )
       case POSITION:
       case POSITION_MODEL_VIEW:
       case ATTENUATION:
+      case AABB_MIN:
+      case AABB_MAX:
+      case BOUNDING_SPHERE:
          return UNSUPPORTED_TYPE;
    }
 
@@ -79,6 +79,7 @@ class rPointLight : public rObjectBase, public rMatrixObjectBase<T> {
    rVec3<T> *getColor() { return &vLightColor; }
    rVec3<T> *getAttenuation() { return &vAttenuation; }
 
+   virtual void updateMatrices() { this->updateFinalMatrix(); }
    virtual uint32_t getVector( rVec3<T> **_vec, VECTOR_TYPES _type );
 };
 
@@ -104,6 +105,9 @@ uint32_t rPointLight<T>::getVector( rVec3<T> **_vec, VECTOR_TYPES _type ) {
          *_vec = &vAttenuation;
          return ALL_OK;
       case DIRECTION:
+      case AABB_MIN:
+      case AABB_MAX:
+      case BOUNDING_SPHERE:
          return UNSUPPORTED_TYPE;
    }
 
@@ -0,0 +1,74 @@
+/*!
+ * \file rMeshRegistry.cpp
+ * \brief \b Classes: \a rMeshRegistry
+ */
+/*
+ * Copyright (C) 2015 EEnginE project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "rMeshRegistry.hpp"
+
+namespace e_engine {
+
+/*!
+ * \brief Returns the registry (created on first use)
+ */
+rMeshRegistry &rMeshRegistry::get() {
+   static rMeshRegistry lRegistry;
+   return lRegistry;
+}
+
+/*!
+ * \brief Returns the shared mesh for _key
+ *
+ * A new (not loaded) entry is created if no object uses the mesh. Entries of meshes without
+ * users are removed on the way.
+ */
+std::shared_ptr<internal::rSharedMesh> rMeshRegistry::acquire( std::string const &_key ) {
+   std::lock_guard<std::mutex> lLock( vMeshes_MUT );
+
+   std::shared_ptr<internal::rSharedMesh> lMesh = vMeshes[_key].lock();
+
+   if ( !lMesh ) {
+      for ( auto i = vMeshes.begin(); i != vMeshes.end(); ) {
+         if ( i->second.expired() )
+            i = vMeshes.erase( i );
+         else
+            ++i;
+      }
+
+      lMesh = std::make_shared<internal::rSharedMesh>();
+      vMeshes[_key] = lMesh;
+   }
+
+   return lMesh;
+}
+
+/*!
+ * \brief Returns the number of meshes used by at least one object
+ */
+size_t rMeshRegistry::getNumMeshes() {
+   std::lock_guard<std::mutex> lLock( vMeshes_MUT );
+
+   size_t lCount = 0;
+   for ( auto const &i : vMeshes )
+      if ( !i.second.expired() )
+         ++lCount;
+
+   return lCount;
+}
+}
+
+// kate: indent-mode cstyle; indent-width 3; replace-tabs on; line-numbers on;
@@ -0,0 +1,107 @@
+/*!
+ * \file rMeshRegistry.hpp
+ * \brief \b Classes: \a rMeshRegistry
+ */
+/*
+ * Copyright (C) 2015 EEnginE project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef R_MESH_REGISTRY_HPP
+#define R_MESH_REGISTRY_HPP
+
+#include "defines.hpp"
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <stdint.h>
+#include <GL/glew.h>
+#include "rLoaderBase.hpp"
+#include "rBoundingVolume.hpp"
+
+namespace e_engine {
+
+namespace internal {
+
+struct rSharedMesh;
+
+//! OpenGL buffers of a mesh, shared by all objects rendering it (see rSimpleMesh)
+struct rSharedMeshBuffers {
+   std::shared_ptr<rSharedMesh> mesh; //!< The mesh; its mutex guards the references to the buffers
+
+   GLuint vbo = 0;
+   GLuint ibo = 0;
+   GLuint nbo = 0;
+   bool hasNormals = false;
+
+   std::vector<uint64_t> lodSize;
+   std::vector<uint64_t> lodOffset;
+   std::vector<uint64_t> hints; //!< All object hints after the upload (rObjectBase::OBJECT_HINTS)
+};
+
+/*!
+ * \brief A mesh file loaded with a set of options, shared by all objects using it
+ *
+ * Only weak references to the data are stored here: the loaded data is freed when no object
+ * holds it anymore, the buffers when the last object clears its OpenGL data.
+ *
+ * \note Lock mutex before accessing any member
+ */
+struct rSharedMesh {
+   std::mutex mutex; //!< Also held while the mesh is loaded, so every file is loaded once
+
+   bool isLoaded = false; //!< The members below are valid
+   std::weak_ptr<rLoaderBase<GLfloat, GLuint>> data;
+   std::weak_ptr<rSharedMeshBuffers> buffers;
+
+   _3D_Bounds<GLfloat> bounds;
+   uint64_t numVertices = 0;
+   uint64_t numIndexes = 0;
+   uint64_t numNormals = 0;
+   uint64_t numLODs = 1;
+};
+}
+
+/*!
+ * \brief Maps mesh keys (canonical path and load options) to the shared mesh data
+ *
+ * Used by rObjectBase when GlobConf.loader.shareMeshes is set. The registry only holds weak
+ * references; the objects using a mesh keep it alive.
+ *
+ * \note This class is thread safe
+ */
+class rMeshRegistry {
+ private:
+   std::mutex vMeshes_MUT;
+   std::unordered_map<std::string, std::weak_ptr<internal::rSharedMesh>> vMeshes;
+
+   rMeshRegistry() {}
+
+ public:
+   rMeshRegistry( const rMeshRegistry & ) = delete;
+   rMeshRegistry &operator=( const rMeshRegistry & ) = delete;
+
+   static rMeshRegistry &get();
+
+   std::shared_ptr<internal::rSharedMesh> acquire( std::string const &_key );
+   size_t getNumMeshes();
+};
+}
+
+#endif // R_MESH_REGISTRY_HPP
+
+// kate: indent-mode cstyle; indent-width 3; replace-tabs on; line-numbers on;
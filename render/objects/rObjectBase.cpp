@@ -20,31 +20,99 @@
 #include "rObjectBase.hpp"
 #include "uLog.hpp"
 #include "rLoader_3D_f_OBJ.hpp"
+#include "rLoader_3D_f_PLY.hpp"
+#include "rLoader_3D_f_STL.hpp"
+#include "rLoader_3D_f_GLB.hpp"
+#include "rLoader_3D_f_CACHE.hpp"
+#include "rMeshOptimizer.hpp"
+#include "rMeshSimplifier.hpp"
+#include "rNormalGenerator.hpp"
+#include "uConfig.hpp"
+#include "uWorkerPool.hpp"
 #include "iInit.hpp"
 #include <regex>
+#include <algorithm>
 #include <boost/filesystem.hpp>
 
 namespace e_engine {
 
+namespace {
+
+//! The pool for loadDataAsync (created on first use)
+uWorkerPool &getLoaderPool() {
+   static uWorkerPool lPool( GlobConf.loader.numLoaderThreads );
+   return lPool;
+}
+
+//! Holds the vectors passed to setData()
+class rManualData final : public internal::rLoaderBase<GLfloat, GLuint> {
+ public:
+   rManualData() { vIsDataLoaded_B = true; }
+
+   int load() { return 6; } // The data is always loaded
+};
+}
+
 rObjectBase::DATA_FILE_TYPE rObjectBase::detectFileTypeFromEnding( const std::string &_str ) {
-   std::regex lDataEndingOBJ_ex( "\\.obj" );
+   if ( _str.size() < 4 )
+      return AUTODETECT;
+
+   std::regex lDataEndingOBJ_ex( "\\.obj", std::regex::icase );
+   std::regex lDataEndingPLY_ex( "\\.ply", std::regex::icase );
+   std::regex lDataEndingSTL_ex( "\\.stl", std::regex::icase );
+   std::regex lDataEndingGLB_ex( "\\.glb", std::regex::icase );
 
    if ( std::regex_match( _str.end() - 4, _str.end(), lDataEndingOBJ_ex ) ) {
       return OBJ_FILE;
    }
 
+   if ( std::regex_match( _str.end() - 4, _str.end(), lDataEndingPLY_ex ) ) {
+      return PLY_FILE;
+   }
+
+   if ( std::regex_match( _str.end() - 4, _str.end(), lDataEndingSTL_ex ) ) {
+      return STL_FILE;
+   }
+
+   if ( std::regex_match( _str.end() - 4, _str.end(), lDataEndingGLB_ex ) ) {
+      return GLB_FILE;
+   }
+
    return AUTODETECT; // failed
 }
 
+/*!
+ * \brief Blocks until a running loadDataAsync() job is finished
+ */
+void rObjectBase::waitForLoadData() {
+   if ( !vLoadFuture.valid() )
+      return;
+
+   vLoadFuture.wait();
+   vLoadFuture = std::shared_future<int>();
+}
+
 /*!
  * \note This function does NOT need a working OpenGL context
+ * \note Waits for a running loadDataAsync() job
  */
 void rObjectBase::clearRAMData() {
-   if ( vLoaderData ) {
-      vLoaderData->unLoad();
-      delete vLoaderData;
-      vLoaderData = nullptr;
-   }
+   waitForLoadData();
+
+   // The data may be shared with other objects; it is freed with the last reference
+   vLoaderData.reset();
+
+   if ( vDataView.release )
+      vDataView.release();
+
+   vDataView = rDataView();
+
+   // Buffers found by loadData__ can not be used without the data in RAM anymore
+   if ( !vIsLoaded_B )
+      vSharedBuffers.reset();
+
+   if ( vObjectHints[IS_DATA_READY] == DATA_IN_RAM )
+      vObjectHints[IS_DATA_READY] = DATA_NOT_READY;
 }
 
 /*!
@@ -63,8 +131,205 @@ int rObjectBase::clearAllData() {
 /*!
  * \brief Loads the data
  *
+ * This function loads all relavent data from the set file. A running loadDataAsync() job is
+ * finished first.
+ *
+ * \sa loadData__
+ */
+int rObjectBase::loadData() {
+   waitForLoadData();
+   return loadData__();
+}
+
+/*!
+ * \brief Loads the data in a worker thread
+ *
+ * Parsing (and reindexing) is done by a pool of GlobConf.loader.numLoaderThreads threads, so
+ * many objects can be loaded at the same time. The IS_DATA_READY hint is DATA_LOADING until the
+ * job is done and DATA_IN_RAM afterwards (DATA_NOT_READY on failure).
+ *
+ * The OpenGL data still has to be set with setOGLData() from the thread with the context.
+ * setOGLData() (and all other functions changing the data) will wait for the job.
+ *
+ * With _streaming the loader passes the triangles it has parsed so far to this object (see
+ * rLoaderBase::emitBatch). Call uploadStreamedData() (every frame) instead of setOGLData() then;
+ * it appends them to the OpenGL buffers and sets the final data once the job is done.
+ *
+ * \param[in] _streaming Stream the triangles into the OpenGL buffers while loading
+ *
+ * \note This function does NOT need a working OpenGL context
+ * \note Streaming is ignored if the object already has OpenGL data
+ *
+ * \returns a future with the return value of loadData__()
+ */
+std::shared_future<int> rObjectBase::loadDataAsync( bool _streaming ) {
+   if ( vLoadFuture.valid() ) {
+      wLOG( "Object '", vName_str, "' is already loading" );
+      return vLoadFuture;
+   }
+
+   if ( !vIsLoaded_B )
+      vObjectHints[IS_DATA_READY] = DATA_LOADING;
+
+   vStream.active = _streaming && !vIsLoaded_B;
+
+   auto lJob = [this]() -> int {
+      int lRet = 0;
+
+      try {
+         lRet = loadData__();
+      } catch ( const boost::filesystem::filesystem_error &ex ) { eLOG( ex.what() ); }
+
+      if ( lRet != 1 && vObjectHints[IS_DATA_READY] == DATA_LOADING )
+         vObjectHints[IS_DATA_READY] = DATA_NOT_READY;
+
+      return lRet;
+   };
+
+   vLoadFuture = getLoaderPool().push( lJob ).share();
+
+   return vLoadFuture;
+}
+
+
+/*!
+ * \brief Sets the data of a SET_DATA_MANUALLY object by moving the vectors
+ *
+ * The vectors are moved into the object (no copy) and uploaded from there by setOGLData(). The
+ * data is used as it is: it is not optimized, no normals or LODs are generated and it is not
+ * interleaved. Only the bounding volume is calculated.
+ *
+ * \param[in] _vertices The positions (3 GLfloat per vertex)
+ * \param[in] _index    The index (3 per triangle)
+ * \param[in] _normals  The normals (3 GLfloat per vertex or empty)
+ *
+ * \note This function does NOT need a working OpenGL context
+ *
+ * \returns the same as checkManualData()
+ */
+int rObjectBase::setData( std::vector<GLfloat> &&_vertices,
+                          std::vector<GLuint> &&_index,
+                          std::vector<GLfloat> &&_normals ) {
+   waitForLoadData();
+
+   if ( !_normals.empty() && _normals.size() != _vertices.size() ) {
+      eLOG( "Number of normals does not match the number of vertices [OBJECT: '", vName_str, "']" );
+      return 103;
+   }
+
+   int lRet = checkManualData(
+         _vertices.data(), _vertices.size() / 3, _index.data(), _index.size(), !_normals.empty() );
+   if ( lRet != 1 )
+      return lRet;
+
+   std::shared_ptr<rManualData> lData = std::make_shared<rManualData>();
+   lData->getData()->vVertexData = std::move( _vertices );
+   lData->getData()->vIndex = std::move( _index );
+   lData->getData()->vNormalesData = std::move( _normals );
+
+   vLoaderData = lData;
+   return 1;
+}
+
+/*!
+ * \brief Sets the data of a SET_DATA_MANUALLY object without copying it
+ *
+ * setOGLData() uploads the data directly from the memory of _view. The memory must stay valid
+ * until _view.release is called (see rDataView). Like with the other setData() overload the data
+ * is not processed.
+ *
+ * \note This function does NOT need a working OpenGL context
+ *
+ * \returns the same as checkManualData(); _view.release is called if the data is not used
+ */
+int rObjectBase::setData( rDataView _view ) {
+   waitForLoadData();
+
+   int lRet = checkManualData( _view.vertices,
+                               _view.numVertices,
+                               _view.index,
+                               _view.numIndexes,
+                               _view.normals != nullptr );
+
+   if ( lRet != 1 || !_view.vertices ) {
+      if ( _view.release )
+         _view.release();
+
+      return lRet != 1 ? lRet : 103;
+   }
+
+   vDataView = std::move( _view );
+   return 1;
+}
+
+/*!
+ * \brief Checks the data passed to setData() and sets the hints and the bounding volume
+ *
+ * \returns 1   - on success
+ * \returns 100 - if data is already in RAM
+ * \returns 101 - if the file type is not SET_DATA_MANUALLY
+ * \returns 103 - if the data is invalid (index out of range or not a multiple of 3)
+ */
+int rObjectBase::checkManualData( GLfloat const *_vertices,
+                                  size_t _numVertices,
+                                  GLuint const *_index,
+                                  size_t _numIndexes,
+                                  bool _hasNormals ) {
+   if ( vLoaderData || vDataView.vertices ) {
+      wLOG( "Object '", vName_str, "' is already loaded! You need to clear the data first" );
+      return 100;
+   }
+
+   if ( vFileType != SET_DATA_MANUALLY ) {
+      eLOG( "setData was called for object '",
+            vName_str,
+            "' but the data file type for this object is not SET_DATA_MANUALLY" );
+      return 101;
+   }
+
+   if ( _numIndexes % 3 != 0 || ( _numIndexes > 0 && !_index ) ||
+        ( _numIndexes > 0 && *std::max_element( _index, _index + _numIndexes ) >= _numVertices ) ) {
+      eLOG( "Invalid index for the manually set data [OBJECT: '", vName_str, "']" );
+      return 103;
+   }
+
+   vSharedMesh.reset();
+
+   internal::calculateBounds( _vertices, _numVertices, vBounds );
+
+   setMeshHints( _numVertices * 3, _numIndexes, _hasNormals ? _numVertices * 3 : 0, 1 );
+   return 1;
+}
+
+
+/*!
+ * \brief Loads the data (implementation)
+ *
  * This function loads all relavent data from the set file.
  *
+ * If GlobConf.loader.useMeshCache is set, the reindexed data is taken from the binary mesh
+ * cache (rLoader_3D_f_CACHE) when the cache has an entry for the (unchanged) file. Otherwise
+ * the file is parsed and the result is written to the cache.
+ *
+ * If GlobConf.loader.generateNormals is set, meshes without normals get smooth normals (see
+ * generateNormals()). If GlobConf.loader.optimizeMeshes is set, the reindexed data is optimized
+ * for rendering (rMeshOptimizer). Both steps are done before the data is cached.
+ *
+ * Then GlobConf.loader.numLODs simplified index buffers are generated (see generateLODs()). They
+ * are cached with the mesh, so a cache hit skips the simplification.
+ *
+ * If GlobConf.loader.interleaveMeshes is set, the data is finally converted into the interleaved
+ * layout (rLoaderBase::interleave), so that it can be uploaded into one vertex buffer. With
+ * GlobConf.loader.quantizeAttributes the normals and UVs are also compressed in this step.
+ *
+ * If GlobConf.loader.shareMeshes is set and another object already loaded the file with the same
+ * options, its data (or its OpenGL buffers) is used instead (see useSharedMesh()). Otherwise the
+ * result is registered for the next objects. Objects loading the same file at the same time wait
+ * for each other, so every file is loaded only once.
+ *
+ * When streaming (loadDataAsync), the parsed triangles are collected for uploadStreamedData()
+ * and the hints are left untouched, because the OpenGL thread owns them until the job is done.
+ *
  * \warning This function wont load the data into the OpenGL context
  *
  * \note This function does NOT need a working OpenGL context
@@ -75,7 +340,7 @@ int rObjectBase::clearAllData() {
  * \returns 102 - if it was impossible to autodetect the file tye
  * \returns the return value of the loader if something went wrong during the load process
  */
-int rObjectBase::loadData() {
+int rObjectBase::loadData__() {
    if ( vLoaderData ) {
       wLOG( "Object '", vName_str, "' is already loaded! You need to clear the data first" );
       return 100;
@@ -112,35 +377,360 @@ int rObjectBase::loadData() {
       return false;
    }
 
-   switch ( vFileType ) {
-      case OBJ_FILE: {
-         vLoaderData = new rLoader_3D_f_OBJ( vFile_str );
-         int lRet = vLoaderData->load();
-         if ( lRet != 1 ) {
-            delete vLoaderData;
-            vLoaderData = nullptr;
-            return lRet;
-         }
-      } break;
-      case AUTODETECT:
-      case SET_DATA_MANUALLY:
-         eLOG( "You should never ever see this line. Please report a bug. [OBJECT: '",
-               vName_str,
-               "']" );
-         return 1002;
+   std::unique_lock<std::mutex> lSharedLock;
+
+   if ( GlobConf.loader.shareMeshes ) {
+      vSharedMesh = rMeshRegistry::get().acquire( getSharedMeshKey( vFile_str ) );
+      lSharedLock = std::unique_lock<std::mutex>( vSharedMesh->mutex );
+
+      if ( useSharedMesh() )
+         return 1;
+   } else {
+      vSharedMesh.reset();
+   }
+
+   // Try the mesh cache first
+   std::vector<unsigned char> lSourceHash;
+   uint64_t lSourceSize = 0;
+   std::string lCacheFile;
+   uint64_t lCacheFlags = GlobConf.loader.optimizeMeshes ? rLoader_3D_f_CACHE::OPTIMIZED : 0;
+
+   if ( GlobConf.loader.generateNormals )
+      lCacheFlags |= GlobConf.loader.angleWeightedNormals
+                           ? rLoader_3D_f_CACHE::GENERATED_NORMALS |
+                                   rLoader_3D_f_CACHE::ANGLE_WEIGHTED_NORMALS
+                           : rLoader_3D_f_CACHE::GENERATED_NORMALS;
+
+   if ( GlobConf.loader.numLODs > 0 )
+      lCacheFlags |= rLoader_3D_f_CACHE::LODS;
+
+   if ( GlobConf.loader.useMeshCache &&
+        rLoader_3D_f_CACHE::hashFile( vFile_str, lSourceHash, lSourceSize ) )
+      lCacheFile = rLoader_3D_f_CACHE::getCacheFilePath( lSourceHash );
+
+   if ( !lCacheFile.empty() && boost::filesystem::exists( lCacheFile ) ) {
+      rLoader_3D_f_CACHE *lCache = new rLoader_3D_f_CACHE( lCacheFile );
+      lCache->setExpectedSource( lSourceHash, lSourceSize );
+      lCache->setExpectedFlags( lCacheFlags );
+      lCache->setExpectedLODs( GlobConf.loader.numLODs, GlobConf.loader.lodReduction );
+
+      if ( lCache->load() == 1 ) {
+         vLoaderData.reset( lCache );
+      } else {
+         // Stale or corrupt ==> fall back to the source file (the cache will be overwritten)
+         delete lCache;
+      }
    }
 
-   vLoaderData->reindex();
+   bool lFromCache = static_cast<bool>( vLoaderData );
+
+   if ( !vLoaderData ) {
+      switch ( vFileType ) {
+         case OBJ_FILE:
+            vLoaderData.reset( new rLoader_3D_f_OBJ( vFile_str ) );
+            break;
+         case PLY_FILE:
+            vLoaderData.reset( new rLoader_3D_f_PLY( vFile_str ) );
+            break;
+         case STL_FILE:
+            vLoaderData.reset( new rLoader_3D_f_STL( vFile_str ) );
+            break;
+         case GLB_FILE:
+            vLoaderData.reset( new rLoader_3D_f_GLB( vFile_str ) );
+            break;
+         case AUTODETECT:
+         case SET_DATA_MANUALLY:
+            eLOG( "You should never ever see this line. Please report a bug. [OBJECT: '",
+                  vName_str,
+                  "']" );
+            return 1002;
+      }
+
+      if ( vStream.active ) {
+         vLoaderData->setBatchCallback( [this]( std::vector<GLfloat> const &_triangles ) {
+            std::lock_guard<std::mutex> lLock( vStream.mutex );
+            vStream.pending.insert( vStream.pending.end(), _triangles.begin(), _triangles.end() );
+         } );
+      }
+
+      int lRet = vLoaderData->load();
+      vLoaderData->setBatchCallback( nullptr );
+
+      if ( lRet != 1 ) {
+         vLoaderData.reset();
+         return lRet;
+      }
+
+      vLoaderData->reindex(); // Does nothing for already indexed formats (GLB)
+
+      if ( GlobConf.loader.generateNormals )
+         generateNormals();
+
+      if ( GlobConf.loader.optimizeMeshes ) {
+         internal::rMeshOptimizer<GLfloat, GLuint> lOptimizer;
+
+         if ( lOptimizer.optimize( vLoaderData->getData() ) ) {
+            iLOG( "Optimized mesh '",
+                  vFile_str,
+                  "': ACMR ",
+                  lOptimizer.getACMRBefore(),
+                  " -> ",
+                  lOptimizer.getACMRAfter(),
+                  " (welded ",
+                  lOptimizer.getNumWeldedVertices(),
+                  " vertices, removed ",
+                  lOptimizer.getNumDegenerateTriangles(),
+                  " degenerate triangles)" );
+         } else {
+            lCacheFlags &= ~static_cast<uint64_t>( rLoader_3D_f_CACHE::OPTIMIZED );
+         }
+      }
+   }
 
    auto *lData = vLoaderData->getData();
 
-   vObjectHints[NUM_VERTICES] = lData->vVertexData.size();
-   vObjectHints[NUM_INDEXES] = lData->vIndex.size();
-   vObjectHints[NUM_NORMALS] = lData->vNormalesData.size();
+   uint64_t lNumVertices = lData->vVertexData.size();
+   uint64_t lNumIndexes = lData->vIndex.size();
+   uint64_t lNumNormals = lData->vNormalesData.size();
+
+   internal::calculateBounds( lData->vVertexData.data(), lData->vVertexData.size() / 3, vBounds );
+
+   if ( !lFromCache ) {
+      generateLODs();
+
+      if ( !lCacheFile.empty() )
+         rLoader_3D_f_CACHE::write( lCacheFile,
+                                    lSourceHash,
+                                    lSourceSize,
+                                    vLoaderData->getData(),
+                                    lCacheFlags,
+                                    vLoaderData->getLODs(),
+                                    GlobConf.loader.numLODs,
+                                    GlobConf.loader.lodReduction );
+   }
+
+   if ( GlobConf.loader.interleaveMeshes )
+      vLoaderData->interleave( GlobConf.loader.quantizeAttributes );
+
+   if ( vSharedMesh ) {
+      vSharedMesh->data = vLoaderData;
+      vSharedMesh->buffers.reset();
+      vSharedMesh->bounds = vBounds;
+      vSharedMesh->numVertices = lNumVertices;
+      vSharedMesh->numIndexes = lNumIndexes;
+      vSharedMesh->numNormals = lNumNormals;
+      vSharedMesh->numLODs = 1 + vLoaderData->getLODs()->size();
+      vSharedMesh->isLoaded = true;
+   }
 
+   setMeshHints( lNumVertices, lNumIndexes, lNumNormals, 1 + vLoaderData->getLODs()->size() );
    return 1;
 }
 
+/*!
+ * \brief Sets the hints of the loaded mesh (or stores them while streaming)
+ */
+void rObjectBase::setMeshHints( uint64_t _numVertices,
+                                uint64_t _numIndexes,
+                                uint64_t _numNormals,
+                                uint64_t _numLODs ) {
+   if ( vStream.active ) {
+      vStream.numVertices = _numVertices;
+      vStream.numIndexes = _numIndexes;
+      vStream.numNormals = _numNormals;
+      vStream.numLODs = _numLODs;
+      return;
+   }
+
+   vObjectHints[NUM_VERTICES] = _numVertices;
+   vObjectHints[NUM_INDEXES] = _numIndexes;
+   vObjectHints[NUM_NORMALS] = _numNormals;
+   vObjectHints[NUM_LODS] = _numLODs;
+   vObjectHints[CURRENT_LOD] = 0;
+   vObjectHints[HAS_BOUNDING_VOLUME] = vBounds.vIsValid ? GL_TRUE : GL_FALSE;
+
+   if ( !vIsLoaded_B )
+      vObjectHints[IS_DATA_READY] = DATA_IN_RAM;
+}
+
+/*!
+ * \brief Builds the key of the mesh in the rMeshRegistry
+ *
+ * The key consists of the canonical path of the file, the file type and all loader options that
+ * change the loaded data.
+ */
+std::string rObjectBase::getSharedMeshKey( std::string const &_path ) const {
+   boost::system::error_code lError;
+   boost::filesystem::path lCanonical = boost::filesystem::canonical( _path, lError );
+
+   std::string lKey = lError ? _path : lCanonical.string();
+
+   lKey += '|' + std::to_string( static_cast<int>( vFileType ) );
+   lKey += '|' + std::to_string( GlobConf.loader.optimizeMeshes );
+   lKey += std::to_string( GlobConf.loader.generateNormals );
+   lKey += std::to_string( GlobConf.loader.angleWeightedNormals );
+   lKey += std::to_string( GlobConf.loader.interleaveMeshes );
+   lKey += std::to_string( GlobConf.loader.quantizeAttributes );
+   lKey += '|' + std::to_string( GlobConf.loader.numLODs );
+   lKey += '|' + std::to_string( GlobConf.loader.lodReduction );
+
+   return lKey;
+}
+
+/*!
+ * \brief Uses the data of vSharedMesh if another object already loaded it
+ *
+ * The loaded data is used while an object still holds it. Otherwise the OpenGL buffers of the
+ * mesh are kept (vSharedBuffers) for setOGLData().
+ *
+ * \note vSharedMesh->mutex must be locked
+ *
+ * \returns true if the mesh data (or buffers) can be used
+ */
+bool rObjectBase::useSharedMesh() {
+   if ( !vSharedMesh->isLoaded )
+      return false;
+
+   vLoaderData = vSharedMesh->data.lock();
+   vSharedBuffers = vSharedMesh->buffers.lock();
+
+   // All objects using the mesh are gone or cleared ==> load the file again
+   if ( !vLoaderData && !vSharedBuffers )
+      return false;
+
+   vBounds = vSharedMesh->bounds;
+
+   setMeshHints( vSharedMesh->numVertices,
+                 vSharedMesh->numIndexes,
+                 vSharedMesh->numNormals,
+                 vSharedMesh->numLODs );
+
+   iLOG( "Using shared mesh '",
+         vFile_str,
+         "' (",
+         vLoaderData ? "data in RAM" : "OpenGL buffers",
+         ") [OBJECT: '",
+         vName_str,
+         "']" );
+   return true;
+}
+
+/*!
+ * \brief The bounding box of the loaded mesh (object space)
+ * \returns false if there is no bounding volume (the mesh was not loaded)
+ */
+bool rObjectBase::getBoundingBox( rVec3f &_min, rVec3f &_max ) const {
+   for ( uint32_t i = 0; i < 3; ++i ) {
+      _min[i] = vBounds.vMin[i];
+      _max[i] = vBounds.vMax[i];
+   }
+
+   return vBounds.vIsValid;
+}
+
+/*!
+ * \brief The bounding sphere of the loaded mesh (object space)
+ *
+ * The center of the sphere is the center of the bounding box.
+ *
+ * \returns false if there is no bounding volume (the mesh was not loaded)
+ */
+bool rObjectBase::getBoundingSphere( rVec3f &_center, float &_radius ) const {
+   for ( uint32_t i = 0; i < 3; ++i )
+      _center[i] = vBounds.vCenter[i];
+
+   _radius = vBounds.vRadius;
+   return vBounds.vIsValid;
+}
+
+/*!
+ * \brief Calculates smooth normals if the loaded mesh has none
+ *
+ * Meshes without normals could only be rendered without lights. The normals are weighted by the
+ * corner angles (GlobConf.loader.angleWeightedNormals) or by the triangle areas and calculated
+ * in parallel (see internal::calculateNormals).
+ */
+void rObjectBase::generateNormals() {
+   auto *lData = vLoaderData->getData();
+
+   if ( !lData->vNormalesData.empty() || lData->vIndex.empty() )
+      return;
+
+   lData->vNormalesData.resize( lData->vVertexData.size() );
+   internal::calculateNormals( lData->vVertexData.data(),
+                               lData->vVertexData.size() / 3,
+                               lData->vIndex.data(),
+                               lData->vIndex.size(),
+                               lData->vNormalesData.data(),
+                               GlobConf.loader.angleWeightedNormals ? internal::ANGLE_WEIGHTED
+                                                                    : internal::AREA_WEIGHTED );
+
+   iLOG( "Generated normals for '", vFile_str, "' [OBJECT: '", vName_str, "']" );
+}
+
+/*!
+ * \brief Generates the simplified index buffers for the levels of detail
+ *
+ * Every LOD has GlobConf.loader.lodReduction times the triangles of the previous LOD
+ * (rMeshSimplifier). The chain ends early if a LOD misses more than half of the requested
+ * reduction, because it would be nearly equal to the previous one. Meshes that can not be
+ * simplified that far at all (flat shading, many seams) are skipped before simplifying. The LODs
+ * are stored in the loader; the caller publishes the NUM_LODS hint (setMeshHints()).
+ */
+void rObjectBase::generateLODs() {
+   auto *lData = vLoaderData->getData();
+   auto *lLODs = vLoaderData->getLODs();
+
+   lLODs->clear();
+
+   if ( GlobConf.loader.numLODs == 0 || lData->vIndex.size() < 3 )
+      return;
+
+   internal::rMeshSimplifier<GLfloat, GLuint> lSimplifier( lData->vVertexData, lData->vIndex );
+   size_t lTarget = lData->vIndex.size();
+   double lNumTriangles = static_cast<double>( lData->vIndex.size() / 3 );
+
+   // Every collapse removes at most two triangles
+   if ( 2.0 * lSimplifier.getNumCollapsible() <
+        lNumTriangles * ( 1.0 - GlobConf.loader.lodReduction ) / 2.0 ) {
+      iLOG( "Mesh of '", vName_str, "' can not be simplified (seams, borders); no LODs" );
+      return;
+   }
+
+   for ( unsigned int i = 0; i < GlobConf.loader.numLODs; ++i ) {
+      size_t lLast = lLODs->empty() ? lData->vIndex.size() : lLODs->back().size();
+      lTarget = static_cast<size_t>( lTarget / 3 * GlobConf.loader.lodReduction ) * 3;
+
+      auto const &lIndex = lSimplifier.simplify( lTarget );
+      size_t lMax = lLast - ( lLast - std::min( lTarget, lLast ) ) / 2;
+
+      if ( lIndex.empty() || lIndex.size() >= lLast || lIndex.size() > lMax )
+         break;
+
+      lLODs->push_back( lIndex );
+
+      if ( GlobConf.loader.optimizeMeshes ) {
+         // The optimizer works on the index of _3D_Data
+         internal::rMeshOptimizer<GLfloat, GLuint> lOptimizer;
+         std::swap( lData->vIndex, lLODs->back() );
+         lOptimizer.optimizeVertexCache( lData );
+         std::swap( lData->vIndex, lLODs->back() );
+      }
+
+      iLOG( "LOD ",
+            lLODs->size(),
+            " of '",
+            vName_str,
+            "': ",
+            lIndex.size() / 3,
+            " triangles (error ",
+            lSimplifier.getError(),
+            ", bounding radius ",
+            vBounds.vRadius,
+            ")" );
+   }
+}
+
 /*!
  * \brief Clears the content of the object
  *
@@ -155,6 +745,8 @@ int rObjectBase::loadData() {
  * \returns the result of clearOGLData__();
  */
 int rObjectBase::clearOGLData() {
+   waitForLoadData();
+
    if ( !vIsLoaded_B ) {
       wLOG( "Data is already cleared [OBJECT: '", vName_str, "']" );
       return 100;
@@ -195,6 +787,10 @@ int rObjectBase::clearOGLData() {
    iLOG( "Cleared data for object '", vName_str, "'" );
 
    vIsLoaded_B = false;
+
+   if ( vLoaderData )
+      vObjectHints[IS_DATA_READY] = DATA_IN_RAM;
+
    return lRet;
 }
 
@@ -207,6 +803,8 @@ int rObjectBase::clearOGLData() {
  *
  * \warning This function needs an \b ACTIVE OpenGL context for THIS THREAD
  *
+ * \note Waits for a running loadDataAsync() job
+ *
  * \returns 1  if everything went fine
  * \returns 100 if there is no OpenGL context current for this thead
  * \returns 101 if data is already loaded
@@ -214,6 +812,8 @@ int rObjectBase::clearOGLData() {
  * \returns the result of setOGLData__();
  */
 int rObjectBase::setOGLData() {
+   waitForLoadData();
+
    if ( vIsLoaded_B ) {
       wLOG( "Data is already present in the OpenGL buffers [OBJECT: '", vName_str, "']" );
       return 101;
@@ -224,7 +824,7 @@ int rObjectBase::setOGLData() {
       return 100;
    }
 
-   if ( !vLoaderData ) {
+   if ( !vLoaderData && !vSharedBuffers && !vDataView.vertices ) {
       eLOG( "The OpenGL Data is not present in RAM! Cannot copy to OpenGL buffers! [OBJECT: '",
             vName_str,
             "']" );
@@ -266,6 +866,76 @@ int rObjectBase::setOGLData() {
    return lRet;
 }
 
+/*!
+ * \brief Uploads the triangles of a streaming loadDataAsync() job
+ *
+ * Call this function regularly (e.g. every frame; rSceneBase::renderScene does it) after
+ * loadDataAsync( true ). While the job is running, the triangles parsed since the last call are
+ * appended to the OpenGL buffers (appendOGLData__) and IS_DATA_READY is DATA_PARTIALLY_READY.
+ * This preview is a triangle soup without LODs; its NUM_INDEXES hint grows with every call.
+ *
+ * When the job is done, the preview is cleared and the final (optimized) data is set with
+ * setOGLData(). The hints of the final data (LIGHT_MODEL, INDEX_TYPE, ...) may differ from the
+ * preview, so renderers must read them again (setDataFromObject) whenever this function
+ * returns a value > 0.
+ *
+ * \warning This function needs an \b ACTIVE OpenGL context for THIS THREAD
+ *
+ * \returns 0 if nothing changed
+ * \returns 1 if triangles were appended
+ * \returns 2 if the job is done and the preview was replaced (or cleared if loading failed)
+ */
+int rObjectBase::uploadStreamedData() {
+   if ( !vStream.active || !iInit::isAContextCurrentForThisThread() )
+      return 0;
+
+   // The future is invalid if another function already waited for the job
+   bool lDone = !vLoadFuture.valid() ||
+                vLoadFuture.wait_for( std::chrono::seconds( 0 ) ) == std::future_status::ready;
+
+   std::vector<GLfloat> lTriangles;
+   {
+      std::lock_guard<std::mutex> lLock( vStream.mutex );
+      lTriangles.swap( vStream.pending );
+   }
+
+   if ( !lDone ) {
+      if ( lTriangles.empty() )
+         return 0;
+
+      int lRet = appendOGLData__( lTriangles );
+      if ( lRet != 1 )
+         return 0; // No preview; wait for the final data
+
+      vIsLoaded_B = true;
+      vObjectHints[IS_DATA_READY] = DATA_PARTIALLY_READY;
+      return 1;
+   }
+
+   int lLoadRet = vLoadFuture.valid() ? vLoadFuture.get() : 1;
+   vStream.active = false;
+
+   if ( vIsLoaded_B )
+      clearOGLData(); // The preview
+
+   waitForLoadData();
+
+   if ( lLoadRet != 1 || ( !vLoaderData && !vSharedBuffers ) ) {
+      vObjectHints[IS_DATA_READY] = DATA_NOT_READY;
+      return 2;
+   }
+
+   vObjectHints[NUM_VERTICES] = vStream.numVertices;
+   vObjectHints[NUM_INDEXES] = vStream.numIndexes;
+   vObjectHints[NUM_NORMALS] = vStream.numNormals;
+   vObjectHints[NUM_LODS] = vStream.numLODs;
+   vObjectHints[CURRENT_LOD] = 0;
+   vObjectHints[HAS_BOUNDING_VOLUME] = vBounds.vIsValid ? GL_TRUE : GL_FALSE;
+
+   setOGLData();
+   return 2;
+}
+
 #if COMPILER_CLANG
 #pragma clang diagnostic push // This warning is irrelevant here
 #pragma clang diagnostic ignored "-Wunused-parameter"
@@ -287,6 +957,40 @@ int rObjectBase::setOGLData() {
  */
 uint32_t rObjectBase::getVBO( GLuint &_n ) { return FUNCTION_NOT_VALID_FOR_THIS_OBJECT; }
 
+/*!
+ * \brief Selects the level of detail to render
+ *
+ * The NUM_INDEXES and INDEX_OFFSET hints are changed, so the renderer has to update its data
+ * from the object (rRenderBase::setDataFromObject).
+ *
+ * \param[in] _lod The LOD (0: base mesh; up to NUM_LODS - 1)
+ * \returns 0 if the requested LOD exists and ERROR_FLAGS flags if not
+ */
+uint32_t rObjectBase::setLOD( uint32_t _lod ) { return FUNCTION_NOT_VALID_FOR_THIS_OBJECT; }
+
+/*!
+ * \brief Brings the matrices and vectors returned by getMatrix and getVector up to date
+ *
+ * Called by rSceneBase::renderScene once per frame for every object before anything is rendered
+ * (renderers keep the pointers). Objects with a transformation (rMatrixObjectBase) only
+ * recalculate what changed since the last frame.
+ */
+void rObjectBase::updateMatrices() {}
+
+/*!
+ * \brief Appends streamed triangles to the OpenGL buffers (see uploadStreamedData())
+ *
+ * _triangles is a triangle soup with position and normal (6 GLfloat) per vertex. An
+ * implementation must append it to its buffers and set the hints for drawing all triangles
+ * appended so far (NUM_INDEXES, VERTEX_LAYOUT, ...).
+ *
+ * \returns 1 on success
+ * \returns FUNCTION_NOT_VALID_FOR_THIS_OBJECT if this object can not show partial data
+ */
+int rObjectBase::appendOGLData__( std::vector<GLfloat> const &_triangles ) {
+   return FUNCTION_NOT_VALID_FOR_THIS_OBJECT;
+}
+
 /*!
  * \brief Get the _n'th IBO
  *
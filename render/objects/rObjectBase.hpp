@@ -23,8 +23,17 @@
 #include "defines.hpp"
 
 #include <string>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <future>
+#include <functional>
+#include <chrono>
 #include <GL/glew.h>
 #include "rLoaderBase.hpp"
+#include "rBoundingVolume.hpp"
+#include "rMeshRegistry.hpp"
 #include "rMatrixMath.hpp"
 
 namespace e_engine {
@@ -62,6 +71,18 @@ namespace e_engine {
  *successfully
  * cleared later. Value = 0 means that this object is completely broken!
  *
+ * The data can also be loaded in the background with loadDataAsync(). The state of the data is
+ * stored in the IS_DATA_READY hint (see DATA_STATE). When streaming is enabled, the triangles
+ * parsed so far are uploaded with uploadStreamedData() and can be drawn before the file is
+ * completely loaded (see appendOGLData__).
+ *
+ * With GlobConf.loader.shareMeshes, objects loading the same file with the same options share the
+ * loaded data and the OpenGL buffers (see rMeshRegistry). The file is loaded and uploaded only
+ * once; the data is freed when the last object clears it.
+ *
+ * Objects of the type SET_DATA_MANUALLY get their data with setData() (moved vectors or caller
+ * owned memory, uploaded without an intermediate copy).
+ *
  */
 class rObjectBase {
  public:
@@ -75,11 +96,33 @@ class rObjectBase {
       NUM_VBO,
       NUM_IBO,
       NUM_NBO,
+      VERTEX_LAYOUT,
+      VERTEX_STRIDE,
+      NORMAL_OFFSET,
+      UV_OFFSET,
+      INDEX_TYPE,
+      NORMAL_TYPE,
+      UV_TYPE,
+      GPU_MEMORY,
+      NUM_LODS,
+      CURRENT_LOD,
+      INDEX_OFFSET,
+      HAS_BOUNDING_VOLUME,
       IS_DATA_READY,
       __LAST__
    };
 
-   enum DATA_FILE_TYPE { AUTODETECT, OBJ_FILE, SET_DATA_MANUALLY };
+   //! PLY and STL files must be binary (see rLoader_3D_f_PLY and rLoader_3D_f_STL); GLB is glTF 2.0
+   enum DATA_FILE_TYPE { AUTODETECT, OBJ_FILE, PLY_FILE, STL_FILE, GLB_FILE, SET_DATA_MANUALLY };
+
+   //! Values of the IS_DATA_READY hint
+   enum DATA_STATE {
+      DATA_NOT_READY = 0,  //!< No data (or loading failed)
+      DATA_READY = 1,      //!< Data is in the OpenGL buffers (== GL_TRUE)
+      DATA_LOADING,        //!< loadDataAsync() is still running
+      DATA_IN_RAM,         //!< Data is in RAM; setOGLData() can be called
+      DATA_PARTIALLY_READY //!< Streaming: the first NUM_INDEXES indexes can be drawn
+   };
 
    enum ERROR_FLAGS {
       ALL_OK = 0,
@@ -108,13 +151,54 @@ class rObjectBase {
       POSITION,
       POSITION_MODEL_VIEW,
       DIRECTION,
-      ATTENUATION
+      ATTENUATION,
+      AABB_MIN,
+      AABB_MAX,
+      BOUNDING_SPHERE
    };
 
    enum LIGHT_MODEL_T { NO_LIGHTS = 0, SIMPLE_ADS_LIGHT };
 
+   /*!
+    * Values of the VERTEX_LAYOUT hint. For INTERLEAVED the VBO also contains the normals (the
+    * NBO is the VBO) and the hints VERTEX_STRIDE, NORMAL_OFFSET and UV_OFFSET are set in bytes.
+    * They are 0 for SEPARATE_BUFFERS.
+    *
+    * The OpenGL types of the data are stored in INDEX_TYPE (GL_UNSIGNED_SHORT or GL_UNSIGNED_INT),
+    * NORMAL_TYPE (GL_FLOAT or GL_INT_2_10_10_10_REV) and UV_TYPE (GL_FLOAT or GL_HALF_FLOAT).
+    * GPU_MEMORY is the size of all buffers of the object in bytes.
+    *
+    * NUM_LODS is the number of levels of detail (1: only the base mesh). All LODs use the same
+    * vertices; NUM_INDEXES and INDEX_OFFSET (in bytes) describe the range of the index buffer of
+    * the CURRENT_LOD (see setLOD()).
+    *
+    * HAS_BOUNDING_VOLUME is GL_TRUE when the bounding box and sphere of the mesh were calculated
+    * while loading (getBoundingBox(), getBoundingSphere()). Objects with a model matrix return the
+    * world space versions as the vectors AABB_MIN, AABB_MAX (rVec3f) and BOUNDING_SPHERE (rVec4f,
+    * w is the radius).
+    */
+   enum VERTEX_LAYOUT_T { SEPARATE_BUFFERS = 0, INTERLEAVED };
+
+   /*!
+    * \brief Vertex data owned by the caller (see setData())
+    *
+    * The memory must stay valid until release is called. This happens when the data is not
+    * needed anymore: after setOGLData() (unless the data is kept in RAM), in clearRAMData() or in
+    * the destructor.
+    */
+   struct rDataView {
+      GLfloat const *vertices = nullptr; //!< 3 GLfloat per vertex
+      GLfloat const *normals = nullptr;  //!< 3 GLfloat per vertex (optional)
+      size_t numVertices = 0;
+
+      GLuint const *index = nullptr;
+      size_t numIndexes = 0;
+
+      std::function<void()> release; //!< Called when the memory is not used anymore (optional)
+   };
+
  protected:
-   uint64_t vObjectHints[__LAST__];
+   std::atomic<uint64_t> vObjectHints[__LAST__];
    std::string vName_str;
 
    std::string vFile_str;
@@ -123,12 +207,54 @@ class rObjectBase {
    bool vIsLoaded_B;
    bool vKeepDataInRAM_B;
 
-   internal::rLoaderBase<GLfloat, GLuint> *vLoaderData;
+   std::shared_ptr<internal::rLoaderBase<GLfloat, GLuint>> vLoaderData;
+
+   std::shared_ptr<internal::rSharedMesh> vSharedMesh; //!< Only set if the mesh is shared
+   //! The shared buffers used (or found while loading and not yet used) by this object
+   std::shared_ptr<internal::rSharedMeshBuffers> vSharedBuffers;
+
+   rDataView vDataView; //!< Caller owned data (SET_DATA_MANUALLY)
+
+   std::shared_future<int> vLoadFuture;
+
+   internal::_3D_Bounds<GLfloat> vBounds; //!< Bounding volume of the mesh (object space)
+
+   //! State of a streaming loadDataAsync() job
+   struct __stream__ {
+      std::mutex mutex;
+      std::vector<GLfloat> pending; //!< Triangles not uploaded yet (position, normal per vertex)
+
+      bool active = false; //!< Only changed while no loader job is running
+
+      uint64_t numVertices = 0; //!< NUM_VERTICES of the final data (set by the loader job)
+      uint64_t numIndexes = 0;  //!< NUM_INDEXES of the final data (set by the loader job)
+      uint64_t numNormals = 0;  //!< NUM_NORMALS of the final data (set by the loader job)
+      uint64_t numLODs = 1;     //!< NUM_LODS of the final data (set by the loader job)
+   };
+
+   __stream__ vStream;
 
    DATA_FILE_TYPE detectFileTypeFromEnding( std::string const &_str );
+   std::string getSharedMeshKey( std::string const &_path ) const;
+   bool useSharedMesh();
+   void setMeshHints( uint64_t _numVertices,
+                      uint64_t _numIndexes,
+                      uint64_t _numNormals,
+                      uint64_t _numLODs );
+   int checkManualData( GLfloat const *_vertices,
+                        size_t _numVertices,
+                        GLuint const *_index,
+                        size_t _numIndexes,
+                        bool _hasNormals );
+
+   int loadData__();
+   void generateLODs();
+   void generateNormals();
+   void waitForLoadData();
 
    virtual int clearOGLData__() = 0;
    virtual int setOGLData__() = 0;
+   virtual int appendOGLData__( std::vector<GLfloat> const &_triangles );
 
  public:
    rObjectBase( std::string _name, std::string _file, DATA_FILE_TYPE _type = AUTODETECT )
@@ -155,11 +281,18 @@ class rObjectBase {
    virtual ~rObjectBase() { clearRAMData(); }
 
    int loadData();
+   std::shared_future<int> loadDataAsync( bool _streaming = false );
+
+   int setData( std::vector<GLfloat> &&_vertices,
+                std::vector<GLuint> &&_index,
+                std::vector<GLfloat> &&_normals = std::vector<GLfloat>() );
+   int setData( rDataView _view );
    void clearRAMData();
    int clearAllData();
 
    int clearOGLData();
    int setOGLData();
+   int uploadStreamedData();
 
    template <class... ARGS>
    inline void getHints( OBJECT_HINTS _hint, uint64_t &_ret, ARGS &&... _args );
@@ -167,7 +300,12 @@ class rObjectBase {
    inline void getHints( OBJECT_HINTS _hint, uint64_t &_ret );
 
    bool getIsDataInRAM() const {
-      if ( vLoaderData )
+      // The loader job is still running
+      if ( vLoadFuture.valid() &&
+           vLoadFuture.wait_for( std::chrono::seconds( 0 ) ) != std::future_status::ready )
+         return false;
+
+      if ( vLoaderData || vDataView.vertices )
          return true;
       return false;
    }
@@ -177,6 +315,12 @@ class rObjectBase {
 
    std::string getName() const { return vName_str; }
 
+   bool getBoundingBox( rVec3f &_min, rVec3f &_max ) const;
+   bool getBoundingSphere( rVec3f &_center, float &_radius ) const;
+
+   virtual uint32_t setLOD( uint32_t _lod );
+   virtual void updateMatrices();
+
    virtual uint32_t getVBO( GLuint &_n );
    virtual uint32_t getIBO( GLuint &_n );
    virtual uint32_t getNBO( GLuint &_n );
@@ -19,29 +19,90 @@
  */
 
 #include "rSimpleMesh.hpp"
+#include "uLog.hpp"
+#include <limits>
+#include <numeric>
+#include <algorithm>
 
 
 namespace e_engine {
 
+namespace {
+
+/*!
+ * \brief Replaces _buffer with a bigger buffer and copies the first _usedBytes into it
+ * \returns the new buffer
+ */
+GLuint growBuffer( GLuint _buffer, size_t _usedBytes, size_t _newBytes ) {
+   GLuint lNew;
+   glGenBuffers( 1, &lNew );
+
+   glBindBuffer( GL_COPY_WRITE_BUFFER, lNew );
+   glBufferData(
+         GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>( _newBytes ), nullptr, GL_DYNAMIC_DRAW );
+
+   glBindBuffer( GL_COPY_READ_BUFFER, _buffer );
+   glCopyBufferSubData(
+         GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, static_cast<GLsizeiptr>( _usedBytes ) );
+
+   glDeleteBuffers( 1, &_buffer );
+   return lNew;
+}
+}
+
 
 rSimpleMesh::~rSimpleMesh() { clearOGLData(); }
 
 
 
 int rSimpleMesh::clearOGLData__() {
-   glDeleteBuffers( 1, &vVertexBufferObject );
-   glDeleteBuffers( 1, &vIndexBufferObject );
+   bool lDeleteBuffers = true;
+
+   // Shared buffers are deleted by the last object using them
+   if ( vSharedBuffers ) {
+      std::shared_ptr<internal::rSharedMesh> lMesh = vSharedBuffers->mesh;
+      std::lock_guard<std::mutex> lLock( lMesh->mutex );
 
-   if ( vHasNormals ) {
-      glDeleteBuffers( 1, &vNormalBufferObject );
-      vHasNormals = false;
+      lDeleteBuffers = vSharedBuffers.use_count() == 1;
+      vSharedBuffers.reset();
    }
 
+   if ( lDeleteBuffers ) {
+      glDeleteBuffers( 1, &vVertexBufferObject );
+      glDeleteBuffers( 1, &vIndexBufferObject );
+
+      // Interleaved: the normals are in the vertex buffer
+      if ( vHasNormals && vNormalBufferObject != vVertexBufferObject )
+         glDeleteBuffers( 1, &vNormalBufferObject );
+   }
+
+   vHasNormals = false;
+   vStreamedVertices = 0;
+   vStreamCapacity = 0;
+
    vObjectHints[IS_DATA_READY] = 0;
    vObjectHints[LIGHT_MODEL] = NO_LIGHTS;
    vObjectHints[NUM_VBO] = 0;
    vObjectHints[NUM_IBO] = 0;
    vObjectHints[NUM_NBO] = 0;
+   vObjectHints[VERTEX_LAYOUT] = SEPARATE_BUFFERS;
+   vObjectHints[VERTEX_STRIDE] = 0;
+   vObjectHints[NORMAL_OFFSET] = 0;
+   vObjectHints[UV_OFFSET] = 0;
+   vObjectHints[INDEX_TYPE] = 0;
+   vObjectHints[NORMAL_TYPE] = 0;
+   vObjectHints[UV_TYPE] = 0;
+   vObjectHints[GPU_MEMORY] = 0;
+   vObjectHints[CURRENT_LOD] = 0;
+   vObjectHints[INDEX_OFFSET] = 0;
+
+   if ( !vLODSize.empty() )
+      vObjectHints[NUM_INDEXES] = vLODSize[0];
+
+   vLODSize.clear();
+   vLODOffset.clear();
+
+   clearBoundingVolume();
 
    return 1;
 }
@@ -52,42 +113,121 @@ int rSimpleMesh::clearOGLData__() {
  * This function loads the content of the object and prepares it for
  * rendering.
  *
+ * Interleaved data (rLoaderBase::interleave) is uploaded into a single buffer, which is also
+ * returned as the NBO. Data set with rObjectBase::setData is uploaded straight from the memory
+ * of the vectors or the rDataView (no intermediate copy).
+ *
+ * Shared meshes (rObjectBase::vSharedMesh) use the buffers of another object if it already
+ * uploaded the mesh; otherwise the new buffers are registered for the next objects.
+ *
  * \warning This function needs an \b ACTIVE OpenGL context for THIS THREAD
  *
  * \returns 1  if everything went fine
  */
 int rSimpleMesh::setOGLData__() {
+   if ( vBounds.vIsValid ) {
+      rVec3f lMin, lMax;
+      rVec4f lSphere;
+      getBoundingBox( lMin, lMax );
+
+      for ( uint32_t i = 0; i < 3; ++i )
+         lSphere[i] = vBounds.vCenter[i];
+
+      lSphere[3] = vBounds.vRadius;
+      setBoundingVolume( lMin, lMax, lSphere );
+   }
+
+   std::shared_ptr<internal::rSharedMesh> lMesh =
+         vSharedBuffers ? vSharedBuffers->mesh : vSharedMesh;
+   std::unique_lock<std::mutex> lLock;
+
+   if ( lMesh ) {
+      lLock = std::unique_lock<std::mutex>( lMesh->mutex );
+
+      if ( !vSharedBuffers )
+         vSharedBuffers = lMesh->buffers.lock();
+
+      if ( vSharedBuffers )
+         return useSharedBuffers();
+   }
+
+   int lRet;
+
+   if ( vDataView.vertices ) {
+      lRet = setOGLDataSeparate( vDataView.vertices,
+                                 vDataView.normals,
+                                 vDataView.numVertices,
+                                 vDataView.index,
+                                 vDataView.numIndexes );
+   } else if ( vLoaderData->getIsInterleaved() ) {
+      lRet = setOGLDataInterleaved();
+   } else {
+      auto *lData = vLoaderData->getData();
+      GLfloat const *lNormals = nullptr;
+
+      if ( !lData->vNormalesData.empty() )
+         lNormals = lData->vNormalesData.data();
+
+      lRet = setOGLDataSeparate( lData->vVertexData.data(),
+                                 lNormals,
+                                 lData->vVertexData.size() / 3,
+                                 lData->vIndex.data(),
+                                 lData->vIndex.size() );
+   }
+
+   // Only share buffers of the data loaded for the shared mesh
+   if ( lRet == 1 && vSharedMesh && vSharedMesh->data.lock() == vLoaderData )
+      shareBuffers();
+
+   return lRet;
+}
+
+/*!
+ * \brief Uploads positions and normals (3 GLfloat per vertex each) into separate buffers
+ *
+ * The data is read directly from the pointers (loader data or a rDataView).
+ *
+ * \param[in] _vertices    The positions
+ * \param[in] _normals     The normals (nullptr: no normals)
+ * \param[in] _numVertices The number of vertices
+ * \param[in] _index       The index
+ * \param[in] _numIndexes  The number of indexes
+ */
+int rSimpleMesh::setOGLDataSeparate( GLfloat const *_vertices,
+                                     GLfloat const *_normals,
+                                     size_t _numVertices,
+                                     GLuint const *_index,
+                                     size_t _numIndexes ) {
    glGenBuffers( 1, &vVertexBufferObject );
-   glGenBuffers( 1, &vIndexBufferObject );
 
-   auto *lData = vLoaderData->getData();
+   size_t lBytes = sizeof( GLfloat ) * 3 * _numVertices;
 
    glBindBuffer( GL_ARRAY_BUFFER, vVertexBufferObject );
-   glBufferData( GL_ARRAY_BUFFER,
-                 static_cast<GLsizeiptr>( sizeof( GLfloat ) * lData->vVertexData.size() ),
-                 &lData->vVertexData.at( 0 ),
-                 GL_STATIC_DRAW );
+   glBufferData( GL_ARRAY_BUFFER, static_cast<GLsizeiptr>( lBytes ), _vertices, GL_STATIC_DRAW );
 
-   glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, vIndexBufferObject );
-   glBufferData( GL_ELEMENT_ARRAY_BUFFER,
-                 static_cast<GLsizeiptr>( sizeof( GLuint ) * lData->vIndex.size() ),
-                 &lData->vIndex.at( 0 ),
-                 GL_STATIC_DRAW );
+   lBytes += setIndexData( _index, _numIndexes, _numVertices );
 
-   if ( lData->vNormalesData.size() > 0 ) {
+   if ( _normals && _numVertices > 0 ) {
       glGenBuffers( 1, &vNormalBufferObject );
 
       glBindBuffer( GL_ARRAY_BUFFER, vNormalBufferObject );
       glBufferData( GL_ARRAY_BUFFER,
-                    static_cast<GLsizeiptr>( sizeof( GLfloat ) * lData->vNormalesData.size() ),
-                    &lData->vNormalesData.at( 0 ),
+                    static_cast<GLsizeiptr>( sizeof( GLfloat ) * 3 * _numVertices ),
+                    _normals,
                     GL_STATIC_DRAW );
 
+      lBytes += sizeof( GLfloat ) * 3 * _numVertices;
+
       vHasNormals = true;
       vObjectHints[LIGHT_MODEL] = SIMPLE_ADS_LIGHT;
       vObjectHints[NUM_NBO] = 1;
    }
 
+   vObjectHints[NORMAL_TYPE] = GL_FLOAT;
+   vObjectHints[UV_TYPE] = GL_FLOAT;
+
+   logGPUMemory( _numVertices, lBytes );
+
    vObjectHints[IS_DATA_READY] = 1;
 
    vObjectHints[NUM_VBO] = 1;
@@ -96,6 +236,313 @@ int rSimpleMesh::setOGLData__() {
    return 1;
 }
 
+int rSimpleMesh::setOGLDataInterleaved() {
+   auto *lData = vLoaderData->getInterleavedData();
+   size_t lNumVertices = lData->vData.size() / lData->vStride;
+   size_t lBytes = lData->vData.size();
+
+   glGenBuffers( 1, &vVertexBufferObject );
+
+   glBindBuffer( GL_ARRAY_BUFFER, vVertexBufferObject );
+   glBufferData(
+         GL_ARRAY_BUFFER, static_cast<GLsizeiptr>( lBytes ), lData->vData.data(), GL_STATIC_DRAW );
+
+   lBytes += setIndexData( lData->vIndex.data(), lData->vIndex.size(), lNumVertices );
+
+   if ( lData->vNormalOffset != 0 ) {
+      vNormalBufferObject = vVertexBufferObject;
+      vHasNormals = true;
+      vObjectHints[LIGHT_MODEL] = SIMPLE_ADS_LIGHT;
+      vObjectHints[NUM_NBO] = 1;
+   }
+
+   vObjectHints[VERTEX_LAYOUT] = INTERLEAVED;
+   vObjectHints[VERTEX_STRIDE] = lData->vStride;
+   vObjectHints[NORMAL_OFFSET] = lData->vNormalOffset;
+   vObjectHints[UV_OFFSET] = lData->vUVOffset;
+   vObjectHints[NORMAL_TYPE] = lData->vNormalType;
+   vObjectHints[UV_TYPE] = lData->vUVType;
+
+   logGPUMemory( lNumVertices, lBytes );
+
+   vObjectHints[IS_DATA_READY] = 1;
+
+   vObjectHints[NUM_VBO] = 1;
+   vObjectHints[NUM_IBO] = 1;
+
+   return 1;
+}
+
+/*!
+ * \brief Uses the buffers in vSharedBuffers (uploaded by another object)
+ * \note The mutex of the shared mesh must be locked
+ */
+int rSimpleMesh::useSharedBuffers() {
+   static OBJECT_HINTS const lBufferHints[] = {LIGHT_MODEL,
+                                               NUM_VBO,
+                                               NUM_IBO,
+                                               NUM_NBO,
+                                               VERTEX_LAYOUT,
+                                               VERTEX_STRIDE,
+                                               NORMAL_OFFSET,
+                                               UV_OFFSET,
+                                               INDEX_TYPE,
+                                               NORMAL_TYPE,
+                                               UV_TYPE,
+                                               GPU_MEMORY,
+                                               NUM_LODS};
+
+   vVertexBufferObject = vSharedBuffers->vbo;
+   vIndexBufferObject = vSharedBuffers->ibo;
+   vNormalBufferObject = vSharedBuffers->nbo;
+   vHasNormals = vSharedBuffers->hasNormals;
+   vLODSize = vSharedBuffers->lodSize;
+   vLODOffset = vSharedBuffers->lodOffset;
+
+   for ( auto i : lBufferHints )
+      vObjectHints[i] = vSharedBuffers->hints[i];
+
+   vObjectHints[NUM_INDEXES] = vLODSize.empty() ? 0 : vLODSize[0];
+   vObjectHints[CURRENT_LOD] = 0;
+   vObjectHints[INDEX_OFFSET] = 0;
+   vObjectHints[IS_DATA_READY] = 1;
+
+   iLOG( "Mesh '", vName_str, "': using shared buffers (", vSharedBuffers.use_count(), " users)" );
+
+   return 1;
+}
+
+/*!
+ * \brief Registers the uploaded buffers in the shared mesh
+ * \note The mutex of the shared mesh must be locked
+ */
+void rSimpleMesh::shareBuffers() {
+   vSharedBuffers = std::make_shared<internal::rSharedMeshBuffers>();
+
+   vSharedBuffers->mesh = vSharedMesh;
+   vSharedBuffers->vbo = vVertexBufferObject;
+   vSharedBuffers->ibo = vIndexBufferObject;
+   vSharedBuffers->nbo = vNormalBufferObject;
+   vSharedBuffers->hasNormals = vHasNormals;
+   vSharedBuffers->lodSize = vLODSize;
+   vSharedBuffers->lodOffset = vLODOffset;
+   vSharedBuffers->hints.assign( vObjectHints, vObjectHints + __LAST__ );
+
+   vSharedMesh->buffers = vSharedBuffers;
+}
+
+/*!
+ * \brief Appends streamed triangles (see rObjectBase::uploadStreamedData)
+ *
+ * The triangles are stored interleaved (position, normal) in a vertex buffer with a sequential
+ * GLuint index. Both buffers are allocated with spare capacity and filled with glBufferSubData.
+ * When they are full, they are replaced by buffers with twice the capacity (the old content is
+ * copied on the GPU), so the VBO and IBO may change with every call.
+ *
+ * \warning This function needs an \b ACTIVE OpenGL context for THIS THREAD
+ *
+ * \returns 1 if everything went fine
+ */
+int rSimpleMesh::appendOGLData__( std::vector<GLfloat> const &_triangles ) {
+   size_t const lStride = 6 * sizeof( GLfloat );
+   size_t lNumNew = _triangles.size() / 6;
+   size_t lNeeded = vStreamedVertices + lNumNew;
+
+   if ( lNumNew == 0 )
+      return 1;
+
+   if ( vStreamCapacity == 0 ) {
+      vStreamCapacity = std::max( lNeeded * 2, static_cast<size_t>( MIN_STREAM_CAPACITY ) );
+
+      glGenBuffers( 1, &vVertexBufferObject );
+      glBindBuffer( GL_ARRAY_BUFFER, vVertexBufferObject );
+      glBufferData( GL_ARRAY_BUFFER,
+                    static_cast<GLsizeiptr>( vStreamCapacity * lStride ),
+                    nullptr,
+                    GL_DYNAMIC_DRAW );
+
+      glGenBuffers( 1, &vIndexBufferObject );
+      glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, vIndexBufferObject );
+      glBufferData( GL_ELEMENT_ARRAY_BUFFER,
+                    static_cast<GLsizeiptr>( vStreamCapacity * sizeof( GLuint ) ),
+                    nullptr,
+                    GL_DYNAMIC_DRAW );
+   } else if ( lNeeded > vStreamCapacity ) {
+      size_t lCapacity = std::max( vStreamCapacity * 2, lNeeded );
+
+      vVertexBufferObject = growBuffer(
+            vVertexBufferObject, vStreamedVertices * lStride, lCapacity * lStride );
+      vIndexBufferObject = growBuffer( vIndexBufferObject,
+                                       vStreamedVertices * sizeof( GLuint ),
+                                       lCapacity * sizeof( GLuint ) );
+
+      vStreamCapacity = lCapacity;
+   }
+
+   std::vector<GLuint> lIndex( lNumNew );
+   std::iota( lIndex.begin(), lIndex.end(), static_cast<GLuint>( vStreamedVertices ) );
+
+   glBindBuffer( GL_ARRAY_BUFFER, vVertexBufferObject );
+   glBufferSubData( GL_ARRAY_BUFFER,
+                    static_cast<GLintptr>( vStreamedVertices * lStride ),
+                    static_cast<GLsizeiptr>( lNumNew * lStride ),
+                    _triangles.data() );
+
+   glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, vIndexBufferObject );
+   glBufferSubData( GL_ELEMENT_ARRAY_BUFFER,
+                    static_cast<GLintptr>( vStreamedVertices * sizeof( GLuint ) ),
+                    static_cast<GLsizeiptr>( lNumNew * sizeof( GLuint ) ),
+                    lIndex.data() );
+
+   vStreamedVertices = lNeeded;
+
+   vNormalBufferObject = vVertexBufferObject;
+   vHasNormals = true;
+
+   vObjectHints[NUM_VERTICES] = vStreamedVertices * 3;
+   vObjectHints[NUM_NORMALS] = vStreamedVertices * 3;
+   vObjectHints[NUM_INDEXES] = vStreamedVertices;
+   vObjectHints[LIGHT_MODEL] = SIMPLE_ADS_LIGHT;
+   vObjectHints[NUM_VBO] = 1;
+   vObjectHints[NUM_IBO] = 1;
+   vObjectHints[NUM_NBO] = 1;
+   vObjectHints[VERTEX_LAYOUT] = INTERLEAVED;
+   vObjectHints[VERTEX_STRIDE] = lStride;
+   vObjectHints[NORMAL_OFFSET] = 3 * sizeof( GLfloat );
+   vObjectHints[UV_OFFSET] = 0;
+   vObjectHints[INDEX_TYPE] = GL_UNSIGNED_INT;
+   vObjectHints[NORMAL_TYPE] = GL_FLOAT;
+   vObjectHints[UV_TYPE] = GL_FLOAT;
+   vObjectHints[NUM_LODS] = 1;
+   vObjectHints[CURRENT_LOD] = 0;
+   vObjectHints[INDEX_OFFSET] = 0;
+   vObjectHints[GPU_MEMORY] = vStreamCapacity * ( lStride + sizeof( GLuint ) );
+
+   return 1;
+}
+
+/*!
+ * \brief Creates and fills the index buffer
+ *
+ * The index buffer contains the index of the base mesh followed by the indexes of all LODs
+ * (rLoaderBase::getLODs; data set with a rDataView has no LODs). If all indices fit into 16 bits
+ * (less than 65536 vertices), the index is stored as GL_UNSIGNED_SHORT. The type is stored in
+ * the INDEX_TYPE hint.
+ *
+ * \returns the size of the index buffer in bytes
+ */
+size_t rSimpleMesh::setIndexData( GLuint const *_index, size_t _numIndexes, size_t _numVertices ) {
+   static std::vector<std::vector<GLuint>> const lNoLODs;
+
+   auto const *lLODs = vLoaderData ? vLoaderData->getLODs() : &lNoLODs;
+   bool lShort = _numVertices <= std::numeric_limits<GLushort>::max();
+   size_t lIndexSize = lShort ? sizeof( GLushort ) : sizeof( GLuint );
+
+   vLODSize.clear();
+   vLODOffset.clear();
+
+   size_t lBytes = 0;
+   auto lAdd = [&]( size_t _size ) {
+      vLODSize.push_back( _size );
+      vLODOffset.push_back( lBytes );
+      lBytes += _size * lIndexSize;
+   };
+
+   lAdd( _numIndexes );
+   for ( auto const &i : *lLODs )
+      lAdd( i.size() );
+
+   glGenBuffers( 1, &vIndexBufferObject );
+   glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, vIndexBufferObject );
+   glBufferData(
+         GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>( lBytes ), nullptr, GL_STATIC_DRAW );
+
+   auto lUpload = [&]( GLuint const *_lod, size_t _lodIndex ) {
+      GLintptr lOffset = static_cast<GLintptr>( vLODOffset[_lodIndex] );
+      GLsizeiptr lSize = static_cast<GLsizeiptr>( vLODSize[_lodIndex] * lIndexSize );
+
+      if ( !lShort ) {
+         glBufferSubData( GL_ELEMENT_ARRAY_BUFFER, lOffset, lSize, _lod );
+         return;
+      }
+
+      std::vector<GLushort> lShortIndex( _lod, _lod + vLODSize[_lodIndex] );
+      glBufferSubData( GL_ELEMENT_ARRAY_BUFFER, lOffset, lSize, lShortIndex.data() );
+   };
+
+   lUpload( _index, 0 );
+   for ( size_t i = 0; i < lLODs->size(); ++i )
+      lUpload( ( *lLODs )[i].data(), i + 1 );
+
+   vObjectHints[INDEX_TYPE] = lShort ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+   vObjectHints[NUM_LODS] = vLODSize.size();
+   vObjectHints[CURRENT_LOD] = 0;
+   vObjectHints[INDEX_OFFSET] = 0;
+
+   return lBytes;
+}
+
+/*!
+ * \brief Selects the level of detail to render
+ * \sa rObjectBase::setLOD
+ */
+uint32_t rSimpleMesh::setLOD( uint32_t _lod ) {
+   uint32_t lRet = 0;
+
+   if ( !vIsLoaded_B )
+      lRet |= DATA_NOT_LOADED;
+
+   if ( _lod >= vLODSize.size() )
+      lRet |= INDEX_OUT_OF_RANGE;
+
+   if ( lRet != 0 )
+      return lRet;
+
+   vObjectHints[NUM_INDEXES] = vLODSize[_lod];
+   vObjectHints[INDEX_OFFSET] = vLODOffset[_lod];
+   vObjectHints[CURRENT_LOD] = _lod;
+
+   return 0;
+}
+
+/*!
+ * \brief Stores the GPU_MEMORY hint and logs it next to the size of the uncompressed data
+ *
+ * The uncompressed size is the size with GLfloat attributes and a GLuint index (of all LODs).
+ */
+void rSimpleMesh::logGPUMemory( size_t _numVertices, size_t _bytes ) {
+   size_t lComponents = 3;
+   size_t lNumIndices = 0;
+
+   for ( auto i : vLODSize )
+      lNumIndices += i;
+
+   if ( vHasNormals )
+      lComponents += 3;
+
+   if ( vObjectHints[UV_OFFSET] != 0 )
+      lComponents += 2;
+
+   size_t lUncompressed =
+         sizeof( GLfloat ) * lComponents * _numVertices + sizeof( GLuint ) * lNumIndices;
+
+   vObjectHints[GPU_MEMORY] = _bytes;
+
+   iLOG( "Mesh '",
+         vName_str,
+         "': GPU memory ",
+         lUncompressed,
+         " -> ",
+         _bytes,
+         " bytes (",
+         _numVertices,
+         " vertices, ",
+         lNumIndices,
+         " indices, ",
+         vLODSize.size(),
+         " LODs)" );
+}
+
 
 uint32_t rSimpleMesh::getVBO( uint32_t &_n ) {
    uint32_t lRet = 0;
@@ -142,16 +589,29 @@ uint32_t rSimpleMesh::getNBO( uint32_t &_n ) {
    return lRet;
 }
 
+/*!
+ * \brief Returns a matrix of the object
+ *
+ * Only the position, rotation and scale are stored (see rMatrixObjectBase), so SCALE, ROTATION
+ * and TRANSLATION are built on every call. The returned matrix does not follow later changes of
+ * the object; call this function again.
+ */
 uint32_t rSimpleMesh::getMatrix( rMat4f **_mat, rObjectBase::MATRIX_TYPES _type ) {
+   if ( ( _type == SCALE || _type == ROTATION || _type == TRANSLATION ) && !vTRSMatrices )
+      vTRSMatrices.reset( new rMat4f[3] );
+
    switch ( _type ) {
       case SCALE:
-         *_mat = getScaleMatrix();
+         *_mat = &vTRSMatrices[0];
+         getScaleMatrix( **_mat );
          return 0;
       case ROTATION:
-         *_mat = getRotationMatrix();
+         *_mat = &vTRSMatrices[1];
+         getRotationMatrix( **_mat );
          return 0;
       case TRANSLATION:
-         *_mat = getTranslationMatrix();
+         *_mat = &vTRSMatrices[2];
+         getTranslationMatrix( **_mat );
          return 0;
       case CAMERA_MATRIX:
          *_mat = getViewProjectionMatrix();
@@ -198,6 +658,40 @@ uint32_t rSimpleMesh::getMatrix( rMat3f **_mat, rObjectBase::MATRIX_TYPES _type
    return INDEX_OUT_OF_RANGE;
 }
 
+/*!
+ * \brief Returns the world space bounding box (AABB_MIN, AABB_MAX)
+ * \returns DATA_NOT_LOADED if there is no bounding volume
+ */
+uint32_t rSimpleMesh::getVector( rVec3f **_vec, rObjectBase::VECTOR_TYPES _type ) {
+   *_vec = nullptr;
+
+   if ( _type != AABB_MIN && _type != AABB_MAX )
+      return UNSUPPORTED_TYPE;
+
+   if ( !getHasBoundingVolume() )
+      return DATA_NOT_LOADED;
+
+   *_vec = _type == AABB_MIN ? getWorldBoxMin() : getWorldBoxMax();
+   return ALL_OK;
+}
+
+/*!
+ * \brief Returns the world space bounding sphere (BOUNDING_SPHERE; w is the radius)
+ * \returns DATA_NOT_LOADED if there is no bounding volume
+ */
+uint32_t rSimpleMesh::getVector( rVec4f **_vec, rObjectBase::VECTOR_TYPES _type ) {
+   *_vec = nullptr;
+
+   if ( _type != BOUNDING_SPHERE )
+      return UNSUPPORTED_TYPE;
+
+   if ( !getHasBoundingVolume() )
+      return DATA_NOT_LOADED;
+
+   *_vec = getWorldSphere();
+   return ALL_OK;
+}
+
 void rSimpleMesh::setFlags() {
    vObjectHints[FLAGS] = MESH_OBJECT;
    vObjectHints[MATRICES] = SCALE_MATRIX_FLAG | ROTATION_MATRIX_FLAG | TRANSLATION_MATRIX_FLAG |
@@ -24,6 +24,8 @@
 #include "defines.hpp"
 
 #include <string>
+#include <vector>
+#include <memory>
 #include "rRenderBase.hpp"
 #include "rMatrixObjectBase.hpp"
 #include "rMatrixSceneBase.hpp"
@@ -33,15 +35,38 @@
 namespace e_engine {
 
 class rSimpleMesh final : public rMatrixObjectBase<float>, public rObjectBase {
+ public:
+   //! Initial capacity (in vertices) of the buffers for streamed triangles
+   static const size_t MIN_STREAM_CAPACITY = 65536;
+
  private:
    GLuint vVertexBufferObject;
    GLuint vIndexBufferObject;
    GLuint vNormalBufferObject;
 
+   std::vector<uint64_t> vLODSize;   //!< Number of indexes of every LOD
+   std::vector<uint64_t> vLODOffset; //!< Offset of every LOD in the IBO (bytes)
+
+   //! SCALE, ROTATION and TRANSLATION for getMatrix (allocated on the first request)
+   std::unique_ptr<rMat4f[]> vTRSMatrices;
+
    void setFlags();
+   int setOGLDataSeparate( GLfloat const *_vertices,
+                           GLfloat const *_normals,
+                           size_t _numVertices,
+                           GLuint const *_index,
+                           size_t _numIndexes );
+   int setOGLDataInterleaved();
+   int useSharedBuffers();
+   void shareBuffers();
+   size_t setIndexData( GLuint const *_index, size_t _numIndexes, size_t _numVertices );
+   void logGPUMemory( size_t _numVertices, size_t _bytes );
 
    bool vHasNormals;
 
+   size_t vStreamedVertices = 0; //!< Vertices appended with appendOGLData__
+   size_t vStreamCapacity = 0;   //!< Capacity of the buffers for streamed triangles (vertices)
+
  public:
    rSimpleMesh( rMatrixSceneBase<float> *_scene,
                 std::string _name,
@@ -57,12 +82,18 @@ class rSimpleMesh final : public rMatrixObjectBase<float>, public rObjectBase {
 
    int clearOGLData__();
    int setOGLData__();
+   int appendOGLData__( std::vector<GLfloat> const &_triangles );
+
+   virtual uint32_t setLOD( uint32_t _lod );
+   virtual void updateMatrices() { updateFinalMatrix(); }
 
    virtual uint32_t getVBO( uint32_t &_n );
    virtual uint32_t getIBO( uint32_t &_n );
    virtual uint32_t getNBO( uint32_t &_n );
    virtual uint32_t getMatrix( e_engine::rMat4f **_mat, rObjectBase::MATRIX_TYPES _type );
    virtual uint32_t getMatrix( e_engine::rMat3f **_mat, rObjectBase::MATRIX_TYPES _type );
+   virtual uint32_t getVector( e_engine::rVec3f **_vec, rObjectBase::VECTOR_TYPES _type );
+   virtual uint32_t getVector( e_engine::rVec4f **_vec, rObjectBase::VECTOR_TYPES _type );
 };
 }
 
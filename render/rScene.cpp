@@ -19,6 +19,8 @@
 
 #include "rScene.hpp"
 #include "uLog.hpp"
+#include <cmath>
+#include <algorithm>
 
 namespace e_engine {
 
@@ -50,7 +52,7 @@ bool rSceneBase::canRenderScene() {
       d.vObjectPointer->getHints(
             rObjectBase::IS_DATA_READY, lIsObjectReady, rObjectBase::FLAGS, lFlags );
 
-      if ( lIsObjectReady != GL_TRUE ) {
+      if ( lIsObjectReady != GL_TRUE && lIsObjectReady != rObjectBase::DATA_PARTIALLY_READY ) {
          wLOG( "Object data for '",
                d.vObjectPointer->getName(),
                "' is not completely loaded --> Do not render scene '",
@@ -106,17 +108,194 @@ bool rSceneBase::canRenderScene() {
    return lCanRender;
 }
 
+/*!
+ * \brief Selects the LOD of an object from the projected size of its bounding sphere
+ *
+ * The size is the radius of the world space bounding sphere (BOUNDING_SPHERE) divided by the
+ * distance to the camera and multiplied with the y scale of the projection, which is the length
+ * of the 2nd row of the view projection matrix (the view matrix is a rotation and a translation).
+ */
+uint32_t rSceneBase::selectLOD( rObjectBase *_obj, uint32_t _numLODs ) const {
+   rVec4f *lSphere;
+
+   if ( _obj->getVector( &lSphere, rObjectBase::BOUNDING_SPHERE ) != 0 || !lSphere )
+      return 0;
+
+   rMat4f const &lVP = *vViewProjection_MAT;
+   float lWorld[3] = {lSphere->x, lSphere->y, lSphere->z};
+   float lWorldRadius = lSphere->w;
+
+   float lW = lVP.get( 0, 3 ) * lWorld[0] + lVP.get( 1, 3 ) * lWorld[1] +
+              lVP.get( 2, 3 ) * lWorld[2] + lVP.get( 3, 3 );
+
+   // Completely behind the camera
+   if ( lW < -lWorldRadius )
+      return _numLODs - 1;
+
+   // The camera is (nearly) inside the sphere
+   if ( lW <= lWorldRadius )
+      return 0;
+
+   float lProjection = std::sqrt( lVP.get( 0, 1 ) * lVP.get( 0, 1 ) +
+                                  lVP.get( 1, 1 ) * lVP.get( 1, 1 ) +
+                                  lVP.get( 2, 1 ) * lVP.get( 2, 1 ) );
+
+   float lSize = lWorldRadius * lProjection / lW;
+   float lThreshold = vLODScreenSize;
+   uint32_t lLOD = 0;
+
+   while ( lLOD + 1 < _numLODs && lSize < lThreshold ) {
+      ++lLOD;
+      lThreshold *= vLODScreenFactor;
+   }
+
+   return lLOD;
+}
+
+/*!
+ * \brief Updates the LOD of an object and its renderers if the selected LOD changed
+ *
+ * The LOD is stored in the object, so all renderers of the object must read it again, not only
+ * the one of _obj.
+ */
+void rSceneBase::updateLOD( rObject const &_obj ) {
+   uint64_t lNumLODs, lCurrent;
+   _obj.vObjectPointer->getHints(
+         rObjectBase::NUM_LODS, lNumLODs, rObjectBase::CURRENT_LOD, lCurrent );
+
+   if ( lNumLODs < 2 )
+      return;
+
+   uint32_t lLOD = selectLOD( _obj.vObjectPointer, static_cast<uint32_t>( lNumLODs ) );
+
+   if ( lLOD == lCurrent )
+      return;
+
+   if ( _obj.vObjectPointer->setLOD( lLOD ) != 0 )
+      return;
+
+   // An object can be added more than once (with different renderers)
+   for ( auto const &d : vObjects )
+      if ( d.vObjectPointer == _obj.vObjectPointer && d.vRenderer )
+         d.vRenderer->setDataFromObject( d.vObjectPointer );
+}
+
+/*!
+ * \brief Tests the world space bounding volumes of all objects against the view frustum
+ *
+ * The bounding spheres (BOUNDING_SPHERE) and, where available, the boxes (AABB_MIN, AABB_MAX) are
+ * copied into arrays and tested 4 at a time (rFrustum). An object is culled when one of its
+ * volumes is outside. Objects without a bounding volume (e.g. lights) are always visible.
+ *
+ * The matrices of the objects must be up to date (rObjectBase::updateMatrices). Neither an OpenGL
+ * context nor renderers are needed, so this can be tested on the CPU.
+ *
+ * \sa getNumVisible, getNumCulled, getIsVisible
+ */
+void rSceneBase::cullObjects() {
+   vVisible.assign( vObjects.size(), 1 );
+   vCullIndex.clear();
+   vCullSpheres.clear();
+   vCullCenters.clear();
+   vCullExtents.clear();
+
+   if ( vCulling && vViewProjection_MAT ) {
+      for ( size_t i = 0; i < vObjects.size(); ++i ) {
+         rObjectBase *lObj = vObjects[i].vObjectPointer;
+         rVec4f *lSphere;
+         rVec3f *lMin;
+         rVec3f *lMax;
+
+         if ( lObj->getVector( &lSphere, rObjectBase::BOUNDING_SPHERE ) != 0 || !lSphere )
+            continue;
+
+         vCullIndex.push_back( i );
+         vCullSpheres.push_back( *lSphere );
+
+         if ( lObj->getVector( &lMin, rObjectBase::AABB_MIN ) != 0 || !lMin ||
+              lObj->getVector( &lMax, rObjectBase::AABB_MAX ) != 0 || !lMax ) {
+            // The box around the sphere (not tighter than the sphere)
+            vCullCenters.push_back( *lSphere );
+            vCullExtents.emplace_back( lSphere->w );
+            continue;
+         }
+
+         vCullCenters.emplace_back( ( lMin->x + lMax->x ) / 2,
+                                    ( lMin->y + lMax->y ) / 2,
+                                    ( lMin->z + lMax->z ) / 2,
+                                    0.0f );
+         vCullExtents.emplace_back( ( lMax->x - lMin->x ) / 2,
+                                    ( lMax->y - lMin->y ) / 2,
+                                    ( lMax->z - lMin->z ) / 2,
+                                    0.0f );
+      }
+
+      vCullSphereVisible.resize( vCullIndex.size() );
+      vCullBoxVisible.resize( vCullIndex.size() );
+
+      vFrustum.setViewProjection( *vViewProjection_MAT );
+      vFrustum.testSpheres( vCullSpheres.data(), vCullIndex.size(), vCullSphereVisible.data() );
+      vFrustum.testBoxes( vCullCenters.data(),
+                          vCullExtents.data(),
+                          vCullIndex.size(),
+                          vCullBoxVisible.data() );
+
+      for ( size_t i = 0; i < vCullIndex.size(); ++i )
+         vVisible[vCullIndex[i]] = vCullSphereVisible[i] & vCullBoxVisible[i];
+   }
+
+   vNumCulled = static_cast<size_t>( std::count( vVisible.begin(), vVisible.end(), 0 ) );
+   vNumVisible = vVisible.size() - vNumCulled;
+}
+
 /*!
  * \brief Renders the scene
  *
+ * Only the objects inside the view frustum are rendered (see cullObjects() and setCulling()).
+ *
+ * Objects with more than one LOD (NUM_LODS hint) are rendered with the LOD matching their
+ * projected size (see setLODScreenSize()).
+ *
+ * Objects loaded with loadDataAsync( true ) are streamed: the triangles parsed so far are
+ * uploaded (rObjectBase::uploadStreamedData) and the renderers of the object read the new data
+ * before rendering. The final data may have a different LIGHT_MODEL hint than the streamed
+ * triangles (they always have normals), so objects without normals may need a new renderer.
+ *
  * \warning This function does \b NOT check if it is safe to render the objects and if all pointers
  *are OK.
  * \note This function needs an \b active OpenGL context. Again there is no checking for one here!
  */
 void rSceneBase::renderScene() {
+   // An object can be added more than once (with different renderers)
+   std::vector<rObjectBase *> lStreamed;
    for ( auto const &d : vObjects ) {
-      if ( d.vRenderer )
-         d.vRenderer->render();
+      // Also the objects without renderer (light sources are used by the other renderers)
+      d.vObjectPointer->updateMatrices();
+
+      if ( d.vObjectPointer->uploadStreamedData() > 0 )
+         lStreamed.push_back( d.vObjectPointer );
+   }
+
+   cullObjects();
+
+   for ( size_t i = 0; i < vObjects.size(); ++i ) {
+      rObject const &d = vObjects[i];
+
+      if ( !d.vRenderer )
+         continue;
+
+      // Also for culled objects (the streamed data is only uploaded once)
+      if ( !lStreamed.empty() &&
+           std::find( lStreamed.begin(), lStreamed.end(), d.vObjectPointer ) != lStreamed.end() )
+         d.vRenderer->setDataFromObject( d.vObjectPointer );
+
+      if ( !vVisible[i] )
+         continue;
+
+      if ( vViewProjection_MAT )
+         updateLOD( d );
+
+      d.vRenderer->render();
    }
 }
 
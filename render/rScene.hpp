@@ -22,6 +22,7 @@
 
 #include "defines.hpp"
 
+#include "rFrustum.hpp"
 #include "rMatrixSceneBase.hpp"
 #include "rObjectBase.hpp"
 #include "rRenderBase.hpp"
@@ -69,12 +70,38 @@ class rSceneBase {
    std::mutex vObjects_MUT;
    std::mutex vShaders_MUT;
 
+   rMat4f *vViewProjection_MAT = nullptr; //!< For the LOD selection and the frustum culling
+   float vLODScreenSize = 0.5f;
+   float vLODScreenFactor = 0.5f;
+
+   rFrustum<float> vFrustum;
+   bool vCulling = true;
+
+   std::vector<uint8_t> vVisible; //!< One flag per object (see cullObjects())
+   size_t vNumVisible = 0;
+   size_t vNumCulled = 0;
+
+   // Bounding volumes of the tested objects (reused every frame)
+   std::vector<size_t> vCullIndex;
+   std::vector<rVec4f> vCullSpheres;
+   std::vector<rVec4f> vCullCenters;
+   std::vector<rVec4f> vCullExtents;
+   std::vector<uint8_t> vCullSphereVisible;
+   std::vector<uint8_t> vCullBoxVisible;
+
    int assignObjectRenderer( GLuint _index, rRenderBase *_renderer );
 
+   uint32_t selectLOD( rObjectBase *_obj, uint32_t _numLODs ) const;
+   void updateLOD( rObject const &_obj );
+
+ protected:
+   void setViewProjection( rMat4f *_viewProjection ) { vViewProjection_MAT = _viewProjection; }
+
  public:
    rSceneBase( std::string _name ) : vName_str( _name ) {}
    virtual ~rSceneBase();
    void renderScene();
+   void cullObjects();
 
    bool canRenderScene();
 
@@ -86,6 +113,28 @@ class rSceneBase {
 
    size_t getNumObjects() { return vObjects.size(); }
 
+   //! Enables / disables the frustum culling in renderScene() (enabled by default)
+   void setCulling( bool _culling ) { vCulling = _culling; }
+   bool getCulling() const { return vCulling; }
+
+   //! Number of objects inside / outside of the frustum in the last frame (see cullObjects())
+   size_t getNumVisible() const { return vNumVisible; }
+   size_t getNumCulled() const { return vNumCulled; }
+   bool getIsVisible( size_t _index ) const {
+      return _index >= vVisible.size() || vVisible[_index] != 0;
+   }
+
+   /*!
+    * \brief Sets the screen size thresholds for the LOD selection
+    *
+    * LOD n is used if the projected radius of the bounding sphere is smaller than
+    * _size * _factor^(n-1) (in normalized device coordinates: 1 = half of the screen height).
+    */
+   void setLODScreenSize( float _size, float _factor = 0.5f ) {
+      vLODScreenSize = _size;
+      vLODScreenFactor = _factor;
+   }
+
    template <class T, class... RENDERERS>
    int setObjectRenderer( GLuint _index );
 };
@@ -139,7 +188,9 @@ int rSceneBase::setObjectRenderer( GLuint _index ) {
 template <class T>
 class rScene : public rSceneBase, public rMatrixSceneBase<float> {
  public:
-   rScene( std::string _name ) : rSceneBase( _name ) {}
+   rScene( std::string _name ) : rSceneBase( _name ) {
+      setViewProjection( getViewProjectionMatrix() );
+   }
 };
 }
 
@@ -64,6 +64,33 @@ class rRenderBase {
    static inline bool testPointer( T *_p, std::wstring &&_missing, ARGS &&... _args );
    static inline bool testPointer() { return true; }
 
+   //! Converts a byte offset in the bound buffer into the pointer for glVertexAttribPointer
+   static inline GLvoid const *bufferOffset( size_t _offset ) {
+      return reinterpret_cast<GLvoid const *>( _offset );
+   }
+
+   /*!
+    * \brief Sets the attribute pointer for normals of the type _type (NORMAL_TYPE hint)
+    *
+    * GL_INT_2_10_10_10_REV normals are normalized by OpenGL, so the shader still gets floats.
+    */
+   static inline void normalAttribPointer( GLuint _location,
+                                           GLenum _type,
+                                           GLsizei _stride,
+                                           size_t _offset ) {
+      if ( _type == GL_INT_2_10_10_10_REV ) {
+         glVertexAttribPointer( _location, 4, _type, GL_TRUE, _stride, bufferOffset( _offset ) );
+         return;
+      }
+
+      glVertexAttribPointer( _location, 3, GL_FLOAT, GL_FALSE, _stride, bufferOffset( _offset ) );
+   }
+
+   //! Returns the hint value _hint or _default if the object did not set the hint
+   static inline GLenum typeFromHint( uint64_t _hint, GLenum _default ) {
+      return _hint == 0 ? _default : static_cast<GLenum>( _hint );
+   }
+
  public:
    rRenderBase() : vNeedUpdateUniforms_B( false ), vAlwaysUpdateUniforms_B( false ) {}
    virtual ~rRenderBase();
@@ -49,6 +49,11 @@ class rRenderBasicLight_3_3 : public rRenderBase {
    GLint vUniformLightPos_OGL = NOT_SET;
 
    GLsizei vDataSize_uI = 0;
+   GLsizei vStride_uI = 0;
+   size_t vNormalOffset_uI = 0;
+   GLenum vIndexType_OGL = GL_UNSIGNED_INT;
+   size_t vIndexOffset_uI = 0;
+   GLenum vNormalType_OGL = GL_FLOAT;
 
    rMat4f *vModelViewProjection = nullptr;
    rMat4f *vModelView = nullptr;
@@ -55,14 +55,20 @@ void rRenderMultipleLights_3_3::render() {
 
    glEnableVertexAttribArray( vInputVertexLocation_OGL );
    glBindBuffer( GL_ARRAY_BUFFER, vVertexBufferObj_OGL );
-   glVertexAttribPointer( vInputVertexLocation_OGL, 3, GL_FLOAT, GL_FALSE, 0, nullptr );
+   glVertexAttribPointer( vInputVertexLocation_OGL, 3, GL_FLOAT, GL_FALSE, vStride_uI, nullptr );
 
    glEnableVertexAttribArray( vInputNormalsLocation_OGL );
-   glBindBuffer( GL_ARRAY_BUFFER, vNormalBufferObj_OGL );
-   glVertexAttribPointer( vInputNormalsLocation_OGL, 3, GL_FLOAT, GL_FALSE, 0, nullptr );
+
+   // Interleaved layout: the normals are in the (already bound) vertex buffer
+   if ( vNormalBufferObj_OGL != vVertexBufferObj_OGL )
+      glBindBuffer( GL_ARRAY_BUFFER, vNormalBufferObj_OGL );
+
+   normalAttribPointer(
+         vInputNormalsLocation_OGL, vNormalType_OGL, vStride_uI, vNormalOffset_uI );
 
    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, vIndexBufferObj_OGL );
-   glDrawElements( GL_TRIANGLES, vDataSize_uI, GL_UNSIGNED_INT, nullptr );
+   glDrawElements(
+         GL_TRIANGLES, vDataSize_uI, vIndexType_OGL, bufferOffset( vIndexOffset_uI ) );
 
    glDisableVertexAttribArray( vInputVertexLocation_OGL );
    glDisableVertexAttribArray( vInputNormalsLocation_OGL );
@@ -248,11 +254,27 @@ void rRenderMultipleLights_3_3::setDataFromObject( rObjectBase *_obj ) {
    _obj->getMatrix( &vModelView, rObjectBase::MODEL_VIEW_MATRIX );
    _obj->getMatrix( &vNormal, rObjectBase::NORMAL_MATRIX );
 
-   uint64_t lTemp;
+   uint64_t lTemp, lStride, lNormalOffset, lIndexType, lNormalType, lIndexOffset;
 
-   _obj->getHints( rObjectBase::NUM_INDEXES, lTemp );
+   _obj->getHints( rObjectBase::NUM_INDEXES,
+                   lTemp,
+                   rObjectBase::VERTEX_STRIDE,
+                   lStride,
+                   rObjectBase::NORMAL_OFFSET,
+                   lNormalOffset,
+                   rObjectBase::INDEX_TYPE,
+                   lIndexType,
+                   rObjectBase::NORMAL_TYPE,
+                   lNormalType,
+                   rObjectBase::INDEX_OFFSET,
+                   lIndexOffset );
 
    vDataSize_uI = static_cast<GLsizei>( lTemp );
+   vStride_uI = static_cast<GLsizei>( lStride );
+   vNormalOffset_uI = static_cast<size_t>( lNormalOffset );
+   vIndexType_OGL = typeFromHint( lIndexType, GL_UNSIGNED_INT );
+   vNormalType_OGL = typeFromHint( lNormalType, GL_FLOAT );
+   vIndexOffset_uI = static_cast<size_t>( lIndexOffset );
 }
 
 void rRenderMultipleLights_3_3::setDataFromAdditionalObjects( rObjectBase *_obj ) {
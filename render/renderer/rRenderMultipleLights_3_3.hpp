@@ -58,6 +58,11 @@ class rRenderMultipleLights_3_3 : public rRenderBase {
    std::vector<sUniforms> vUniforms;
 
    GLsizei vDataSize_uI = 0;
+   GLsizei vStride_uI = 0;
+   size_t vNormalOffset_uI = 0;
+   GLenum vIndexType_OGL = GL_UNSIGNED_INT;
+   size_t vIndexOffset_uI = 0;
+   GLenum vNormalType_OGL = GL_FLOAT;
 
    rMat4f *vModelViewProjection = nullptr;
    rMat4f *vModelView = nullptr;
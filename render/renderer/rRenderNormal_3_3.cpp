@@ -41,10 +41,11 @@ void rRenderNormal_3_3::render() {
    glEnableVertexAttribArray( vInputLocation_OGL );
 
    glBindBuffer( GL_ARRAY_BUFFER, vVertexBufferObj_OGL );
-   glVertexAttribPointer( vInputLocation_OGL, 3, GL_FLOAT, GL_FALSE, 0, nullptr );
+   glVertexAttribPointer( vInputLocation_OGL, 3, GL_FLOAT, GL_FALSE, vStride_uI, nullptr );
 
    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, vIndexBufferObj_OGL );
-   glDrawElements( GL_TRIANGLES, vDataSize_uI, GL_UNSIGNED_INT, nullptr );
+   glDrawElements(
+         GL_TRIANGLES, vDataSize_uI, vIndexType_OGL, bufferOffset( vIndexOffset_uI ) );
 
    glDisableVertexAttribArray( vInputLocation_OGL );
 }
@@ -121,11 +122,21 @@ void rRenderNormal_3_3::setDataFromObject( rObjectBase *_obj ) {
    _obj->getIBO( vIndexBufferObj_OGL );
    _obj->getMatrix( &vMatrix, rObjectBase::MODEL_VIEW_PROJECTION );
 
-   uint64_t lTemp;
+   uint64_t lTemp, lStride, lIndexType, lIndexOffset;
 
-   _obj->getHints( rObjectBase::NUM_INDEXES, lTemp );
+   _obj->getHints( rObjectBase::NUM_INDEXES,
+                   lTemp,
+                   rObjectBase::VERTEX_STRIDE,
+                   lStride,
+                   rObjectBase::INDEX_TYPE,
+                   lIndexType,
+                   rObjectBase::INDEX_OFFSET,
+                   lIndexOffset );
 
    vDataSize_uI = static_cast<GLsizei>( lTemp );
+   vStride_uI = static_cast<GLsizei>( lStride );
+   vIndexType_OGL = typeFromHint( lIndexType, GL_UNSIGNED_INT );
+   vIndexOffset_uI = static_cast<size_t>( lIndexOffset );
 }
 }
 // kate: indent-mode cstyle; indent-width 3; replace-tabs on; line-numbers on;
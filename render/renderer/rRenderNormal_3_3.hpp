@@ -46,6 +46,9 @@ class rRenderNormal_3_3 final : public rRenderBase {
    GLint vUniformLocation_OGL = NOT_SET_ui;
 
    GLsizei vDataSize_uI = 0;
+   GLsizei vStride_uI = 0;
+   GLenum vIndexType_OGL = GL_UNSIGNED_INT;
+   size_t vIndexOffset_uI = 0;
 
    rMat4f *vMatrix = nullptr;
 
@@ -42,6 +42,11 @@ class rRenderVertexNormal_3_3 : public rRenderBase {
    GLint vUniformMVP_OGL = NOT_SET;
 
    GLsizei vDataSize_uI = 0;
+   GLsizei vStride_uI = 0;
+   size_t vNormalOffset_uI = 0;
+   GLenum vIndexType_OGL = GL_UNSIGNED_INT;
+   size_t vIndexOffset_uI = 0;
+   GLenum vNormalType_OGL = GL_FLOAT;
 
    rMat4f *vModelViewProjection = nullptr;
 
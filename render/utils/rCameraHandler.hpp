@@ -103,7 +103,8 @@ class rCameraHandler {
 
    void printCameraPosition();
 
-   virtual void afterCameraUpdate() = 0;
+   //! The matrices of the objects are updated lazily (rMatrixSceneBase::getVersion)
+   virtual void afterCameraUpdate() {}
 };
 
 template <class T>
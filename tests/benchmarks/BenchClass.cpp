@@ -17,10 +17,22 @@
 #include <engine.hpp>
 #include "BenchClass.hpp"
 #include "cmdANDinit.hpp"
+#include <boost/filesystem.hpp>
+#include <thread>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <memory>
+
+#if UNIX
+#include <sys/resource.h>
+#endif
 
 BenchBaseVirtual::~BenchBaseVirtual() {}
 
 using namespace std;
+using namespace e_engine;
 
 #define START( __VarName__ )                                                                       \
    std::chrono::system_clock::time_point __VarName__ = std::chrono::system_clock::now();
@@ -37,8 +49,16 @@ BenchClass::BenchClass( cmdANDinit *_cmd )
 
    bool lDoFunctionBench = false;
    bool lDoMutexBench = false;
+   bool lDoOBJBench = false;
+   bool lDoReindexBench = false;
+   bool lDoFormatsBench = false;
+   bool lDoMatrixBench = false;
    _cmd->getFunctionInf( vLoopsToDo, lDoFunctionBench );
    _cmd->getMutexInf( vLoopsToDoMutex, lDoMutexBench );
+   _cmd->getOBJInf( vOBJFile_str, lDoOBJBench );
+   _cmd->getReindexInf( vReindexCorners, lDoReindexBench );
+   _cmd->getFormatsInf( vFormatCorners, lDoFormatsBench );
+   _cmd->getMatrixInf( vMatrixLoops, lDoMatrixBench );
 
    if ( lDoFunctionBench ) {
       vTheSignal.connect( &vTheSlot );
@@ -60,6 +80,18 @@ BenchClass::BenchClass( cmdANDinit *_cmd )
 
    if ( lDoMutexBench )
       doMutex();
+
+   if ( lDoOBJBench )
+      doOBJ();
+
+   if ( lDoReindexBench )
+      doReindex();
+
+   if ( lDoFormatsBench )
+      doFormats();
+
+   if ( lDoMatrixBench )
+      doMatrix();
 }
 
 void BenchClass::doFunction() {
@@ -314,4 +346,908 @@ void BenchClass::doMutex() {
 }
 
 
+void BenchClass::doOBJ() {
+   double lSize = static_cast<double>( boost::filesystem::file_size( vOBJFile_str ) ) / 1000000.0;
+
+   iLOG( "==== BEGIN OBJ LOADER BENCHMARK ====" );
+   iLOG( "" );
+   iLOG( "  - File: ", vOBJFile_str );
+   iLOG( "  - Size: ", lSize, " MB" );
+
+   rLoader_3D_f_OBJ lReadLoader( vOBJFile_str );
+   lReadLoader.setLoadMode( rLoader_3D_f_OBJ::READ_FILE );
+   lReadLoader.setNumThreads( 1 );
+
+   START( readFile );
+   int lReadRet = lReadLoader.load();
+   uint64_t lReadFile = STOP( readFile );
+
+   rLoader_3D_f_OBJ lMappedLoader( vOBJFile_str );
+   lMappedLoader.setLoadMode( rLoader_3D_f_OBJ::MEMORY_MAPPED );
+   lMappedLoader.setNumThreads( 1 );
+
+   START( mapped );
+   int lMappedRet = lMappedLoader.load();
+   uint64_t lMapped = STOP( mapped );
+
+   rLoader_3D_f_OBJ lParallelLoader( vOBJFile_str );
+   lParallelLoader.setLoadMode( rLoader_3D_f_OBJ::MEMORY_MAPPED );
+   lParallelLoader.setNumThreads( 0 );
+
+   START( parallel );
+   int lParallelRet = lParallelLoader.load();
+   uint64_t lParallel = STOP( parallel );
+
+   START( reindex );
+   lMappedLoader.reindex();
+   uint64_t lReindex = STOP( reindex );
+
+   if ( lReadRet != 1 || lMappedRet != 1 || lParallelRet != 1 ) {
+      eLOG( "Failed to load ",
+            vOBJFile_str,
+            " (",
+            lReadRet,
+            ", ",
+            lMappedRet,
+            ", ",
+            lParallelRet,
+            ")" );
+      return;
+   }
+
+   iLOG( "  - Threads: ", std::thread::hardware_concurrency() );
+   iLOG( "  - Time: microseconds" );
+
+   iLOG( "  = Read file:         ", lReadFile, " (", lSize / ( lReadFile / 1000000.0 ), " MB/s)" );
+   iLOG( "  = Memory mapped:     ", lMapped, " (", lSize / ( lMapped / 1000000.0 ), " MB/s)" );
+   iLOG( "  = Mapped + threads:  ", lParallel, " (", lSize / ( lParallel / 1000000.0 ), " MB/s)" );
+   iLOG( "  = Reindex:           ", lReindex );
+}
+
+
+namespace {
+
+/*!
+ * \brief Generates a grid mesh with positions, normals and UVs (every vertex has its own normal
+ *        and UV, so the mesh has as many unique vertices as grid points)
+ */
+class BenchGridMesh final : public internal::rLoaderBase<GLfloat, GLuint> {
+ private:
+   GLuint vSize;
+
+ public:
+   BenchGridMesh( unsigned int _corners ) {
+      vIsDataLoaded_B = false;
+      vSize = static_cast<GLuint>( sqrt( _corners / 6.0 ) ) + 1;
+   }
+
+   int load() {
+      for ( GLuint y = 0; y < vSize; ++y ) {
+         for ( GLuint x = 0; x < vSize; ++x ) {
+            vDataRaw.vVertexData.insert(
+                  vDataRaw.vVertexData.end(),
+                  {static_cast<GLfloat>( x ), static_cast<GLfloat>( y ), 0} );
+            vDataRaw.vNormalesData.insert( vDataRaw.vNormalesData.end(), {0, 0, 1} );
+            vDataRaw.vUVData.insert(
+                  vDataRaw.vUVData.end(),
+                  {static_cast<GLfloat>( x ) / vSize, static_cast<GLfloat>( y ) / vSize} );
+         }
+      }
+
+      for ( GLuint y = 0; y + 1 < vSize; ++y ) {
+         for ( GLuint x = 0; x + 1 < vSize; ++x ) {
+            GLuint a = y * vSize + x;
+            GLuint b = a + 1;
+            GLuint c = a + vSize;
+            GLuint d = c + 1;
+
+            for ( GLuint i : {a, b, c, b, d, c} ) {
+               vDataRaw.vIndexVertexData.emplace_back( i );
+               vDataRaw.vIndexNormalData.emplace_back( i );
+               vDataRaw.vIndexUVData.emplace_back( i );
+            }
+         }
+      }
+
+      vIsDataLoaded_B = true;
+      return 1;
+   }
+
+   size_t getNumCorners() const { return vDataRaw.vIndexVertexData.size(); }
+};
+
+//! Peak resident memory in KiB (0 if not supported)
+uint64_t getPeakMemory() {
+#if UNIX
+   struct rusage lUsage;
+   getrusage( RUSAGE_SELF, &lUsage );
+   return static_cast<uint64_t>( lUsage.ru_maxrss );
+#else
+   return 0;
+#endif
+}
+}
+
+void BenchClass::doReindex() {
+   BenchGridMesh lMesh( vReindexCorners );
+   lMesh.load();
+
+   iLOG( "==== BEGIN REINDEX BENCHMARK ====" );
+   iLOG( "" );
+   iLOG( "  - Corners: ", lMesh.getNumCorners() );
+
+   uint64_t lMemBefore = getPeakMemory();
+
+   START( reindex );
+   lMesh.reindex();
+   uint64_t lReindex = STOP( reindex );
+
+   uint64_t lMemAfter = getPeakMemory();
+
+   internal::rMeshOptimizer<GLfloat, GLuint> lOptimizer;
+
+   START( optimize );
+   lOptimizer.optimize( lMesh.getData() );
+   uint64_t lOptimize = STOP( optimize );
+
+   iLOG( "  - Vertices: ", lMesh.getData()->vVertexData.size() / 3 );
+   iLOG( "  - Time: microseconds" );
+
+   iLOG( "  = Reindex:     ", lReindex );
+   iLOG( "  = Peak memory: +", ( lMemAfter - lMemBefore ) / 1024, " MiB (only on UNIX)" );
+   iLOG( "  = Optimize:    ", lOptimize );
+   iLOG( "  = ACMR:        ",
+         lOptimizer.getACMRBefore(),
+         " -> ",
+         lOptimizer.getACMRAfter(),
+         " (FIFO cache with ",
+         static_cast<uint32_t>( internal::rMeshOptimizer<GLfloat, GLuint>::CACHE_SIZE ),
+         " entries)" );
+}
+
+
+namespace {
+
+typedef internal::_3D_Data<GLfloat, GLuint> BENCH_DATA;
+
+//! Writes the mesh as OBJ (indexes start at 0, like the files from tools/objParsePrint.awk)
+bool writeOBJ( std::string _file, BENCH_DATA const *_data ) {
+   FILE *lFile = fopen( _file.c_str(), "w" );
+   if ( !lFile )
+      return false;
+
+   auto const &lV = _data->vVertexData;
+   auto const &lN = _data->vNormalesData;
+
+   for ( size_t i = 0; i + 2 < lV.size(); i += 3 )
+      fprintf( lFile, "v %f %f %f\n", lV[i], lV[i + 1], lV[i + 2] );
+
+   for ( size_t i = 0; i + 2 < lN.size(); i += 3 )
+      fprintf( lFile, "vn %f %f %f\n", lN[i], lN[i + 1], lN[i + 2] );
+
+   for ( size_t i = 0; i + 2 < _data->vIndex.size(); i += 3 ) {
+      GLuint a = _data->vIndex[i], b = _data->vIndex[i + 1], c = _data->vIndex[i + 2];
+      fprintf( lFile, "f %u//%u %u//%u %u//%u\n", a, a, b, b, c, c );
+   }
+
+   return fclose( lFile ) == 0;
+}
+
+//! Writes the mesh as binary little endian PLY (x y z nx ny nz, triangles)
+bool writePLY( std::string _file, BENCH_DATA const *_data ) {
+   FILE *lFile = fopen( _file.c_str(), "wb" );
+   if ( !lFile )
+      return false;
+
+   size_t lNumVertices = _data->vVertexData.size() / 3;
+   size_t lNumFaces = _data->vIndex.size() / 3;
+
+   fprintf( lFile,
+            "ply\nformat binary_little_endian 1.0\nelement vertex %zu\n"
+            "property float x\nproperty float y\nproperty float z\n"
+            "property float nx\nproperty float ny\nproperty float nz\n"
+            "element face %zu\nproperty list uchar int vertex_indices\nend_header\n",
+            lNumVertices,
+            lNumFaces );
+
+   for ( size_t i = 0; i < lNumVertices; ++i ) {
+      fwrite( &_data->vVertexData[i * 3], sizeof( GLfloat ), 3, lFile );
+      fwrite( &_data->vNormalesData[i * 3], sizeof( GLfloat ), 3, lFile );
+   }
+
+   unsigned char lThree = 3;
+   for ( size_t i = 0; i < lNumFaces; ++i ) {
+      fwrite( &lThree, 1, 1, lFile );
+      fwrite( &_data->vIndex[i * 3], sizeof( GLuint ), 3, lFile );
+   }
+
+   return fclose( lFile ) == 0;
+}
+
+//! Writes the mesh as binary STL (the normal of a triangle is the normal of its first vertex)
+bool writeSTL( std::string _file, BENCH_DATA const *_data ) {
+   FILE *lFile = fopen( _file.c_str(), "wb" );
+   if ( !lFile )
+      return false;
+
+   char lHeader[80] = "EEnginE benchmark";
+   uint32_t lNumTriangles = static_cast<uint32_t>( _data->vIndex.size() / 3 );
+   uint16_t lAttribute = 0;
+
+   fwrite( lHeader, 1, sizeof( lHeader ), lFile );
+   fwrite( &lNumTriangles, sizeof( lNumTriangles ), 1, lFile );
+
+   for ( size_t i = 0; i < lNumTriangles; ++i ) {
+      fwrite( &_data->vNormalesData[_data->vIndex[i * 3] * 3], sizeof( GLfloat ), 3, lFile );
+
+      for ( size_t j = 0; j < 3; ++j )
+         fwrite( &_data->vVertexData[_data->vIndex[i * 3 + j] * 3], sizeof( GLfloat ), 3, lFile );
+
+      fwrite( &lAttribute, sizeof( lAttribute ), 1, lFile );
+   }
+
+   return fclose( lFile ) == 0;
+}
+
+//! Writes _size raw bytes to _file
+bool writeRaw( std::string _file, void const *_data, size_t _size ) {
+   FILE *lFile = fopen( _file.c_str(), "wb" );
+   if ( !lFile )
+      return false;
+
+   fwrite( _data, 1, _size, lFile );
+   return fclose( lFile ) == 0;
+}
+
+//! Loads a malformed file; the loader must reject it with a parsing error (2)
+template <class LOADER>
+bool rejectsFile( std::string _file, void const *_data, size_t _size ) {
+   if ( !writeRaw( _file, _data, _size ) )
+      return false;
+
+   LOADER lLoader( _file );
+   int lRet = lLoader.load();
+   boost::filesystem::remove( _file );
+   return lRet == 2;
+}
+
+struct BenchFormatResult {
+   double size = 0;       //!< MB
+   uint64_t load = 0;     //!< microseconds
+   uint64_t reindex = 0;  //!< microseconds
+   size_t vertices = 0;   //!< after reindex
+   size_t triangles = 0;  //!< after reindex
+   int ret = 0;
+};
+
+template <class LOADER>
+BenchFormatResult benchLoader( std::string _file ) {
+   BenchFormatResult lResult;
+   lResult.size = static_cast<double>( boost::filesystem::file_size( _file ) ) / 1000000.0;
+
+   LOADER lLoader( _file );
+
+   START( load );
+   lResult.ret = lLoader.load();
+   lResult.load = STOP( load );
+
+   START( reindex );
+   lLoader.reindex();
+   lResult.reindex = STOP( reindex );
+
+   lResult.vertices = lLoader.getData()->vVertexData.size() / 3;
+   lResult.triangles = lLoader.getData()->vIndex.size() / 3;
+   return lResult;
+}
+}
+
+void BenchClass::doFormats() {
+   BenchGridMesh lMesh( vFormatCorners );
+   lMesh.load();
+   lMesh.reindex();
+
+   iLOG( "==== BEGIN MESH FORMATS BENCHMARK ====" );
+   iLOG( "" );
+   iLOG( "  - Corners: ", lMesh.getData()->vIndex.size() );
+
+   boost::filesystem::path lBase =
+         boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+
+   std::string lOBJ = lBase.string() + ".obj";
+   std::string lPLY = lBase.string() + ".ply";
+   std::string lSTL = lBase.string() + ".stl";
+
+   if ( !writeOBJ( lOBJ, lMesh.getData() ) || !writePLY( lPLY, lMesh.getData() ) ||
+        !writeSTL( lSTL, lMesh.getData() ) ) {
+      eLOG( "Failed to write the benchmark meshes (", lBase.string(), ".*)" );
+      boost::filesystem::remove( lOBJ );
+      boost::filesystem::remove( lPLY );
+      boost::filesystem::remove( lSTL );
+      return;
+   }
+
+   BenchFormatResult lResults[] = {benchLoader<rLoader_3D_f_OBJ>( lOBJ ),
+                                   benchLoader<rLoader_3D_f_PLY>( lPLY ),
+                                   benchLoader<rLoader_3D_f_STL>( lSTL )};
+   char const *lNames[] = {"OBJ:", "PLY:", "STL:"};
+
+   boost::filesystem::remove( lOBJ );
+   boost::filesystem::remove( lPLY );
+   boost::filesystem::remove( lSTL );
+
+   iLOG( "  - Time: microseconds (load + reindex)" );
+
+   for ( size_t i = 0; i < 3; ++i ) {
+      BenchFormatResult const &r = lResults[i];
+
+      if ( r.ret != 1 ) {
+         eLOG( "  = ", lNames[i], " failed to load (", r.ret, ")" );
+         continue;
+      }
+
+      iLOG( "  = ",
+            lNames[i],
+            " ",
+            r.load,
+            " + ",
+            r.reindex,
+            " (",
+            r.size,
+            " MB, ",
+            r.size / ( r.load / 1000000.0 ),
+            " MB/s, ",
+            r.vertices,
+            " vertices, ",
+            r.triangles,
+            " triangles)" );
+   }
+
+   // Malformed headers: magic, version, file length, JSON chunk length and type (little endian)
+   uint8_t const lGLBShortLength[] = {'g', 'l', 'T', 'F', 2, 0, 0, 0, 12, 0, 0, 0,
+                                      0, 0, 0, 16, 'J', 'S', 'O', 'N', 0, 0};
+   uint8_t const lGLBTruncated[] = {'g', 'l', 'T', 'F', 2, 0, 0, 0, 0, 1, 0, 0,
+                                    4, 0, 0, 0, 'J', 'S', 'O', 'N', '{', '}'};
+
+   char const lPLYHugeFaces[] = "ply\nformat binary_little_endian 1.0\nelement vertex 0\n"
+                                "property float x\nproperty float y\nproperty float z\n"
+                                "element face 4000000000000000000\n"
+                                "property list uchar int vertex_indices\nend_header\n";
+
+   bool lRejected[] = {
+         rejectsFile<rLoader_3D_f_GLB>(
+               lBase.string() + ".glb", lGLBShortLength, sizeof( lGLBShortLength ) ),
+         rejectsFile<rLoader_3D_f_GLB>(
+               lBase.string() + ".glb", lGLBTruncated, sizeof( lGLBTruncated ) ),
+         rejectsFile<rLoader_3D_f_PLY>(
+               lBase.string() + ".ply", lPLYHugeFaces, sizeof( lPLYHugeFaces ) - 1 )};
+   char const *lMalformed[] = {"GLB (length < 20):", "GLB (truncated):", "PLY (face count):"};
+
+   for ( size_t i = 0; i < sizeof( lRejected ) / sizeof( lRejected[0] ); ++i ) {
+      if ( lRejected[i] ) {
+         iLOG( "  = ", lMalformed[i], " rejected" );
+      } else {
+         eLOG( "  = ", lMalformed[i], " NOT rejected" );
+      }
+   }
+}
+
+
+namespace {
+
+struct BenchMatrixResult {
+   uint64_t scalar = 0; //!< microseconds
+   uint64_t simd = 0;   //!< microseconds
+   bool identical = false;
+};
+
+/*!
+ * \brief Runs both kernels _loops times on their own copy of _start (the output is the next input)
+ *
+ * The feedback keeps the compiler from removing the loop; the final states are compared bit by bit.
+ */
+template <class SCALAR, class SIMD>
+BenchMatrixResult benchMatrixKernel( SCALAR _scalar,
+                                     SIMD _simd,
+                                     rMat4f const &_start,
+                                     unsigned int _loops ) {
+   BenchMatrixResult lResult;
+   rMat4f lScalar = _start;
+   rMat4f lSIMD = _start;
+
+   START( scalar );
+   for ( unsigned int i = 0; i < _loops; ++i )
+      _scalar( lScalar.getMatrix() );
+   lResult.scalar = STOP( scalar );
+
+   START( simd );
+   for ( unsigned int i = 0; i < _loops; ++i )
+      _simd( lSIMD.getMatrix() );
+   lResult.simd = STOP( simd );
+
+   lResult.identical = memcmp( lScalar.getMatrix(), lSIMD.getMatrix(), sizeof( float ) * 16 ) == 0;
+   return lResult;
+}
+
+//! rMatrix operator* before the expression templates (operands and result passed by value)
+rMat4f multiplyByValue( rMat4f _lMatrix, rMat4f _rMatrix ) {
+   rMat4f lTarget;
+   _lMatrix.multiply( _rMatrix, &lTarget );
+   return lTarget;
+}
+
+//! Replaces the upper 3x3 matrix of _m with its normal matrix
+void normalMatrixKernel( float *_m, rMatrixMath::TRANSFORM_CLASS _class ) {
+   rMat4f lIn( _m );
+   rMat3f lNormal;
+   rMatrixMath::getNormalMatrix( lIn, lNormal, _class );
+
+   for ( uint32_t c = 0; c < 3; ++c )
+      for ( uint32_t r = 0; r < 3; ++r )
+         _m[c * 4 + r] = lNormal.get( c, r );
+}
+
+void affineInverseKernel( float *_m, rMatrixMath::TRANSFORM_CLASS _class ) {
+   rMat4f lIn( _m );
+   rMatrixMath::affineInverse( lIn, lIn, _class );
+   memcpy( _m, lIn.getMatrix(), sizeof( float ) * 16 );
+}
+
+//! Largest error of the normal matrix and the inverse of _m (float) relative to a double reference
+float transformClassError( rMat4f const &_m, rMatrixMath::TRANSFORM_CLASS _class ) {
+   rMat4d lRef;
+   rMat3d lRefNormal;
+   rMat4d lRefInverse;
+   for ( uint32_t i = 0; i < 16; ++i )
+      lRef.vDataMat[i] = _m.vDataMat[i];
+
+   rMatrixMath::getNormalMatrix( lRef, lRefNormal );
+   rMatrixMath::affineInverse( lRef, lRefInverse );
+
+   rMat3f lNormal;
+   rMat4f lInverse;
+   rMatrixMath::getNormalMatrix( _m, lNormal, _class );
+   rMatrixMath::affineInverse( _m, lInverse, _class );
+
+   double lError = 0;
+   for ( uint32_t i = 0; i < 9; ++i )
+      lError = std::max( lError,
+                         std::abs( lNormal.vDataMat[i] - lRefNormal.vDataMat[i] ) /
+                               std::max( 1.0, std::abs( lRefNormal.vDataMat[i] ) ) );
+
+   for ( uint32_t i = 0; i < 16; ++i )
+      lError = std::max( lError,
+                         std::abs( lInverse.vDataMat[i] - lRefInverse.vDataMat[i] ) /
+                               std::max( 1.0, std::abs( lRefInverse.vDataMat[i] ) ) );
+
+   return static_cast<float>( lError );
+}
+
+//! Object with only a bounding volume (cube with the size 2) for the culling test
+class BenchCullObject final : public rObjectBase, public rMatrixObjectBase<float> {
+   virtual int clearOGLData__() { return -1; }
+   virtual int setOGLData__() { return -1; }
+
+ public:
+   BenchCullObject( rMatrixSceneBase<float> *_scene, rVec3f _position )
+       : rObjectBase( "CULL", "", SET_DATA_MANUALLY ), rMatrixObjectBase<float>( _scene ) {
+      setBoundingVolume( rVec3f( -1, -1, -1 ), rVec3f( 1, 1, 1 ), rVec4f( 0, 0, 0, 1.7320508f ) );
+      setPosition( _position );
+   }
+
+   virtual void updateMatrices() { updateFinalMatrix(); }
+
+   virtual uint32_t getVector( rVec3f **_vec, VECTOR_TYPES _type ) {
+      *_vec = _type == AABB_MIN ? getWorldBoxMin() : getWorldBoxMax();
+      return _type == AABB_MIN || _type == AABB_MAX ? ALL_OK : UNSUPPORTED_TYPE;
+   }
+
+   virtual uint32_t getVector( rVec4f **_vec, VECTOR_TYPES _type ) {
+      *_vec = getWorldSphere();
+      return _type == BOUNDING_SPHERE ? ALL_OK : UNSUPPORTED_TYPE;
+   }
+};
+}
+
+void BenchClass::doMatrix() {
+   iLOG( "==== BEGIN MATRIX BENCHMARK ====" );
+   iLOG( "" );
+   iLOG( "  - Loops: ", vMatrixLoops );
+#if E_SIMD_SSE2
+   iLOG( "  - SIMD:  SSE2" );
+#else
+   iLOG( "  - SIMD:  none (the scalar fallback is used)" );
+#endif
+
+   rMat4f lRot;
+   rMat4f lStart;
+   rMatrixMath::rotate( rVec3f( 1, 2, 3 ), 10.0f, lRot );
+   rMatrixMath::rotate( rVec3f( 3, 1, 2 ), 42.0f, lStart );
+   lStart.get<3, 0>() = 1.5f;
+   lStart.get<3, 1>() = -2.0f;
+   lStart.get<3, 2>() = 4.0f;
+
+   float const *lR = lRot.getMatrix();
+
+   BenchMatrixResult lMul = benchMatrixKernel(
+         [lR]( float *_m ) { internal::mat4MultiplyScalar( lR, _m, _m ); },
+         [lR]( float *_m ) { internal::mat4Multiply( lR, _m, _m ); },
+         lStart,
+         vMatrixLoops );
+
+   // Only the first column is used as vector
+   BenchMatrixResult lVec = benchMatrixKernel(
+         [lR]( float *_m ) { internal::mat4MultiplyVec4Scalar( lR, _m, _m ); },
+         [lR]( float *_m ) { internal::mat4MultiplyVec4( lR, _m, _m ); },
+         lStart,
+         vMatrixLoops );
+
+   BenchMatrixResult lTrans = benchMatrixKernel(
+         []( float *_m ) { internal::mat4TransposeScalar( _m, _m ); },
+         []( float *_m ) { internal::mat4Transpose( _m, _m ); },
+         lStart,
+         vMatrixLoops );
+
+   BenchMatrixResult lInv = benchMatrixKernel(
+         []( float *_m ) { internal::mat4AffineInverseScalar( _m, _m ); },
+         []( float *_m ) { internal::mat4AffineInverse( _m, _m ); },
+         lStart,
+         vMatrixLoops );
+
+   // Only the first 4 elements are used as quaternion
+   rQuatf lQuat = rQuatf::fromAxisAngle( rVec3f( 1, 2, 3 ), 10.0f );
+   float const *lQ = lQuat.getMatrix();
+
+   BenchMatrixResult lQuatMul = benchMatrixKernel(
+         [lQ]( float *_m ) { internal::quatMultiplyScalar( lQ, _m, _m ); },
+         [lQ]( float *_m ) { internal::quatMultiply( lQ, _m, _m ); },
+         lStart,
+         vMatrixLoops );
+
+   BenchMatrixResult lRigidInv = benchMatrixKernel(
+         []( float *_m ) { internal::mat4RigidInverseScalar( _m, 1.0f, _m ); },
+         []( float *_m ) { internal::mat4RigidInverse( _m, 1.0f, _m ); },
+         lStart,
+         vMatrixLoops );
+
+   BenchMatrixResult const *lResults[] = {&lMul, &lVec, &lTrans, &lInv, &lRigidInv, &lQuatMul};
+   char const *lNames[] = {"Mat4 * Mat4:    ",
+                           "Mat4 * Vec4:    ",
+                           "Transpose:      ",
+                           "Affine inverse: ",
+                           "Rigid inverse:  ",
+                           "Quat * Quat:    "};
+
+   iLOG( "  - Time: microseconds (scalar -> SIMD)" );
+
+   for ( size_t i = 0; i < 6; ++i ) {
+      BenchMatrixResult const &r = *lResults[i];
+
+      iLOG( "  = ",
+            lNames[i],
+            r.scalar,
+            " -> ",
+            r.simd,
+            " (",
+            static_cast<double>( r.scalar ) / std::max<uint64_t>( r.simd, 1 ),
+            "x; bit identical: ",
+            r.identical ? "yes)" : "NO)" );
+   }
+
+   // The T * R * S chain of updateFinalMatrix(): temporaries of the by value operators vs. the
+   // expression templates (the product is written directly into the target)
+   rMat4f lTranslation;
+   lTranslation.setMat( 1.0f, 0.0f, 0.0f, 0.5f, 0.0f, 1.0f, 0.0f, -0.25f, 0.0f, 0.0f, 1.0f, 0.125f,
+                        0.0f, 0.0f, 0.0f, 1.0f );
+
+   BenchMatrixResult lChain = benchMatrixKernel(
+         [&]( float *_m ) {
+            rMat4f lScale( _m );
+            rMat4f lModel = multiplyByValue( multiplyByValue( lTranslation, lRot ), lScale );
+            memcpy( _m, lModel.getMatrix(), sizeof( float ) * 16 );
+         },
+         [&]( float *_m ) {
+            rMat4f lScale( _m );
+            rMat4f lModel = lTranslation * lRot * lScale;
+            memcpy( _m, lModel.getMatrix(), sizeof( float ) * 16 );
+         },
+         lStart,
+         vMatrixLoops );
+
+   iLOG( "  - Time: microseconds (by value operators -> expression templates)" );
+   iLOG( "  = T * R * S:      ",
+         lChain.scalar,
+         " -> ",
+         lChain.simd,
+         " (",
+         static_cast<double>( lChain.scalar ) / std::max<uint64_t>( lChain.simd, 1 ),
+         "x; bit identical: ",
+         lChain.identical ? "yes)" : "NO)" );
+
+   // Normal matrix and inverse: the general path (cofactors / 3x3 inverse) vs. the fast path of the
+   // transform class. The fast paths assume an exactly orthogonal rotation, so they are a few ulp
+   // less accurate than the general path.
+   rMat4f lClassMatrices[3];
+   rMat4f lClassScale;
+   lClassMatrices[0] = lStart;
+   rMatrixMath::scale( 2.5f, lClassScale );
+   lClassMatrices[1] = lStart * lClassScale;
+   rMatrixMath::scale( rVec3f( 0.5f, 2.0f, 3.0f ), lClassScale );
+   lClassMatrices[2] = lStart * lClassScale;
+
+   char const *lClassNames[] = {"Rigid:          ", "Uniform scale:  ", "General:        "};
+
+   iLOG( "  - Time: microseconds (general -> transform class; normal matrix | inverse)" );
+
+   for ( int i = 0; i < 3; ++i ) {
+      auto lClass = static_cast<rMatrixMath::TRANSFORM_CLASS>( i );
+
+      BenchMatrixResult lNormal = benchMatrixKernel(
+            []( float *_m ) { normalMatrixKernel( _m, rMatrixMath::TRANSFORM_GENERAL ); },
+            [lClass]( float *_m ) { normalMatrixKernel( _m, lClass ); },
+            lClassMatrices[i],
+            vMatrixLoops );
+
+      BenchMatrixResult lInverse = benchMatrixKernel(
+            []( float *_m ) { affineInverseKernel( _m, rMatrixMath::TRANSFORM_GENERAL ); },
+            [lClass]( float *_m ) { affineInverseKernel( _m, lClass ); },
+            lClassMatrices[i],
+            vMatrixLoops );
+
+      iLOG( "  = ",
+            lClassNames[i],
+            lNormal.scalar,
+            " -> ",
+            lNormal.simd,
+            " | ",
+            lInverse.scalar,
+            " -> ",
+            lInverse.simd,
+            " (max. relative error: ",
+            transformClassError( lClassMatrices[i], lClass ),
+            ")" );
+   }
+
+   // Per object updateFinalMatrix() vs. the batched transform system (static objects, so only the
+   // view dependent matrices are recalculated)
+   const size_t lNumObjects = 10000;
+   unsigned int lRounds = std::max( vMatrixLoops / 100000, 1u );
+
+   rMatrixSceneBase<float> lScene;
+   rTransformSystem<float> lTransforms( &lScene, lNumObjects );
+   std::vector<std::unique_ptr<rMatrixObjectBase<float>>> lObjects;
+   std::vector<std::unique_ptr<rMatrixObjectBase<float>>> lBatched;
+
+   for ( size_t i = 0; i < lNumObjects; ++i ) {
+      lObjects.emplace_back( new rMatrixObjectBase<float>( &lScene ) );
+      lBatched.emplace_back( new rMatrixObjectBase<float>( &lScene ) );
+      lBatched.back()->setTransformSystem( &lTransforms );
+
+      for ( auto *j : {lObjects.back().get(), lBatched.back().get()} ) {
+         j->setPosition( rVec3f( i % 100, i / 100, -5.0f ) );
+         j->setRotation( rVec3f( 0, 1, 0 ), static_cast<float>( i ) );
+      }
+   }
+
+   lScene.calculateProjectionPerspective( 1.5f, 0.1f, 100.0f, 60.0f );
+
+   for ( auto &j : lObjects )
+      j->updateFinalMatrix();
+
+   START( perObject );
+   for ( unsigned int i = 0; i < lRounds; ++i ) {
+      lScene.setCamera( rVec3f( i, 0, 0 ), rVec3f( i, 0, -1 ), rVec3f( 0, 1, 0 ) );
+      for ( auto &j : lObjects )
+         j->updateFinalMatrix();
+   }
+   uint64_t lPerObject = STOP( perObject );
+
+   // Spinning objects (myScene::keySlot): new axis / angle rotation vs. a quaternion step
+   rQuatf lStep = rQuatf::fromAxisAngle( rVec3f( 0, 1, 0 ), 0.25f );
+
+   START( axisAngle );
+   for ( unsigned int i = 0; i < lRounds; ++i )
+      for ( auto &j : lObjects ) {
+         j->setRotation( rVec3f( 0, 1, 0 ), static_cast<float>( i ) * 0.25f );
+         j->updateFinalMatrix();
+      }
+   uint64_t lAxisAngle = STOP( axisAngle );
+
+   START( rotationDelta );
+   for ( unsigned int i = 0; i < lRounds; ++i )
+      for ( auto &j : lObjects ) {
+         j->addRotationDelta( lStep );
+         j->updateFinalMatrix();
+      }
+   uint64_t lRotationDelta = STOP( rotationDelta );
+
+   START( batched );
+   for ( unsigned int i = 0; i < lRounds; ++i ) {
+      lScene.setCamera( rVec3f( i, 0, 0 ), rVec3f( i, 0, -1 ), rVec3f( 0, 1, 0 ) );
+      lTransforms.update();
+   }
+   uint64_t lBatchedTime = STOP( batched );
+
+   uWorkerPool lPool;
+
+   START( threaded );
+   for ( unsigned int i = 0; i < lRounds; ++i ) {
+      lScene.setCamera( rVec3f( i, 0, 0 ), rVec3f( i, 0, -1 ), rVec3f( 0, 1, 0 ) );
+      lTransforms.update( &lPool );
+   }
+   uint64_t lThreaded = STOP( threaded );
+
+   iLOG( "  - Transforms: ", lNumObjects, " objects, ", lRounds, " camera changes" );
+   iLOG( "  = updateFinalMatrix():     ", lPerObject );
+   iLOG( "  = setRotation( axis, a ):  ", lAxisAngle );
+   iLOG( "  = addRotationDelta():      ", lRotationDelta );
+   iLOG( "  = rTransformSystem:        ", lBatchedTime );
+   iLOG( "  = rTransformSystem (pool): ", lThreaded, " (", lPool.getNumThreads(), " threads)" );
+
+   // Scene graph: 4 children per node, 1% of the nodes animated. Only their subtrees are updated,
+   // the full update recalculates every node.
+   const size_t lNumNodes = 10000;
+   const size_t lAnimateEvery = 100;
+
+   rSceneGraph<float> lGraph;
+   std::vector<size_t> lNodes;
+   rVec3f lNodeOffset( 1.0f, 0.0f, 0.0f );
+   rVec3f lNodeScale( 1.0f, 1.0f, 1.0f );
+
+   for ( size_t i = 0; i < lNumNodes; ++i ) {
+      size_t lParent = i == 0 ? rSceneGraph<float>::INVALID_ID : lNodes[( i - 1 ) / 4];
+      lNodes.push_back( lGraph.add( lParent ) );
+      lGraph.setTransform( lNodes.back(), lNodeOffset, rQuatf(), lNodeScale );
+   }
+
+   lGraph.update();
+
+   rQuatf lNodeRotation;
+   size_t lNumUpdated = 0;
+
+   START( incremental );
+   for ( unsigned int i = 0; i < lRounds; ++i ) {
+      lNodeRotation = lStep * lNodeRotation;
+
+      for ( size_t j = lAnimateEvery / 2; j < lNumNodes; j += lAnimateEvery )
+         lGraph.setTransform( lNodes[j], lNodeOffset, lNodeRotation, lNodeScale );
+
+      lNumUpdated += lGraph.update();
+   }
+   uint64_t lIncremental = STOP( incremental );
+
+   START( fullGraph );
+   for ( unsigned int i = 0; i < lRounds; ++i ) {
+      lNodeRotation = lStep * lNodeRotation;
+
+      for ( size_t j = 0; j < lNumNodes; ++j )
+         lGraph.setTransform( lNodes[j], lNodeOffset, lNodeRotation, lNodeScale );
+
+      lGraph.update();
+   }
+   uint64_t lFullGraph = STOP( fullGraph );
+
+   iLOG( "  - Scene graph: ",
+         lNumNodes,
+         " nodes, ",
+         lNumNodes / lAnimateEvery,
+         " animated, ",
+         lRounds,
+         " frames" );
+   iLOG( "  = full update:             ", lFullGraph );
+   iLOG( "  = dirty subtrees:          ",
+         lIncremental,
+         " (",
+         lNumUpdated / lRounds,
+         " nodes per frame)" );
+
+   // Frustum culling of a scene without OpenGL: in front of the camera, behind it, beside it and
+   // crossing the far plane
+   rScene<float> lCullScene( "CULLING" );
+   lCullScene.calculateProjectionPerspective( 1.5f, 0.1f, 100.0f, 60.0f );
+   lCullScene.setCamera( rVec3f( 0, 0, 0 ), rVec3f( 0, 0, -1 ), rVec3f( 0, 1, 0 ) );
+
+   BenchCullObject lCullObjects[] = {{&lCullScene, rVec3f( 0, 0, -10 )},
+                                     {&lCullScene, rVec3f( 0, 0, 10 )},
+                                     {&lCullScene, rVec3f( 50, 0, -10 )},
+                                     {&lCullScene, rVec3f( 0, 0, -101 )}};
+
+   for ( auto &i : lCullObjects ) {
+      lCullScene.addObject( &i, 0 );
+      i.updateMatrices();
+   }
+
+   lCullScene.cullObjects();
+
+   if ( lCullScene.getNumVisible() != 2 || lCullScene.getNumCulled() != 2 ||
+        !lCullScene.getIsVisible( 0 ) || lCullScene.getIsVisible( 1 ) ||
+        lCullScene.getIsVisible( 2 ) || !lCullScene.getIsVisible( 3 ) )
+      eLOG( "  = Frustum culling: wrong result (", lCullScene.getNumVisible(), " visible)" );
+
+   // Batched tests of 10k bounding volumes: float (SSE) vs. double (scalar)
+   const size_t lNumVolumes = 10000;
+
+   rMat4d lViewProjectionD;
+   for ( uint32_t i = 0; i < 16; ++i )
+      lViewProjectionD.vDataMat[i] = lCullScene.getViewProjectionMatrix()->vDataMat[i];
+
+   rFrustum<float> lFrustum;
+   rFrustum<double> lFrustumD;
+   lFrustum.setViewProjection( *lCullScene.getViewProjectionMatrix() );
+   lFrustumD.setViewProjection( lViewProjectionD );
+
+   std::vector<rVec4f> lSpheres;
+   std::vector<rVec4f> lExtents;
+   std::vector<rVec4d> lSpheresD;
+   std::vector<rVec4d> lExtentsD;
+
+   // Exact in float and double
+   for ( size_t i = 0; i < lNumVolumes; ++i ) {
+      double lX = static_cast<double>( i % 100 ) - 49.5;
+      double lY = static_cast<double>( ( i / 100 ) % 20 ) - 9.5;
+      double lZ = 10.0 - static_cast<double>( i % 37 ) * 3.0;
+      double lSize = 0.25 + static_cast<double>( i % 7 ) * 0.5;
+
+      lSpheresD.emplace_back( static_cast<double>( lX ),
+                              static_cast<double>( lY ),
+                              static_cast<double>( lZ ),
+                              lSize * 2.0 );
+      lExtentsD.emplace_back( static_cast<double>( lSize ),
+                              static_cast<double>( lSize ),
+                              static_cast<double>( lSize ),
+                              0.0 );
+
+      lSpheres.emplace_back( static_cast<float>( lX ),
+                             static_cast<float>( lY ),
+                             static_cast<float>( lZ ),
+                             static_cast<float>( lSize * 2.0 ) );
+      lExtents.emplace_back( static_cast<float>( lSize ),
+                             static_cast<float>( lSize ),
+                             static_cast<float>( lSize ),
+                             0.0f );
+   }
+
+   std::vector<uint8_t> lVisible( lNumVolumes );
+   std::vector<uint8_t> lVisibleD( lNumVolumes );
+   size_t lNumVisible = 0;
+
+   START( cullSpheres );
+   for ( unsigned int i = 0; i < lRounds; ++i )
+      lNumVisible = lFrustum.testSpheres( lSpheres.data(), lNumVolumes, lVisible.data() );
+   uint64_t lCullSpheres = STOP( cullSpheres );
+
+   START( cullSpheresD );
+   for ( unsigned int i = 0; i < lRounds; ++i )
+      lFrustumD.testSpheres( lSpheresD.data(), lNumVolumes, lVisibleD.data() );
+   uint64_t lCullSpheresD = STOP( cullSpheresD );
+
+   size_t lSphereDiff = 0;
+   for ( size_t i = 0; i < lNumVolumes; ++i )
+      lSphereDiff += lVisible[i] != lVisibleD[i] ? 1 : 0;
+
+   // The box centers are the sphere centers
+   START( cullBoxes );
+   for ( unsigned int i = 0; i < lRounds; ++i )
+      lFrustum.testBoxes( lSpheres.data(), lExtents.data(), lNumVolumes, lVisible.data() );
+   uint64_t lCullBoxes = STOP( cullBoxes );
+
+   START( cullBoxesD );
+   for ( unsigned int i = 0; i < lRounds; ++i )
+      lFrustumD.testBoxes( lSpheresD.data(), lExtentsD.data(), lNumVolumes, lVisibleD.data() );
+   uint64_t lCullBoxesD = STOP( cullBoxesD );
+
+   size_t lBoxDiff = 0;
+   for ( size_t i = 0; i < lNumVolumes; ++i )
+      lBoxDiff += lVisible[i] != lVisibleD[i] ? 1 : 0;
+
+   iLOG( "  - Frustum culling: ",
+         lNumVolumes,
+         " volumes (",
+         lNumVisible,
+         " spheres visible), ",
+         lRounds,
+         " frames (double -> float)" );
+   iLOG( "  = spheres: ", lCullSpheresD, " -> ", lCullSpheres, " (different: ", lSphereDiff, ")" );
+   iLOG( "  = boxes:   ", lCullBoxesD, " -> ", lCullBoxes, " (different: ", lBoxDiff, ")" );
+}
+
 // kate: indent-mode cstyle; indent-width 3; replace-tabs on; line-numbers on;
@@ -77,8 +77,17 @@ class BenchClass : public BenchBaseVirtual {
 
    unsigned int vLoopsToDoCast;
 
+   std::string vOBJFile_str;
+   unsigned int vReindexCorners;
+   unsigned int vFormatCorners;
+   unsigned int vMatrixLoops;
+
    void doFunction();
    void doMutex();
+   void doOBJ();
+   void doReindex();
+   void doFormats();
+   void doMatrix();
 
  public:
    BenchClass() = delete;
@@ -59,6 +59,17 @@ cmdANDinit::cmdANDinit( int argc, char *argv[], bool _color ) {
 
    vDoMutex = false;
    vMutexLoops = 10000000;
+
+   vDoOBJ = false;
+
+   vDoReindex = false;
+   vReindexCorners = 10000000;
+
+   vDoFormats = false;
+   vFormatCorners = 6000000;
+
+   vDoMatrix = false;
+   vMatrixLoops = 10000000;
 }
 
 
@@ -77,7 +88,11 @@ void cmdANDinit::usage() {
    iLOG( "MODES:"
          "\nall            : do all benchmarks"
          "\nfunc           : do the functions benchmark"
-         "\nmutex          : do the mutex benchmark" );
+         "\nmutex          : do the mutex benchmark"
+         "\nobj            : do the OBJ loader benchmark (needs --objFile)"
+         "\nreindex        : do the mesh reindex benchmark"
+         "\nformats        : compare the OBJ, PLY and STL loaders on the same mesh (+ broken files)"
+         "\nmatrix         : compare the scalar and SIMD 4x4 float matrix kernels" );
    iLOG( "" );
    iLOG( "BENCHMARK OPTIONS:" );
    dLOG( "    --funcLoops=<loops>  : ammount of loops to do in function benchmark (default: ",
@@ -86,6 +101,16 @@ void cmdANDinit::usage() {
    dLOG( "    --mutexLoops=<loops> : ammount of loops to do in mutex benchmark    (default: ",
          vMutexLoops,
          ")" );
+   dLOG( "    --objFile=<path>     : the OBJ file to load in the OBJ loader benchmark" );
+   dLOG( "    --reindexCorners=<n> : number of face corners in the reindex benchmark (default: ",
+         vReindexCorners,
+         ")" );
+   dLOG( "    --formatCorners=<n>  : number of face corners in the formats benchmark (default: ",
+         vFormatCorners,
+         ")" );
+   dLOG( "    --matrixLoops=<n>    : ammount of loops to do in matrix benchmark   (default: ",
+         vMatrixLoops,
+         ")" );
    wLOG( "You MUST define one ore more modes\n\n" );
 }
 
@@ -125,6 +150,10 @@ bool cmdANDinit::parseArgsAndInit() {
       if ( arg == "all" ) {
          vDoFunction = true;
          vDoMutex = true;
+         vDoOBJ = true;
+         vDoReindex = true;
+         vDoFormats = true;
+         vDoMatrix = true;
          continue;
       }
 
@@ -138,6 +167,26 @@ bool cmdANDinit::parseArgsAndInit() {
          continue;
       }
 
+      if ( arg == "obj" ) {
+         vDoOBJ = true;
+         continue;
+      }
+
+      if ( arg == "reindex" ) {
+         vDoReindex = true;
+         continue;
+      }
+
+      if ( arg == "formats" ) {
+         vDoFormats = true;
+         continue;
+      }
+
+      if ( arg == "matrix" ) {
+         vDoMatrix = true;
+         continue;
+      }
+
 
 
       std::regex lFuncRegex( "^\\-\\-funcLoops=[0-9 ]*$" );
@@ -158,10 +207,51 @@ bool cmdANDinit::parseArgsAndInit() {
          continue;
       }
 
+      std::regex lOBJRegex( "^\\-\\-objFile=.+$" );
+      if ( std::regex_match( arg, lOBJRegex ) ) {
+         std::regex lOBJRegexRep( "^\\-\\-objFile=" );
+         const char *lRep = "";
+         vOBJFile_str = std::regex_replace( arg, lOBJRegexRep, lRep );
+         continue;
+      }
+
+      std::regex lReindexRegex( "^\\-\\-reindexCorners=[0-9 ]*$" );
+      if ( std::regex_match( arg, lReindexRegex ) ) {
+         std::regex lReindexRegexRep( "^\\-\\-reindexCorners=" );
+         const char *lRep = "";
+         string reindexString = std::regex_replace( arg, lReindexRegexRep, lRep );
+         vReindexCorners = static_cast<unsigned>( atoi( reindexString.c_str() ) );
+         continue;
+      }
+
+      std::regex lFormatRegex( "^\\-\\-formatCorners=[0-9 ]*$" );
+      if ( std::regex_match( arg, lFormatRegex ) ) {
+         std::regex lFormatRegexRep( "^\\-\\-formatCorners=" );
+         const char *lRep = "";
+         string formatString = std::regex_replace( arg, lFormatRegexRep, lRep );
+         vFormatCorners = static_cast<unsigned>( atoi( formatString.c_str() ) );
+         continue;
+      }
+
+      std::regex lMatrixRegex( "^\\-\\-matrixLoops=[0-9 ]*$" );
+      if ( std::regex_match( arg, lMatrixRegex ) ) {
+         std::regex lMatrixRegexRep( "^\\-\\-matrixLoops=" );
+         const char *lRep = "";
+         string matrixString = std::regex_replace( arg, lMatrixRegexRep, lRep );
+         vMatrixLoops = static_cast<unsigned>( atoi( matrixString.c_str() ) );
+         continue;
+      }
+
       eLOG( "Unkonwn option '", arg, "'" );
    }
 
-   if ( vDoFunction == false && vDoMutex == false ) {
+   if ( vDoOBJ && vOBJFile_str.empty() ) {
+      wLOG( "No OBJ file set (--objFile=<path>) ==> skipping the OBJ loader benchmark" );
+      vDoOBJ = false;
+   }
+
+   if ( vDoFunction == false && vDoMutex == false && vDoOBJ == false && vDoReindex == false &&
+        vDoFormats == false && vDoMatrix == false ) {
       postInit();
       usage();
       return false;
@@ -34,6 +34,18 @@ class cmdANDinit {
    bool vDoMutex;
    unsigned int vMutexLoops;
 
+   bool vDoOBJ;
+   std::string vOBJFile_str;
+
+   bool vDoReindex;
+   unsigned int vReindexCorners;
+
+   bool vDoFormats;
+   unsigned int vFormatCorners;
+
+   bool vDoMatrix;
+   unsigned int vMatrixLoops;
+
    cmdANDinit() {}
 
    void postInit();
@@ -53,6 +65,22 @@ class cmdANDinit {
       _loops = vMutexLoops;
       _doIt = vDoMutex;
    }
+   void getOBJInf( std::string &_file, bool &_doIt ) {
+      _file = vOBJFile_str;
+      _doIt = vDoOBJ;
+   }
+   void getReindexInf( unsigned int &_corners, bool &_doIt ) {
+      _corners = vReindexCorners;
+      _doIt = vDoReindex;
+   }
+   void getFormatsInf( unsigned int &_corners, bool &_doIt ) {
+      _corners = vFormatCorners;
+      _doIt = vDoFormats;
+   }
+   void getMatrixInf( unsigned int &_loops, bool &_doIt ) {
+      _loops = vMatrixLoops;
+      _doIt = vDoMatrix;
+   }
 };
 
 #endif // CMDANDINIT_H
@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2015 EEnginE project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Compile time tests of the constexpr rMatrix / rMatrixMath functions. Nothing here is executed:
+ * if this file compiles, the matrices were built by the compiler.
+ */
+
+#include <engine.hpp>
+
+using namespace e_engine;
+
+namespace {
+
+constexpr rMat4f translation() {
+   rMat4f lOut( 0.0f );
+   rMatrixMath::translate( rVec3f( 1.0f, 2.0f, 3.0f ), lOut );
+   return lOut;
+}
+
+constexpr rMat4d scaleTranslate() {
+   rMat4d lScale( 0.0 );
+   rMat4d lTranslate( 0.0 );
+   rMatrixMath::scale( rVec3d( 2.0, 4.0, 8.0 ), lScale );
+   rMatrixMath::translate( rVec3d( 1.0, -1.0, 0.5 ), lTranslate );
+   return lTranslate * lScale;
+}
+
+constexpr rMat4f rotationZ90() {
+   // Quaternion of 90 degrees around z (sqrt(0.5) is exact enough in float for the asserts)
+   rMat4f lOut( 0.0f );
+   rMatrixMath::rotate( rVec4f( 0.0f, 0.0f, 0.70710678f, 0.70710678f ), lOut );
+   return lOut;
+}
+
+constexpr rMat4d rotationX90() {
+   rMat4d lOut( 0.0 );
+   rQuatd( 0.70710678118654752, 0.0, 0.0, 0.70710678118654752 ).toMatrix( lOut );
+   return lOut;
+}
+
+constexpr rMat4f projection() {
+   rMat4f lOut( 0.0f );
+   rMatrixMath::perspectiveFocal( 2.0f, 1.0f, 3.0f, 1.0f, lOut );
+   return lOut;
+}
+
+constexpr rMat3d normalMatrix() {
+   rMat4d lIn = scaleTranslate();
+   rMat3d lOut( 0.0 );
+   rMatrixMath::getNormalMatrix( lIn, lOut );
+   return lOut;
+}
+
+constexpr rMat3d uniformNormalMatrix() {
+   rMat4d lIn( 0.0 );
+   rMat3d lOut( 0.0 );
+   rMatrixMath::scale( rVec3d( 4.0, 4.0, 4.0 ), lIn );
+   rMatrixMath::getNormalMatrix( lIn, lOut, rMatrixMath::TRANSFORM_UNIFORM_SCALE );
+   return lOut;
+}
+
+constexpr rMat3d identity3() {
+   rMat3d lOut( 0.0 );
+   lOut.toIdentityMatrix();
+   return lOut;
+}
+
+constexpr rMat4f lTranslation = translation();
+constexpr rMat4d lScaleTranslate = scaleTranslate();
+constexpr rMat4f lRotationZ90 = rotationZ90();
+constexpr rMat4d lRotationX90 = rotationX90();
+constexpr rMat4f lProjection = projection();
+constexpr rMat3d lNormal = normalMatrix();
+constexpr rMat3d lUniformNormal = uniformNormalMatrix();
+constexpr rMat3d lIdentity = identity3();
+
+constexpr rVec3d lA( 1.0, 2.0, 3.0 );
+constexpr rVec3d lB( 4.0, 5.0, 6.0 );
+constexpr rVec3d lCross = rVectorMath::crossProduct( lA, lB );
+constexpr rVec3d lSum = lA + lB * 2.0 - lA;
+
+constexpr rQuatd lQuarterZ( 0.0, 0.0, 0.70710678118654752, 0.70710678118654752 );
+constexpr rQuatd lHalfZ = lQuarterZ * lQuarterZ;
+constexpr rVec3d lTurned = lQuarterZ.rotate( rVec3d( 1.0, 0.0, 0.0 ) );
+
+constexpr bool near( double _a, double _b ) { return _a - _b < 1e-6 && _b - _a < 1e-6; }
+
+// Constructors, fill and setMat (row-major arguments, column-major storage)
+static_assert( rVec4f( 2.0f )[0] == 2.0f && rVec4f( 2.0f )[3] == 2.0f, "fill constructor" );
+static_assert( rMatrix<int, 2, 2>( 1, 2, 3, 4 ).get( 1, 0 ) == 2, "element constructor" );
+static_assert( rMatrix<int, 2, 2>( 1, 2, 3, 4 ).get<0, 1>() == 3, "element constructor" );
+
+// rMatrixMath
+static_assert( lTranslation.get<3, 0>() == 1.0f && lTranslation.get<3, 2>() == 3.0f, "translate" );
+static_assert( lTranslation.get<0, 0>() == 1.0f && lTranslation.get<3, 3>() == 1.0f, "translate" );
+static_assert( lScaleTranslate.get<0, 0>() == 2.0 && lScaleTranslate.get<2, 2>() == 8.0, "scale" );
+static_assert( lScaleTranslate.get<3, 1>() == -1.0, "product of scale and translation" );
+static_assert( near( lRotationZ90.get<0, 1>(), 1.0 ) && near( lRotationZ90.get<1, 0>(), -1.0 ),
+               "rotate (quaternion)" );
+static_assert( near( lRotationZ90.get<0, 0>(), 0.0 ) && lRotationZ90.get<2, 2>() == 1.0f,
+               "rotate (quaternion)" );
+static_assert( near( lRotationX90.get<1, 2>(), 1.0 ) && near( lRotationX90.get<2, 1>(), -1.0 ),
+               "rotate (quaternion)" );
+static_assert( lProjection.get<0, 0>() == 0.5f && lProjection.get<2, 2>() == -2.0f, "perspective" );
+static_assert( lProjection.get<3, 2>() == -3.0f && lProjection.get<2, 3>() == -1.0f, "perspective" );
+static_assert( near( lNormal.get<0, 0>(), 0.5 ) && near( lNormal.get<2, 2>(), 0.125 ), "normal" );
+static_assert( lNormal.get<1, 0>() == 0.0, "normal matrix" );
+static_assert( lUniformNormal.get<0, 0>() == 0.25 && lUniformNormal.get<1, 0>() == 0.0,
+               "normal matrix (uniform scale)" );
+static_assert( rMatrixMath::getTransformClass( rVec3f( 1.0f, 1.0f, 1.0f ) ) ==
+                     rMatrixMath::TRANSFORM_RIGID,
+               "transform class" );
+static_assert( rMatrixMath::getTransformClass( rVec3f( 2.0f, 2.0f, 2.0f ) ) ==
+                     rMatrixMath::TRANSFORM_UNIFORM_SCALE,
+               "transform class" );
+static_assert( rMatrixMath::getTransformClass( rVec3f( 2.0f, 1.0f, 2.0f ) ) ==
+                     rMatrixMath::TRANSFORM_GENERAL,
+               "transform class" );
+static_assert( lIdentity.get<1, 1>() == 1.0 && lIdentity.get<2, 1>() == 0.0, "identity" );
+
+// rVectorMath and the expression templates
+static_assert( lCross[0] == -3.0 && lCross[1] == 6.0 && lCross[2] == -3.0, "cross product" );
+static_assert( rVectorMath::dotProduct( lA, lB ) == 32.0, "dot product" );
+static_assert( lSum[0] == 8.0 && lSum[2] == 12.0, "lazy sum / difference / scalar product" );
+
+// rQuat
+static_assert( near( lHalfZ[2], 1.0 ) && near( lHalfZ[3], 0.0 ), "quaternion product" );
+static_assert( near( lTurned[0], 0.0 ) && near( lTurned[1], 1.0 ), "quaternion rotate" );
+static_assert( lQuarterZ.conjugate()[2] == -lQuarterZ[2], "quaternion conjugate" );
+static_assert( near( lQuarterZ.dot( lQuarterZ ), 1.0 ), "quaternion dot" );
+}
+
+// kate: indent-mode cstyle; indent-width 3; replace-tabs on; line-numbers on;
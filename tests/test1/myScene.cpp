@@ -20,11 +20,14 @@
 using namespace e_engine;
 
 int myScene::init() {
+   vObject1.setTransformSystem( &vTransforms );
+   vLight1.setTransformSystem( &vTransforms );
+   vLight2.setTransformSystem( &vTransforms );
+
    updateCamera();
 
-   vObject1.loadData();
-   vObject1.setOGLData();
-   vObject1.setPosition( rVec3f( 0, 0, -5 ) );
+   // Load the mesh while the shaders are compiled
+   vObject1.loadDataAsync();
 
    vLight1.setPosition( rVec3f( 1, 1, -4 ) );
    vLight2.setPosition( rVec3f( -1, -1, -4 ) );
@@ -36,13 +39,6 @@ int myScene::init() {
    vLight1.setAttenuation( 0.1f, 0.01f, 0.1f );
    vLight2.setAttenuation( 0.1f, 0.02f, 0.2f );
 
-   uint64_t lLight;
-   vObject1.getHints( rObjectBase::LIGHT_MODEL, lLight );
-   if ( lLight != rObjectBase::SIMPLE_ADS_LIGHT ) {
-      wLOG( "Light not supported! Normals missing!" );
-      vRenderNormals = false;
-   }
-
    GLint lShaderID = addShader( vShader_str ), lNormalShader = -1;
 
    if ( vRenderNormals )
@@ -55,6 +51,16 @@ int myScene::init() {
 
    parseShaders();
 
+   vObject1.setOGLData();
+   vObject1.setPosition( rVec3f( 0, 0, -5 ) );
+
+   uint64_t lLight;
+   vObject1.getHints( rObjectBase::LIGHT_MODEL, lLight );
+   if ( lLight != rObjectBase::SIMPLE_ADS_LIGHT ) {
+      wLOG( "Light not supported! Normals missing!" );
+      vRenderNormals = false;
+   }
+
    addObject( &vLight1, -1 );
    addObject( &vLight2, -1 );
    addObject( &vLight3, -1 );
@@ -101,22 +107,13 @@ void myScene::keySlot( const iEventInfo &_inf ) {
 
    switch ( _inf.eKey.key ) {
       case L'z':
-         vRotationAngle += 0.25;
-         vObject1.setRotation( rVec3f( 0, 1, 0 ), vRotationAngle );
+         vObject1.addRotationDelta( vRotationStep );
          break;
       case L't':
-         vRotationAngle -= 0.25;
-         vObject1.setRotation( rVec3f( 0, 1, 0 ), vRotationAngle );
+         vObject1.addRotationDelta( vRotationStep.conjugate() );
          break;
    }
 }
 
 
-void myScene::afterCameraUpdate() {
-   vObject1.updateFinalMatrix();
-   vLight1.updateFinalMatrix();
-   vLight2.updateFinalMatrix();
-}
-
-
 // kate: indent-mode cstyle; indent-width 3; replace-tabs on; line-numbers on;
@@ -25,6 +25,7 @@
 
 using e_engine::rScene;
 using e_engine::rCameraHandler;
+using e_engine::rTransformSystem;
 using e_engine::rSimpleMesh;
 using e_engine::rPointLight;
 using e_engine::rDirectionalLight;
@@ -36,6 +37,8 @@ class myScene final : public rScene<float>, public rCameraHandler<float> {
    typedef uSlot<void, myScene, iEventInfo const &> _SLOT_;
 
  private:
+   rTransformSystem<float> vTransforms; // Must be destroyed after the objects
+
    rSimpleMesh vObject1;
 
    rPointLight<float> vLight1;
@@ -46,7 +49,7 @@ class myScene final : public rScene<float>, public rCameraHandler<float> {
    std::string vNormalShader_str;
 
    _SLOT_ vKeySlot;
-   float vRotationAngle;
+   e_engine::rQuatf vRotationStep; //!< Rotation of one key press
    bool vRenderNormals;
 
  public:
@@ -55,6 +58,7 @@ class myScene final : public rScene<float>, public rCameraHandler<float> {
    myScene( iInit *_init, cmdANDinit &_cmd )
        : rScene( "MAIN SCENE" ),
          rCameraHandler( this, _init ),
+         vTransforms( this, 16 ),
          vObject1( this, "OBJ 1", _cmd.getMesh() ),
          vLight1( this, "L1" ),
          vLight2( this, "L2" ),
@@ -62,7 +66,7 @@ class myScene final : public rScene<float>, public rCameraHandler<float> {
          vShader_str( _cmd.getShader() ),
          vNormalShader_str( _cmd.getNormalShader() ),
          vKeySlot( &myScene::keySlot, this ),
-         vRotationAngle( 0 ),
+         vRotationStep( e_engine::rQuatf::fromAxisAngle( e_engine::rVec3f( 0, 1, 0 ), 0.25f ) ),
          vRenderNormals( _cmd.getRenderNormals() ) {
       _init->addKeySlot( &vKeySlot );
    }
@@ -71,7 +75,6 @@ class myScene final : public rScene<float>, public rCameraHandler<float> {
 
    void keySlot( iEventInfo const &_inf );
 
-   virtual void afterCameraUpdate();
 };
 
 #endif
@@ -0,0 +1,213 @@
+/*!
+ * \file uMemoryMappedFile.cpp
+ * \brief \b Classes: \a uMemoryMappedFile
+ */
+/*
+ * Copyright (C) 2015 EEnginE project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "uMemoryMappedFile.hpp"
+#include "uLog.hpp"
+#include <boost/filesystem.hpp>
+
+#if UNIX
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#if WINDOWS
+#include <windows.h>
+#endif
+
+namespace e_engine {
+
+uMemoryMappedFile::uMemoryMappedFile() : vData( nullptr ), vSize( 0 ), vFileMapped_B( false ) {
+#if WINDOWS
+   vFileHandle = nullptr;
+   vMappingHandle = nullptr;
+#endif
+}
+
+uMemoryMappedFile::uMemoryMappedFile( std::string _file )
+    : vFilePath_str( _file ), vData( nullptr ), vSize( 0 ), vFileMapped_B( false ) {
+#if WINDOWS
+   vFileHandle = nullptr;
+   vMappingHandle = nullptr;
+#endif
+}
+
+/*!
+ * \brief Sets the file to map
+ * \note The file will be unmapped if it is currently mapped
+ */
+void uMemoryMappedFile::setFilePath( std::string _file ) {
+   unmap();
+   vFilePath_str = _file;
+}
+
+/*!
+ * \brief Maps the file into memory (read only)
+ *
+ * \returns 1 if everything went fine
+ * \returns 2 if the file is already mapped
+ * \returns 3 if the file doesn't exists
+ * \returns 4 if the file is not a regular file
+ * \returns 5 if the file is not readable / mappable
+ *
+ * \note The return values are the same as uFileIO::read()
+ */
+int uMemoryMappedFile::map() {
+   if ( vFileMapped_B )
+      return 2;
+
+   boost::filesystem::path lFilePath_BFS( vFilePath_str.c_str() );
+
+   if ( !boost::filesystem::exists( lFilePath_BFS ) ) {
+      eLOG( "File ", vFilePath_str, " does not exists" );
+      return 3;
+   }
+
+   if ( !boost::filesystem::is_regular_file( lFilePath_BFS ) ) {
+      eLOG( vFilePath_str, " is not a file!" );
+      return 4;
+   }
+
+#if UNIX
+   int lFD = open( vFilePath_str.c_str(), O_RDONLY );
+   if ( lFD < 0 ) {
+      eLOG( "Unable to open ", vFilePath_str );
+      return 5;
+   }
+
+   struct stat lStat;
+   if ( fstat( lFD, &lStat ) != 0 ) {
+      eLOG( "Unable to stat ", vFilePath_str );
+      close( lFD );
+      return 5;
+   }
+
+   vSize = static_cast<size_t>( lStat.st_size );
+
+   // mmap does not support empty mappings
+   if ( vSize == 0 ) {
+      close( lFD );
+      vData = nullptr;
+      vFileMapped_B = true;
+      return 1;
+   }
+
+   void *lMap = mmap( nullptr, vSize, PROT_READ, MAP_PRIVATE, lFD, 0 );
+   close( lFD ); // The mapping keeps its own reference to the file
+
+   if ( lMap == MAP_FAILED ) {
+      eLOG( "Unable to map ", vFilePath_str );
+      vSize = 0;
+      return 5;
+   }
+
+   // We are (almost) always parsing from the front to the back
+   madvise( lMap, vSize, MADV_SEQUENTIAL );
+
+   vData = static_cast<char const *>( lMap );
+#elif WINDOWS
+   HANDLE lFile = CreateFileA( vFilePath_str.c_str(),
+                               GENERIC_READ,
+                               FILE_SHARE_READ,
+                               nullptr,
+                               OPEN_EXISTING,
+                               FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                               nullptr );
+
+   if ( lFile == INVALID_HANDLE_VALUE ) {
+      eLOG( "Unable to open ", vFilePath_str );
+      return 5;
+   }
+
+   LARGE_INTEGER lSize;
+   if ( !GetFileSizeEx( lFile, &lSize ) ) {
+      eLOG( "Unable to get the size of ", vFilePath_str );
+      CloseHandle( lFile );
+      return 5;
+   }
+
+   vSize = static_cast<size_t>( lSize.QuadPart );
+
+   // CreateFileMapping does not support empty mappings
+   if ( vSize == 0 ) {
+      CloseHandle( lFile );
+      vData = nullptr;
+      vFileMapped_B = true;
+      return 1;
+   }
+
+   HANDLE lMapping = CreateFileMappingA( lFile, nullptr, PAGE_READONLY, 0, 0, nullptr );
+   if ( lMapping == nullptr ) {
+      eLOG( "Unable to map ", vFilePath_str );
+      CloseHandle( lFile );
+      vSize = 0;
+      return 5;
+   }
+
+   void *lMap = MapViewOfFile( lMapping, FILE_MAP_READ, 0, 0, 0 );
+   if ( lMap == nullptr ) {
+      eLOG( "Unable to map ", vFilePath_str );
+      CloseHandle( lMapping );
+      CloseHandle( lFile );
+      vSize = 0;
+      return 5;
+   }
+
+   vFileHandle = lFile;
+   vMappingHandle = lMapping;
+   vData = static_cast<char const *>( lMap );
+#endif
+
+   vFileMapped_B = true;
+   return 1;
+}
+
+/*!
+ * \brief Removes the mapping
+ * \warning All iterators become invalid
+ */
+void uMemoryMappedFile::unmap() {
+   if ( !vFileMapped_B )
+      return;
+
+#if UNIX
+   if ( vData )
+      munmap( const_cast<char *>( vData ), vSize );
+#elif WINDOWS
+   if ( vData )
+      UnmapViewOfFile( vData );
+
+   if ( vMappingHandle )
+      CloseHandle( static_cast<HANDLE>( vMappingHandle ) );
+
+   if ( vFileHandle )
+      CloseHandle( static_cast<HANDLE>( vFileHandle ) );
+
+   vFileHandle = nullptr;
+   vMappingHandle = nullptr;
+#endif
+
+   vData = nullptr;
+   vSize = 0;
+   vFileMapped_B = false;
+}
+}
+// kate: indent-mode cstyle; indent-width 3; replace-tabs on; line-numbers on;
@@ -0,0 +1,83 @@
+/*!
+ * \file uMemoryMappedFile.hpp
+ * \brief \b Classes: \a uMemoryMappedFile
+ */
+/*
+ * Copyright (C) 2015 EEnginE project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef U_MEMORY_MAPPED_FILE_HPP
+#define U_MEMORY_MAPPED_FILE_HPP
+
+#include "defines.hpp"
+
+#include <string>
+#include <stddef.h>
+
+namespace e_engine {
+
+/*!
+ * \brief Read only memory mapping of a whole file
+ *
+ * Unlike uFileIO the content is NOT copied into RAM. The OS pages the file in on demand, so
+ * the range begin() - end() can be parsed in place.
+ *
+ * \note The mapped range is NOT null terminated
+ */
+class uMemoryMappedFile final {
+ public:
+   typedef char const *C_ITERATOR;
+
+ private:
+   std::string vFilePath_str;
+
+   char const *vData;
+   size_t vSize;
+   bool vFileMapped_B;
+
+#if WINDOWS
+   void *vFileHandle;
+   void *vMappingHandle;
+#endif
+
+ public:
+   uMemoryMappedFile();
+   uMemoryMappedFile( std::string _file );
+
+   // Forbid copying
+   uMemoryMappedFile( const uMemoryMappedFile & ) = delete;
+   uMemoryMappedFile &operator=( const uMemoryMappedFile & ) = delete;
+
+   ~uMemoryMappedFile() { unmap(); }
+
+   void setFilePath( std::string _file );
+   std::string getFilePath() const { return vFilePath_str; }
+
+   C_ITERATOR begin() const { return vData; }
+   C_ITERATOR end() const { return vData + vSize; }
+
+   size_t size() const { return vSize; }
+   bool isFileMapped() const { return vFileMapped_B; }
+
+   int map();
+   void unmap();
+
+   int operator()() { return map(); }
+};
+}
+
+#endif // U_MEMORY_MAPPED_FILE_HPP
+
+// kate: indent-mode cstyle; indent-width 3; replace-tabs on; line-numbers on;
@@ -71,6 +71,7 @@ bool uParserJSON::continueWhitespace() {
          case '\n':
             ++vCurrentLine;
             FALLTHROUGH
+         case '\r':
          case '\t':
          case ' ':
             ++vIter;
@@ -274,16 +275,22 @@ bool uParserJSON::parseValue( e_engine::uJSON_data &_currentObject, const std::s
                case '7':
                case '8':
                case '9':
+               case 'e':
+               case 'E':
+               case '+':
+               case '-':
                   lNum += *vIter;
                   ++vIter;
                   break;
 
                case '\n':
-                  ++vCurrentLine;
-                  FALLTHROUGH
+               case '\r':
                case '\t':
                case ' ':
                case ',':
+               case ']':
+               case '}':
+                  // Not consumed; the caller needs the char (and counts the lines)
                   lFound = true;
                   break;
 
@@ -321,12 +328,20 @@ bool uParserJSON::parseArray( uJSON_data &_currentObject ) {
       return false;
    }
 
-   if ( *vIter == ']' )
+   // Empty array
+   if ( *vIter == ']' ) {
+      ++vIter;
       return true;
+   }
 
    if ( !parseValue( _currentObject, "" ) )
       return false;
 
+   if ( !continueWhitespace() ) {
+      eLOG( "Failed parsing file '", vFilePath_str, "': unexpected end of file" );
+      return false;
+   }
+
    while ( *vIter == ',' ) {
       ++vIter;
       if ( !continueWhitespace() ) {
@@ -363,8 +378,10 @@ bool uParserJSON::parseObject( uJSON_data &lCurrentObject ) {
       return false;
 
    // Empty object
-   if ( *vIter == '}' )
+   if ( *vIter == '}' ) {
+      ++vIter;
       return true;
+   }
 
    while ( true ) {
       if ( !continueWhitespace() )
@@ -377,7 +394,7 @@ bool uParserJSON::parseObject( uJSON_data &lCurrentObject ) {
                *vIter,
                "' Line ",
                vCurrentLine );
-         return true;
+         return false;
       }
 
       std::string lName;
@@ -430,7 +447,9 @@ bool uParserJSON::parseObject( uJSON_data &lCurrentObject ) {
             break;
       }
 
-      continueWhitespace();
+      if ( !continueWhitespace() )
+         break;
+
       if ( *vIter != ':' ) {
          eLOG( "Failed parsing file '",
                vFilePath_str,
@@ -442,11 +461,15 @@ bool uParserJSON::parseObject( uJSON_data &lCurrentObject ) {
       }
 
       ++vIter;
-      continueWhitespace();
+      if ( !continueWhitespace() )
+         break;
 
-      parseValue( lCurrentObject, lName );
+      if ( !parseValue( lCurrentObject, lName ) )
+         return false;
+
+      if ( !continueWhitespace() )
+         break;
 
-      continueWhitespace();
       switch ( *vIter ) {
          case '}':
             ++vIter;
@@ -491,6 +514,28 @@ int uParserJSON::parse() {
    vIter = lFile.begin();
    vEnd = lFile.end();
 
+   return parseData();
+}
+
+/*!
+ * \brief parses JSON data which is already in memory (for instance a chunk of a binary file)
+ * \param[in] _json The JSON data (the file path is only used for error messages)
+ * \returns 1 on success
+ * \returns 2 if there was a parsing error
+ * \returns 6 if already parsed
+ */
+int uParserJSON::parseString( std::string const &_json ) {
+   if ( vIsParsed )
+      return 6;
+
+   vIter = _json.begin();
+   vEnd = _json.end();
+
+   return parseData();
+}
+
+int uParserJSON::parseData() {
+   vCurrentLine = 1;
    bool lHasPrimaryObject = false;
 
    while ( vIter != vEnd ) {
@@ -502,6 +547,7 @@ int uParserJSON::parse() {
             ++vIter;
             ++vCurrentLine;
             break;
+         case '\r':
          case '\t':
             ++vIter;
             break;
@@ -522,6 +568,7 @@ int uParserJSON::parse() {
             if ( !parseObject( vData ) )
                return 2;
 
+            lHasPrimaryObject = true;
             break;
          default:
             eLOG( "Failed parsing file '",
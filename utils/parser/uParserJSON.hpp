@@ -48,6 +48,7 @@ class uParserJSON final {
    bool parseObject( e_engine::uJSON_data &lCurrentObject );
    bool parseArray( e_engine::uJSON_data &_currentObject );
    bool parseValue( e_engine::uJSON_data &_currentObject, const std::string &_name );
+   int parseData();
 
  public:
    ~uParserJSON() {}
@@ -57,6 +58,7 @@ class uParserJSON final {
 
    void setFile( std::string _file );
    int parse();
+   int parseString( std::string const &_json );
    void clear();
 
    int write( uJSON_data const &_data, bool _overwriteIfNeeded = false );
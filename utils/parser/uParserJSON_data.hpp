@@ -71,8 +71,8 @@ namespace e_engine {
 struct uJSON_data {
    std::string id;
    std::string value_str;
-   double value_num;
-   bool value_bool;
+   double value_num = 0.0;
+   bool value_bool = false;
    VALUES value_obj;
 
    JSON_DATA_TYPE type;
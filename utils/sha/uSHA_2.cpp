@@ -20,6 +20,7 @@
 
 #include "uSHA_2.hpp"
 #include <stdio.h>
+#include <string.h>
 
 namespace e_engine {
 
@@ -124,6 +125,55 @@ bool uSHA_2::add( std::vector<unsigned char> const &_binary ) {
 }
 
 
+/*!
+ * \brief Fills the data in a buffer and calculates the hash when it's full
+ *
+ * Copies whole chunks instead of single bytes, so this is the fastest way to hash big buffers
+ * (e.g. a memory mapped file)
+ *
+ * \param _data What should be hashed
+ * \param _size Size of _data in bytes
+ * \returns false if the hash is already calculated or true if all went fine
+ */
+bool uSHA_2::add( unsigned char const *_data, size_t _size ) {
+   if ( vEnded_B )
+      return false;
+
+   while ( _size > 0 ) {
+      size_t lFree;
+
+      if ( vType == SHA2_224 || vType == SHA2_256 ) {
+         if ( vCurrentPos512_A_IT == vBuffer512_A_uC.end() ) {
+            block( vBuffer512_A_uC );
+            vCurrentPos512_A_IT = vBuffer512_A_uC.begin();
+         }
+
+         lFree = static_cast<size_t>( vBuffer512_A_uC.end() - vCurrentPos512_A_IT );
+         lFree = lFree < _size ? lFree : _size;
+
+         memcpy( &*vCurrentPos512_A_IT, _data, lFree );
+         vCurrentPos512_A_IT += static_cast<ptrdiff_t>( lFree );
+      } else {
+         if ( vCurrentPos1024_A_IT == vBuffer1024_A_uC.end() ) {
+            block( vBuffer1024_A_uC );
+            vCurrentPos1024_A_IT = vBuffer1024_A_uC.begin();
+         }
+
+         lFree = static_cast<size_t>( vBuffer1024_A_uC.end() - vCurrentPos1024_A_IT );
+         lFree = lFree < _size ? lFree : _size;
+
+         memcpy( &*vCurrentPos1024_A_IT, _data, lFree );
+         vCurrentPos1024_A_IT += static_cast<ptrdiff_t>( lFree );
+      }
+
+      _data += lFree;
+      _size -= lFree;
+   }
+
+   return true;
+}
+
+
 std::vector<unsigned char> uSHA_2::quickHash( HASH_FUNCTION _type, std::string _message ) {
    reset( _type );
    add( _message );
@@ -27,6 +27,7 @@
 #include <array>
 #include <vector>
 #include <stdint.h>
+#include <stddef.h>
 
 namespace e_engine {
 
@@ -70,6 +71,7 @@ class uSHA_2 {
 
    bool add( std::string const &_message );
    bool add( std::vector<unsigned char> const &_binary );
+   bool add( unsigned char const *_data, size_t _size );
 
    void block( std::array<unsigned char, 64> const &_data );
    void block( std::array<unsigned char, 128> const &_data );
@@ -57,6 +57,8 @@ _uConfig::__uConfig_OpenGL::__uConfig_OpenGL() { reset(); }
 
 _uConfig::__uConfig_Camera::__uConfig_Camera() { reset(); }
 
+_uConfig::__uConfig_Loader::__uConfig_Loader() { reset(); }
+
 
 
 
@@ -190,6 +192,20 @@ void _uConfig::__uConfig_Camera::reset() {
    angleVertical = 0;
 }
 
+void _uConfig::__uConfig_Loader::reset() {
+   useMeshCache = true;
+   meshCacheSubFolder = "meshCache";
+   optimizeMeshes = true;
+   generateNormals = true;
+   angleWeightedNormals = true;
+   interleaveMeshes = true;
+   quantizeAttributes = false;
+   numLoaderThreads = 0;
+   numLODs = 3;
+   lodReduction = 0.5f;
+   shareMeshes = true;
+}
+
 
 
 _uConfig::_uConfig() {
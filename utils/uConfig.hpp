@@ -345,6 +345,34 @@ struct _uConfig {
       void reset();
    } camera;
 
+   //   _                     _
+   //  | |                   | |
+   //  | |     ___   __ _  __| | ___ _ __
+   //  | |    / _ \ / _` |/ _` |/ _ \ '__|
+   //  | |___| (_) | (_| | (_| |  __/ |
+   //  \_____/\___/ \__,_|\__,_|\___|_|
+   //
+
+   struct __uConfig_Loader {
+      bool useMeshCache;              //!< Cache reindexed meshes on disk \c CLASSES: \a rObjectBase
+      std::string meshCacheSubFolder; //!< Mesh cache sub dir in the main config dir
+      bool optimizeMeshes;            //!< Optimize meshes after loading \c CLASSES: \a rObjectBase
+      bool generateNormals;           //!< Calculate missing normals \c CLASSES: \a rObjectBase
+      bool angleWeightedNormals;      //!< Weight generated normals by angle (else by area)
+      bool interleaveMeshes;          //!< One VBO for all attributes \c CLASSES: \a rSimpleMesh
+      bool quantizeAttributes;        //!< Packed normals, half UVs \c CLASSES: \a rSimpleMesh
+      unsigned int numLoaderThreads;  //!< Threads for loadDataAsync \c CLASSES: \a rObjectBase
+      unsigned int numLODs;           //!< Simplified LODs per mesh \c CLASSES: \a rObjectBase
+      float lodReduction;             //!< Triangles of a LOD / previous LOD
+      bool shareMeshes;               //!< Load / upload equal files once \c CLASSES: \a rObjectBase
+
+      __uConfig_Loader();
+      /*!
+       * \brief Reset to default
+       */
+      void reset();
+   } loader;
+
    uExtensions extensions;
 
    // Versions
@@ -378,6 +378,55 @@ std::string uSystem::getConfigFilePath() {
    }
    return vConfigFilePath;
 }
+
+
+/*!
+ * \brief Get the mesh cache dir
+ *
+ * Search for an existing mesh cache dir in the main config dir and
+ * if it doesn't exist, creates it.
+ * The settings from \c GlobConf.loader will be used.
+ *
+ * \returns The mesh cache dir path
+ * \sa _uConfig rLoader_3D_f_CACHE
+ */
+std::string uSystem::getMeshCachePath() {
+   if ( vMeshCachePath.empty() ) {
+      if ( GlobConf.loader.meshCacheSubFolder.empty() ) {
+         vMeshCachePath = getMainConfigDirPath();
+         return vMeshCachePath;
+      } else {
+
+#if UNIX
+         std::string temp = getMainConfigDirPath() + "/";
+#elif WINDOWS
+         std::string temp = getMainConfigDirPath() + "\\";
+#endif
+         temp += GlobConf.loader.meshCacheSubFolder;
+
+         boost::filesystem::path cachePath( temp );
+
+         try {
+            if ( boost::filesystem::exists( cachePath ) ) {
+               if ( boost::filesystem::is_directory( cachePath ) ) {
+                  vMeshCachePath = temp;
+                  return vMeshCachePath;
+               } else {
+                  boost::filesystem::remove( cachePath );
+                  boost::filesystem::create_directory( cachePath );
+                  vMeshCachePath = temp;
+                  return vMeshCachePath;
+               }
+            } else {
+               boost::filesystem::create_directory( cachePath );
+               vMeshCachePath = temp;
+               return vMeshCachePath;
+            }
+         } catch ( const boost::filesystem::filesystem_error &ex ) { eLOG( ex.what() ); }
+      }
+   }
+   return vMeshCachePath;
+}
 }
 
 
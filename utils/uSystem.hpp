@@ -43,6 +43,7 @@ class uSystem {
    std::string vMainConfigDir;
    std::string vLogFilePath;
    std::string vConfigFilePath;
+   std::string vMeshCachePath;
 
  public:
    uSystem();
@@ -69,6 +70,7 @@ class uSystem {
    std::string getMainConfigDirPath();
    std::string getLogFilePath();
    std::string getConfigFilePath();
+   std::string getMeshCachePath();
 };
 
 /*!
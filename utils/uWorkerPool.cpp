@@ -0,0 +1,73 @@
+/*!
+ * \file uWorkerPool.cpp
+ * \brief \b Classes: \a uWorkerPool
+ */
+/*
+ * Copyright (C) 2015 EEnginE project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "uWorkerPool.hpp"
+
+namespace e_engine {
+
+/*!
+ * \brief Starts the workers
+ * \param[in] _numThreads The number of workers (0: std::thread::hardware_concurrency())
+ */
+uWorkerPool::uWorkerPool( unsigned int _numThreads ) {
+   if ( _numThreads == 0 )
+      _numThreads = std::thread::hardware_concurrency();
+
+   if ( _numThreads == 0 )
+      _numThreads = 1;
+
+   for ( unsigned int i = 0; i < _numThreads; ++i )
+      vWorkers.emplace_back( &uWorkerPool::workerLoop, this );
+}
+
+uWorkerPool::~uWorkerPool() {
+   {
+      std::lock_guard<std::mutex> lLock( vJobs_MUT );
+      vStop_B = true;
+   }
+
+   vJobs_CV.notify_all();
+
+   for ( auto &i : vWorkers )
+      i.join();
+}
+
+void uWorkerPool::workerLoop() {
+   while ( true ) {
+      std::function<void()> lJob;
+
+      {
+         std::unique_lock<std::mutex> lLock( vJobs_MUT );
+         vJobs_CV.wait( lLock, [this]() { return vStop_B || !vJobs.empty(); } );
+
+         // Finish all remaining jobs before stopping
+         if ( vJobs.empty() )
+            return;
+
+         lJob = std::move( vJobs.front() );
+         vJobs.pop_front();
+      }
+
+      lJob();
+   }
+}
+}
+
+// kate: indent-mode cstyle; indent-width 3; replace-tabs on; line-numbers on;
@@ -0,0 +1,96 @@
+/*!
+ * \file uWorkerPool.hpp
+ * \brief \b Classes: \a uWorkerPool
+ */
+/*
+ * Copyright (C) 2015 EEnginE project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef U_WORKER_POOL_HPP
+#define U_WORKER_POOL_HPP
+
+#include "defines.hpp"
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+
+namespace e_engine {
+
+/*!
+ * \brief A fixed number of worker threads processing a job queue
+ *
+ * Jobs are pushed with push() and executed in FIFO order by the first free worker. The result
+ * (or the exception) of a job is available through the returned future.
+ *
+ * The destructor finishes all queued jobs before joining the workers.
+ */
+class uWorkerPool final {
+ private:
+   std::vector<std::thread> vWorkers;
+   std::deque<std::function<void()>> vJobs;
+
+   std::mutex vJobs_MUT;
+   std::condition_variable vJobs_CV;
+
+   bool vStop_B = false;
+
+   void workerLoop();
+
+ public:
+   uWorkerPool( unsigned int _numThreads = 0 );
+   ~uWorkerPool();
+
+   // Forbid copying
+   uWorkerPool( const uWorkerPool & ) = delete;
+   uWorkerPool &operator=( const uWorkerPool & ) = delete;
+
+   template <class F>
+   std::future<typename std::result_of<F()>::type> push( F _job );
+
+   size_t getNumThreads() const { return vWorkers.size(); }
+};
+
+/*!
+ * \brief Adds a job to the queue
+ * \param[in] _job A callable without arguments
+ * \returns the future of the result of _job
+ */
+template <class F>
+std::future<typename std::result_of<F()>::type> uWorkerPool::push( F _job ) {
+   typedef typename std::result_of<F()>::type RESULT;
+
+   auto lTask = std::make_shared<std::packaged_task<RESULT()>>( std::move( _job ) );
+   std::future<RESULT> lFuture = lTask->get_future();
+
+   {
+      std::lock_guard<std::mutex> lLock( vJobs_MUT );
+      vJobs.emplace_back( [lTask]() { ( *lTask )(); } );
+   }
+
+   vJobs_CV.notify_one();
+   return lFuture;
+}
+}
+
+#endif // U_WORKER_POOL_HPP
+
+// kate: indent-mode cstyle; indent-width 3; replace-tabs on; line-numbers on;